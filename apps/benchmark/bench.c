@@ -0,0 +1,165 @@
+/**
+ * @file
+ * @brief Common timing and reporting helpers for the BACnet Stack
+ * benchmark applications.
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "bench.h"
+
+#if defined(BENCH_ALLOCATIONS)
+/* Count the heap allocations of the library and the benchmark.
+   The executables are linked with --wrap for each function, so that
+   calls to malloc() resolve to __wrap_malloc() and so on. */
+static unsigned long Bench_Allocations;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void *__wrap_malloc(size_t size);
+void *__wrap_calloc(size_t nmemb, size_t size);
+void *__wrap_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    Bench_Allocations++;
+
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+    Bench_Allocations++;
+
+    return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    Bench_Allocations++;
+
+    return __real_realloc(ptr, size);
+}
+#endif
+
+/**
+ * @brief Get the number of heap allocations so far
+ * @return number of calls to malloc, calloc and realloc, or zero
+ *  when the allocations are not counted
+ */
+unsigned long bench_allocations(void)
+{
+#if defined(BENCH_ALLOCATIONS)
+    return Bench_Allocations;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Get a monotonic timestamp
+ * @return timestamp in nanoseconds
+ */
+uint64_t bench_time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Get the number of iterations from the command line
+ * @param argc - number of command line arguments
+ * @param argv - command line arguments
+ * @return number of iterations for each benchmark case
+ */
+unsigned long bench_iterations(int argc, char *argv[])
+{
+    unsigned long iterations = BENCH_ITERATIONS_DEFAULT;
+
+    if (argc > 1) {
+        iterations = strtoul(argv[1], NULL, 0);
+        if (iterations == 0) {
+            iterations = 1;
+        }
+    }
+
+    return iterations;
+}
+
+/**
+ * @brief Start timing a benchmark case
+ * @param bench - benchmark case
+ * @param name - name of the benchmark case
+ */
+void bench_begin(BENCH_CASE *bench, const char *name)
+{
+    bench->name = name;
+    bench->iterations = 0;
+    bench->elapsed_ns = 0;
+    bench->bytes = 0;
+    bench->allocations = 0;
+    bench->start_allocations = bench_allocations();
+    bench->start_ns = bench_time_ns();
+}
+
+/**
+ * @brief Stop timing a benchmark case
+ * @param bench - benchmark case
+ * @param iterations - number of operations that were timed
+ * @param bytes - number of bytes that were encoded or decoded
+ */
+void bench_end(BENCH_CASE *bench, unsigned long iterations, uint64_t bytes)
+{
+    bench->elapsed_ns = bench_time_ns() - bench->start_ns;
+    bench->allocations = bench_allocations() - bench->start_allocations;
+    bench->iterations = iterations;
+    bench->bytes = bytes;
+}
+
+/**
+ * @brief Print the column header for bench_report()
+ */
+void bench_report_header(void)
+{
+    printf("%-32s %12s %12s %12s %10s %10s\n", "benchmark", "ops", "ns/op",
+        "bytes/op", "MB/s", "allocs/op");
+}
+
+/**
+ * @brief Print the results of a benchmark case
+ * @param bench - benchmark case
+ */
+void bench_report(BENCH_CASE const *bench)
+{
+    double ns_per_op = 0.0;
+    double bytes_per_op = 0.0;
+    double mb_per_s = 0.0;
+    double allocs_per_op = 0.0;
+
+    if (bench->iterations) {
+        ns_per_op = (double)bench->elapsed_ns / (double)bench->iterations;
+        bytes_per_op = (double)bench->bytes / (double)bench->iterations;
+        allocs_per_op =
+            (double)bench->allocations / (double)bench->iterations;
+    }
+    if (bench->elapsed_ns) {
+        mb_per_s = ((double)bench->bytes * 1000.0) / (double)bench->elapsed_ns;
+    }
+    printf("%-32s %12lu %12.1f %12.1f %10.1f", bench->name, bench->iterations,
+        ns_per_op, bytes_per_op, mb_per_s);
+#if defined(BENCH_ALLOCATIONS)
+    printf(" %10.2f\n", allocs_per_op);
+#else
+    (void)allocs_per_op;
+    printf(" %10s\n", "-");
+#endif
+}
@@ -0,0 +1,47 @@
+/**
+ * @file
+ * @brief Common timing and reporting helpers for the BACnet Stack
+ * benchmark applications.
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BENCH_H
+#define BACNET_BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* default number of times each benchmark case is run */
+#ifndef BENCH_ITERATIONS_DEFAULT
+#define BENCH_ITERATIONS_DEFAULT 100000UL
+#endif
+
+struct bench_case_t {
+    const char *name;
+    unsigned long iterations;
+    uint64_t start_ns;
+    uint64_t elapsed_ns;
+    uint64_t bytes;
+    unsigned long start_allocations;
+    unsigned long allocations;
+};
+typedef struct bench_case_t BENCH_CASE;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+uint64_t bench_time_ns(void);
+unsigned long bench_allocations(void);
+unsigned long bench_iterations(int argc, char *argv[]);
+void bench_begin(BENCH_CASE *bench, const char *name);
+void bench_end(BENCH_CASE *bench, unsigned long iterations, uint64_t bytes);
+void bench_report_header(void);
+void bench_report(BENCH_CASE const *bench);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
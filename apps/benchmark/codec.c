@@ -0,0 +1,846 @@
+/**
+ * @file
+ * @brief Benchmark of the BACnet codec: application data and its JSON
+ * text, NPDU and BVLC framing, and the ReadProperty, ReadPropertyMultiple,
+ * COV notification, ReadRange and I-Am services, using payloads like those
+ * seen on a site.
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/apdu.h"
+#include "bacnet/bacapp.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacjson.h"
+#include "bacnet/bacstr.h"
+#include "bacnet/bactext.h"
+#include "bacnet/cov.h"
+#include "bacnet/datetime.h"
+#include "bacnet/iam.h"
+#include "bacnet/npdu.h"
+#include "bacnet/readrange.h"
+#include "bacnet/rp.h"
+#include "bacnet/rpm.h"
+#include "bacnet/datalink/bvlc.h"
+#include "bacnet/basic/service/h_rpm_a.h"
+#include "bacnet/basic/sys/arena.h"
+#include "bench.h"
+
+/* number of values in the application data corpus */
+#define CODEC_VALUES 12
+/* number of records in the ReadRange-ACK of a trend log */
+#ifndef CODEC_LOG_RECORDS
+#define CODEC_LOG_RECORDS 16
+#endif
+/* size of the arena for decoding one RPM-ACK */
+#ifndef CODEC_ARENA_SIZE
+#define CODEC_ARENA_SIZE (256UL * 1024UL)
+#endif
+
+struct codec_message_t {
+    uint8_t pdu[MAX_PDU];
+    uint16_t pdu_len;
+};
+
+static BACNET_APPLICATION_DATA_VALUE Values[CODEC_VALUES];
+static struct codec_message_t Encoded_Values[CODEC_VALUES];
+static BACNET_ADDRESS Dest_Addresses[3];
+static BACNET_ADDRESS Src_Addresses[3];
+static struct codec_message_t Npdus[3];
+static struct codec_message_t Rpm_Ack;
+static struct codec_message_t Cov_Notification;
+static struct codec_message_t Log_Records;
+static struct codec_message_t Rr_Ack;
+static struct codec_message_t I_Am;
+#if defined(BACDL_BIP)
+static struct codec_message_t Bvlc;
+#endif
+static uint8_t Buffer[MAX_PDU];
+/* number of values or items seen by the walks of the replies */
+static unsigned long Result_Count;
+
+/**
+ * @brief Build a corpus of the application datatypes that are common
+ *  in property values, and their encodings
+ */
+static void codec_values_init(void)
+{
+    BACNET_APPLICATION_DATA_VALUE *value;
+    unsigned i;
+    int len;
+
+    value = &Values[0];
+    value->tag = BACNET_APPLICATION_TAG_REAL;
+    value->type.Real = 72.5f;
+    value++;
+    value->tag = BACNET_APPLICATION_TAG_ENUMERATED;
+    value->type.Enumerated = UNITS_DEGREES_FAHRENHEIT;
+    value++;
+    value->tag = BACNET_APPLICATION_TAG_BOOLEAN;
+    value->type.Boolean = false;
+    value++;
+    value->tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+    value->type.Unsigned_Int = 1476;
+    value++;
+    value->tag = BACNET_APPLICATION_TAG_SIGNED_INT;
+    value->type.Signed_Int = -40;
+    value++;
+    value->tag = BACNET_APPLICATION_TAG_CHARACTER_STRING;
+    characterstring_init_ansi(
+        &value->type.Character_String, "AHU-1 Supply Air Temperature");
+    value++;
+    value->tag = BACNET_APPLICATION_TAG_BIT_STRING;
+    bitstring_init(&value->type.Bit_String);
+    bitstring_set_bit(&value->type.Bit_String, STATUS_FLAG_IN_ALARM, false);
+    bitstring_set_bit(&value->type.Bit_String, STATUS_FLAG_FAULT, false);
+    bitstring_set_bit(&value->type.Bit_String, STATUS_FLAG_OVERRIDDEN, false);
+    bitstring_set_bit(
+        &value->type.Bit_String, STATUS_FLAG_OUT_OF_SERVICE, false);
+    value++;
+    value->tag = BACNET_APPLICATION_TAG_OBJECT_ID;
+    value->type.Object_Id.type = OBJECT_ANALOG_INPUT;
+    value->type.Object_Id.instance = 1001;
+    value++;
+    value->tag = BACNET_APPLICATION_TAG_DATE;
+    datetime_set_date(&value->type.Date, 2026, 10, 17);
+    value++;
+    value->tag = BACNET_APPLICATION_TAG_TIME;
+    datetime_set_time(&value->type.Time, 13, 45, 30, 0);
+    value++;
+    value->tag = BACNET_APPLICATION_TAG_DOUBLE;
+    value->type.Double = 123456.789;
+    value++;
+    value->tag = BACNET_APPLICATION_TAG_OCTET_STRING;
+    octetstring_init(&value->type.Octet_String,
+        (uint8_t *)"\xc0\xa8\x00\x0a\xba\xc0", 6);
+    for (i = 0; i < CODEC_VALUES; i++) {
+        len = bacapp_encode_application_data(
+            Encoded_Values[i].pdu, &Values[i]);
+        Encoded_Values[i].pdu_len = (uint16_t)len;
+    }
+}
+
+/**
+ * @brief Build NPDU for a local, a routed, and a router-forwarded message
+ */
+static void codec_npdu_init(void)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS *dest;
+    BACNET_ADDRESS *src;
+    unsigned i;
+
+    /* local unicast */
+    dest = &Dest_Addresses[0];
+    src = &Src_Addresses[0];
+    dest->mac_len = 6;
+    memcpy(dest->mac, "\xc0\xa8\x00\x0a\xba\xc0", 6);
+    src->mac_len = 6;
+    memcpy(src->mac, "\xc0\xa8\x00\x01\xba\xc0", 6);
+    /* routed to an MS/TP device */
+    dest = &Dest_Addresses[1];
+    src = &Src_Addresses[1];
+    dest->net = 2001;
+    dest->len = 1;
+    dest->adr[0] = 23;
+    src->mac_len = 6;
+    memcpy(src->mac, "\xc0\xa8\x00\x01\xba\xc0", 6);
+    /* global broadcast forwarded by a router */
+    dest = &Dest_Addresses[2];
+    src = &Src_Addresses[2];
+    dest->net = BACNET_BROADCAST_NETWORK;
+    src->net = 2001;
+    src->len = 1;
+    src->adr[0] = 23;
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+    for (i = 0; i < 3; i++) {
+        Npdus[i].pdu_len = (uint16_t)npdu_encode_pdu(
+            Npdus[i].pdu, &Dest_Addresses[i], &Src_Addresses[i], &npdu_data);
+    }
+}
+
+/**
+ * @brief Build the service messages of the corpus
+ */
+static void codec_services_init(void)
+{
+    BACNET_RPM_DATA rpmdata = { 0 };
+    BACNET_COV_DATA cov_data = { 0 };
+    BACNET_PROPERTY_VALUE value_list[2];
+    BACNET_READ_RANGE_DATA rrdata = { 0 };
+    BACNET_BIT_STRING status_flags;
+    BACNET_DATE date;
+    BACNET_TIME time;
+    uint8_t *apdu;
+    uint32_t instance;
+    unsigned i;
+    int len = 0;
+
+    /* RPM-ACK of present-value, status-flags, object-name and units
+       of a few analog inputs */
+    apdu = Rpm_Ack.pdu;
+    len = rpm_ack_encode_apdu_init(apdu, 1);
+    for (instance = 1; instance <= 4; instance++) {
+        rpmdata.object_type = OBJECT_ANALOG_INPUT;
+        rpmdata.object_instance = instance;
+        len += rpm_ack_encode_apdu_object_begin(&apdu[len], &rpmdata);
+        len += rpm_ack_encode_apdu_object_property(
+            &apdu[len], PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+        len += rpm_ack_encode_apdu_object_property_value(&apdu[len],
+            Encoded_Values[0].pdu, Encoded_Values[0].pdu_len);
+        len += rpm_ack_encode_apdu_object_property(
+            &apdu[len], PROP_STATUS_FLAGS, BACNET_ARRAY_ALL);
+        len += rpm_ack_encode_apdu_object_property_value(&apdu[len],
+            Encoded_Values[6].pdu, Encoded_Values[6].pdu_len);
+        len += rpm_ack_encode_apdu_object_property(
+            &apdu[len], PROP_OBJECT_NAME, BACNET_ARRAY_ALL);
+        len += rpm_ack_encode_apdu_object_property_value(&apdu[len],
+            Encoded_Values[5].pdu, Encoded_Values[5].pdu_len);
+        len += rpm_ack_encode_apdu_object_property(
+            &apdu[len], PROP_UNITS, BACNET_ARRAY_ALL);
+        len += rpm_ack_encode_apdu_object_property_value(&apdu[len],
+            Encoded_Values[1].pdu, Encoded_Values[1].pdu_len);
+        len += rpm_ack_encode_apdu_object_end(&apdu[len]);
+    }
+    Rpm_Ack.pdu_len = (uint16_t)len;
+    /* COV notification of present-value and status-flags */
+    cov_data.subscriberProcessIdentifier = 1;
+    cov_data.initiatingDeviceIdentifier = 260001;
+    cov_data.monitoredObjectIdentifier.type = OBJECT_ANALOG_INPUT;
+    cov_data.monitoredObjectIdentifier.instance = 1;
+    cov_data.timeRemaining = 300;
+    cov_data_value_list_link(&cov_data, value_list, 2);
+    value_list[0].propertyIdentifier = PROP_PRESENT_VALUE;
+    value_list[0].propertyArrayIndex = BACNET_ARRAY_ALL;
+    value_list[0].value = Values[0];
+    value_list[0].priority = BACNET_NO_PRIORITY;
+    value_list[1].propertyIdentifier = PROP_STATUS_FLAGS;
+    value_list[1].propertyArrayIndex = BACNET_ARRAY_ALL;
+    value_list[1].value = Values[6];
+    value_list[1].priority = BACNET_NO_PRIORITY;
+    Cov_Notification.pdu_len = (uint16_t)cov_notify_service_request_encode(
+        Cov_Notification.pdu, sizeof(Cov_Notification.pdu), &cov_data);
+    /* trend log records: timestamp, real value, and status flags */
+    apdu = Log_Records.pdu;
+    len = 0;
+    bitstring_init(&status_flags);
+    bitstring_set_bit(&status_flags, STATUS_FLAG_IN_ALARM, false);
+    bitstring_set_bit(&status_flags, STATUS_FLAG_FAULT, false);
+    bitstring_set_bit(&status_flags, STATUS_FLAG_OVERRIDDEN, false);
+    bitstring_set_bit(&status_flags, STATUS_FLAG_OUT_OF_SERVICE, false);
+    datetime_set_date(&date, 2026, 10, 17);
+    for (i = 0; i < CODEC_LOG_RECORDS; i++) {
+        datetime_set_time(&time, 13, (uint8_t)(i % 60), 0, 0);
+        len += encode_opening_tag(&apdu[len], 0);
+        len += encode_application_date(&apdu[len], &date);
+        len += encode_application_time(&apdu[len], &time);
+        len += encode_closing_tag(&apdu[len], 0);
+        len += encode_opening_tag(&apdu[len], 1);
+        len += encode_context_real(&apdu[len], 2, 70.0f + (float)i);
+        len += encode_closing_tag(&apdu[len], 1);
+        len += encode_context_bitstring(&apdu[len], 2, &status_flags);
+    }
+    Log_Records.pdu_len = (uint16_t)len;
+    rrdata.object_type = OBJECT_TRENDLOG;
+    rrdata.object_instance = 1;
+    rrdata.object_property = PROP_LOG_BUFFER;
+    rrdata.array_index = BACNET_ARRAY_ALL;
+    rrdata.application_data = Log_Records.pdu;
+    rrdata.application_data_len = Log_Records.pdu_len;
+    bitstring_init(&rrdata.ResultFlags);
+    bitstring_set_bit(&rrdata.ResultFlags, RESULT_FLAG_FIRST_ITEM, true);
+    bitstring_set_bit(&rrdata.ResultFlags, RESULT_FLAG_LAST_ITEM, true);
+    bitstring_set_bit(&rrdata.ResultFlags, RESULT_FLAG_MORE_ITEMS, false);
+    rrdata.RequestType = RR_BY_SEQUENCE;
+    rrdata.ItemCount = CODEC_LOG_RECORDS;
+    rrdata.FirstSequence = 1;
+    Rr_Ack.pdu_len = (uint16_t)rr_ack_encode_apdu(Rr_Ack.pdu, 1, &rrdata);
+    /* I-Am, and the BACnet/IPv4 frame that carries it */
+    I_Am.pdu_len = (uint16_t)iam_encode_apdu(
+        I_Am.pdu, 260001, MAX_APDU, SEGMENTATION_NONE, 260);
+#if defined(BACDL_BIP)
+    len = Npdus[0].pdu_len;
+    memcpy(Buffer, Npdus[0].pdu, (size_t)len);
+    memcpy(&Buffer[len], I_Am.pdu, I_Am.pdu_len);
+    len += I_Am.pdu_len;
+    Bvlc.pdu_len = (uint16_t)bvlc_encode_original_unicast(
+        Bvlc.pdu, sizeof(Bvlc.pdu), Buffer, (uint16_t)len);
+#endif
+}
+
+/**
+ * @brief Encode and decode the application data corpus, round robin
+ * @param iterations - number of values to encode, and to decode
+ */
+static void codec_application_data_run(unsigned long iterations)
+{
+    BENCH_CASE bench;
+    BACNET_APPLICATION_DATA_VALUE value;
+    struct codec_message_t *message;
+    unsigned long i;
+    uint64_t bytes = 0;
+    int len;
+
+    bench_begin(&bench, "app-data-encode");
+    for (i = 0; i < iterations; i++) {
+        len = bacapp_encode_application_data(
+            Buffer, &Values[i % CODEC_VALUES]);
+        if (len > 0) {
+            bytes += (uint64_t)len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+    bytes = 0;
+    bench_begin(&bench, "app-data-decode");
+    for (i = 0; i < iterations; i++) {
+        message = &Encoded_Values[i % CODEC_VALUES];
+        len = bacapp_decode_application_data(
+            message->pdu, message->pdu_len, &value);
+        if (len > 0) {
+            bytes += (uint64_t)len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+}
+
+/**
+ * @brief Get the property of a value of the application data corpus,
+ *  so that enumerations are written by name
+ * @param value - value of the corpus
+ * @return property identifier
+ */
+static BACNET_PROPERTY_ID codec_value_property(
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    if (value->tag == BACNET_APPLICATION_TAG_ENUMERATED) {
+        return PROP_UNITS;
+    }
+
+    return PROP_PRESENT_VALUE;
+}
+
+/**
+ * @brief Write the application data corpus as text with
+ *  bacapp_snprintf_value() and as JSON, and parse the JSON, round robin
+ * @param iterations - number of values to write, and to parse
+ */
+static void codec_json_run(unsigned long iterations)
+{
+    BENCH_CASE bench;
+    BACNET_OBJECT_PROPERTY_VALUE object_value = { 0 };
+    BACNET_APPLICATION_DATA_VALUE value;
+    BACJSON_WRITER writer = { 0 };
+    static char text[CODEC_VALUES][64];
+    static size_t text_len[CODEC_VALUES];
+    BACNET_PROPERTY_ID property;
+    unsigned long i;
+    unsigned n;
+    uint64_t bytes = 0;
+    int len;
+
+    object_value.object_type = OBJECT_ANALOG_INPUT;
+    object_value.array_index = BACNET_ARRAY_ALL;
+    bench_begin(&bench, "app-data-snprintf");
+    for (i = 0; i < iterations; i++) {
+        object_value.value = &Values[i % CODEC_VALUES];
+        object_value.object_property =
+            codec_value_property(object_value.value);
+        len = bacapp_snprintf_value(
+            (char *)Buffer, sizeof(Buffer), &object_value);
+        if (len > 0) {
+            bytes += (uint64_t)len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+    bytes = 0;
+    bench_begin(&bench, "app-data-json");
+    for (i = 0; i < iterations; i++) {
+        bacjson_writer_init(&writer, (char *)Buffer, sizeof(Buffer));
+        property = codec_value_property(&Values[i % CODEC_VALUES]);
+        if (bacjson_value_encode(&writer, OBJECT_ANALOG_INPUT, property,
+                &Values[i % CODEC_VALUES])) {
+            bytes += writer.length;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+    for (n = 0; n < CODEC_VALUES; n++) {
+        bacjson_writer_init(&writer, text[n], sizeof(text[n]));
+        bacjson_value_encode(&writer, OBJECT_ANALOG_INPUT,
+            codec_value_property(&Values[n]), &Values[n]);
+        text_len[n] = writer.length;
+    }
+    bytes = 0;
+    bench_begin(&bench, "app-data-json-parse");
+    for (i = 0; i < iterations; i++) {
+        n = (unsigned)(i % CODEC_VALUES);
+        len = bacjson_value_parse(text[n], text_len[n], Values[n].tag,
+            OBJECT_ANALOG_INPUT, codec_value_property(&Values[n]), &value);
+        if (len > 0) {
+            bytes += (uint64_t)len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+}
+
+/**
+ * @brief Encode and decode the NPDU corpus, round robin
+ * @param iterations - number of NPDU to encode, and to decode
+ */
+static void codec_npdu_run(unsigned long iterations)
+{
+    BENCH_CASE bench;
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_NPDU_VIEW view = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    struct codec_message_t *message;
+    unsigned long i;
+    uint64_t bytes = 0;
+    int len;
+
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+    bench_begin(&bench, "npdu-encode");
+    for (i = 0; i < iterations; i++) {
+        len = npdu_encode_pdu(Buffer, &Dest_Addresses[i % 3],
+            &Src_Addresses[i % 3], &npdu_data);
+        if (len > 0) {
+            bytes += (uint64_t)len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+    bytes = 0;
+    bench_begin(&bench, "npdu-decode");
+    for (i = 0; i < iterations; i++) {
+        message = &Npdus[i % 3];
+        len = bacnet_npdu_decode(
+            message->pdu, message->pdu_len, &dest, &src, &npdu_data);
+        if (len > 0) {
+            bytes += (uint64_t)len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+    bytes = 0;
+    bench_begin(&bench, "npdu-view-decode");
+    for (i = 0; i < iterations; i++) {
+        message = &Npdus[i % 3];
+        len = bacnet_npdu_view_decode(message->pdu, message->pdu_len, &view);
+        if (len > 0) {
+            bytes += (uint64_t)len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+}
+
+/**
+ * @brief Encode and decode ReadProperty-ACK of the corpus values,
+ *  including the property value, round robin
+ * @param iterations - number of ACK to encode, and to decode
+ */
+static void codec_rp_ack_run(unsigned long iterations)
+{
+    BENCH_CASE bench;
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    BACNET_APPLICATION_DATA_VALUE value;
+    struct codec_message_t *message;
+    struct codec_message_t *acks;
+    unsigned long i;
+    uint64_t bytes = 0;
+    int len;
+
+    acks = calloc(CODEC_VALUES, sizeof(struct codec_message_t));
+    if (!acks) {
+        return;
+    }
+    rpdata.object_type = OBJECT_ANALOG_INPUT;
+    rpdata.object_instance = 1;
+    rpdata.object_property = PROP_PRESENT_VALUE;
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    bench_begin(&bench, "rp-ack-encode");
+    for (i = 0; i < iterations; i++) {
+        message = &Encoded_Values[i % CODEC_VALUES];
+        rpdata.application_data = message->pdu;
+        rpdata.application_data_len = message->pdu_len;
+        len = rp_ack_encode_apdu(Buffer, (uint8_t)i, &rpdata);
+        if (len > 0) {
+            bytes += (uint64_t)len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+    for (i = 0; i < CODEC_VALUES; i++) {
+        rpdata.application_data = Encoded_Values[i].pdu;
+        rpdata.application_data_len = Encoded_Values[i].pdu_len;
+        acks[i].pdu_len =
+            (uint16_t)rp_ack_encode_apdu(acks[i].pdu, 1, &rpdata);
+    }
+    bytes = 0;
+    bench_begin(&bench, "rp-ack-decode");
+    for (i = 0; i < iterations; i++) {
+        message = &acks[i % CODEC_VALUES];
+        /* skip the complex-ack header: type, invoke-id, service */
+        len = rp_ack_decode_service_request(
+            &message->pdu[3], message->pdu_len - 3, &rpdata);
+        if (len > 0) {
+            len = bacapp_decode_application_data(rpdata.application_data,
+                (uint32_t)rpdata.application_data_len, &value);
+            if (len > 0) {
+                bytes += message->pdu_len;
+            }
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+    free(acks);
+}
+
+/**
+ * @brief Decode the RPM-ACK into the result lists, as the client
+ *  RPM-ACK handler does, with the heap and with an arena
+ * @param iterations - number of ACK to decode
+ */
+static void codec_rpm_ack_run(unsigned long iterations)
+{
+    BENCH_CASE bench;
+    BACNET_READ_ACCESS_DATA *rpm_data;
+    ARENA_BUFFER arena;
+    void *arena_data;
+    unsigned long i;
+    uint64_t bytes = 0;
+    int len;
+
+    bench_begin(&bench, "rpm-ack-decode");
+    for (i = 0; i < iterations; i++) {
+        rpm_data = calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
+        /* skip the complex-ack header: type, invoke-id, service */
+        len = rpm_ack_decode_service_request(
+            &Rpm_Ack.pdu[3], Rpm_Ack.pdu_len - 3, rpm_data);
+        while (rpm_data) {
+            rpm_data = rpm_data_free(rpm_data);
+        }
+        if (len > 0) {
+            bytes += Rpm_Ack.pdu_len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+    arena_data = malloc(CODEC_ARENA_SIZE);
+    Arena_Init(&arena, arena_data, CODEC_ARENA_SIZE);
+    bytes = 0;
+    bench_begin(&bench, "rpm-ack-decode-arena");
+    for (i = 0; i < iterations; i++) {
+        rpm_data = Arena_Alloc(&arena, sizeof(BACNET_READ_ACCESS_DATA));
+        len = rpm_ack_decode_service_request_arena(
+            &Rpm_Ack.pdu[3], Rpm_Ack.pdu_len - 3, rpm_data, &arena);
+        Arena_Reset(&arena);
+        if (len > 0) {
+            bytes += Rpm_Ack.pdu_len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+    free(arena_data);
+}
+
+/**
+ * @brief Count the results of a walk of an RPM-ACK
+ * @param device_id - device instance of the device that replied
+ * @param rp_data - object, property, and value or error of one result
+ */
+static void codec_rpm_ack_result(
+    uint32_t device_id, BACNET_READ_PROPERTY_DATA *rp_data)
+{
+    (void)device_id;
+    if (rp_data->application_data) {
+        Result_Count++;
+    }
+}
+
+/**
+ * @brief Walk the RPM-ACK in place, without building the result lists
+ * @param iterations - number of ACK to walk
+ */
+static void codec_rpm_ack_process_run(unsigned long iterations)
+{
+    BENCH_CASE bench;
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    unsigned long i;
+    uint64_t bytes = 0;
+    int len;
+
+    bench_begin(&bench, "rpm-ack-process");
+    for (i = 0; i < iterations; i++) {
+        /* skip the complex-ack header: type, invoke-id, service */
+        len = rpm_ack_object_property_process(&Rpm_Ack.pdu[3],
+            Rpm_Ack.pdu_len - 3, 260001, &rp_data, codec_rpm_ack_result);
+        if (len > 0) {
+            bytes += Rpm_Ack.pdu_len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+}
+
+/**
+ * @brief Encode and decode the COV notification
+ * @param iterations - number of notifications to encode, and to decode
+ */
+static void codec_cov_run(unsigned long iterations)
+{
+    BENCH_CASE bench;
+    BACNET_COV_DATA cov_data = { 0 };
+    BACNET_PROPERTY_VALUE value_list[2];
+    unsigned long i;
+    uint64_t bytes = 0;
+    int len;
+
+    cov_data_value_list_link(&cov_data, value_list, 2);
+    len = cov_notify_decode_service_request(
+        Cov_Notification.pdu, Cov_Notification.pdu_len, &cov_data);
+    if (len <= 0) {
+        return;
+    }
+    bench_begin(&bench, "cov-notify-encode");
+    for (i = 0; i < iterations; i++) {
+        len = (int)cov_notify_service_request_encode(
+            Buffer, sizeof(Buffer), &cov_data);
+        if (len > 0) {
+            bytes += (uint64_t)len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+    bytes = 0;
+    bench_begin(&bench, "cov-notify-decode");
+    for (i = 0; i < iterations; i++) {
+        cov_data_value_list_link(&cov_data, value_list, 2);
+        len = cov_notify_decode_service_request(
+            Cov_Notification.pdu, Cov_Notification.pdu_len, &cov_data);
+        if (len > 0) {
+            bytes += (uint64_t)len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+}
+
+/**
+ * @brief Encode and decode the ReadRange-ACK of trend log records
+ * @param iterations - number of ACK to encode, and to decode
+ */
+static void codec_rr_ack_run(unsigned long iterations)
+{
+    BENCH_CASE bench;
+    BACNET_READ_RANGE_DATA rrdata = { 0 };
+    unsigned long i;
+    uint64_t bytes = 0;
+    int len;
+
+    len = rr_ack_decode_service_request(
+        &Rr_Ack.pdu[3], Rr_Ack.pdu_len - 3, &rrdata);
+    if (len <= 0) {
+        return;
+    }
+    rrdata.RequestType = RR_BY_SEQUENCE;
+    bench_begin(&bench, "readrange-ack-encode");
+    for (i = 0; i < iterations; i++) {
+        len = rr_ack_encode_apdu(Buffer, (uint8_t)i, &rrdata);
+        if (len > 0) {
+            bytes += (uint64_t)len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+    bytes = 0;
+    bench_begin(&bench, "readrange-ack-decode");
+    for (i = 0; i < iterations; i++) {
+        /* skip the complex-ack header: type, invoke-id, service */
+        len = rr_ack_decode_service_request(
+            &Rr_Ack.pdu[3], Rr_Ack.pdu_len - 3, &rrdata);
+        if (len > 0) {
+            bytes += Rr_Ack.pdu_len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+}
+
+/**
+ * @brief Count the items of a walk of a ReadRange-ACK
+ * @param device_id - device instance of the device that replied
+ * @param rrdata - decoded ReadRange-ACK
+ * @param item_number - item number in this reply
+ * @param item_data - encoded item
+ * @param item_data_len - number of bytes in the encoded item
+ */
+static void codec_rr_ack_item(uint32_t device_id,
+    BACNET_READ_RANGE_DATA *rrdata,
+    uint32_t item_number,
+    uint8_t *item_data,
+    int item_data_len)
+{
+    (void)device_id;
+    (void)rrdata;
+    (void)item_number;
+    (void)item_data;
+    if (item_data_len > 0) {
+        Result_Count++;
+    }
+}
+
+/**
+ * @brief Walk the items of the ReadRange-ACK of trend log records
+ * @param iterations - number of ACK to walk
+ */
+static void codec_rr_ack_process_run(unsigned long iterations)
+{
+    BENCH_CASE bench;
+    BACNET_READ_RANGE_DATA rrdata = { 0 };
+    unsigned long i;
+    uint64_t bytes = 0;
+    int len;
+
+    bench_begin(&bench, "readrange-ack-process");
+    for (i = 0; i < iterations; i++) {
+        /* skip the complex-ack header: type, invoke-id, service */
+        len = rr_ack_item_process(&Rr_Ack.pdu[3], Rr_Ack.pdu_len - 3, 260001,
+            &rrdata, codec_rr_ack_item);
+        if (len > 0) {
+            bytes += Rr_Ack.pdu_len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+}
+
+/**
+ * @brief Encode and decode I-Am
+ * @param iterations - number of messages to encode, and to decode
+ */
+static void codec_iam_run(unsigned long iterations)
+{
+    BENCH_CASE bench;
+    uint32_t device_id = 0;
+    unsigned max_apdu = 0;
+    int segmentation = 0;
+    uint16_t vendor_id = 0;
+    unsigned long i;
+    uint64_t bytes = 0;
+    int len;
+
+    bench_begin(&bench, "iam-encode");
+    for (i = 0; i < iterations; i++) {
+        len = iam_encode_apdu(Buffer, (uint32_t)(i & BACNET_MAX_INSTANCE),
+            MAX_APDU, SEGMENTATION_NONE, 260);
+        if (len > 0) {
+            bytes += (uint64_t)len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+    bytes = 0;
+    bench_begin(&bench, "iam-decode");
+    for (i = 0; i < iterations; i++) {
+        /* skip the unconfirmed request header: type, service */
+        len = iam_decode_service_request(&I_Am.pdu[2], &device_id,
+            &max_apdu, &segmentation, &vendor_id);
+        if (len > 0) {
+            bytes += I_Am.pdu_len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+}
+
+#if defined(BACDL_BIP)
+/**
+ * @brief Decode the BACnet/IPv4 frame of an I-Am
+ * @param iterations - number of messages to decode
+ */
+static void codec_bvlc_iam_run(unsigned long iterations)
+{
+    BENCH_CASE bench;
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint32_t device_id = 0;
+    unsigned max_apdu = 0;
+    int segmentation = 0;
+    uint16_t vendor_id = 0;
+    uint8_t message_type = 0;
+    uint16_t message_length = 0;
+    uint16_t npdu_len = 0;
+    unsigned long i;
+    uint64_t bytes = 0;
+    int len;
+    int offset;
+
+    bench_begin(&bench, "bvlc-iam-decode");
+    for (i = 0; i < iterations; i++) {
+        offset = bvlc_decode_header(
+            Bvlc.pdu, Bvlc.pdu_len, &message_type, &message_length);
+        if ((offset <= 0) || (message_type != BVLC_ORIGINAL_UNICAST_NPDU)) {
+            continue;
+        }
+        len = bvlc_decode_original_unicast(&Bvlc.pdu[offset],
+            message_length - offset, Buffer, sizeof(Buffer), &npdu_len);
+        if (len <= 0) {
+            continue;
+        }
+        offset = bacnet_npdu_decode(Buffer, npdu_len, &dest, &src, &npdu_data);
+        if ((offset <= 0) || (offset + 2 >= npdu_len)) {
+            continue;
+        }
+        len = iam_decode_service_request(&Buffer[offset + 2], &device_id,
+            &max_apdu, &segmentation, &vendor_id);
+        if (len > 0) {
+            bytes += Bvlc.pdu_len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+}
+#endif
+
+int main(int argc, char *argv[])
+{
+    unsigned long iterations;
+
+    iterations = bench_iterations(argc, argv);
+    bactext_index_init();
+    codec_values_init();
+    codec_npdu_init();
+    codec_services_init();
+    bench_report_header();
+    codec_application_data_run(iterations);
+    codec_json_run(iterations);
+    codec_npdu_run(iterations);
+    codec_rp_ack_run(iterations);
+    codec_rpm_ack_run(iterations);
+    codec_rpm_ack_process_run(iterations);
+    codec_cov_run(iterations);
+    codec_rr_ack_run(iterations);
+    codec_rr_ack_process_run(iterations);
+    codec_iam_run(iterations);
+#if defined(BACDL_BIP)
+    codec_bvlc_iam_run(iterations);
+#endif
+
+    return 0;
+}
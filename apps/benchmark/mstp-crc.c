@@ -0,0 +1,148 @@
+/**
+ * @file
+ * @brief Benchmark of the MS/TP data CRC and the COBS CRC-32K, an octet
+ * at a time and a span at a time, and of COBS frame encoding and decoding.
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/datalink/cobs.h"
+#include "bacnet/datalink/crc.h"
+#include "bacnet/datalink/mstpdef.h"
+#include "bench.h"
+
+/* most data octets in an MS/TP frame with a CRC-16 */
+#define MSTP_CRC_DATA_LEN 501
+/* data octets in an extended frame, and its COBS encoded size */
+#define MSTP_CRC_COBS_DATA_LEN 1476
+#define MSTP_CRC_COBS_FRAME_LEN \
+    (COBS_ENCODED_SIZE(MSTP_CRC_COBS_DATA_LEN) + COBS_ENCODED_CRC_SIZE)
+
+static uint8_t Data[MSTP_CRC_COBS_DATA_LEN];
+static uint8_t Frame[MSTP_CRC_COBS_FRAME_LEN];
+static size_t Frame_Len;
+static uint8_t Decoded[MSTP_CRC_COBS_FRAME_LEN];
+/* keeps the results of each case from being optimized away */
+static volatile uint32_t CRC_Sink;
+
+/**
+ * @brief Accumulate the MS/TP data CRC of a frame of data octets
+ * @param iterations - number of frames
+ */
+static void mstp_crc16_run(unsigned long iterations)
+{
+    BENCH_CASE bench;
+    unsigned long i;
+    uint16_t crc;
+    unsigned n;
+
+    bench_begin(&bench, "crc16-octet");
+    for (i = 0; i < iterations; i++) {
+        crc = 0xFFFF;
+        for (n = 0; n < MSTP_CRC_DATA_LEN; n++) {
+            crc = CRC_Calc_Data(Data[n], crc);
+        }
+        CRC_Sink = crc;
+    }
+    bench_end(&bench, iterations, (uint64_t)iterations * MSTP_CRC_DATA_LEN);
+    bench_report(&bench);
+    bench_begin(&bench, "crc16-span");
+    for (i = 0; i < iterations; i++) {
+        crc = CRC_Calc_Data_Span(Data, MSTP_CRC_DATA_LEN, 0xFFFF);
+        CRC_Sink = crc;
+    }
+    bench_end(&bench, iterations, (uint64_t)iterations * MSTP_CRC_DATA_LEN);
+    bench_report(&bench);
+}
+
+/**
+ * @brief Accumulate the CRC-32K of the encoded data of an extended frame
+ * @param iterations - number of frames
+ */
+static void mstp_crc32k_run(unsigned long iterations)
+{
+    BENCH_CASE bench;
+    unsigned long i;
+    uint32_t crc;
+    size_t n;
+
+    bench_begin(&bench, "crc32k-octet");
+    for (i = 0; i < iterations; i++) {
+        crc = CRC32K_INITIAL_VALUE;
+        for (n = 0; n < Frame_Len; n++) {
+            crc = cobs_crc32k(Frame[n], crc);
+        }
+        CRC_Sink = crc;
+    }
+    bench_end(&bench, iterations, (uint64_t)iterations * Frame_Len);
+    bench_report(&bench);
+    bench_begin(&bench, "crc32k-span");
+    for (i = 0; i < iterations; i++) {
+        crc = cobs_crc32k_span(Frame, Frame_Len, CRC32K_INITIAL_VALUE);
+        CRC_Sink = crc;
+    }
+    bench_end(&bench, iterations, (uint64_t)iterations * Frame_Len);
+    bench_report(&bench);
+}
+
+/**
+ * @brief Encode and decode the COBS encoded data and CRC-32K fields of
+ *  an extended frame
+ * @param iterations - number of frames
+ */
+static void mstp_cobs_run(unsigned long iterations)
+{
+    BENCH_CASE bench;
+    unsigned long i;
+    uint64_t bytes = 0;
+    size_t len;
+
+    bench_begin(&bench, "cobs-frame-encode");
+    for (i = 0; i < iterations; i++) {
+        len = cobs_frame_encode(Frame, sizeof(Frame), Data, sizeof(Data));
+        bytes += len;
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+    bytes = 0;
+    bench_begin(&bench, "cobs-frame-decode");
+    for (i = 0; i < iterations; i++) {
+        len = cobs_frame_decode(Decoded, sizeof(Decoded), Frame, Frame_Len);
+        bytes += len;
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long iterations;
+    unsigned n;
+
+    iterations = bench_iterations(argc, argv);
+    for (n = 0; n < sizeof(Data); n++) {
+        Data[n] = (uint8_t)((n * 73) + 41);
+    }
+    Frame_Len = cobs_frame_encode(Frame, sizeof(Frame), Data, sizeof(Data));
+    if ((Frame_Len == 0) ||
+        (cobs_frame_decode(Decoded, sizeof(Decoded), Frame, Frame_Len) !=
+            sizeof(Data))) {
+        fprintf(stderr, "COBS frame encode or decode failed\n");
+        return 1;
+    }
+    bench_report_header();
+    mstp_crc16_run(iterations);
+    mstp_crc32k_run(iterations);
+    mstp_cobs_run(iterations);
+
+    return 0;
+}
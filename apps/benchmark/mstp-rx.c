@@ -0,0 +1,235 @@
+/**
+ * @file
+ * @brief Benchmark of the CPU used by the Linux MS/TP receive path, fed
+ * with frames at the pace of a serial line through a pseudo-terminal pair.
+ * The octet at a time receive path, RS485_Check_UART_Data() and
+ * MSTP_Receive_Frame_FSM(), is compared with the block receive path,
+ * RS485_Receive_Frame_Data().
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/datalink/dlmstp.h"
+#include "bacnet/datalink/mstp.h"
+#include "bacnet/datalink/mstpdef.h"
+#include "rs485.h"
+#include "bench.h"
+
+/* default number of frames received by each case */
+#ifndef MSTP_RX_FRAMES_DEFAULT
+#define MSTP_RX_FRAMES_DEFAULT 500UL
+#endif
+/* default baud rate at which the frames are paced */
+#ifndef MSTP_RX_BAUD_DEFAULT
+#define MSTP_RX_BAUD_DEFAULT 115200UL
+#endif
+/* number of octets of data in the data frames */
+#define MSTP_RX_DATA_LEN 120
+
+struct mstp_rx_writer_t {
+    int fd;
+    unsigned long frames;
+    unsigned long baud;
+};
+
+static uint8_t Rx_Buffer[DLMSTP_MPDU_MAX];
+static uint8_t Tx_Buffer[DLMSTP_MPDU_MAX];
+static uint64_t Silence_Start_ns;
+
+static uint32_t mstp_rx_silence(void *arg)
+{
+    (void)arg;
+
+    return (uint32_t)((bench_time_ns() - Silence_Start_ns) / 1000000ULL);
+}
+
+static void mstp_rx_silence_reset(void *arg)
+{
+    (void)arg;
+    Silence_Start_ns = bench_time_ns();
+}
+
+/**
+ * @brief Write a token, a data frame, and a token for another node, over
+ *  and over, each frame at the pace of the baud rate
+ * @param arg - writer settings
+ * @return NULL
+ */
+static void *mstp_rx_writer_task(void *arg)
+{
+    struct mstp_rx_writer_t *writer = (struct mstp_rx_writer_t *)arg;
+    uint8_t frame[DLMSTP_MPDU_MAX];
+    uint8_t data[MSTP_RX_DATA_LEN];
+    struct timespec delay;
+    unsigned long i;
+    uint16_t len;
+    uint64_t ns;
+    unsigned n;
+
+    for (n = 0; n < sizeof(data); n++) {
+        data[n] = (uint8_t)n;
+    }
+    for (i = 0; i < writer->frames; i++) {
+        switch (i % 3) {
+            case 0:
+                len = MSTP_Create_Frame(frame, sizeof(frame),
+                    FRAME_TYPE_TOKEN, 1, 2, NULL, 0);
+                break;
+            case 1:
+                len = MSTP_Create_Frame(frame, sizeof(frame),
+                    FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, 1, 2, data,
+                    sizeof(data));
+                break;
+            default:
+                len = MSTP_Create_Frame(frame, sizeof(frame),
+                    FRAME_TYPE_TOKEN, 3, 1, NULL, 0);
+                break;
+        }
+        if (write(writer->fd, frame, len) != (ssize_t)len) {
+            break;
+        }
+        /* ten bits per octet on the wire */
+        ns = ((uint64_t)len * 10ULL * 1000000000ULL) / writer->baud;
+        delay.tv_sec = (time_t)(ns / 1000000000ULL);
+        delay.tv_nsec = (long)(ns % 1000000000ULL);
+        nanosleep(&delay, NULL);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Receive frames from the pseudo-terminal and report the CPU used
+ * @param name - name of the case
+ * @param master_fd - pseudo-terminal master, written with frames
+ * @param frames - number of frames to receive
+ * @param baud - baud rate at which the frames are paced
+ * @param block - true for the block receive path
+ */
+static void mstp_rx_run(const char *name,
+    int master_fd,
+    unsigned long frames,
+    unsigned long baud,
+    bool block)
+{
+    struct mstp_port_struct_t mstp_port = { 0 };
+    struct mstp_rx_writer_t writer = { 0 };
+    struct rusage usage_start, usage_end;
+    struct timespec cpu_start, cpu_end;
+    pthread_t thread;
+    unsigned long received = 0;
+    uint64_t start_ns, elapsed_ns, cpu_ns, deadline_ns;
+    long wakeups;
+
+    mstp_port.InputBuffer = Rx_Buffer;
+    mstp_port.InputBufferSize = sizeof(Rx_Buffer);
+    mstp_port.OutputBuffer = Tx_Buffer;
+    mstp_port.OutputBufferSize = sizeof(Tx_Buffer);
+    mstp_port.SilenceTimer = mstp_rx_silence;
+    mstp_port.SilenceTimerReset = mstp_rx_silence_reset;
+    mstp_port.This_Station = 1;
+    mstp_port.Nmax_info_frames = 1;
+    mstp_port.Nmax_master = 127;
+    MSTP_Init(&mstp_port);
+    mstp_port.Tframe_abort = DEFAULT_Tframe_abort;
+    writer.fd = master_fd;
+    writer.frames = frames;
+    writer.baud = baud;
+    /* allow for a slow start and a few lost frames */
+    deadline_ns = ((uint64_t)frames * 80ULL * 10ULL * 1000000000ULL) / baud;
+    deadline_ns = (deadline_ns * 2) + 2000000000ULL;
+    start_ns = bench_time_ns();
+    getrusage(RUSAGE_THREAD, &usage_start);
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_start);
+    if (pthread_create(&thread, NULL, mstp_rx_writer_task, &writer) != 0) {
+        return;
+    }
+    while ((received < frames) &&
+        ((bench_time_ns() - start_ns) < deadline_ns)) {
+        if (block) {
+            RS485_Receive_Frame_Data(&mstp_port, RS485_RECEIVE_WAIT_MS);
+        } else {
+            RS485_Check_UART_Data(&mstp_port);
+            MSTP_Receive_Frame_FSM(&mstp_port);
+        }
+        if (mstp_port.ReceivedValidFrame || mstp_port.ReceivedInvalidFrame) {
+            if (mstp_port.ReceivedValidFrame) {
+                received++;
+            }
+            mstp_port.ReceivedValidFrame = false;
+            mstp_port.ReceivedInvalidFrame = false;
+        }
+    }
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_end);
+    getrusage(RUSAGE_THREAD, &usage_end);
+    elapsed_ns = bench_time_ns() - start_ns;
+    pthread_join(thread, NULL);
+    cpu_ns = ((uint64_t)(cpu_end.tv_sec - cpu_start.tv_sec) * 1000000000ULL) +
+        (uint64_t)cpu_end.tv_nsec - (uint64_t)cpu_start.tv_nsec;
+    wakeups = (usage_end.ru_nvcsw - usage_start.ru_nvcsw) +
+        (usage_end.ru_nivcsw - usage_start.ru_nivcsw);
+    printf("%-24s %10lu %10.1f %12.1f %8.2f %12.1f\n", name, received,
+        (double)elapsed_ns / 1000000.0,
+        received ? ((double)cpu_ns / 1000.0) / (double)received : 0.0,
+        elapsed_ns ? (100.0 * (double)cpu_ns) / (double)elapsed_ns : 0.0,
+        received ? (double)wakeups / (double)received : 0.0);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long frames = MSTP_RX_FRAMES_DEFAULT;
+    unsigned long baud = MSTP_RX_BAUD_DEFAULT;
+    char *slave_name;
+    int master_fd;
+
+    if (argc > 1) {
+        frames = strtoul(argv[1], NULL, 0);
+        if (frames == 0) {
+            frames = 1;
+        }
+    }
+    if (argc > 2) {
+        baud = strtoul(argv[2], NULL, 0);
+        if (baud == 0) {
+            baud = MSTP_RX_BAUD_DEFAULT;
+        }
+    }
+    master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((master_fd < 0) || (grantpt(master_fd) != 0) ||
+        (unlockpt(master_fd) != 0)) {
+        perror("posix_openpt");
+        return 1;
+    }
+    slave_name = ptsname(master_fd);
+    if (!slave_name) {
+        perror("ptsname");
+        return 1;
+    }
+    RS485_Set_Interface(slave_name);
+    RS485_Set_Baud_Rate(baud);
+    RS485_Initialize();
+    printf("%-24s %10s %10s %12s %8s %12s\n", "benchmark", "frames",
+        "wall-ms", "cpu-us/frame", "cpu-%", "wakeups/frame");
+    mstp_rx_run("mstp-rx-octet", master_fd, frames, baud, false);
+    mstp_rx_run("mstp-rx-block", master_fd, frames, baud, true);
+    close(master_fd);
+
+    return 0;
+}
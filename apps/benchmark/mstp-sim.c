@@ -0,0 +1,581 @@
+/**
+ * @file
+ * @brief Simulation of an MS/TP network, with a number of master nodes
+ * running the MS/TP state machines on an in-process virtual bus, and
+ * a benchmark of the token rotation time, the data frames per second,
+ * and the reply latency, with and without a load of requests.
+ * Octets take the time of the baud rate on the virtual bus, and the
+ * simulated time runs as fast as the host can run the state machines.
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/datalink/dlmstp.h"
+#include "bacnet/datalink/mstp.h"
+#include "bacnet/datalink/mstpdef.h"
+#include "bench.h"
+
+/* most master nodes on the virtual bus */
+#define MSTP_SIM_NODES_MAX (DEFAULT_MAX_MASTER + 1)
+/* octets in flight on the virtual bus, a power of two */
+#define MSTP_SIM_BUS_OCTETS 65536UL
+/* requests waiting for the token at each node */
+#define MSTP_SIM_QUEUE_SIZE 16
+/* octets of the send time at the start of each request and reply */
+#define MSTP_SIM_STAMP_LEN 8
+/* most simulated seconds for the nodes to form the token ring */
+#define MSTP_SIM_WARMUP_S 60
+/* defaults for the command line arguments */
+#define MSTP_SIM_NODES_DEFAULT 8
+#define MSTP_SIM_BAUD_DEFAULT 115200UL
+#define MSTP_SIM_SECONDS_DEFAULT 10UL
+#define MSTP_SIM_RATE_DEFAULT 10UL
+#define MSTP_SIM_PDU_DEFAULT 64
+
+/* an octet on the virtual bus, and when it is received */
+struct mstp_sim_octet_t {
+    uint64_t time_us;
+    uint8_t octet;
+    uint8_t sender;
+};
+
+/* a master node with its port and its application */
+struct mstp_sim_node_t {
+    struct mstp_port_struct_t port;
+    uint8_t rx_buffer[DLMSTP_MPDU_MAX];
+    uint8_t tx_buffer[DLMSTP_MPDU_MAX];
+    /* time as seen by this node, and the end of its transmission */
+    uint64_t clock_us;
+    uint64_t busy_until_us;
+    uint64_t silence_us;
+    /* next octet of the virtual bus to receive */
+    uint64_t rx_index;
+    /* requests waiting for the token: when each was queued */
+    uint64_t queue[MSTP_SIM_QUEUE_SIZE];
+    unsigned queue_head;
+    unsigned queue_count;
+    uint64_t next_request_us;
+    uint8_t next_destination;
+    /* the reply to the last request received */
+    bool reply_valid;
+    uint8_t reply_destination;
+    uint8_t reply_stamp[MSTP_SIM_STAMP_LEN];
+    /* when this node last received the token */
+    uint64_t token_us;
+};
+
+/* the virtual bus, and what is measured on it */
+struct mstp_sim_t {
+    struct mstp_sim_octet_t octets[MSTP_SIM_BUS_OCTETS];
+    uint64_t head;
+    uint64_t free_us;
+    uint64_t now_us;
+    uint32_t octet_us;
+    unsigned node_count;
+    uint64_t request_us;
+    uint16_t pdu_len;
+    bool load;
+    /* measurements */
+    unsigned long token_count;
+    unsigned long rotation_count;
+    uint64_t rotation_total_us;
+    uint64_t rotation_max_us;
+    unsigned long data_frames;
+    unsigned long reply_count;
+    uint64_t reply_total_us;
+    uint64_t reply_max_us;
+    unsigned long drops;
+};
+
+static struct mstp_sim_t Sim;
+static struct mstp_sim_node_t Nodes[MSTP_SIM_NODES_MAX];
+
+static uint32_t mstp_sim_silence(void *arg)
+{
+    struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)arg;
+    struct mstp_sim_node_t *node =
+        (struct mstp_sim_node_t *)mstp_port->UserData;
+
+    if (node->clock_us <= node->silence_us) {
+        return 0;
+    }
+
+    return (uint32_t)((node->clock_us - node->silence_us) / 1000);
+}
+
+static void mstp_sim_silence_reset(void *arg)
+{
+    struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)arg;
+    struct mstp_sim_node_t *node =
+        (struct mstp_sim_node_t *)mstp_port->UserData;
+
+    /* silence starts after the last octet that this node sends */
+    if (node->clock_us > node->busy_until_us) {
+        node->silence_us = node->clock_us;
+    } else {
+        node->silence_us = node->busy_until_us;
+    }
+}
+
+static uint32_t mstp_sim_milliseconds(void *arg)
+{
+    struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)arg;
+    struct mstp_sim_node_t *node =
+        (struct mstp_sim_node_t *)mstp_port->UserData;
+
+    return (uint32_t)(node->clock_us / 1000);
+}
+
+static void mstp_sim_stamp_encode(uint8_t *buffer, uint64_t time_us)
+{
+    unsigned i;
+
+    for (i = 0; i < MSTP_SIM_STAMP_LEN; i++) {
+        buffer[i] = (uint8_t)(time_us >> (8 * i));
+    }
+}
+
+static uint64_t mstp_sim_stamp_decode(const uint8_t *buffer)
+{
+    uint64_t time_us = 0;
+    unsigned i;
+
+    for (i = 0; i < MSTP_SIM_STAMP_LEN; i++) {
+        time_us |= (uint64_t)buffer[i] << (8 * i);
+    }
+
+    return time_us;
+}
+
+/**
+ * @brief Put a frame on the virtual bus, after any frame already on it,
+ *  with each octet received the time of an octet after the one before
+ * @param mstp_port - port of the node that sends
+ * @param buffer - frame to send
+ * @param nbytes - number of octets in the frame
+ */
+void MSTP_Send_Frame(
+    struct mstp_port_struct_t *mstp_port, uint8_t *buffer, uint16_t nbytes)
+{
+    struct mstp_sim_node_t *node =
+        (struct mstp_sim_node_t *)mstp_port->UserData;
+    struct mstp_sim_node_t *destination;
+    struct mstp_sim_octet_t *octet;
+    uint64_t start_us, rotation_us;
+    uint16_t i;
+
+    start_us = node->clock_us;
+    /* Tturnaround: 40 bit times of idle line after the last octet */
+    if ((Sim.free_us + (4 * Sim.octet_us)) > start_us) {
+        start_us = Sim.free_us + (4 * Sim.octet_us);
+    }
+    for (i = 0; i < nbytes; i++) {
+        octet = &Sim.octets[Sim.head % MSTP_SIM_BUS_OCTETS];
+        octet->time_us = start_us + ((uint64_t)(i + 1) * Sim.octet_us);
+        octet->octet = buffer[i];
+        octet->sender = mstp_port->This_Station;
+        Sim.head++;
+    }
+    Sim.free_us = start_us + ((uint64_t)nbytes * Sim.octet_us);
+    node->busy_until_us = Sim.free_us;
+    node->silence_us = Sim.free_us;
+    if (nbytes < 8) {
+        return;
+    }
+    switch (buffer[2]) {
+        case FRAME_TYPE_TOKEN:
+            Sim.token_count++;
+            if (buffer[3] < Sim.node_count) {
+                destination = &Nodes[buffer[3]];
+                if (destination->token_us) {
+                    rotation_us = Sim.free_us - destination->token_us;
+                    Sim.rotation_count++;
+                    Sim.rotation_total_us += rotation_us;
+                    if (rotation_us > Sim.rotation_max_us) {
+                        Sim.rotation_max_us = rotation_us;
+                    }
+                }
+                destination->token_us = Sim.free_us;
+            }
+            break;
+        case FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY:
+        case FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY:
+        case FRAME_TYPE_BACNET_EXTENDED_DATA_EXPECTING_REPLY:
+        case FRAME_TYPE_BACNET_EXTENDED_DATA_NOT_EXPECTING_REPLY:
+            Sim.data_frames++;
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief The application of a node receives a request, and has its reply
+ *  ready at once, or a reply to one of its own requests
+ * @param mstp_port - port of the node that receives
+ * @return number of octets received
+ */
+uint16_t MSTP_Put_Receive(struct mstp_port_struct_t *mstp_port)
+{
+    struct mstp_sim_node_t *node =
+        (struct mstp_sim_node_t *)mstp_port->UserData;
+    uint64_t reply_us;
+
+    if (mstp_port->DataLength < MSTP_SIM_STAMP_LEN) {
+        return mstp_port->DataLength;
+    }
+    if (mstp_port->FrameType == FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY) {
+        if (node->reply_valid) {
+            Sim.drops++;
+        }
+        node->reply_valid = true;
+        node->reply_destination = mstp_port->SourceAddress;
+        memcpy(node->reply_stamp, mstp_port->InputBuffer, MSTP_SIM_STAMP_LEN);
+    } else if (mstp_port->DestinationAddress == mstp_port->This_Station) {
+        reply_us = node->clock_us -
+            mstp_sim_stamp_decode(mstp_port->InputBuffer);
+        Sim.reply_count++;
+        Sim.reply_total_us += reply_us;
+        if (reply_us > Sim.reply_max_us) {
+            Sim.reply_max_us = reply_us;
+        }
+    }
+
+    return mstp_port->DataLength;
+}
+
+/**
+ * @brief Encode the reply held by a node into its output buffer
+ * @param node - node with the reply
+ * @return number of octets in the frame
+ */
+static uint16_t mstp_sim_reply_frame(struct mstp_sim_node_t *node)
+{
+    uint8_t data[MSTP_SIM_STAMP_LEN];
+
+    memcpy(data, node->reply_stamp, sizeof(data));
+    node->reply_valid = false;
+
+    return MSTP_Create_Frame(node->port.OutputBuffer,
+        node->port.OutputBufferSize, FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY,
+        node->reply_destination, node->port.This_Station, data, sizeof(data));
+}
+
+uint16_t MSTP_Get_Reply(struct mstp_port_struct_t *mstp_port, unsigned timeout)
+{
+    struct mstp_sim_node_t *node =
+        (struct mstp_sim_node_t *)mstp_port->UserData;
+    (void)timeout;
+
+    if (!node->reply_valid ||
+        (node->reply_destination != mstp_port->SourceAddress)) {
+        return 0;
+    }
+
+    return mstp_sim_reply_frame(node);
+}
+
+/**
+ * @brief Send a reply left over from a Reply Postponed, or the oldest
+ *  request waiting for the token, to the next node around the ring
+ * @param mstp_port - port of the node holding the token
+ * @param timeout - unused
+ * @return number of octets in the frame, or zero for nothing to send
+ */
+uint16_t MSTP_Get_Send(struct mstp_port_struct_t *mstp_port, unsigned timeout)
+{
+    struct mstp_sim_node_t *node =
+        (struct mstp_sim_node_t *)mstp_port->UserData;
+    uint8_t data[MAX_PDU] = { 0 };
+    uint8_t destination;
+    (void)timeout;
+
+    if (node->reply_valid) {
+        return mstp_sim_reply_frame(node);
+    }
+    if (node->queue_count == 0) {
+        return 0;
+    }
+    mstp_sim_stamp_encode(data, node->queue[node->queue_head]);
+    node->queue_head = (node->queue_head + 1) % MSTP_SIM_QUEUE_SIZE;
+    node->queue_count--;
+    destination = node->next_destination;
+    node->next_destination = (uint8_t)((destination + 1) % Sim.node_count);
+    if (node->next_destination == mstp_port->This_Station) {
+        node->next_destination =
+            (uint8_t)((node->next_destination + 1) % Sim.node_count);
+    }
+
+    return MSTP_Create_Frame(mstp_port->OutputBuffer,
+        mstp_port->OutputBufferSize, FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY,
+        destination, mstp_port->This_Station, data, Sim.pdu_len);
+}
+
+/**
+ * @brief Queue the requests of a node that are due, at a steady rate
+ * @param node - node that makes the requests
+ */
+static void mstp_sim_node_requests(struct mstp_sim_node_t *node)
+{
+    unsigned tail;
+
+    while (node->next_request_us <= node->clock_us) {
+        if (node->queue_count < MSTP_SIM_QUEUE_SIZE) {
+            tail = (node->queue_head + node->queue_count) % MSTP_SIM_QUEUE_SIZE;
+            node->queue[tail] = node->next_request_us;
+            node->queue_count++;
+        } else {
+            Sim.drops++;
+        }
+        node->next_request_us += Sim.request_us;
+    }
+}
+
+static void mstp_sim_node_fsm(struct mstp_sim_node_t *node)
+{
+    while (MSTP_Master_Node_FSM(&node->port)) {
+        /* do nothing while immediate transitioning */
+    }
+}
+
+/**
+ * @brief Receive the octets that reached a node by now, one frame at a
+ *  time, and run its state machine for each frame and for its timers
+ * @param node - node to run
+ */
+static void mstp_sim_node_run(struct mstp_sim_node_t *node)
+{
+    struct mstp_port_struct_t *mstp_port = &node->port;
+    struct mstp_sim_octet_t *octet;
+
+    if (node->busy_until_us > Sim.now_us) {
+        /* still sending */
+        return;
+    }
+    if (node->clock_us < node->busy_until_us) {
+        node->clock_us = node->busy_until_us;
+    }
+    if ((Sim.head - node->rx_index) > MSTP_SIM_BUS_OCTETS) {
+        /* overrun */
+        node->rx_index = Sim.head - MSTP_SIM_BUS_OCTETS;
+    }
+    while (node->rx_index < Sim.head) {
+        octet = &Sim.octets[node->rx_index % MSTP_SIM_BUS_OCTETS];
+        if (octet->time_us > Sim.now_us) {
+            break;
+        }
+        node->rx_index++;
+        if (octet->sender == mstp_port->This_Station) {
+            continue;
+        }
+        if (octet->time_us > node->clock_us) {
+            node->clock_us = octet->time_us;
+        }
+        (void)MSTP_Receive_Frame_Data(mstp_port, &octet->octet, 1);
+        if (mstp_port->ReceivedValidFrame || mstp_port->ReceivedInvalidFrame) {
+            mstp_sim_node_fsm(node);
+            if (node->busy_until_us > Sim.now_us) {
+                return;
+            }
+        }
+    }
+    node->clock_us = Sim.now_us;
+    if (Sim.load) {
+        mstp_sim_node_requests(node);
+    }
+    mstp_sim_node_fsm(node);
+}
+
+/**
+ * @brief Start the virtual bus with its nodes powered up at once
+ * @param node_count - number of master nodes
+ * @param baud - baud rate of the virtual bus
+ * @param adaptive - true to tune Max_Master and Max_Info_Frames
+ */
+static void mstp_sim_init(
+    unsigned node_count, unsigned long baud, bool adaptive)
+{
+    struct mstp_sim_node_t *node;
+    unsigned i;
+
+    memset(&Sim, 0, sizeof(Sim));
+    memset(Nodes, 0, sizeof(Nodes));
+    Sim.node_count = node_count;
+    /* ten bits per octet on the wire */
+    Sim.octet_us = (uint32_t)((10UL * 1000000UL) / baud);
+    if (Sim.octet_us == 0) {
+        Sim.octet_us = 1;
+    }
+    for (i = 0; i < node_count; i++) {
+        node = &Nodes[i];
+        node->port.UserData = node;
+        node->port.InputBuffer = node->rx_buffer;
+        node->port.InputBufferSize = sizeof(node->rx_buffer);
+        node->port.OutputBuffer = node->tx_buffer;
+        node->port.OutputBufferSize = sizeof(node->tx_buffer);
+        node->port.SilenceTimer = mstp_sim_silence;
+        node->port.SilenceTimerReset = mstp_sim_silence_reset;
+        node->port.MillisecondTimer = mstp_sim_milliseconds;
+        node->port.This_Station = (uint8_t)i;
+        node->port.Nmax_info_frames = 1;
+        node->port.Nmax_master = DEFAULT_MAX_MASTER;
+        MSTP_Init(&node->port);
+        node->port.Tframe_abort = DEFAULT_Tframe_abort;
+        if (adaptive) {
+            MSTP_Adaptive_Enable(&node->port, true);
+        }
+        node->next_destination = (uint8_t)((i + 1) % node_count);
+    }
+}
+
+/**
+ * @brief Run the virtual bus and its nodes for a time
+ * @param duration_us - microseconds of simulated time
+ * @param ring - true to stop once every node has had the token
+ */
+static void mstp_sim_run(uint64_t duration_us, bool ring)
+{
+    uint64_t end_us = Sim.now_us + duration_us;
+    unsigned i;
+
+    while (Sim.now_us < end_us) {
+        Sim.now_us += Sim.octet_us;
+        for (i = 0; i < Sim.node_count; i++) {
+            mstp_sim_node_run(&Nodes[i]);
+        }
+        if (ring) {
+            for (i = 0; i < Sim.node_count; i++) {
+                if (Nodes[i].token_us == 0) {
+                    break;
+                }
+            }
+            if (i == Sim.node_count) {
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Simulate a case and report what was measured on the bus
+ * @param name - name of the case
+ * @param node_count - number of master nodes
+ * @param baud - baud rate of the virtual bus
+ * @param seconds - simulated seconds to measure
+ * @param rate - requests per second from each node, or zero for none
+ * @param pdu_len - octets in each request
+ * @param adaptive - true to tune Max_Master and Max_Info_Frames
+ */
+static void mstp_sim_case(const char *name,
+    unsigned node_count,
+    unsigned long baud,
+    unsigned long seconds,
+    unsigned long rate,
+    uint16_t pdu_len,
+    bool adaptive)
+{
+    uint64_t start_ns, elapsed_ns, start_us;
+    unsigned i;
+
+    start_ns = bench_time_ns();
+    mstp_sim_init(node_count, baud, adaptive);
+    /* let the nodes find each other and form the ring */
+    mstp_sim_run(MSTP_SIM_WARMUP_S * 1000000ULL, true);
+    Sim.token_count = 0;
+    Sim.rotation_count = 0;
+    Sim.rotation_total_us = 0;
+    Sim.rotation_max_us = 0;
+    Sim.data_frames = 0;
+    for (i = 0; i < node_count; i++) {
+        /* the first rotation holds the Poll For Master sweep */
+        Nodes[i].token_us = 0;
+    }
+    if (rate) {
+        Sim.request_us = 1000000ULL / rate;
+        if (Sim.request_us == 0) {
+            Sim.request_us = 1;
+        }
+    }
+    Sim.pdu_len = pdu_len;
+    Sim.load = (rate > 0);
+    start_us = Sim.now_us;
+    for (i = 0; i < node_count; i++) {
+        /* spread the requests of the nodes over the interval */
+        Nodes[i].next_request_us = start_us;
+        Nodes[i].next_request_us += (Sim.request_us * i) / node_count;
+    }
+    mstp_sim_run(seconds * 1000000ULL, false);
+    elapsed_ns = bench_time_ns() - start_ns;
+    printf("%-24s %5u %8.1f %8.2f %8.2f %9.1f %9.1f %8.2f %8.2f %6lu %9.1f\n",
+        name, node_count, (double)Sim.token_count / (double)seconds,
+        Sim.rotation_count ? ((double)Sim.rotation_total_us / 1000.0) /
+                (double)Sim.rotation_count
+                           : 0.0,
+        (double)Sim.rotation_max_us / 1000.0,
+        (double)Sim.data_frames / (double)seconds,
+        (double)Sim.reply_count / (double)seconds,
+        Sim.reply_count
+            ? ((double)Sim.reply_total_us / 1000.0) / (double)Sim.reply_count
+            : 0.0,
+        (double)Sim.reply_max_us / 1000.0, Sim.drops,
+        (double)elapsed_ns / 1000000.0);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned node_count = MSTP_SIM_NODES_DEFAULT;
+    unsigned long baud = MSTP_SIM_BAUD_DEFAULT;
+    unsigned long seconds = MSTP_SIM_SECONDS_DEFAULT;
+    unsigned long rate = MSTP_SIM_RATE_DEFAULT;
+    unsigned long pdu_len = MSTP_SIM_PDU_DEFAULT;
+
+    if (argc > 1) {
+        node_count = (unsigned)strtoul(argv[1], NULL, 0);
+    }
+    if (argc > 2) {
+        baud = strtoul(argv[2], NULL, 0);
+    }
+    if (argc > 3) {
+        seconds = strtoul(argv[3], NULL, 0);
+    }
+    if (argc > 4) {
+        rate = strtoul(argv[4], NULL, 0);
+    }
+    if (argc > 5) {
+        pdu_len = strtoul(argv[5], NULL, 0);
+    }
+    if ((node_count < 2) || (node_count > MSTP_SIM_NODES_MAX)) {
+        node_count = MSTP_SIM_NODES_DEFAULT;
+    }
+    if (baud == 0) {
+        baud = MSTP_SIM_BAUD_DEFAULT;
+    }
+    if (seconds == 0) {
+        seconds = 1;
+    }
+    if (pdu_len < MSTP_SIM_STAMP_LEN) {
+        pdu_len = MSTP_SIM_STAMP_LEN;
+    } else if (pdu_len > MSTP_FRAME_NPDU_MAX) {
+        pdu_len = MSTP_FRAME_NPDU_MAX;
+    }
+    printf("%-24s %5s %8s %8s %8s %9s %9s %8s %8s %6s %9s\n", "benchmark",
+        "nodes", "tokens/s", "trot-ms", "trot-max", "frames/s", "replies/s",
+        "reply-ms", "rply-max", "drops", "wall-ms");
+    mstp_sim_case("mstp-sim-idle", node_count, baud, seconds, 0,
+        (uint16_t)pdu_len, false);
+    mstp_sim_case("mstp-sim-load", node_count, baud, seconds, rate,
+        (uint16_t)pdu_len, false);
+    mstp_sim_case("mstp-sim-load-adaptive", node_count, baud, seconds, rate,
+        (uint16_t)pdu_len, true);
+
+    return 0;
+}
@@ -0,0 +1,325 @@
+/**
+ * @file
+ * @brief Benchmark of the ReadPropertyMultiple ALL response encoding
+ * of the basic device and objects, and of decoding the recorded
+ * responses as a client would, without any datalink.
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/apdu.h"
+#include "bacnet/bacapp.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/rpm.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/object/ai.h"
+#include "bacnet/basic/object/av.h"
+#include "bacnet/basic/object/bi.h"
+#include "bacnet/basic/object/bv.h"
+#include "bacnet/basic/object/msv.h"
+#include "bacnet/basic/object/property_cache.h"
+#include "bacnet/basic/service/h_rpm.h"
+#include "bacnet/basic/service/h_rpm_a.h"
+#include "bench.h"
+
+/* number of each type of object added to the device */
+#ifndef BENCH_RPM_OBJECTS
+#define BENCH_RPM_OBJECTS 100
+#endif
+
+struct rpm_request_t {
+    BACNET_OBJECT_TYPE object_type;
+    uint8_t pdu[MAX_APDU];
+    uint16_t pdu_len;
+    /* recorded RPM-ACK service data for this request */
+    uint8_t ack[MAX_APDU];
+    uint16_t ack_len;
+};
+
+static struct rpm_request_t *Requests;
+static unsigned Request_Count;
+/* recorded RPM-ACK of the populated object types */
+static struct rpm_request_t **Acks;
+static unsigned Ack_Count;
+static uint8_t Response[MAX_APDU];
+
+/**
+ * @brief Build one RPM request per object for the ALL property
+ */
+static void bench_rpm_requests_init(void)
+{
+    unsigned i = 0;
+    unsigned count = 0;
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t instance = 0;
+    struct rpm_request_t *request;
+    int len = 0;
+
+    count = Device_Object_List_Count();
+    Requests = calloc(count, sizeof(struct rpm_request_t));
+    if (!Requests) {
+        return;
+    }
+    for (i = 0; i < count; i++) {
+        if (!Device_Object_List_Identifier(i + 1, &object_type, &instance)) {
+            continue;
+        }
+        request = &Requests[Request_Count];
+        request->object_type = object_type;
+        /* service request only - skip the confirmed request header */
+        len = rpm_encode_apdu_object_begin(
+            &request->pdu[0], object_type, instance);
+        len += rpm_encode_apdu_object_property(
+            &request->pdu[len], PROP_ALL, BACNET_ARRAY_ALL);
+        len += rpm_encode_apdu_object_end(&request->pdu[len]);
+        request->pdu_len = (uint16_t)len;
+        Request_Count++;
+    }
+}
+
+/**
+ * @brief Add objects to the device so that the responses are realistic
+ */
+static void bench_rpm_objects_init(void)
+{
+    uint32_t instance;
+
+    Device_Init(NULL);
+    for (instance = 1; instance <= BENCH_RPM_OBJECTS; instance++) {
+        Analog_Input_Create(instance);
+        Analog_Value_Create(instance);
+        Binary_Input_Create(instance);
+        Binary_Value_Create(instance);
+        Multistate_Value_Create(instance);
+    }
+}
+
+/**
+ * @brief Encode the RPM ALL responses for all the objects, round robin
+ * @param name - name of the benchmark case
+ * @param iterations - number of responses to encode
+ */
+static void bench_rpm_run(const char *name, unsigned long iterations)
+{
+    BENCH_CASE bench;
+    BACNET_CONFIRMED_SERVICE_DATA service_data = { 0 };
+    unsigned long i;
+    uint64_t bytes = 0;
+    struct rpm_request_t *request;
+    int len;
+
+    service_data.max_segs = 0;
+    service_data.max_resp = MAX_APDU;
+    service_data.segmented_message = false;
+    bench_begin(&bench, name);
+    for (i = 0; i < iterations; i++) {
+        request = &Requests[i % Request_Count];
+        service_data.invoke_id = (uint8_t)i;
+        len = handler_read_property_multiple_encode(request->pdu,
+            request->pdu_len, &service_data, Response, sizeof(Response));
+        if (len > 0) {
+            bytes += (uint64_t)len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+}
+
+/**
+ * @brief Record the RPM-ACK service data of the populated object types
+ */
+static void bench_rpm_acks_init(void)
+{
+    BACNET_CONFIRMED_SERVICE_DATA service_data = { 0 };
+    struct rpm_request_t *request;
+    unsigned i;
+    int len;
+
+    Acks = calloc(Request_Count, sizeof(struct rpm_request_t *));
+    if (!Acks) {
+        return;
+    }
+    service_data.max_segs = 0;
+    service_data.max_resp = MAX_APDU;
+    service_data.segmented_message = false;
+    for (i = 0; i < Request_Count; i++) {
+        request = &Requests[i];
+        switch (request->object_type) {
+            case OBJECT_DEVICE:
+            case OBJECT_ANALOG_INPUT:
+            case OBJECT_ANALOG_VALUE:
+            case OBJECT_BINARY_INPUT:
+            case OBJECT_BINARY_VALUE:
+            case OBJECT_MULTI_STATE_VALUE:
+                break;
+            default:
+                continue;
+        }
+        len = handler_read_property_multiple_encode(request->pdu,
+            request->pdu_len, &service_data, Response, sizeof(Response));
+        /* skip the complex-ack header: type, invoke-id, service */
+        if ((len > 3) && (Response[0] == PDU_TYPE_COMPLEX_ACK)) {
+            memcpy(request->ack, &Response[3], (size_t)(len - 3));
+            request->ack_len = (uint16_t)(len - 3);
+            Acks[Ack_Count] = request;
+            Ack_Count++;
+        }
+    }
+}
+
+/**
+ * @brief Decode each property value of an RPM-ACK into one value
+ *  without building the result lists, to measure the value decoders
+ * @param apdu - RPM-ACK service data
+ * @param apdu_size - number of bytes of service data
+ * @return number of values decoded, or BACNET_STATUS_ERROR
+ */
+static int bench_rpm_ack_values_decode(uint8_t *apdu, int apdu_size)
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t object_instance = 0;
+    BACNET_PROPERTY_ID property = PROP_ALL;
+    BACNET_ARRAY_INDEX array_index = BACNET_ARRAY_ALL;
+    int count = 0;
+    int len;
+
+    while (apdu_size > 0) {
+        len = rpm_ack_decode_object_id(
+            apdu, (unsigned)apdu_size, &object_type, &object_instance);
+        if (len <= 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu += len;
+        apdu_size -= len;
+        for (;;) {
+            len = rpm_ack_decode_object_property(
+                apdu, (unsigned)apdu_size, &property, &array_index);
+            if (len <= 0) {
+                break;
+            }
+            apdu += len;
+            apdu_size -= len;
+            if (apdu_size <= 0) {
+                return BACNET_STATUS_ERROR;
+            }
+            if (decode_is_opening_tag_number(apdu, 4)) {
+                apdu++;
+                apdu_size--;
+                while ((apdu_size > 0) &&
+                    !decode_is_closing_tag_number(apdu, 4)) {
+                    len = bacapp_decode_known_property(
+                        apdu, apdu_size, &value, object_type, property);
+                    if (len <= 0) {
+                        return BACNET_STATUS_ERROR;
+                    }
+                    apdu += len;
+                    apdu_size -= len;
+                    count++;
+                }
+            } else {
+                /* propertyAccessError */
+                len = bacapp_data_len(apdu, (unsigned)apdu_size, property);
+                if (len < 0) {
+                    return BACNET_STATUS_ERROR;
+                }
+                apdu += len + 1;
+                apdu_size -= len + 1;
+            }
+            /* closing tag */
+            apdu++;
+            apdu_size--;
+        }
+        len = rpm_ack_decode_object_end(apdu, (unsigned)apdu_size);
+        if (len <= 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu += len;
+        apdu_size -= len;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Decode the recorded RPM-ACK of all the objects, round robin
+ * @param name - name of the benchmark case
+ * @param iterations - number of responses to decode
+ * @param lists - true to decode into the RPM result lists, as the
+ *  client RPM-ACK handler does, or false to decode only the values
+ */
+static void bench_rpm_ack_run(
+    const char *name, unsigned long iterations, bool lists)
+{
+    BENCH_CASE bench;
+    BACNET_READ_ACCESS_DATA *rpm_data;
+    struct rpm_request_t *request;
+    unsigned long i;
+    uint64_t bytes = 0;
+    int len;
+
+    if (Ack_Count == 0) {
+        return;
+    }
+    bench_begin(&bench, name);
+    for (i = 0; i < iterations; i++) {
+        request = Acks[i % Ack_Count];
+        if (lists) {
+            rpm_data = calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
+            len = rpm_ack_decode_service_request(
+                request->ack, request->ack_len, rpm_data);
+            while (rpm_data) {
+                rpm_data = rpm_data_free(rpm_data);
+            }
+        } else {
+            len = bench_rpm_ack_values_decode(request->ack, request->ack_len);
+        }
+        if (len > 0) {
+            bytes += request->ack_len;
+        }
+    }
+    bench_end(&bench, iterations, bytes);
+    bench_report(&bench);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long iterations;
+
+    iterations = bench_iterations(argc, argv);
+    bench_rpm_objects_init();
+    bench_rpm_requests_init();
+    if (Request_Count == 0) {
+        fprintf(stderr, "bench-rpm: no objects\n");
+        return 1;
+    }
+    printf("RPM ALL responses for %u objects\n", Request_Count);
+    bench_report_header();
+    bench_rpm_run("rpm-all-encode", iterations);
+#if defined(BACNET_PROPERTY_CACHE)
+    Property_Cache_Enable(OBJECT_DEVICE, true);
+    Property_Cache_Enable(OBJECT_ANALOG_INPUT, true);
+    Property_Cache_Enable(OBJECT_ANALOG_VALUE, true);
+    Property_Cache_Enable(OBJECT_BINARY_INPUT, true);
+    Property_Cache_Enable(OBJECT_BINARY_VALUE, true);
+    Property_Cache_Enable(OBJECT_MULTI_STATE_VALUE, true);
+    bench_rpm_run("rpm-all-encode-cached", iterations);
+    Property_Cache_Cleanup();
+#endif
+    bench_rpm_acks_init();
+    bench_rpm_ack_run("rpm-ack-decode", iterations, true);
+    bench_rpm_ack_run("rpm-ack-decode-values", iterations, false);
+    free(Acks);
+    free(Requests);
+
+    return 0;
+}
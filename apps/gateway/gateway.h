@@ -42,6 +42,8 @@
 #define DEV_NAME_BASE "Gateway Demo Device"
 #define DEV_DESCR_GATEWAY "Gateway Device and Router"
 #define DEV_DESCR_REMOTE  "Routed Remote Device"
+/* I-Am sent each second in answer to a Who-Is for the routed Devices */
+#define GATEWAY_I_AM_RATE 100
 
 
 
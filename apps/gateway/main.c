@@ -48,6 +48,7 @@
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/mstimer.h"
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/datalink/dlenv.h"
 /* include the device object */
@@ -175,12 +176,18 @@ static void Init_Service_Handlers(uint32_t first_object_instance)
     /* we need to handle who-is to support dynamic device binding
      * For the gateway, we will use the unicast variety so we can
      * get back through switches to different subnets.
-     * Don't need the routed versions, since the npdu handler calls
-     * each device in turn.
+     * The npdu handler calls each device in turn, except for global
+     * broadcasts, which the routed versions decode once and answer
+     * for every device.
      */
     apdu_set_unconfirmed_handler(
         SERVICE_UNCONFIRMED_WHO_IS, handler_who_is_unicast);
     apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_WHO_HAS, handler_who_has);
+    routed_apdu_set_broadcast_handler(
+        SERVICE_UNCONFIRMED_WHO_IS, handler_who_is_unicast_for_routing);
+    routed_apdu_set_broadcast_handler(
+        SERVICE_UNCONFIRMED_WHO_HAS, handler_who_has_for_routing);
+    handler_who_is_for_routing_rate_set(GATEWAY_I_AM_RATE);
     /* set the handler for all the services we don't implement */
     /* It is required to send the proper reject message... */
     apdu_set_unrecognized_service_handler_handler(handler_unrecognized_service);
@@ -221,7 +228,7 @@ static void Init_Service_Handlers(uint32_t first_object_instance)
  *      datalink_receive, npdu_handler,
  *      dcc_timer_seconds, datalink_maintenance_timer,
  *      Load_Control_State_Machine_Handler, handler_cov_task,
- *      tsm_timer_milliseconds
+ *      tsm_timer_milliseconds, handler_who_is_for_routing_task
  *
  * @param argc [in] Arg count.
  * @param argv [in] Takes one argument: the Device Instance #.
@@ -236,6 +243,8 @@ int main(int argc, char *argv[])
     time_t current_seconds = 0;
     uint32_t elapsed_seconds = 0;
     uint32_t elapsed_milliseconds = 0;
+    unsigned long last_milliseconds = 0;
+    unsigned long current_milliseconds = 0;
     uint32_t first_object_instance = FIRST_DEVICE_NUMBER;
 #ifdef BACNET_TEST_VMAC
     /* Router data */
@@ -273,6 +282,7 @@ int main(int argc, char *argv[])
 #endif
     /* configure the timeout values */
     last_seconds = time(NULL);
+    last_milliseconds = mstimer_now();
 
     /* broadcast an I-am-router-to-network on startup */
     printf("Remote Network DNET Number %d \n", DNET_list[0]);
@@ -301,6 +311,15 @@ int main(int argc, char *argv[])
             elapsed_milliseconds = elapsed_seconds * 1000;
             tsm_timer_milliseconds(elapsed_milliseconds);
         }
+        /* pace the I-Am replies to Who-Is on every pass */
+        current_milliseconds = mstimer_now();
+        elapsed_milliseconds = current_milliseconds - last_milliseconds;
+        last_milliseconds = current_milliseconds;
+        if (elapsed_milliseconds > 1000UL) {
+            /* no more than a second of replies is sent at once */
+            elapsed_milliseconds = 1000UL;
+        }
+        handler_who_is_for_routing_task((uint16_t)elapsed_milliseconds);
         handler_cov_task();
         /* output */
         if (Routed_Device_Index < MAX_NUM_DEVICES) {
@@ -45,6 +45,7 @@
 #include "bacnet/iam.h"
 #include "bacnet/version.h"
 #include "bacnet/datetime.h"
+#include "bacnet/bactext.h"
 /* basic datalink, timer, and filename */
 #include "bacnet/datalink/dlmstp.h"
 #include "bacnet/basic/sys/mstimer.h"
@@ -54,6 +55,10 @@
 /* OS specific includes */
 #include "bacport.h"
 #include "rs485.h"
+#if !defined(_WIN32)
+#include <pthread.h>
+#include <sys/mman.h>
+#endif
 
 #ifdef _WIN32
 #define strncasecmp(x, y, z) _strnicmp(x, y, z)
@@ -68,6 +73,13 @@
 #endif
 
 #define MSTP_HEADER_MAX (2 + 1 + 1 + 1 + 2 + 1)
+/* libpcap file header, and the header of each packet in the file */
+#define PCAP_GLOBAL_HEADER_LEN 24
+#define PCAP_RECORD_HEADER_LEN 16
+/* most threads that scan capture files at once */
+#ifndef MSTP_SCAN_THREADS_MAX
+#define MSTP_SCAN_THREADS_MAX 64
+#endif
 
 /* local port data - shared with RS-485 */
 static struct mstp_port_struct_t MSTP_Port;
@@ -84,7 +96,7 @@ static bool Wireshark_Capture;
 static struct mstimer Silence_Timer;
 
 /* statistics derived from monitoring the network for each node */
-struct mstp_statistics {
+struct mstp_node_statistics {
     /* counts how many times the node passes the token */
     uint32_t token_count;
     /* counts how many times the node receives the token */
@@ -134,8 +146,28 @@ struct mstp_statistics {
 };
 
 #define MAX_MSTP_DEVICES 256
-static struct mstp_statistics MSTP_Statistics[MAX_MSTP_DEVICES];
-static uint32_t Invalid_Frame_Count;
+/* number of APDU types, from the upper nibble of the first octet */
+#define MSTP_PDU_TYPES 16
+
+/* statistics of the nodes and the BACnet services seen in one capture */
+struct mstp_monitor {
+    struct mstp_node_statistics node[MAX_MSTP_DEVICES];
+    uint32_t invalid_frame_count;
+    /* counts of the network layer messages and of each type of APDU */
+    uint32_t network_message_count;
+    uint32_t pdu_type_count[MSTP_PDU_TYPES];
+    /* counts of the requests of each service */
+    uint32_t confirmed_count[MAX_BACNET_CONFIRMED_SERVICE];
+    uint32_t unconfirmed_count[MAX_BACNET_UNCONFIRMED_SERVICE];
+    /* the previous frame, to infer the usage and timing */
+    struct timeval old_tv;
+    uint8_t old_frame;
+    uint8_t old_src;
+    uint8_t old_dst;
+    uint8_t old_token_dst;
+};
+/* statistics of the live capture */
+static struct mstp_monitor MSTP_Monitor;
 
 static uint32_t timeval_diff_ms(struct timeval *old, struct timeval *now)
 {
@@ -148,7 +180,16 @@ static uint32_t timeval_diff_ms(struct timeval *old, struct timeval *now)
     return ms;
 }
 
-static void mstp_monitor_i_am(uint8_t mac, uint8_t *pdu, uint16_t pdu_len)
+/**
+ * @brief Count the APDU type and the service of the NPDU in a data frame,
+ *  and keep the Device ID of a node that sends an I-Am
+ * @param monitor - statistics of the capture
+ * @param mac - MS/TP address of the node that sent the frame
+ * @param pdu - NPDU from the data frame
+ * @param pdu_len - number of octets in the NPDU
+ */
+static void mstp_monitor_apdu(
+    struct mstp_monitor *monitor, uint8_t mac, uint8_t *pdu, uint16_t pdu_len)
 {
     BACNET_ADDRESS src = { 0 };
     BACNET_ADDRESS dest = { 0 };
@@ -158,42 +199,68 @@ static void mstp_monitor_i_am(uint8_t mac, uint8_t *pdu, uint16_t pdu_len)
     uint8_t *apdu = NULL;
     uint8_t pdu_type = 0;
     uint8_t service_choice = 0;
+    uint16_t service_offset = 0;
     uint8_t *service_request = NULL;
     uint32_t device_id = 0;
     int len = 0;
 
-    if (pdu[0] == BACNET_PROTOCOL_VERSION) {
-        MSTP_Fill_BACnet_Address(&src, mac);
-        apdu_offset = bacnet_npdu_decode(pdu, pdu_len, &dest, &src, &npdu_data);
-        if ((!npdu_data.network_layer_message) && (apdu_offset > 0) &&
-            (apdu_offset < pdu_len) && (src.net == 0)) {
-            apdu_len = pdu_len - apdu_offset;
-            apdu = &pdu[apdu_offset];
-            pdu_type = apdu[0] & 0xF0;
-            if ((pdu_type == PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST) &&
-                (apdu_len >= 2)) {
-                service_choice = apdu[1];
-                service_request = &apdu[2];
-                if (service_choice == SERVICE_UNCONFIRMED_I_AM) {
-                    len = iam_decode_service_request(
-                        service_request, &device_id, NULL, NULL, NULL);
-                    if (len != -1) {
-                        MSTP_Statistics[mac].device_id = device_id;
-                    }
-                }
+    if (pdu[0] != BACNET_PROTOCOL_VERSION) {
+        return;
+    }
+    MSTP_Fill_BACnet_Address(&src, mac);
+    apdu_offset = bacnet_npdu_decode(pdu, pdu_len, &dest, &src, &npdu_data);
+    if (npdu_data.network_layer_message) {
+        monitor->network_message_count++;
+        return;
+    }
+    if ((apdu_offset <= 0) || (apdu_offset >= pdu_len)) {
+        return;
+    }
+    apdu_len = pdu_len - apdu_offset;
+    apdu = &pdu[apdu_offset];
+    pdu_type = apdu[0] & 0xF0;
+    monitor->pdu_type_count[pdu_type >> 4]++;
+    if (pdu_type == PDU_TYPE_CONFIRMED_SERVICE_REQUEST) {
+        /* a segmented request adds the sequence number and window size */
+        if (apdu[0] & 0x08) {
+            service_offset = 5;
+        } else {
+            service_offset = 3;
+        }
+        if (service_offset < apdu_len) {
+            service_choice = apdu[service_offset];
+            if (service_choice < MAX_BACNET_CONFIRMED_SERVICE) {
+                monitor->confirmed_count[service_choice]++;
+            }
+        }
+    } else if ((pdu_type == PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST) &&
+        (apdu_len >= 2)) {
+        service_choice = apdu[1];
+        service_request = &apdu[2];
+        if (service_choice < MAX_BACNET_UNCONFIRMED_SERVICE) {
+            monitor->unconfirmed_count[service_choice]++;
+        }
+        if ((service_choice == SERVICE_UNCONFIRMED_I_AM) && (src.net == 0)) {
+            len = iam_decode_service_request(
+                service_request, &device_id, NULL, NULL, NULL);
+            if (len != -1) {
+                monitor->node[mac].device_id = device_id;
             }
         }
     }
 }
 
-static void packet_statistics(
-    struct timeval *tv, struct mstp_port_struct_t *mstp_port)
+static bool frame_type_der(uint8_t frame)
 {
-    static struct timeval old_tv = { 0 };
-    static uint8_t old_frame = 255;
-    static uint8_t old_src = 255;
-    static uint8_t old_dst = 255;
-    static uint8_t old_token_dst = 255;
+    return (frame == FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY) ||
+        (frame == FRAME_TYPE_BACNET_EXTENDED_DATA_EXPECTING_REPLY);
+}
+
+static void packet_statistics(struct mstp_monitor *monitor,
+    struct timeval *tv,
+    struct mstp_port_struct_t *mstp_port)
+{
+    struct mstp_node_statistics *node = monitor->node;
     uint8_t frame, src, dst;
     uint32_t delta;
     uint32_t npoll;
@@ -203,107 +270,116 @@ static void packet_statistics(
     frame = mstp_port->FrameType;
     switch (frame) {
         case FRAME_TYPE_TOKEN:
-            MSTP_Statistics[src].token_count++;
-            MSTP_Statistics[dst].token_received_count++;
+            node[src].token_count++;
+            node[dst].token_received_count++;
             if (src == dst) {
-                MSTP_Statistics[src].self_token_count++;
+                node[src].self_token_count++;
             }
-            if (old_frame == FRAME_TYPE_TOKEN) {
-                if ((old_dst == dst) && (old_src == src)) {
+            if (monitor->old_frame == FRAME_TYPE_TOKEN) {
+                if ((monitor->old_dst == dst) && (monitor->old_src == src)) {
                     /* repeated token */
-                    MSTP_Statistics[dst].token_retries++;
+                    node[dst].token_retries++;
                     /* Tusage_timeout */
-                    delta = timeval_diff_ms(&old_tv, tv);
-                    if (delta > MSTP_Statistics[src].tusage_timeout) {
-                        MSTP_Statistics[src].tusage_timeout = delta;
+                    delta = timeval_diff_ms(&monitor->old_tv, tv);
+                    if (delta > node[src].tusage_timeout) {
+                        node[src].tusage_timeout = delta;
                     }
-                } else if (old_dst == src) {
+                } else if (monitor->old_dst == src) {
                     /* token to token response time */
-                    delta = timeval_diff_ms(&old_tv, tv);
-                    if (delta > MSTP_Statistics[src].token_reply) {
-                        MSTP_Statistics[src].token_reply = delta;
+                    delta = timeval_diff_ms(&monitor->old_tv, tv);
+                    if (delta > node[src].token_reply) {
+                        node[src].token_reply = delta;
                     }
                 }
-            } else if ((old_frame == FRAME_TYPE_POLL_FOR_MASTER) &&
-                (old_src == src)) {
+            } else if ((monitor->old_frame == FRAME_TYPE_POLL_FOR_MASTER) &&
+                (monitor->old_src == src)) {
                 /* Tusage_timeout */
-                delta = timeval_diff_ms(&old_tv, tv);
-                if (delta > MSTP_Statistics[src].tusage_timeout) {
-                    MSTP_Statistics[src].tusage_timeout = delta;
+                delta = timeval_diff_ms(&monitor->old_tv, tv);
+                if (delta > node[src].tusage_timeout) {
+                    node[src].tusage_timeout = delta;
                 }
             }
-            if (old_token_dst != src) {
+            if (monitor->old_token_dst != src) {
                 /* out-of-order Token sender */
-                MSTP_Statistics[src].ooo_token_count++;
+                node[src].ooo_token_count++;
             }
-            old_token_dst = dst;
+            monitor->old_token_dst = dst;
             break;
         case FRAME_TYPE_POLL_FOR_MASTER:
-            if (MSTP_Statistics[src].last_pfm_tokens) {
-                npoll = MSTP_Statistics[src].token_received_count -
-                    MSTP_Statistics[src].last_pfm_tokens;
-                if (npoll > MSTP_Statistics[src].npoll) {
-                    MSTP_Statistics[src].npoll = npoll;
+            if (node[src].last_pfm_tokens) {
+                npoll =
+                    node[src].token_received_count - node[src].last_pfm_tokens;
+                if (npoll > node[src].npoll) {
+                    node[src].npoll = npoll;
                 }
             }
-            MSTP_Statistics[src].last_pfm_tokens =
-                MSTP_Statistics[src].token_received_count;
-            MSTP_Statistics[src].pfm_count++;
-            if (dst > MSTP_Statistics[src].max_master) {
-                MSTP_Statistics[src].max_master = dst;
+            node[src].last_pfm_tokens = node[src].token_received_count;
+            node[src].pfm_count++;
+            if (dst > node[src].max_master) {
+                node[src].max_master = dst;
             }
-            if ((old_frame == FRAME_TYPE_POLL_FOR_MASTER) && (old_src == src)) {
+            if ((monitor->old_frame == FRAME_TYPE_POLL_FOR_MASTER) &&
+                (monitor->old_src == src)) {
                 /* Tusage_timeout - sole master */
-                delta = timeval_diff_ms(&old_tv, tv);
-                if (delta > MSTP_Statistics[src].tusage_timeout) {
-                    MSTP_Statistics[src].tusage_timeout = delta;
+                delta = timeval_diff_ms(&monitor->old_tv, tv);
+                if (delta > node[src].tusage_timeout) {
+                    node[src].tusage_timeout = delta;
                 }
             }
             break;
         case FRAME_TYPE_REPLY_TO_POLL_FOR_MASTER:
-            MSTP_Statistics[src].rpfm_count++;
-            if (old_frame == FRAME_TYPE_POLL_FOR_MASTER) {
-                delta = timeval_diff_ms(&old_tv, tv);
-                if (delta > MSTP_Statistics[src].pfm_reply) {
-                    MSTP_Statistics[src].pfm_reply = delta;
+            node[src].rpfm_count++;
+            if (monitor->old_frame == FRAME_TYPE_POLL_FOR_MASTER) {
+                delta = timeval_diff_ms(&monitor->old_tv, tv);
+                if (delta > node[src].pfm_reply) {
+                    node[src].pfm_reply = delta;
                 }
             }
             break;
         case FRAME_TYPE_TEST_REQUEST:
-            MSTP_Statistics[src].test_request_count++;
+            node[src].test_request_count++;
             break;
         case FRAME_TYPE_TEST_RESPONSE:
-            MSTP_Statistics[src].test_response_count++;
+            node[src].test_response_count++;
             break;
         case FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY:
-            MSTP_Statistics[src].der_count++;
+        case FRAME_TYPE_BACNET_EXTENDED_DATA_EXPECTING_REPLY:
+            node[src].der_count++;
+            if (mstp_port->ReceivedValidFrame) {
+                if ((mstp_port->DataLength <= mstp_port->InputBufferSize) &&
+                    (mstp_port->DataLength > 0)) {
+                    mstp_monitor_apdu(monitor, src,
+                        &mstp_port->InputBuffer[0], mstp_port->DataLength);
+                }
+            }
             break;
         case FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY:
-            MSTP_Statistics[src].dner_count++;
-            if ((old_frame == FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY) &&
-                (old_dst == src)) {
+        case FRAME_TYPE_BACNET_EXTENDED_DATA_NOT_EXPECTING_REPLY:
+            node[src].dner_count++;
+            if (frame_type_der(monitor->old_frame) &&
+                (monitor->old_dst == src)) {
                 /* DER response time */
-                delta = timeval_diff_ms(&old_tv, tv);
-                if (delta > MSTP_Statistics[src].der_reply) {
-                    MSTP_Statistics[src].der_reply = delta;
+                delta = timeval_diff_ms(&monitor->old_tv, tv);
+                if (delta > node[src].der_reply) {
+                    node[src].der_reply = delta;
                 }
             }
             if (mstp_port->ReceivedValidFrame) {
                 if ((mstp_port->DataLength <= mstp_port->InputBufferSize) &&
                     (mstp_port->DataLength > 0)) {
-                    mstp_monitor_i_am(
-                        src, &mstp_port->InputBuffer[0], mstp_port->DataLength);
+                    mstp_monitor_apdu(monitor, src,
+                        &mstp_port->InputBuffer[0], mstp_port->DataLength);
                 }
             }
             break;
         case FRAME_TYPE_REPLY_POSTPONED:
-            MSTP_Statistics[src].reply_postponed_count++;
-            if ((old_frame == FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY) &&
-                (old_dst == src)) {
+            node[src].reply_postponed_count++;
+            if (frame_type_der(monitor->old_frame) &&
+                (monitor->old_dst == src)) {
                 /* Postponed response time */
-                delta = timeval_diff_ms(&old_tv, tv);
-                if (delta > MSTP_Statistics[src].reply_postponed) {
-                    MSTP_Statistics[src].reply_postponed = delta;
+                delta = timeval_diff_ms(&monitor->old_tv, tv);
+                if (delta > node[src].reply_postponed) {
+                    node[src].reply_postponed = delta;
                 }
             }
             break;
@@ -312,15 +388,58 @@ static void packet_statistics(
     }
 
     /* update the old variables */
-    old_dst = dst;
-    old_src = src;
-    old_frame = frame;
-    old_tv.tv_sec = tv->tv_sec;
-    old_tv.tv_usec = tv->tv_usec;
+    monitor->old_dst = dst;
+    monitor->old_src = src;
+    monitor->old_frame = frame;
+    monitor->old_tv.tv_sec = tv->tv_sec;
+    monitor->old_tv.tv_usec = tv->tv_usec;
 }
 
-static void packet_statistics_print(void)
+static void packet_services_print(struct mstp_monitor *monitor)
 {
+    static const char *pdu_type_names[8] = { "Confirmed-Request",
+        "Unconfirmed-Request", "Simple-ACK", "Complex-ACK", "Segment-ACK",
+        "Error", "Reject", "Abort" };
+    unsigned i; /* loop counter */
+
+    fprintf(stdout, "\n");
+    fprintf(stdout, "==== BACnet APDU Counts ====\n");
+    fprintf(stdout, "%-32s%-10s\n", "Type", "Count");
+    fprintf(stdout, "%-32s%-10lu\n", "Network-Message",
+        (long unsigned int)monitor->network_message_count);
+    for (i = 0; i < MSTP_PDU_TYPES; i++) {
+        if (monitor->pdu_type_count[i]) {
+            if (i < 8) {
+                fprintf(stdout, "%-32s", pdu_type_names[i]);
+            } else {
+                fprintf(stdout, "PDU-Type-%-23u", i);
+            }
+            fprintf(stdout, "%-10lu\n",
+                (long unsigned int)monitor->pdu_type_count[i]);
+        }
+    }
+    fprintf(stdout, "\n");
+    fprintf(stdout, "==== BACnet Service Request Counts ====\n");
+    fprintf(stdout, "%-32s%-10s\n", "Service", "Count");
+    for (i = 0; i < MAX_BACNET_CONFIRMED_SERVICE; i++) {
+        if (monitor->confirmed_count[i]) {
+            fprintf(stdout, "%-32s%-10lu\n",
+                bactext_confirmed_service_name(i),
+                (long unsigned int)monitor->confirmed_count[i]);
+        }
+    }
+    for (i = 0; i < MAX_BACNET_UNCONFIRMED_SERVICE; i++) {
+        if (monitor->unconfirmed_count[i]) {
+            fprintf(stdout, "%-32s%-10lu\n",
+                bactext_unconfirmed_service_name(i),
+                (long unsigned int)monitor->unconfirmed_count[i]);
+        }
+    }
+}
+
+static void packet_statistics_print(struct mstp_monitor *monitor)
+{
+    struct mstp_node_statistics *node = monitor->node;
     unsigned i; /* loop counter */
     unsigned node_count = 0;
     long unsigned int self_or_ooo_count;
@@ -332,26 +451,25 @@ static void packet_statistics_print(void)
     fprintf(stdout, "\n");
     for (i = 0; i < MAX_MSTP_DEVICES; i++) {
         /* check for masters or slaves */
-        if ((MSTP_Statistics[i].token_count) ||
-            (MSTP_Statistics[i].der_reply) || (MSTP_Statistics[i].pfm_count)) {
+        if ((node[i].token_count) || (node[i].der_reply) ||
+            (node[i].pfm_count)) {
             node_count++;
             fprintf(stdout, "%-8u", i);
-            if (MSTP_Statistics[i].device_id <= 4194303) {
-                fprintf(stdout, "%-8lu",
-                    (long unsigned int)MSTP_Statistics[i].device_id);
+            if (node[i].device_id <= 4194303) {
+                fprintf(stdout, "%-8lu", (long unsigned int)node[i].device_id);
             } else {
                 fprintf(stdout, "%-8s", "-");
             }
             fprintf(stdout, "%-8lu%-8lu%-8lu%-8lu",
-                (long unsigned int)MSTP_Statistics[i].token_count,
-                (long unsigned int)MSTP_Statistics[i].pfm_count,
-                (long unsigned int)MSTP_Statistics[i].rpfm_count,
-                (long unsigned int)MSTP_Statistics[i].der_count);
+                (long unsigned int)node[i].token_count,
+                (long unsigned int)node[i].pfm_count,
+                (long unsigned int)node[i].rpfm_count,
+                (long unsigned int)node[i].der_count);
             fprintf(stdout, "%-8lu%-8lu%-8lu%-7lu",
-                (long unsigned int)MSTP_Statistics[i].reply_postponed_count,
-                (long unsigned int)MSTP_Statistics[i].dner_count,
-                (long unsigned int)MSTP_Statistics[i].test_request_count,
-                (long unsigned int)MSTP_Statistics[i].test_response_count);
+                (long unsigned int)node[i].reply_postponed_count,
+                (long unsigned int)node[i].dner_count,
+                (long unsigned int)node[i].test_request_count,
+                (long unsigned int)node[i].test_response_count);
             fprintf(stdout, "\n");
         }
     }
@@ -365,40 +483,44 @@ static void packet_statistics_print(void)
     fprintf(stdout, "\n");
     for (i = 0; i < MAX_MSTP_DEVICES; i++) {
         /* check for masters or slaves */
-        if ((MSTP_Statistics[i].token_count) ||
-            (MSTP_Statistics[i].der_reply) || (MSTP_Statistics[i].pfm_count)) {
+        if ((node[i].token_count) || (node[i].der_reply) ||
+            (node[i].pfm_count)) {
             node_count++;
-            self_or_ooo_count = MSTP_Statistics[i].self_token_count +
-                MSTP_Statistics[i].ooo_token_count;
+            self_or_ooo_count =
+                node[i].self_token_count + node[i].ooo_token_count;
             fprintf(stdout, "%-8u", i);
             fprintf(stdout, "%-8lu%-8lu%-8lu%-8lu%-8lu",
-                (long unsigned int)MSTP_Statistics[i].max_master,
-                (long unsigned int)MSTP_Statistics[i].token_retries,
-                (long unsigned int)MSTP_Statistics[i].npoll, self_or_ooo_count,
-                (long unsigned int)MSTP_Statistics[i].token_reply);
+                (long unsigned int)node[i].max_master,
+                (long unsigned int)node[i].token_retries,
+                (long unsigned int)node[i].npoll, self_or_ooo_count,
+                (long unsigned int)node[i].token_reply);
             fprintf(stdout, "%-8lu%-8lu%-8lu%-7lu",
-                (long unsigned int)MSTP_Statistics[i].tusage_timeout,
-                (long unsigned int)MSTP_Statistics[i].pfm_reply,
-                (long unsigned int)MSTP_Statistics[i].der_reply,
-                (long unsigned int)MSTP_Statistics[i].reply_postponed);
+                (long unsigned int)node[i].tusage_timeout,
+                (long unsigned int)node[i].pfm_reply,
+                (long unsigned int)node[i].der_reply,
+                (long unsigned int)node[i].reply_postponed);
             fprintf(stdout, "\n");
         }
     }
     fprintf(stdout, "Node Count: %u\n", node_count);
     fprintf(stdout, "Invalid Frame Count: %lu\n",
-        (long unsigned int)Invalid_Frame_Count);
+        (long unsigned int)monitor->invalid_frame_count);
+    packet_services_print(monitor);
     fflush(stdout);
 }
 
-static void packet_statistics_clear(void)
+static void packet_statistics_clear(struct mstp_monitor *monitor)
 {
     unsigned i = 0;
 
-    memset(&MSTP_Statistics[0], 0, sizeof(MSTP_Statistics));
+    memset(monitor, 0, sizeof(*monitor));
     for (i = 0; i < MAX_MSTP_DEVICES; i++) {
-        MSTP_Statistics[i].device_id = 0xFFFFFFFF;
+        monitor->node[i].device_id = 0xFFFFFFFF;
     }
-    Invalid_Frame_Count = 0;
+    monitor->old_frame = 255;
+    monitor->old_src = 255;
+    monitor->old_dst = 255;
+    monitor->old_token_dst = 255;
 }
 
 static uint32_t Timer_Silence(void *pArg)
@@ -639,7 +761,7 @@ static void write_received_packet(
     ts_sec = tv.tv_sec;
     ts_usec = tv.tv_usec;
     if (mstp_port->ReceivedValidFrame) {
-        packet_statistics(&tv, mstp_port);
+        packet_statistics(&MSTP_Monitor, &tv, mstp_port);
     }
     (void)data_write(&ts_sec, sizeof(ts_sec), 1);
     (void)data_write(&ts_usec, sizeof(ts_usec), 1);
@@ -692,200 +814,10 @@ static void write_received_packet(
     }
 }
 
-/* read header from file in libpcap format */
-static bool test_global_header(const char *filename)
-{
-    uint32_t magic_number = 0; /* magic number */
-    uint16_t version_major = 0; /* major version number */
-    uint16_t version_minor = 0; /* minor version number */
-    int32_t thiszone = 0; /* GMT to local correction */
-    uint32_t sigfigs = 0; /* accuracy of timestamps */
-    uint32_t snaplen = 0; /* max length of captured packets, in octets */
-    uint32_t network = 0; /* data link type - BACNET_MS_TP */
-    size_t count = 0;
-
-    /* open existing file. */
-    File_Handle = fopen(filename, "rb");
-    if (File_Handle) {
-        count = fread(&magic_number, sizeof(magic_number), 1, File_Handle);
-        if ((count != 1) || (magic_number != 0xa1b2c3d4)) {
-            fprintf(stderr, "mstpcap: invalid magic number\n");
-            fclose(File_Handle);
-            File_Handle = NULL;
-            return false;
-        }
-        count = fread(&version_major, sizeof(version_major), 1, File_Handle);
-        if ((count != 1) || (version_major != 2)) {
-            fprintf(stderr, "mstpcap: invalid major version\n");
-            fclose(File_Handle);
-            File_Handle = NULL;
-            return false;
-        }
-        count = fread(&version_minor, sizeof(version_minor), 1, File_Handle);
-        if ((count != 1) || (version_minor != 4)) {
-            fprintf(stderr, "mstpcap: invalid minor version\n");
-            fclose(File_Handle);
-            File_Handle = NULL;
-            return false;
-        }
-        count = fread(&thiszone, sizeof(thiszone), 1, File_Handle);
-        if ((count != 1) || (thiszone != 0)) {
-            fprintf(stderr, "mstpcap: invalid time zone\n");
-            fclose(File_Handle);
-            File_Handle = NULL;
-            return false;
-        }
-        count = fread(&sigfigs, sizeof(sigfigs), 1, File_Handle);
-        if ((count != 1) || (sigfigs != 0)) {
-            fprintf(stderr, "mstpcap: invalid time stamp accuracy\n");
-            fclose(File_Handle);
-            File_Handle = NULL;
-            return false;
-        }
-        count = fread(&snaplen, sizeof(snaplen), 1, File_Handle);
-        if (count != 1) {
-            fprintf(stderr, "mstpcap: unable to read SNAP length\n");
-            fclose(File_Handle);
-            File_Handle = NULL;
-            return false;
-        }
-        count = fread(&network, sizeof(network), 1, File_Handle);
-        if ((count != 1) || (network != DLT_BACNET_MS_TP)) {
-            fprintf(stderr, "mstpcap: invalid data link type (DLT)\n");
-            fclose(File_Handle);
-            File_Handle = NULL;
-            return false;
-        }
-    } else {
-        fprintf(stderr, "mstpcap[scan]: failed to open %s: %s\n", filename,
-            strerror(errno));
-        return false;
-    }
-
-    return true;
-}
-
-static bool read_received_packet(struct mstp_port_struct_t *mstp_port)
-{
-    uint32_t ts_sec = 0; /* timestamp seconds */
-    uint32_t ts_usec = 0; /* timestamp microseconds */
-    uint32_t incl_len = 0; /* number of octets of packet saved in file */
-    uint32_t orig_len = 0; /* actual length of packet */
-    uint8_t header[8] = { 0 }; /* MS/TP header */
-    struct timeval tv;
-    size_t count = 0;
-    unsigned i = 0;
-
-    if (File_Handle) {
-        count = fread(&ts_sec, sizeof(ts_sec), 1, File_Handle);
-        if (count != 1) {
-            fclose(File_Handle);
-            File_Handle = NULL;
-            return false;
-        }
-        count = fread(&ts_usec, sizeof(ts_usec), 1, File_Handle);
-        if (count != 1) {
-            fclose(File_Handle);
-            File_Handle = NULL;
-            return false;
-        }
-        tv.tv_sec = ts_sec;
-        tv.tv_usec = ts_usec;
-        count = fread(&incl_len, sizeof(incl_len), 1, File_Handle);
-        if (count != 1) {
-            fclose(File_Handle);
-            File_Handle = NULL;
-            return false;
-        }
-        count = fread(&orig_len, sizeof(orig_len), 1, File_Handle);
-        if (count != 1) {
-            fclose(File_Handle);
-            File_Handle = NULL;
-            return false;
-        }
-        count = fread(&header, sizeof(header), 1, File_Handle);
-        if (count != 1) {
-            fclose(File_Handle);
-            File_Handle = NULL;
-            return false;
-        }
-        mstp_port->FrameType = header[2];
-        mstp_port->DestinationAddress = header[3];
-        mstp_port->SourceAddress = header[4];
-        mstp_port->DataLength = MAKE_WORD(header[6], header[5]);
-        mstp_port->HeaderCRCActual = header[7];
-        mstp_port->HeaderCRC = 0xFF;
-        for (i = 2; i < 8; i++) {
-            mstp_port->HeaderCRC =
-                CRC_Calc_Header(header[i], mstp_port->HeaderCRC);
-        }
-        if (mstp_port->HeaderCRC == 0x55) {
-            mstp_port->ReceivedValidFrame = true;
-            mstp_port->ReceivedInvalidFrame = false;
-            if (mstp_port->DataLength == 0) {
-                mstp_port->ReceivedValidFrame = true;
-            }
-        } else {
-            mstp_port->ReceivedValidFrame = false;
-            mstp_port->ReceivedInvalidFrame = true;
-        }
-        if (orig_len > 8) {
-            /* packet includes data */
-            mstp_port->DataLength = orig_len - 8 - 2;
-            count =
-                fread(mstp_port->InputBuffer, mstp_port->DataLength, 1, File_Handle);
-            if (count != 1) {
-                fclose(File_Handle);
-                File_Handle = NULL;
-                return false;
-            }
-            count = fread((char *)&mstp_port->DataCRCActualMSB, 1, 1, File_Handle);
-            if (count != 1) {
-                fclose(File_Handle);
-                File_Handle = NULL;
-                return false;
-            }
-            count = fread((char *)&mstp_port->DataCRCActualLSB, 1, 1, File_Handle);
-            if (count != 1) {
-                fclose(File_Handle);
-                File_Handle = NULL;
-                return false;
-            }
-            mstp_port->DataCRC = 0xFFFF;
-            for (i = 0; i < mstp_port->DataLength; i++) {
-                mstp_port->DataCRC = CRC_Calc_Data(
-                    mstp_port->InputBuffer[i], mstp_port->DataCRC);
-            }
-            mstp_port->DataCRC =
-                CRC_Calc_Data(mstp_port->DataCRCActualMSB, mstp_port->DataCRC);
-            mstp_port->DataCRC =
-                CRC_Calc_Data(mstp_port->DataCRCActualLSB, mstp_port->DataCRC);
-            if (mstp_port->DataCRC == 0xF0B8) {
-                mstp_port->ReceivedInvalidFrame = false;
-                mstp_port->ReceivedValidFrame = true;
-            } else {
-                mstp_port->ReceivedInvalidFrame = true;
-                mstp_port->ReceivedValidFrame = false;
-            }
-        } else {
-            mstp_port->DataLength = 0;
-        }
-        if (mstp_port->ReceivedInvalidFrame) {
-            Invalid_Frame_Count++;
-        } else if (mstp_port->ReceivedValidFrame) {
-            packet_statistics(&tv, mstp_port);
-        }
-    } else {
-        return false;
-    }
-
-    return true;
-}
-
 static void cleanup(void)
 {
     if (!Wireshark_Capture) {
-        packet_statistics_print();
+        packet_statistics_print(&MSTP_Monitor);
     }
     if (File_Handle) {
         fflush(File_Handle); /* stream pointer */
@@ -936,7 +868,7 @@ static void signal_init(void)
 static void print_usage(char *filename)
 {
     printf("Usage: %s", filename);
-    printf(" [--scan <filename>]\n");
+    printf(" [--scan <filename> [<filename> ...]][--threads count]\n");
     printf(" [--extcap-interface port]\n");
     printf(" [--extcap-interfaces][--extcap-dlts][--extcap-config]\n");
     printf(" [--capture][--baud baud][--fifo pipe]\n");
@@ -945,8 +877,10 @@ static void print_usage(char *filename)
 
 static void print_help(char *filename)
 {
-    printf("%s --scan <filename>\n"
-           "perform statistic analysis on MS/TP capture file.\n",
+    printf("%s --scan <filename> [<filename> ...] [--threads count]\n"
+           "perform statistic analysis on MS/TP capture files.\n"
+           "The files are scanned at once by a number of threads,\n"
+           "which defaults to the number of processors.\n",
         filename);
     printf("\n");
     printf("Captures MS/TP packets from a serial interface\n"
@@ -996,6 +930,331 @@ static void mstp_structure_init(struct mstp_port_struct_t *mstp_port)
     }
 }
 
+/* a capture file scanned by the offline analysis */
+struct mstp_scan {
+    const char *filename;
+    uint32_t packet_count;
+    bool valid;
+    struct mstp_monitor monitor;
+};
+
+#if !defined(_WIN32)
+/* the capture files shared by the scan threads */
+struct mstp_scan_pool {
+    struct mstp_scan *scans;
+    unsigned scan_count;
+    unsigned next;
+    pthread_mutex_t lock;
+};
+#endif
+
+/* time is taken from the capture, so the frames never time out */
+static uint32_t Timer_Scan_Silence(void *pArg)
+{
+    (void)pArg;
+    return 0;
+}
+
+static void Timer_Scan_Silence_Reset(void *pArg)
+{
+    (void)pArg;
+}
+
+static uint32_t pcap_uint32(const uint8_t *buffer, bool swapped)
+{
+    uint32_t value = 0;
+
+    memcpy(&value, buffer, sizeof(value));
+    if (swapped) {
+        value = ((value & 0x000000FFUL) << 24) |
+            ((value & 0x0000FF00UL) << 8) | ((value & 0x00FF0000UL) >> 8) |
+            ((value & 0xFF000000UL) >> 24);
+    }
+
+    return value;
+}
+
+static uint16_t pcap_uint16(const uint8_t *buffer, bool swapped)
+{
+    uint16_t value = 0;
+
+    memcpy(&value, buffer, sizeof(value));
+    if (swapped) {
+        value = (uint16_t)((value << 8) | (value >> 8));
+    }
+
+    return value;
+}
+
+/**
+ * @brief Check the libpcap global header of a capture in memory, which
+ *  may have been written with either byte order
+ * @param data - capture file contents
+ * @param size - number of octets in the capture
+ * @param swapped - set true if the byte order is not ours
+ * @return true if the capture holds BACnet MS/TP frames
+ */
+static bool test_global_header(const uint8_t *data, size_t size, bool *swapped)
+{
+    uint32_t magic_number = 0; /* magic number */
+
+    if (size < PCAP_GLOBAL_HEADER_LEN) {
+        fprintf(stderr, "mstpcap: invalid magic number\n");
+        return false;
+    }
+    memcpy(&magic_number, data, sizeof(magic_number));
+    if (magic_number == 0xa1b2c3d4) {
+        *swapped = false;
+    } else if (magic_number == 0xd4c3b2a1) {
+        *swapped = true;
+    } else {
+        fprintf(stderr, "mstpcap: invalid magic number\n");
+        return false;
+    }
+    if (pcap_uint16(&data[4], *swapped) != 2) {
+        fprintf(stderr, "mstpcap: invalid major version\n");
+        return false;
+    }
+    if (pcap_uint16(&data[6], *swapped) != 4) {
+        fprintf(stderr, "mstpcap: invalid minor version\n");
+        return false;
+    }
+    if (pcap_uint32(&data[8], *swapped) != 0) {
+        fprintf(stderr, "mstpcap: invalid time zone\n");
+        return false;
+    }
+    if (pcap_uint32(&data[12], *swapped) != 0) {
+        fprintf(stderr, "mstpcap: invalid time stamp accuracy\n");
+        return false;
+    }
+    if (pcap_uint32(&data[20], *swapped) != DLT_BACNET_MS_TP) {
+        fprintf(stderr, "mstpcap: invalid data link type (DLT)\n");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Decode each packet of a capture in memory with the MS/TP receive
+ *  state machine, and gather the statistics of the frames
+ * @param scan - capture being scanned
+ * @param data - capture file contents
+ * @param size - number of octets in the capture
+ */
+static void mstp_scan_data(
+    struct mstp_scan *scan, const uint8_t *data, size_t size)
+{
+    struct mstp_port_struct_t mstp_port = { 0 };
+    /* room for an extended frame to be decoded after its encoding */
+    uint8_t buffer[2 * DLMSTP_MPDU_MAX];
+    struct timeval tv = { 0 };
+    const uint8_t *record = NULL;
+    uint32_t incl_len = 0; /* number of octets of packet saved in file */
+    bool swapped = false;
+    size_t offset = 0;
+
+    scan->valid = test_global_header(data, size, &swapped);
+    if (!scan->valid) {
+        return;
+    }
+    mstp_port.InputBuffer = buffer;
+    mstp_port.InputBufferSize = sizeof(buffer);
+    mstp_port.This_Station = 127;
+    mstp_port.Nmax_info_frames = 1;
+    mstp_port.Nmax_master = 127;
+    mstp_port.SilenceTimer = Timer_Scan_Silence;
+    mstp_port.SilenceTimerReset = Timer_Scan_Silence_Reset;
+    MSTP_Init(&mstp_port);
+    offset = PCAP_GLOBAL_HEADER_LEN;
+    while ((size - offset) >= PCAP_RECORD_HEADER_LEN) {
+        record = &data[offset];
+        tv.tv_sec = pcap_uint32(&record[0], swapped);
+        tv.tv_usec = pcap_uint32(&record[4], swapped);
+        incl_len = pcap_uint32(&record[8], swapped);
+        offset += PCAP_RECORD_HEADER_LEN;
+        if (incl_len > (size - offset)) {
+            /* the capture was cut short */
+            break;
+        }
+        /* each packet holds one frame, or the octets of a broken one */
+        mstp_structure_init(&mstp_port);
+        mstp_port.DataAvailable = false;
+        mstp_port.ReceiveError = false;
+        (void)MSTP_Receive_Frame_Data(&mstp_port, &data[offset],
+            (uint16_t)min(incl_len, UINT16_MAX));
+        if (mstp_port.ReceivedValidFrame) {
+            packet_statistics(&scan->monitor, &tv, &mstp_port);
+        } else {
+            scan->monitor.invalid_frame_count++;
+        }
+        offset += incl_len;
+        scan->packet_count++;
+    }
+}
+
+#if defined(_WIN32)
+static void mstp_scan_file(struct mstp_scan *scan)
+{
+    FILE *pFile = NULL;
+    uint8_t *data = NULL;
+    long size = 0;
+
+    pFile = fopen(scan->filename, "rb");
+    if (!pFile) {
+        fprintf(stderr, "mstpcap[scan]: failed to open %s: %s\n",
+            scan->filename, strerror(errno));
+        return;
+    }
+    if ((fseek(pFile, 0, SEEK_END) == 0) && ((size = ftell(pFile)) > 0) &&
+        (fseek(pFile, 0, SEEK_SET) == 0)) {
+        data = malloc((size_t)size);
+    }
+    if (data && (fread(data, (size_t)size, 1, pFile) == 1)) {
+        mstp_scan_data(scan, data, (size_t)size);
+    } else {
+        fprintf(stderr, "mstpcap[scan]: failed to read %s\n", scan->filename);
+    }
+    free(data);
+    fclose(pFile);
+}
+#else
+/**
+ * @brief Map a capture file into memory and scan it
+ * @param scan - capture being scanned
+ */
+static void mstp_scan_file(struct mstp_scan *scan)
+{
+    struct stat file_stat;
+    void *data = NULL;
+    int fd = -1;
+
+    fd = open(scan->filename, O_RDONLY);
+    if (fd == -1) {
+        fprintf(stderr, "mstpcap[scan]: failed to open %s: %s\n",
+            scan->filename, strerror(errno));
+        return;
+    }
+    if ((fstat(fd, &file_stat) == 0) && (file_stat.st_size > 0)) {
+        data = mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE,
+            fd, 0);
+    }
+    if (data && (data != MAP_FAILED)) {
+        /* the capture is read once, front to back */
+        (void)madvise(data, (size_t)file_stat.st_size, MADV_SEQUENTIAL);
+        mstp_scan_data(scan, data, (size_t)file_stat.st_size);
+        (void)munmap(data, (size_t)file_stat.st_size);
+    } else {
+        fprintf(stderr, "mstpcap[scan]: failed to map %s: %s\n",
+            scan->filename, strerror(errno));
+    }
+    close(fd);
+}
+
+/**
+ * @brief Scan the capture files of the pool, one after another, until
+ *  none are left
+ * @param arg - pool of capture files
+ * @return NULL
+ */
+static void *mstp_scan_task(void *arg)
+{
+    struct mstp_scan_pool *pool = (struct mstp_scan_pool *)arg;
+    unsigned index;
+
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        index = pool->next;
+        if (index < pool->scan_count) {
+            pool->next++;
+        }
+        pthread_mutex_unlock(&pool->lock);
+        if (index >= pool->scan_count) {
+            break;
+        }
+        mstp_scan_file(&pool->scans[index]);
+    }
+
+    return NULL;
+}
+#endif
+
+/**
+ * @brief Scan capture files for statistics, with several files scanned
+ *  at once by a pool of threads, and print the statistics of each file
+ *  in the order given
+ * @param filenames - names of the capture files
+ * @param count - number of capture files
+ * @param threads - most files scanned at once, or 0 for one per CPU
+ * @return true if every file was a BACnet MS/TP capture
+ */
+static bool mstp_scan_files(
+    char *filenames[], unsigned count, unsigned threads)
+{
+    struct mstp_scan *scans = NULL;
+    bool status = true;
+    unsigned i;
+#if !defined(_WIN32)
+    struct mstp_scan_pool pool;
+    pthread_t thread_id[MSTP_SCAN_THREADS_MAX];
+    unsigned thread_count = 0;
+    long cpus;
+#endif
+
+    scans = calloc(count, sizeof(struct mstp_scan));
+    if (!scans) {
+        fprintf(stderr, "mstpcap[scan]: out of memory\n");
+        return false;
+    }
+    for (i = 0; i < count; i++) {
+        scans[i].filename = filenames[i];
+        packet_statistics_clear(&scans[i].monitor);
+    }
+#if defined(_WIN32)
+    (void)threads;
+    for (i = 0; i < count; i++) {
+        mstp_scan_file(&scans[i]);
+    }
+#else
+    if (threads == 0) {
+        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cpus > 0) ? (unsigned)cpus : 1;
+    }
+    threads = min(threads, min(count, MSTP_SCAN_THREADS_MAX));
+    pool.scans = scans;
+    pool.scan_count = count;
+    pool.next = 0;
+    pthread_mutex_init(&pool.lock, NULL);
+    /* this thread scans files too, as one of the threads */
+    for (i = 1; i < threads; i++) {
+        if (pthread_create(&thread_id[thread_count], NULL, mstp_scan_task,
+                &pool) == 0) {
+            thread_count++;
+        }
+    }
+    (void)mstp_scan_task(&pool);
+    for (i = 0; i < thread_count; i++) {
+        pthread_join(thread_id[i], NULL);
+    }
+    pthread_mutex_destroy(&pool.lock);
+#endif
+    for (i = 0; i < count; i++) {
+        printf("Scanning %s\n", scans[i].filename);
+        if (scans[i].valid) {
+            printf("%u packets\n", (unsigned)scans[i].packet_count);
+            if (scans[i].packet_count) {
+                packet_statistics_print(&scans[i].monitor);
+            }
+        } else {
+            fprintf(stderr, "File header does not match.\n");
+            status = false;
+        }
+    }
+    free(scans);
+
+    return status;
+}
+
 /* simple test to packetize the data and print it */
 int main(int argc, char *argv[])
 {
@@ -1005,6 +1264,9 @@ int main(int argc, char *argv[])
     uint32_t header_len = 0;
     int argi = 0;
     char *filename = NULL;
+    char **scan_filenames = NULL;
+    unsigned scan_count = 0;
+    unsigned scan_threads = 0;
 
     MSTP_Port.InputBuffer = &RxBuffer[0];
     MSTP_Port.InputBufferSize = sizeof(RxBuffer);
@@ -1018,7 +1280,7 @@ int main(int argc, char *argv[])
     /* mimic our pointer in the state machine */
     mstp_port = &MSTP_Port;
     MSTP_Init(mstp_port);
-    packet_statistics_clear();
+    packet_statistics_clear(&MSTP_Monitor);
     /* decode any command line parameters */
     filename = filename_remove_path(argv[0]);
     for (argi = 1; argi < argc; argi++) {
@@ -1037,26 +1299,27 @@ int main(int argc, char *argv[])
             return 0;
         }
         if (strcmp(argv[argi], "--scan") == 0) {
-            argi++;
-            if (argi >= argc) {
+            /* the file names up to the next option */
+            scan_filenames = &argv[argi + 1];
+            while (((argi + 1) < argc) &&
+                (strncmp(argv[argi + 1], "--", 2) != 0)) {
+                argi++;
+                scan_count++;
+            }
+            if (scan_count == 0) {
                 printf("An file name must be provided.\n");
                 return 1;
             }
-            printf("Scanning %s\n", argv[argi]);
-            /* perform statistics on the file */
-            if (test_global_header(argv[argi])) {
-                while (read_received_packet(mstp_port)) {
-                    packet_count++;
-                    fprintf(stderr, "\r%u packets", (unsigned)packet_count);
-                }
-                if (packet_count) {
-                    packet_statistics_print();
-                }
-                Exit_Requested = true;
-            } else {
-                fprintf(stderr, "File header does not match.\n");
+            continue;
+        }
+        if (strcmp(argv[argi], "--threads") == 0) {
+            argi++;
+            if (argi >= argc) {
+                printf("A number of threads must be provided.\n");
                 return 1;
             }
+            scan_threads = (unsigned)strtoul(argv[argi], NULL, 0);
+            continue;
         }
         if (strcmp(argv[argi], "--extcap-interfaces") == 0) {
             RS485_Print_Ports();
@@ -1141,6 +1404,13 @@ int main(int argc, char *argv[])
             named_pipe_create(argv[argi]);
         }
     }
+    if (scan_count) {
+        /* perform statistics on the files */
+        if (!mstp_scan_files(scan_filenames, scan_count, scan_threads)) {
+            return 1;
+        }
+        return 0;
+    }
     if (Exit_Requested) {
         return 0;
     }
@@ -1178,7 +1448,7 @@ int main(int argc, char *argv[])
             }
             write_received_packet(mstp_port, MSTP_HEADER_MAX);
             mstp_structure_init(mstp_port);
-            Invalid_Frame_Count++;
+            MSTP_Monitor.invalid_frame_count++;
             packet_count++;
         } else if (mstp_port->receive_state == MSTP_RECEIVE_STATE_IDLE) {
             if (MSTP_Receive_State == MSTP_RECEIVE_STATE_IDLE) {
@@ -1189,7 +1459,7 @@ int main(int argc, char *argv[])
                 } else if (mstp_port->EventCount > 1) {
                     write_received_packet(mstp_port, 1);
                     mstp_structure_init(mstp_port);
-                    Invalid_Frame_Count++;
+                    MSTP_Monitor.invalid_frame_count++;
                 }
             } else {
                 /* invalid byte or timeout */
@@ -1204,18 +1474,19 @@ int main(int argc, char *argv[])
                 }
                 write_received_packet(mstp_port, header_len);
                 mstp_structure_init(mstp_port);
-                Invalid_Frame_Count++;
+                MSTP_Monitor.invalid_frame_count++;
             }
         }
         if (!Wireshark_Capture) {
             if (!(packet_count % 100)) {
                 fprintf(stdout, "\r%u packets, %u invalid frames",
-                    (unsigned)packet_count, (unsigned)Invalid_Frame_Count);
+                    (unsigned)packet_count,
+                    (unsigned)MSTP_Monitor.invalid_frame_count);
                 fflush(stdout);
             }
             if (packet_count >= 65535) {
-                packet_statistics_print();
-                packet_statistics_clear();
+                packet_statistics_print(&MSTP_Monitor);
+                packet_statistics_clear(&MSTP_Monitor);
                 filename_create_new();
                 write_global_header();
                 packet_count = 0;
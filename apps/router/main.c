@@ -52,6 +52,12 @@
 #include "network_layer.h"
 #include "ipmodule.h"
 #include "mstpmodule.h"
+#include "dlmstp_linux.h"
+
+/* MS/TP ports driven by each thread of the MS/TP port manager */
+#ifndef ROUTER_MSTP_PORTS_PER_THREAD
+#define ROUTER_MSTP_PORTS_PER_THREAD 4
+#endif
 
 #define KEY_ESC 27
 
@@ -351,6 +357,13 @@ bool read_config(char *filepath)
                 } else {
                     current->params.mstp_params.max_frames = 1;
                 }
+                result = config_setting_lookup_bool(
+                    port, "adaptive", (int *)&param);
+                if (result) {
+                    current->params.mstp_params.adaptive = (param != 0);
+                } else {
+                    current->params.mstp_params.adaptive = false;
+                }
                 result = config_setting_lookup_int(port, "baud", (int *)&param);
                 if (result) {
                     current->params.mstp_params.baudrate = param;
@@ -548,6 +561,7 @@ bool parse_cmd(int argc, char *argv[])
                     current->route_info.mac_len = 1;
                     current->params.mstp_params.max_master = 127;
                     current->params.mstp_params.max_frames = 1;
+                    current->params.mstp_params.adaptive = false;
                     current->params.mstp_params.baudrate = 9600;
                     current->params.mstp_params.parity = PARITY_NONE;
                     current->params.mstp_params.databits = 8;
@@ -645,7 +659,20 @@ void init_port_threads(ROUTER_PORT *port_list)
 {
     ROUTER_PORT *port = port_list;
     pthread_t *thread;
+    unsigned mstp_ports = 0;
 
+    while (port != NULL) {
+        if (port->type == MSTP) {
+            mstp_ports++;
+        }
+        port = port->next;
+    }
+    if (mstp_ports > 1) {
+        /* drive the MS/TP ports from a few threads instead of one each */
+        dlmstp_manager_init((mstp_ports + ROUTER_MSTP_PORTS_PER_THREAD - 1) /
+            ROUTER_MSTP_PORTS_PER_THREAD);
+    }
+    port = port_list;
     while (port != NULL) {
         switch (port->type) {
             case BIP:
@@ -739,6 +766,8 @@ void cleanup()
             head = port;
         }
     }
+    /* the MS/TP ports are cleaned up, so stop their threads */
+    dlmstp_manager_cleanup();
 
     pthread_mutex_destroy(&msg_lock);
 }
@@ -761,7 +790,7 @@ void print_msg(BACMSG *msg)
 
 uint16_t process_msg(BACMSG *msg, MSG_DATA *data, uint8_t **buff)
 {
-    BACNET_ADDRESS addr;
+    BACNET_NPDU_VIEW view;
     BACNET_NPDU_DATA npdu_data;
     ROUTER_PORT *srcport;
     ROUTER_PORT *destport;
@@ -773,23 +802,32 @@ uint16_t process_msg(BACMSG *msg, MSG_DATA *data, uint8_t **buff)
 
     memmove(data, msg->data, sizeof(MSG_DATA));
 
-    apdu_offset = bacnet_npdu_decode(data->pdu, data->pdu_len, &data->dest,
-        &addr, &npdu_data);
+    /* decide from the NPCI view, and only copy the addresses to forward */
+    apdu_offset = bacnet_npdu_view_decode(data->pdu, data->pdu_len, &view);
+    if (apdu_offset <= 0) {
+        /* delete received message, the caller discards the copy */
+        free_data((MSG_DATA *)msg->data);
+        data->pdu = NULL;
+        data->pdu_len = 0;
+        return 0;
+    }
     apdu_len = data->pdu_len - apdu_offset;
 
     srcport = find_snet(msg->origin);
-    destport = find_dnet(data->dest.net, NULL);
+    destport = find_dnet(view.dnet, NULL);
     assert(srcport);
+    npdu_view_destination(data->pdu, &view, &data->dest);
 
     if (srcport && destport) {
         data->src.net = srcport->route_info.net;
 
         /* if received from another router save real source address (not other
          * router source address) */
-        if (addr.net > 0 && addr.net < BACNET_BROADCAST_NETWORK &&
-            data->src.net != addr.net) {
-            memmove(&data->src, &addr, sizeof(BACNET_ADDRESS));
+        if (view.snet > 0 && view.snet < BACNET_BROADCAST_NETWORK &&
+            data->src.net != view.snet) {
+            npdu_view_source(data->pdu, &view, &data->src);
         }
+        npdu_view_npdu_data(data->pdu, &view, &npdu_data);
 
         /* encode both source and destination for broadcast and router-to-router
          * communication */
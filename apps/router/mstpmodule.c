@@ -47,6 +47,8 @@ void *dl_mstp_thread(void *pArgs)
     ROUTER_PORT *port = (ROUTER_PORT *)pArgs;
     struct mstp_port_struct_t mstp_port = { (MSTP_RECEIVE_STATE)0 };
     volatile SHARED_MSTP_DATA shared_port_data = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t pdu[DLMSTP_MPDU_MAX];
     uint16_t pdu_len;
     uint8_t shutdown = 0;
 
@@ -95,6 +97,9 @@ void *dl_mstp_thread(void *pArgs)
     }
     mstp_port.Treply_timeout = 260;
     mstp_port.Tusage_timeout = 30;
+    if (port->params.mstp_params.adaptive) {
+        MSTP_Adaptive_Enable(&mstp_port, true);
+    }
 
     port->port_id = create_msgbox();
     if (port->port_id == INVALID_MSGBOX_ID) {
@@ -143,19 +148,15 @@ void *dl_mstp_thread(void *pArgs)
                     break;
             }
         } else {
-            pdu_len = dlmstp_receive(&mstp_port, NULL, NULL, 0, 5);
+            pdu_len = dlmstp_receive(&mstp_port, &src, pdu, sizeof(pdu), 5);
 
             if (pdu_len > 0) {
                 msg_data = (MSG_DATA *)malloc(sizeof(MSG_DATA));
-                memmove(&(msg_data->src),
-                    (const void *)&(shared_port_data.Receive_Packet.address),
-                    sizeof(shared_port_data.Receive_Packet.address));
+                memmove(&(msg_data->src), &src, sizeof(src));
                 msg_data->src.adr[0] = msg_data->src.mac[0];
                 msg_data->src.len = 1;
                 msg_data->pdu = (uint8_t *)malloc(pdu_len);
-                memmove(msg_data->pdu,
-                    (const void *)&(shared_port_data.Receive_Packet.pdu),
-                    pdu_len);
+                memmove(msg_data->pdu, pdu, pdu_len);
                 msg_data->pdu_len = pdu_len;
 
                 msg_storage.type = DATA;
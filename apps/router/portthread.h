@@ -85,6 +85,8 @@ typedef union _port_params {
         uint8_t stopbits;
         uint8_t max_master;
         uint8_t max_frames;
+        /* tune max_master and max_frames from the traffic */
+        bool adaptive;
     } mstp_params;
 } PORT_PARAMS;
 
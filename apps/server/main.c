@@ -67,6 +67,9 @@
 #if defined(BAC_UCI)
 #include "bacnet/basic/ucix/ucix.h"
 #endif /* defined(BAC_UCI) */
+#if defined(BACNET_APDU_WORKERS)
+#include "apdu-workers.h"
+#endif
 
 /** @file server/main.c  Example server application using the BACnet Stack. */
 
@@ -230,6 +233,9 @@ int main(int argc, char *argv[])
 #endif
     int argi = 0;
     const char *filename = NULL;
+#if defined(BACNET_APDU_WORKERS)
+    const char *pEnv = NULL;
+#endif
 
     filename = filename_remove_path(argv[0]);
     for (argi = 1; argi < argc; argi++) {
@@ -299,13 +305,24 @@ int main(int argc, char *argv[])
 
     dlenv_init();
     atexit(datalink_cleanup);
+#if defined(BACNET_APDU_WORKERS)
+    /* answer ReadProperty and ReadPropertyMultiple in worker threads */
+    pEnv = getenv("BACNET_APDU_WORKERS");
+    if (pEnv && apdu_workers_init((unsigned)strtol(pEnv, NULL, 0))) {
+        printf("BACnet APDU Workers: %u\n", apdu_workers_count());
+        atexit(apdu_workers_cleanup);
+    }
+#endif
     /* broadcast an I-Am on startup */
     Send_I_Am(&Handler_Transmit_Buffer[0]);
     /* loop forever */
     for (;;) {
         /* input */
         pdu_len = datalink_receive(&src, &Rx_Buf[0], MAX_MPDU, timeout);
-
+#if defined(BACNET_APDU_WORKERS)
+        /* the workers only read the objects while the main loop waits */
+        apdu_workers_lock();
+#endif
         /* process */
         if (pdu_len) {
             npdu_handler(&src, &Rx_Buf[0], pdu_len);
@@ -353,6 +370,9 @@ int main(int argc, char *argv[])
             elapsed_milliseconds = mstimer_interval(&BACnet_Object_Timer);
             Device_Timer(elapsed_milliseconds);
         }
+#if defined(BACNET_APDU_WORKERS)
+        apdu_workers_unlock();
+#endif
     }
 
     return 0;
@@ -283,6 +283,34 @@ int bip6_send_mpdu(BACNET_IP6_ADDRESS *dest, uint8_t *mtu, uint16_t mtu_len)
         (struct sockaddr *)&bvlc_dest, sizeof(bvlc_dest));
 }
 
+/**
+ * The send function for BACnet/IPv6 driver layer to send the same
+ * message to several destinations
+ *
+ * @param dest - array of BACNET_IP6_ADDRESS destination addresses
+ * @param dest_count - number of destination addresses
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ *
+ * @return number of destinations that the message was sent to
+ */
+int bip6_send_mpdu_list(BACNET_IP6_ADDRESS *dest,
+    unsigned dest_count,
+    uint8_t *mtu,
+    uint16_t mtu_len)
+{
+    unsigned i;
+    int sent = 0;
+
+    for (i = 0; i < dest_count; i++) {
+        if (bip6_send_mpdu(&dest[i], mtu, mtu_len) > 0) {
+            sent++;
+        }
+    }
+
+    return sent;
+}
+
 /**
  * The common send function for BACnet/IPv6 application layer
  *
@@ -0,0 +1,299 @@
+/**
+ * @file
+ * @brief A pool of worker threads that answer ReadProperty and
+ * ReadPropertyMultiple requests in parallel with the main loop.
+ *
+ * The main loop keeps receiving and handling every other service.
+ * Read requests are copied from the receive buffer into a queue by the
+ * confirmed service dispatcher of apdu_handler(), and each worker encodes
+ * the reply into its own transmit buffer and sends it.
+ *
+ * The object data is protected by a reader-writer lock: workers hold it
+ * shared while reading properties, and the main loop must hold it
+ * exclusively with apdu_workers_lock() while it handles received messages
+ * or runs the object timers.  The workers send their replies one at a time
+ * while they still hold the lock shared, so the datalink never sees two
+ * sends at once, even one like MS/TP whose send queue has a single producer.
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/apdu.h"
+#include "bacnet/npdu.h"
+#include "bacnet/basic/services.h"
+#include "bacnet/datalink/datalink.h"
+#if defined(BACNET_PROPERTY_CACHE)
+#include "bacnet/basic/object/property_cache.h"
+#endif
+/* me! */
+#include "apdu-workers.h"
+
+struct apdu_job {
+    BACNET_ADDRESS src;
+    BACNET_CONFIRMED_SERVICE_DATA service_data;
+    uint8_t service_choice;
+    uint16_t service_len;
+    uint8_t service_request[MAX_APDU];
+};
+
+/* requests waiting for a worker */
+static struct apdu_job Queue[APDU_WORKERS_QUEUE_SIZE];
+static unsigned Queue_Head;
+static unsigned Queue_Tail;
+static pthread_mutex_t Queue_Mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t Queue_Cond = PTHREAD_COND_INITIALIZER;
+/* object data - shared by the workers, exclusive for the main loop */
+static pthread_rwlock_t Object_Lock;
+/* one worker at a time in the datalink send */
+static pthread_mutex_t Send_Mutex = PTHREAD_MUTEX_INITIALIZER;
+#if defined(BACNET_PROPERTY_CACHE)
+static pthread_mutex_t Cache_Mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+static pthread_t Workers[APDU_WORKERS_MAX];
+static unsigned Workers_Count;
+static bool Workers_Stop;
+
+#if defined(BACNET_PROPERTY_CACHE)
+static void apdu_workers_cache_lock(void)
+{
+    pthread_mutex_lock(&Cache_Mutex);
+}
+
+static void apdu_workers_cache_unlock(void)
+{
+    pthread_mutex_unlock(&Cache_Mutex);
+}
+#endif
+
+/**
+ * @brief Encode and send the reply to a queued request
+ * @param job - the queued request
+ * @param pdu - the transmit buffer of this worker
+ * @param pdu_size - size of the transmit buffer
+ */
+static void apdu_worker_reply(
+    struct apdu_job *job, uint8_t *pdu, size_t pdu_size)
+{
+    BACNET_NPDU_DATA npdu_data;
+    BACNET_ADDRESS my_address;
+    int npdu_len = 0;
+    int apdu_len = 0;
+
+    datalink_get_my_address(&my_address);
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    npdu_len = npdu_encode_pdu(&pdu[0], &job->src, &my_address, &npdu_data);
+    if (npdu_len <= 0) {
+        return;
+    }
+    pthread_rwlock_rdlock(&Object_Lock);
+    if (job->service_choice == SERVICE_CONFIRMED_READ_PROPERTY) {
+        apdu_len = handler_read_property_encode(job->service_request,
+            job->service_len, &job->service_data, &pdu[npdu_len],
+            pdu_size - npdu_len);
+    } else {
+        apdu_len = handler_read_property_multiple_encode(job->service_request,
+            job->service_len, &job->service_data, &pdu[npdu_len],
+            pdu_size - npdu_len);
+    }
+    if (apdu_len > 0) {
+        /* the main loop only sends while it holds the lock exclusively */
+        pthread_mutex_lock(&Send_Mutex);
+        datalink_send_pdu(&job->src, &npdu_data, &pdu[0], npdu_len + apdu_len);
+        pthread_mutex_unlock(&Send_Mutex);
+    }
+    pthread_rwlock_unlock(&Object_Lock);
+}
+
+/**
+ * @brief Worker thread: wait for a queued request and answer it
+ * @param arg - not used
+ * @return NULL when the pool is stopped
+ */
+static void *apdu_worker_thread(void *arg)
+{
+    struct apdu_job job;
+    struct apdu_job *pJob;
+    uint8_t pdu[MAX_PDU];
+
+    (void)arg;
+    for (;;) {
+        pthread_mutex_lock(&Queue_Mutex);
+        while (!Workers_Stop && (Queue_Head == Queue_Tail)) {
+            pthread_cond_wait(&Queue_Cond, &Queue_Mutex);
+        }
+        if (Workers_Stop) {
+            pthread_mutex_unlock(&Queue_Mutex);
+            break;
+        }
+        pJob = &Queue[Queue_Tail % APDU_WORKERS_QUEUE_SIZE];
+        job.src = pJob->src;
+        job.service_data = pJob->service_data;
+        job.service_choice = pJob->service_choice;
+        job.service_len = pJob->service_len;
+        memcpy(job.service_request, pJob->service_request, pJob->service_len);
+        Queue_Tail++;
+        pthread_mutex_unlock(&Queue_Mutex);
+        apdu_worker_reply(&job, pdu, sizeof(pdu));
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Confirmed service dispatcher for apdu_handler() that queues the
+ *  supported read requests for the workers.
+ * @return true if the request was queued, false to handle it in the caller,
+ *  which is also the fallback when the queue is full.
+ */
+static bool apdu_workers_dispatch(uint8_t service_choice,
+    uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    struct apdu_job *pJob;
+    bool status = false;
+
+    if (service_choice == SERVICE_CONFIRMED_READ_PROPERTY) {
+        if (!apdu_service_supported(SERVICE_SUPPORTED_READ_PROPERTY)) {
+            return false;
+        }
+    } else if (service_choice == SERVICE_CONFIRMED_READ_PROP_MULTIPLE) {
+        if (!apdu_service_supported(SERVICE_SUPPORTED_READ_PROP_MULTIPLE)) {
+            return false;
+        }
+    } else {
+        return false;
+    }
+    if (!src || !service_data || (service_len > MAX_APDU)) {
+        return false;
+    }
+    pthread_mutex_lock(&Queue_Mutex);
+    if ((Queue_Head - Queue_Tail) < APDU_WORKERS_QUEUE_SIZE) {
+        pJob = &Queue[Queue_Head % APDU_WORKERS_QUEUE_SIZE];
+        pJob->src = *src;
+        pJob->service_data = *service_data;
+        pJob->service_choice = service_choice;
+        pJob->service_len = service_len;
+        if (service_len > 0) {
+            memcpy(pJob->service_request, service_request, service_len);
+        }
+        Queue_Head++;
+        pthread_cond_signal(&Queue_Cond);
+        status = true;
+    }
+    pthread_mutex_unlock(&Queue_Mutex);
+
+    return status;
+}
+
+/**
+ * @brief Start the worker threads and route the read requests to them
+ * @param workers - number of worker threads, up to APDU_WORKERS_MAX
+ * @return true if at least one worker thread was started
+ */
+bool apdu_workers_init(unsigned workers)
+{
+    pthread_rwlockattr_t attr;
+
+    if ((workers == 0) || Workers_Count) {
+        return false;
+    }
+    if (workers > APDU_WORKERS_MAX) {
+        workers = APDU_WORKERS_MAX;
+    }
+    pthread_rwlockattr_init(&attr);
+#if defined(__GLIBC__)
+    /* the main loop must not wait behind a steady stream of readers */
+    pthread_rwlockattr_setkind_np(
+        &attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+    pthread_rwlock_init(&Object_Lock, &attr);
+    pthread_rwlockattr_destroy(&attr);
+    Workers_Stop = false;
+    Queue_Head = 0;
+    Queue_Tail = 0;
+    while (Workers_Count < workers) {
+        if (pthread_create(
+                &Workers[Workers_Count], NULL, apdu_worker_thread, NULL) != 0) {
+            break;
+        }
+        Workers_Count++;
+    }
+    if (Workers_Count == 0) {
+        pthread_rwlock_destroy(&Object_Lock);
+        return false;
+    }
+#if defined(BACNET_PROPERTY_CACHE)
+    Property_Cache_Lock_Set(apdu_workers_cache_lock, apdu_workers_cache_unlock);
+#endif
+    apdu_set_confirmed_dispatch(apdu_workers_dispatch);
+
+    return true;
+}
+
+/**
+ * @brief Stop the worker threads and handle requests in the main loop.
+ *  Requests still waiting in the queue are dropped.
+ */
+void apdu_workers_cleanup(void)
+{
+    unsigned i;
+
+    if (Workers_Count == 0) {
+        return;
+    }
+    apdu_set_confirmed_dispatch(NULL);
+    pthread_mutex_lock(&Queue_Mutex);
+    Workers_Stop = true;
+    pthread_cond_broadcast(&Queue_Cond);
+    pthread_mutex_unlock(&Queue_Mutex);
+    for (i = 0; i < Workers_Count; i++) {
+        pthread_join(Workers[i], NULL);
+    }
+    Workers_Count = 0;
+#if defined(BACNET_PROPERTY_CACHE)
+    Property_Cache_Lock_Set(NULL, NULL);
+#endif
+    pthread_rwlock_destroy(&Object_Lock);
+}
+
+/**
+ * @brief Get the number of running worker threads
+ * @return number of worker threads, 0 if requests are handled in the caller
+ */
+unsigned apdu_workers_count(void)
+{
+    return Workers_Count;
+}
+
+/**
+ * @brief Acquire exclusive access to the object data.  The main loop holds
+ *  this while it handles received messages and runs the object timers.
+ */
+void apdu_workers_lock(void)
+{
+    if (Workers_Count) {
+        pthread_rwlock_wrlock(&Object_Lock);
+    }
+}
+
+/**
+ * @brief Release the exclusive access from apdu_workers_lock()
+ */
+void apdu_workers_unlock(void)
+{
+    if (Workers_Count) {
+        pthread_rwlock_unlock(&Object_Lock);
+    }
+}
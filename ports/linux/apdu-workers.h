@@ -0,0 +1,45 @@
+/**
+ * @file
+ * @brief API for a pool of worker threads that answer ReadProperty and
+ * ReadPropertyMultiple requests in parallel with the main loop
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_PORT_LINUX_APDU_WORKERS_H
+#define BACNET_PORT_LINUX_APDU_WORKERS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* maximum number of worker threads */
+#ifndef APDU_WORKERS_MAX
+#define APDU_WORKERS_MAX 16
+#endif
+/* number of requests that can wait for a worker, a power of two */
+#ifndef APDU_WORKERS_QUEUE_SIZE
+#define APDU_WORKERS_QUEUE_SIZE 32
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+bool apdu_workers_init(unsigned workers);
+BACNET_STACK_EXPORT
+void apdu_workers_cleanup(void);
+BACNET_STACK_EXPORT
+unsigned apdu_workers_count(void);
+
+BACNET_STACK_EXPORT
+void apdu_workers_lock(void);
+BACNET_STACK_EXPORT
+void apdu_workers_unlock(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
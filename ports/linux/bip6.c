@@ -31,6 +31,10 @@
  License.
  -------------------------------------------
 ####COPYRIGHTEND####*/
+#ifndef _GNU_SOURCE
+/* for sendmmsg */
+#define _GNU_SOURCE
+#endif
 
 #include <ifaddrs.h>
 #include <stdio.h>
@@ -233,6 +237,29 @@ bool bip6_get_broadcast_addr(BACNET_IP6_ADDRESS *addr)
     return bvlc6_address_copy(addr, &BIP6_Broadcast_Addr);
 }
 
+/**
+ * Set a socket address from a BACnet/IPv6 address
+ *
+ * @param sin6 - socket address to set
+ * @param addr - BACnet/IPv6 address and port
+ */
+static void bip6_sockaddr_set(
+    struct sockaddr_in6 *sin6, BACNET_IP6_ADDRESS *addr)
+{
+    uint16_t addr16[8];
+    unsigned i;
+
+    memset(sin6, 0, sizeof(*sin6));
+    sin6->sin6_family = AF_INET6;
+    bvlc6_address_get(addr, &addr16[0], &addr16[1], &addr16[2], &addr16[3],
+        &addr16[4], &addr16[5], &addr16[6], &addr16[7]);
+    for (i = 0; i < 8; i++) {
+        sin6->sin6_addr.s6_addr16[i] = htons(addr16[i]);
+    }
+    sin6->sin6_port = htons(addr->port);
+    sin6->sin6_scope_id = BIP6_Socket_Scope_Id;
+}
+
 /**
  * The send function for BACnet/IPv6 driver layer
  *
@@ -247,32 +274,80 @@ bool bip6_get_broadcast_addr(BACNET_IP6_ADDRESS *addr)
 int bip6_send_mpdu(BACNET_IP6_ADDRESS *dest, uint8_t *mtu, uint16_t mtu_len)
 {
     struct sockaddr_in6 bvlc_dest = { 0 };
-    uint16_t addr16[8];
 
     /* assumes that the driver has already been initialized */
     if (BIP6_Socket < 0) {
         return 0;
     }
-    /* load destination IP address */
-    bvlc_dest.sin6_family = AF_INET6;
-    bvlc6_address_get(dest, &addr16[0], &addr16[1], &addr16[2], &addr16[3],
-        &addr16[4], &addr16[5], &addr16[6], &addr16[7]);
-    bvlc_dest.sin6_addr.s6_addr16[0] = htons(addr16[0]);
-    bvlc_dest.sin6_addr.s6_addr16[1] = htons(addr16[1]);
-    bvlc_dest.sin6_addr.s6_addr16[2] = htons(addr16[2]);
-    bvlc_dest.sin6_addr.s6_addr16[3] = htons(addr16[3]);
-    bvlc_dest.sin6_addr.s6_addr16[4] = htons(addr16[4]);
-    bvlc_dest.sin6_addr.s6_addr16[5] = htons(addr16[5]);
-    bvlc_dest.sin6_addr.s6_addr16[6] = htons(addr16[6]);
-    bvlc_dest.sin6_addr.s6_addr16[7] = htons(addr16[7]);
-    bvlc_dest.sin6_port = htons(dest->port);
-    bvlc_dest.sin6_scope_id = BIP6_Socket_Scope_Id;
+    bip6_sockaddr_set(&bvlc_dest, dest);
     debug_print_ipv6("Sending MPDU->", &bvlc_dest.sin6_addr);
     /* Send the packet */
     return sendto(BIP6_Socket, (char *)mtu, mtu_len, 0,
         (struct sockaddr *)&bvlc_dest, sizeof(bvlc_dest));
 }
 
+/* number of messages handed to the kernel in one system call */
+#ifndef BIP6_SEND_MPDU_BATCH
+#define BIP6_SEND_MPDU_BATCH 64
+#endif
+
+/**
+ * The send function for BACnet/IPv6 driver layer to send the same
+ * message to several destinations, in batches of one system call
+ *
+ * @param dest - array of BACNET_IP6_ADDRESS destination addresses
+ * @param dest_count - number of destination addresses
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ *
+ * @return number of destinations that the message was sent to
+ */
+int bip6_send_mpdu_list(BACNET_IP6_ADDRESS *dest,
+    unsigned dest_count,
+    uint8_t *mtu,
+    uint16_t mtu_len)
+{
+    struct sockaddr_in6 bvlc_dest[BIP6_SEND_MPDU_BATCH];
+    struct mmsghdr msgs[BIP6_SEND_MPDU_BATCH];
+    struct iovec iov;
+    unsigned batch;
+    unsigned i;
+    int sent = 0;
+    int rv;
+
+    /* assumes that the driver has already been initialized */
+    if ((BIP6_Socket < 0) || !dest) {
+        return 0;
+    }
+    iov.iov_base = mtu;
+    iov.iov_len = mtu_len;
+    while (dest_count) {
+        batch = dest_count;
+        if (batch > BIP6_SEND_MPDU_BATCH) {
+            batch = BIP6_SEND_MPDU_BATCH;
+        }
+        memset(msgs, 0, batch * sizeof(msgs[0]));
+        for (i = 0; i < batch; i++) {
+            bip6_sockaddr_set(&bvlc_dest[i], &dest[i]);
+            msgs[i].msg_hdr.msg_name = &bvlc_dest[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(bvlc_dest[i]);
+            msgs[i].msg_hdr.msg_iov = &iov;
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        rv = sendmmsg(BIP6_Socket, msgs, batch, 0);
+        if (rv <= 0) {
+            /* skip the destination that could not be sent to */
+            rv = 1;
+        } else {
+            sent += rv;
+        }
+        dest += rv;
+        dest_count -= rv;
+    }
+
+    return sent;
+}
+
 /**
  * The common send function for BACnet/IPv6 application layer
  *
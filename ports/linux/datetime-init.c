@@ -34,10 +34,14 @@ bool datetime_local(BACNET_DATE *bdate,
 {
     bool status = false;
     struct tm *tblock = NULL;
+    struct tm tm_local;
     struct timeval tv;
+    time_t seconds;
 
     if (gettimeofday(&tv, NULL) == 0) {
-        tblock = (struct tm *)localtime((const time_t *)&tv.tv_sec);
+        /* reentrant, since the time can be read from more than one thread */
+        seconds = tv.tv_sec;
+        tblock = localtime_r(&seconds, &tm_local);
     }
     if (tblock) {
         status = true;
@@ -81,12 +81,13 @@ static struct mstp_port_struct_t MSTP_Port;
 /* buffers needed by mstp port struct */
 static uint8_t TxBuffer[DLMSTP_MPDU_MAX];
 static uint8_t RxBuffer[DLMSTP_MPDU_MAX];
-/* data structure for MS/TP PDU Queue */
+/* data structure for MS/TP PDU Queue: the PDU is written after room
+   for the frame header, so the frame is built around it in place */
 struct mstp_pdu_packet {
     bool data_expecting_reply;
     uint8_t destination_mac;
     uint16_t length;
-    uint8_t buffer[DLMSTP_MPDU_MAX];
+    uint8_t frame[DLMSTP_MPDU_MAX];
 };
 /* count must be a power of 2 for ringbuf library */
 #ifndef MSTP_PDU_PACKET_COUNT
@@ -94,6 +95,8 @@ struct mstp_pdu_packet {
 #endif
 static struct mstp_pdu_packet PDU_Buffer[MSTP_PDU_PACKET_COUNT];
 static RING_BUFFER PDU_Queue;
+/* the packet whose frame is being sent from the output buffer */
+static struct mstp_pdu_packet *Transmit_Packet;
 /* The minimum time without a DataAvailable or ReceiveError event */
 /* that a node must wait for a station to begin replying to a */
 /* confirmed request: 255 milliseconds. (Implementations may use */
@@ -214,14 +217,16 @@ int dlmstp_send_pdu(BACNET_ADDRESS *dest, /* destination address */
 { /* number of bytes of data */
     int bytes_sent = 0;
     struct mstp_pdu_packet *pkt;
-    unsigned i = 0;
+
+    if (pdu_len > (sizeof(pkt->frame) - DLMSTP_HEADER_MAX)) {
+        return 0;
+    }
     pthread_mutex_lock(&Ring_Buffer_Mutex);
     pkt = (struct mstp_pdu_packet *)Ringbuf_Data_Peek(&PDU_Queue);
     if (pkt) {
         pkt->data_expecting_reply = npdu_data->data_expecting_reply;
-        for (i = 0; i < pdu_len; i++) {
-            pkt->buffer[i] = pdu[i];
-        }
+        /* the only copy of the PDU before it is sent */
+        memcpy(&pkt->frame[MSTP_FRAME_HEADER_LEN], pdu, pdu_len);
         pkt->length = pdu_len;
         if (dest && dest->mac_len) {
             pkt->destination_mac = dest->mac[0];
@@ -246,7 +251,6 @@ uint16_t dlmstp_receive(BACNET_ADDRESS *src, /* source address */
     uint16_t pdu_len = 0;
     struct timespec abstime;
 
-    (void)max_pdu;
     /* see if there is a packet available, and a place
        to put the reply (if necessary) and process it */
     pthread_mutex_lock(&Receive_Packet_Mutex);
@@ -254,14 +258,15 @@ uint16_t dlmstp_receive(BACNET_ADDRESS *src, /* source address */
     pthread_cond_timedwait(
         &Receive_Packet_Flag, &Receive_Packet_Mutex, &abstime);
     if (Receive_Packet.ready) {
-        if (Receive_Packet.pdu_len) {
+        if (Receive_Packet.pdu_len && (Receive_Packet.pdu_len <= max_pdu)) {
             MSTP_Packets++;
             if (src) {
                 memmove(src, &Receive_Packet.address,
                     sizeof(Receive_Packet.address));
             }
             if (pdu) {
-                memmove(pdu, &Receive_Packet.pdu, sizeof(Receive_Packet.pdu));
+                /* only the octets received */
+                memcpy(pdu, Receive_Packet.pdu, Receive_Packet.pdu_len);
             }
             pdu_len = Receive_Packet.pdu_len;
         }
@@ -283,8 +288,7 @@ static void *dlmstp_master_fsm_task(void *pArg)
     while (thread_alive) {
         if (MSTP_Port.ReceivedValidFrame == false &&
             MSTP_Port.ReceivedInvalidFrame == false) {
-            RS485_Check_UART_Data(&MSTP_Port);
-            MSTP_Receive_Frame_FSM(&MSTP_Port);
+            RS485_Receive_Frame_Data(&MSTP_Port, RS485_RECEIVE_WAIT_MS);
         }
         if (MSTP_Port.ReceivedValidFrame || MSTP_Port.ReceivedInvalidFrame) {
             run_master = true;
@@ -375,7 +379,7 @@ uint16_t MSTP_Put_Receive(struct mstp_port_struct_t *mstp_port)
             (void *)&mstp_port->InputBuffer[0], pdu_len);
         dlmstp_fill_bacnet_address(
             &Receive_Packet.address, mstp_port->SourceAddress);
-        Receive_Packet.pdu_len = mstp_port->DataLength;
+        Receive_Packet.pdu_len = pdu_len;
         Receive_Packet.ready = true;
         pthread_cond_signal(&Receive_Packet_Flag);
     }
@@ -384,32 +388,81 @@ uint16_t MSTP_Put_Receive(struct mstp_port_struct_t *mstp_port)
     return pdu_len;
 }
 
+/**
+ * @brief Give the packet of the last frame sent back to the queue, and
+ *  send from the port's own output buffer again.
+ * @param mstp_port - port specific data
+ * @note called with the Ring_Buffer_Mutex locked
+ */
+static void dlmstp_transmit_packet_release(
+    struct mstp_port_struct_t *mstp_port)
+{
+    if (Transmit_Packet) {
+        /* the state machine sent the frame before asking for another */
+        (void)Ringbuf_Pop(&PDU_Queue, NULL);
+        Transmit_Packet = NULL;
+    }
+    mstp_port->OutputBuffer = &TxBuffer[0];
+    mstp_port->OutputBufferSize = sizeof(TxBuffer);
+}
+
+/**
+ * @brief Build the frame of the packet at the head of the queue, and
+ *  lend the packet to the port as its output buffer until the frame is
+ *  sent.  The PDU is not copied: the header and CRC are written around
+ *  it.  A PDU too long for a frame with no COBS encoding is encoded into
+ *  the port's own output buffer instead.
+ * @param mstp_port - port specific data
+ * @param pkt - packet at the head of the queue
+ * @return number of octets in the frame, or zero if none
+ * @note called with the Ring_Buffer_Mutex locked
+ */
+static uint16_t dlmstp_pdu_frame(
+    struct mstp_port_struct_t *mstp_port, struct mstp_pdu_packet *pkt)
+{
+    uint16_t frame_len = 0;
+    uint8_t frame_type = 0;
+
+    if (pkt->data_expecting_reply) {
+        frame_type = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
+    } else {
+        frame_type = FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY;
+    }
+    if (pkt->length > MSTP_FRAME_NPDU_MAX) {
+        frame_len = MSTP_Create_Frame(mstp_port->OutputBuffer,
+            mstp_port->OutputBufferSize, frame_type, pkt->destination_mac,
+            mstp_port->This_Station, &pkt->frame[MSTP_FRAME_HEADER_LEN],
+            pkt->length);
+        (void)Ringbuf_Pop(&PDU_Queue, NULL);
+    } else {
+        frame_len = MSTP_Create_Frame(pkt->frame, sizeof(pkt->frame),
+            frame_type, pkt->destination_mac, mstp_port->This_Station,
+            &pkt->frame[MSTP_FRAME_HEADER_LEN], pkt->length);
+        mstp_port->OutputBuffer = pkt->frame;
+        mstp_port->OutputBufferSize = sizeof(pkt->frame);
+        Transmit_Packet = pkt;
+    }
+
+    return frame_len;
+}
+
 /* for the MS/TP state machine to use for getting data to send */
 /* Return: amount of PDU data */
 uint16_t MSTP_Get_Send(struct mstp_port_struct_t *mstp_port, unsigned timeout)
 { /* milliseconds to wait for a packet */
     uint16_t pdu_len = 0;
-    uint8_t frame_type = 0;
     struct mstp_pdu_packet *pkt;
 
     (void)timeout;
     pthread_mutex_lock(&Ring_Buffer_Mutex);
+    dlmstp_transmit_packet_release(mstp_port);
     if (Ringbuf_Empty(&PDU_Queue)) {
         pthread_mutex_unlock(&Ring_Buffer_Mutex);
         return 0;
     }
     pkt = (struct mstp_pdu_packet *)Ringbuf_Peek(&PDU_Queue);
-    if (pkt->data_expecting_reply) {
-        frame_type = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
-    } else {
-        frame_type = FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY;
-    }
     /* convert the PDU into the MSTP Frame */
-    pdu_len =
-        MSTP_Create_Frame(&mstp_port->OutputBuffer[0], /* <-- loading this */
-            mstp_port->OutputBufferSize, frame_type, pkt->destination_mac,
-            mstp_port->This_Station, (uint8_t *)&pkt->buffer[0], pkt->length);
-    (void)Ringbuf_Pop(&PDU_Queue, NULL);
+    pdu_len = dlmstp_pdu_frame(mstp_port, pkt);
     pthread_mutex_unlock(&Ring_Buffer_Mutex);
 
     return pdu_len;
@@ -589,32 +642,26 @@ uint16_t MSTP_Get_Reply(struct mstp_port_struct_t *mstp_port, unsigned timeout)
 { /* milliseconds to wait for a packet */
     uint16_t pdu_len = 0; /* return value */
     bool matched = false;
-    uint8_t frame_type = 0;
     struct mstp_pdu_packet *pkt;
 
     (void)timeout;
+    pthread_mutex_lock(&Ring_Buffer_Mutex);
+    dlmstp_transmit_packet_release(mstp_port);
     if (Ringbuf_Empty(&PDU_Queue)) {
+        pthread_mutex_unlock(&Ring_Buffer_Mutex);
         return 0;
     }
     pkt = (struct mstp_pdu_packet *)Ringbuf_Peek(&PDU_Queue);
     /* is this the reply to the DER? */
     matched = dlmstp_compare_data_expecting_reply(&mstp_port->InputBuffer[0],
         mstp_port->DataLength, mstp_port->SourceAddress,
-        (uint8_t *)&pkt->buffer[0], pkt->length, pkt->destination_mac);
-    if (!matched) {
-        return 0;
+        &pkt->frame[MSTP_FRAME_HEADER_LEN], pkt->length,
+        pkt->destination_mac);
+    if (matched) {
+        /* convert the PDU into the MSTP Frame */
+        pdu_len = dlmstp_pdu_frame(mstp_port, pkt);
     }
-    if (pkt->data_expecting_reply) {
-        frame_type = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
-    } else {
-        frame_type = FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY;
-    }
-    /* convert the PDU into the MSTP Frame */
-    pdu_len =
-        MSTP_Create_Frame(&mstp_port->OutputBuffer[0], /* <-- loading this */
-            mstp_port->OutputBufferSize, frame_type, pkt->destination_mac,
-            mstp_port->This_Station, (uint8_t *)&pkt->buffer[0], pkt->length);
-    (void)Ringbuf_Pop(&PDU_Queue, NULL);
+    pthread_mutex_unlock(&Ring_Buffer_Mutex);
 
     return pdu_len;
 }
@@ -754,6 +801,7 @@ bool dlmstp_init(char *ifname)
     /* initialize PDU queue */
     Ringbuf_Init(&PDU_Queue, (uint8_t *)&PDU_Buffer,
         sizeof(struct mstp_pdu_packet), MSTP_PDU_PACKET_COUNT);
+    Transmit_Packet = NULL;
     /* initialize packet queue */
     Receive_Packet.ready = false;
     Receive_Packet.pdu_len = 0;
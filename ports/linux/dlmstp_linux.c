@@ -29,6 +29,8 @@
 #include <string.h>
 #include <stdio.h>
 #include <time.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -56,6 +58,50 @@
         if (x < 0xFFFF)               \
             x++;                      \
     }
+/* port manager threads, each driving some of the ports */
+struct dlmstp_manager_thread {
+    pthread_t thread;
+    int epoll_fd;
+    /* wakes the thread when a port is added */
+    int event_fd;
+    /* guards the list of ports while they are added or removed */
+    pthread_mutex_t mutex;
+    /* true when the thread is asked to exit */
+    bool stop;
+    unsigned port_count;
+    struct mstp_port_struct_t *ports[DLMSTP_MANAGER_PORTS_MAX];
+};
+static struct dlmstp_manager_thread Manager_Threads[DLMSTP_MANAGER_THREADS_MAX];
+static unsigned Manager_Thread_Count;
+static void dlmstp_manager_port_remove(struct mstp_port_struct_t *mstp_port);
+
+/**
+ * @brief Get the time from the monotonic clock, which does not jump
+ *  when the time of day is set
+ * @param tv - the time
+ */
+static void Timer_Now(struct timeval *tv)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    tv->tv_sec = ts.tv_sec;
+    tv->tv_usec = ts.tv_nsec / 1000;
+}
+
+/**
+ * @brief Get the time from the monotonic clock
+ * @return microseconds
+ */
+static uint64_t Timer_Now_us(void)
+{
+    struct timeval now;
+
+    Timer_Now(&now);
+
+    return ((uint64_t)now.tv_sec * 1000000ULL) + (uint64_t)now.tv_usec;
+}
+
 uint32_t Timer_Silence(void *poPort)
 {
     struct timeval now, tmp_diff;
@@ -69,13 +115,27 @@ uint32_t Timer_Silence(void *poPort)
         return -1;
     }
 
-    int32_t res;
+    Timer_Now(&now);
+    if (timercmp(&now, &poSharedData->start, <)) {
+        /* the last frame sent is still being transmitted */
+        return 0;
+    }
+    timersub(&now, &poSharedData->start, &tmp_diff);
 
-    gettimeofday(&now, NULL);
-    timersub(&poSharedData->start, &now, &tmp_diff);
-    res = ((tmp_diff.tv_sec) * 1000 + (tmp_diff.tv_usec) / 1000);
+    return (tmp_diff.tv_sec * 1000) + (tmp_diff.tv_usec / 1000);
+}
 
-    return (res >= 0 ? res : -res);
+/**
+ * @brief Free running millisecond timer, used by the MS/TP state
+ *  machine to measure the token rotation time
+ * @param poPort - MS/TP port, unused
+ * @return milliseconds from the monotonic clock
+ */
+static uint32_t Timer_Milliseconds(void *poPort)
+{
+    (void)poPort;
+
+    return (uint32_t)(Timer_Now_us() / 1000ULL);
 }
 
 void Timer_Silence_Reset(void *poPort)
@@ -90,7 +150,7 @@ void Timer_Silence_Reset(void *poPort)
         return;
     }
 
-    gettimeofday(&poSharedData->start, NULL);
+    Timer_Now(&poSharedData->start);
 }
 
 void get_abstime(struct timespec *abstime, unsigned long milliseconds)
@@ -117,6 +177,9 @@ void dlmstp_cleanup(void *poPort)
         return;
     }
 
+    if (poSharedData->Managed) {
+        dlmstp_manager_port_remove(mstp_port);
+    }
     /* restore the old port settings */
     tcsetattr(poSharedData->RS485_Handle, TCSANOW, &poSharedData->RS485_oldtio);
     close(poSharedData->RS485_Handle);
@@ -128,6 +191,138 @@ void dlmstp_cleanup(void *poPort)
     pthread_mutex_destroy(&poSharedData->Master_Done_Mutex);
 }
 
+/**
+ * @brief Decode the parts of a confirmed request that its reply must match
+ * @param pdu - NPDU of a Data Expecting Reply frame
+ * @param pdu_len - number of octets in the NPDU
+ * @param src_mac - MS/TP address of the node that sent the request
+ * @param key - the decoded request
+ * @return true if the NPDU holds a confirmed request
+ */
+static bool dlmstp_request_key_decode(uint8_t *pdu,
+    uint16_t pdu_len,
+    uint8_t src_mac,
+    struct dlmstp_reply_key *key)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int offset;
+
+    memset(key, 0, sizeof(*key));
+    key->address.mac[0] = src_mac;
+    key->address.mac_len = 1;
+    offset =
+        bacnet_npdu_decode(pdu, pdu_len, NULL, &key->address, &npdu_data);
+    if ((offset <= 0) || npdu_data.network_layer_message ||
+        (pdu_len < (offset + 4))) {
+        return false;
+    }
+    key->pdu_type = pdu[offset] & 0xF0;
+    if (key->pdu_type != PDU_TYPE_CONFIRMED_SERVICE_REQUEST) {
+        return false;
+    }
+    key->invoke_id = pdu[offset + 2];
+    /* segmented message? */
+    if (pdu[offset] & BIT(3)) {
+        if (pdu_len < (offset + 6)) {
+            return false;
+        }
+        key->service_choice = pdu[offset + 5];
+    } else {
+        key->service_choice = pdu[offset + 3];
+    }
+    key->protocol_version = npdu_data.protocol_version;
+
+    return true;
+}
+
+/**
+ * @brief Decode the parts of a reply that must match its confirmed request
+ * @param pdu - NPDU to be sent
+ * @param pdu_len - number of octets in the NPDU
+ * @param dest_mac - MS/TP address of the node the NPDU is sent to
+ * @param key - the decoded reply
+ * @return true if the NPDU holds a reply: a simple, complex, error,
+ *  reject, or abort PDU
+ */
+static bool dlmstp_reply_key_decode(uint8_t *pdu,
+    uint16_t pdu_len,
+    uint8_t dest_mac,
+    struct dlmstp_reply_key *key)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int offset;
+
+    memset(key, 0, sizeof(*key));
+    key->address.mac[0] = dest_mac;
+    key->address.mac_len = 1;
+    offset =
+        bacnet_npdu_decode(pdu, pdu_len, &key->address, NULL, &npdu_data);
+    if ((offset <= 0) || npdu_data.network_layer_message ||
+        (pdu_len < (offset + 2))) {
+        return false;
+    }
+    key->pdu_type = pdu[offset] & 0xF0;
+    key->invoke_id = pdu[offset + 1];
+    switch (key->pdu_type) {
+        case PDU_TYPE_SIMPLE_ACK:
+        case PDU_TYPE_ERROR:
+            if (pdu_len < (offset + 3)) {
+                return false;
+            }
+            key->service_choice = pdu[offset + 2];
+            break;
+        case PDU_TYPE_COMPLEX_ACK:
+            /* segmented message? */
+            if (pdu[offset] & BIT(3)) {
+                if (pdu_len < (offset + 5)) {
+                    return false;
+                }
+                key->service_choice = pdu[offset + 4];
+            } else {
+                if (pdu_len < (offset + 3)) {
+                    return false;
+                }
+                key->service_choice = pdu[offset + 2];
+            }
+            break;
+        case PDU_TYPE_REJECT:
+        case PDU_TYPE_ABORT:
+            break;
+        default:
+            return false;
+    }
+    key->protocol_version = npdu_data.protocol_version;
+
+    return true;
+}
+
+/**
+ * @brief Compare a decoded reply with its decoded confirmed request.
+ *  The NPDU priority is not compared because it doesn't get passed
+ *  through the stack.
+ * @param request - decoded confirmed request
+ * @param reply - decoded reply
+ * @return true if the reply answers the request
+ */
+static bool dlmstp_reply_key_match(
+    struct dlmstp_reply_key *request, struct dlmstp_reply_key *reply)
+{
+    if (request->invoke_id != reply->invoke_id) {
+        return false;
+    }
+    /* reject and abort don't have the service choice included */
+    if ((reply->pdu_type != PDU_TYPE_REJECT) &&
+        (reply->pdu_type != PDU_TYPE_ABORT) &&
+        (request->service_choice != reply->service_choice)) {
+        return false;
+    }
+    if (request->protocol_version != reply->protocol_version) {
+        return false;
+    }
+
+    return bacnet_address_same(&request->address, &reply->address);
+}
+
 /* returns number of bytes sent on success, zero on failure */
 int dlmstp_send_pdu(void *poPort,
     BACNET_ADDRESS *dest, /* destination address */
@@ -136,7 +331,10 @@ int dlmstp_send_pdu(void *poPort,
 { /* number of bytes of data */
     int bytes_sent = 0;
     struct mstp_pdu_packet *pkt;
-    unsigned i = 0;
+    struct dlmstp_reply_key reply_key;
+    RING_BUFFER *queue;
+    uint8_t priority;
+    unsigned depth;
     SHARED_MSTP_DATA *poSharedData;
     struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
     if (!mstp_port) {
@@ -146,20 +344,53 @@ int dlmstp_send_pdu(void *poPort,
     if (!poSharedData) {
         return 0;
     }
+    if (!pdu || (pdu_len < 2) ||
+        (pdu_len > (sizeof(pkt->frame) - DLMSTP_HEADER_MAX))) {
+        return 0;
+    }
 
-    pkt = (struct mstp_pdu_packet *)Ringbuf_Data_Peek(&poSharedData->PDU_Queue);
+    /* replies are decoded once here, so that the MS/TP thread only
+       compares keys when it looks for the answer to a request */
+    if (dlmstp_reply_key_decode(
+            pdu, (uint16_t)pdu_len, dest->mac[0], &reply_key)) {
+        queue = &poSharedData->Reply_Queue;
+        if (Ringbuf_Full(queue)) {
+            /* too many replies are waiting: this one is postponed,
+               and sent with the normal PDUs when the token arrives */
+            queue = &poSharedData->PDU_Queue;
+        }
+    } else {
+        priority = pdu[BACNET_PDU_CONTROL_BYTE_OFFSET] & 0x03;
+        if (priority == MESSAGE_PRIORITY_NORMAL) {
+            queue = &poSharedData->PDU_Queue;
+        } else {
+            queue = &poSharedData->PDU_Priority_Queue[priority - 1];
+        }
+    }
+    pkt = (struct mstp_pdu_packet *)Ringbuf_Data_Peek(queue);
     if (pkt) {
         pkt->data_expecting_reply =
             BACNET_DATA_EXPECTING_REPLY(pdu[BACNET_PDU_CONTROL_BYTE_OFFSET]);
-        for (i = 0; i < pdu_len; i++) {
-            pkt->buffer[i] = pdu[i];
+        if (queue == &poSharedData->Reply_Queue) {
+            pkt->reply_key = reply_key;
         }
+        /* the only copy of the PDU before it is sent */
+        memcpy(&pkt->frame[MSTP_FRAME_HEADER_LEN], pdu, pdu_len);
         pkt->length = pdu_len;
         pkt->destination_mac = dest->mac[0];
-        if (Ringbuf_Data_Put(&poSharedData->PDU_Queue, (uint8_t *)pkt)) {
+        if (Ringbuf_Data_Put(queue, (uint8_t *)pkt)) {
             bytes_sent = pdu_len;
+            poSharedData->Transmit_Packet_Puts++;
+            depth = poSharedData->Transmit_Packet_Puts -
+                poSharedData->Transmit_Packet_Pops;
+            if (depth > poSharedData->Transmit_Packet_High_Water) {
+                poSharedData->Transmit_Packet_High_Water = depth;
+            }
         }
     }
+    if (bytes_sent == 0) {
+        poSharedData->Transmit_Packet_Drops++;
+    }
 
     return bytes_sent;
 }
@@ -173,6 +404,7 @@ uint16_t dlmstp_receive(void *poPort,
     uint16_t pdu_len = 0;
     struct timespec abstime;
     int rv = 0;
+    DLMSTP_PACKET *pkt;
     SHARED_MSTP_DATA *poSharedData;
     struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
     if (!mstp_port) {
@@ -182,26 +414,26 @@ uint16_t dlmstp_receive(void *poPort,
     if (!poSharedData) {
         return 0;
     }
-    (void)max_pdu;
     /* see if there is a packet available, and a place
        to put the reply (if necessary) and process it */
     get_abstime(&abstime, timeout);
     rv = sem_timedwait(&poSharedData->Receive_Packet_Flag, &abstime);
     if (rv == 0) {
-        if (poSharedData->Receive_Packet.ready) {
-            if (poSharedData->Receive_Packet.pdu_len) {
+        /* the semaphore is posted once for each packet in the queue */
+        pkt = (DLMSTP_PACKET *)Ringbuf_Peek(&poSharedData->Receive_Queue);
+        if (pkt) {
+            if (pkt->pdu_len && (pkt->pdu_len <= max_pdu)) {
                 poSharedData->MSTP_Packets++;
                 if (src) {
-                    memmove(src, &poSharedData->Receive_Packet.address,
-                        sizeof(poSharedData->Receive_Packet.address));
+                    memmove(src, &pkt->address, sizeof(pkt->address));
                 }
                 if (pdu) {
-                    memmove(pdu, &poSharedData->Receive_Packet.pdu,
-                        sizeof(poSharedData->Receive_Packet.pdu));
+                    memmove(pdu, &pkt->pdu, pkt->pdu_len);
                 }
-                pdu_len = poSharedData->Receive_Packet.pdu_len;
+                pdu_len = pkt->pdu_len;
             }
-            poSharedData->Receive_Packet.ready = false;
+            /* frees the slot for the MS/TP thread */
+            (void)Ringbuf_Pop(&poSharedData->Receive_Queue, NULL);
         }
     }
 
@@ -227,26 +459,88 @@ void *dlmstp_receive_fsm_task(void *pArg)
         /* only do receive state machine while we don't have a frame */
         if ((mstp_port->ReceivedValidFrame == false) &&
             (mstp_port->ReceivedInvalidFrame == false)) {
-            do {
-                RS485_Check_UART_Data(mstp_port);
-                MSTP_Receive_Frame_FSM(
-                    (struct mstp_port_struct_t *)pArg);
-                received_frame = mstp_port->ReceivedValidFrame ||
-                    mstp_port->ReceivedInvalidFrame;
-                if (received_frame) {
-                    pthread_cond_signal(&poSharedData->Received_Frame_Flag);
-                    break;
-                }
-            } while (mstp_port->DataAvailable);
+            RS485_Receive_Frame_Data(mstp_port, RS485_RECEIVE_WAIT_MS);
+            received_frame = mstp_port->ReceivedValidFrame ||
+                mstp_port->ReceivedInvalidFrame;
+            if (received_frame) {
+                pthread_cond_signal(&poSharedData->Received_Frame_Flag);
+            }
+        } else {
+            /* wait for the frame to be handled */
+            usleep(1000);
         }
     }
 
     return NULL;
 }
 
-void *dlmstp_master_fsm_task(void *pArg)
+/**
+ * @brief Get the milliseconds until the MS/TP state machines of a port
+ *  need to run, if no frame is received before then
+ * @param poPort - port specific data
+ * @return milliseconds, or zero when the state machines need to run now
+ */
+uint32_t dlmstp_port_timeout(void *poPort)
 {
+    struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
+    SHARED_MSTP_DATA *poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
     uint32_t silence = 0;
+    uint32_t timeout = 0;
+
+    if (mstp_port->This_Station > DEFAULT_MAX_MASTER) {
+        /* slave nodes only answer the frames they receive, and poll
+           for the reply to a request until Treply_delay has passed */
+        if (poSharedData && poSharedData->Reply_Request_Valid &&
+            (mstp_port->SilenceTimer((void *)mstp_port) <=
+                mstp_port->Treply_delay)) {
+            return 0;
+        }
+        timeout = Tno_token;
+    } else {
+        switch (mstp_port->master_state) {
+            case MSTP_MASTER_STATE_IDLE:
+                timeout = Tno_token;
+                break;
+            case MSTP_MASTER_STATE_WAIT_FOR_REPLY:
+                timeout = mstp_port->Treply_timeout;
+                break;
+            case MSTP_MASTER_STATE_POLL_FOR_MASTER:
+                timeout = mstp_port->Tusage_timeout;
+                break;
+            default:
+                /* transitioning, or waiting on the application */
+                return 0;
+        }
+    }
+    if ((mstp_port->receive_state != MSTP_RECEIVE_STATE_IDLE) &&
+        (mstp_port->Tframe_abort < timeout)) {
+        timeout = mstp_port->Tframe_abort;
+    }
+    silence = mstp_port->SilenceTimer((void *)mstp_port);
+    if (silence >= timeout) {
+        return 0;
+    }
+
+    return timeout - silence;
+}
+
+/**
+ * @brief Run the master or slave node state machine of a port
+ * @param mstp_port - port specific data
+ */
+static void dlmstp_port_node_fsm(struct mstp_port_struct_t *mstp_port)
+{
+    if (mstp_port->This_Station <= DEFAULT_MAX_MASTER) {
+        while (MSTP_Master_Node_FSM(mstp_port)) {
+            /* do nothing while immediate transitioning */
+        }
+    } else if (mstp_port->This_Station < 255) {
+        MSTP_Slave_Node_FSM(mstp_port);
+    }
+}
+
+void *dlmstp_master_fsm_task(void *pArg)
+{
     bool run_master = false;
     SHARED_MSTP_DATA *poSharedData;
     struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)pArg;
@@ -263,38 +557,115 @@ void *dlmstp_master_fsm_task(void *pArg)
     for (;;) {
         if (mstp_port->ReceivedValidFrame == false &&
             mstp_port->ReceivedInvalidFrame == false) {
-            RS485_Check_UART_Data(mstp_port);
-            MSTP_Receive_Frame_FSM(mstp_port);
+            RS485_Receive_Frame_Data(mstp_port, RS485_RECEIVE_WAIT_MS);
         }
         if (mstp_port->ReceivedValidFrame || mstp_port->ReceivedInvalidFrame) {
             run_master = true;
         } else {
-            silence = mstp_port->SilenceTimer(NULL);
-            switch (mstp_port->master_state) {
-                case MSTP_MASTER_STATE_IDLE:
-                    if (silence >= Tno_token)
-                        run_master = true;
-                    break;
-                case MSTP_MASTER_STATE_WAIT_FOR_REPLY:
-                    if (silence >= mstp_port->Treply_timeout)
-                        run_master = true;
-                    break;
-                case MSTP_MASTER_STATE_POLL_FOR_MASTER:
-                    if (silence >= mstp_port->Tusage_timeout)
-                        run_master = true;
-                    break;
-                default:
-                    run_master = true;
-                    break;
-            }
+            run_master = (dlmstp_port_timeout(mstp_port) == 0);
         }
         if (run_master) {
-            if (mstp_port->This_Station <= DEFAULT_MAX_MASTER) {
-                while (MSTP_Master_Node_FSM(mstp_port)) {
-                    /* do nothing while immediate transitioning */
-                }
-            } else if (mstp_port->This_Station < 255) {
-                MSTP_Slave_Node_FSM(mstp_port);
+            dlmstp_port_node_fsm(mstp_port);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Receive what a managed port has read, and run its state
+ *  machines for each frame, and when its timers expire
+ * @param mstp_port - port specific data
+ * @param wake_us - monotonic microseconds when the manager thread woke
+ * @return milliseconds until the state machines of the port need to run
+ */
+static uint32_t dlmstp_manager_port_run(
+    struct mstp_port_struct_t *mstp_port, uint64_t wake_us)
+{
+    SHARED_MSTP_DATA *poSharedData;
+    uint8_t event_count;
+    uint64_t due_us, now_us, latency_us;
+    uint32_t timeout;
+    unsigned passes;
+    bool received;
+
+    poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+    /* a few frames at a time, to be fair to the other ports */
+    for (passes = 0; passes < 4; passes++) {
+        event_count = mstp_port->EventCount;
+        RS485_Receive_Frame_Data(mstp_port, 0);
+        received = mstp_port->ReceivedValidFrame ||
+            mstp_port->ReceivedInvalidFrame ||
+            (mstp_port->EventCount != event_count);
+        if (received) {
+            due_us = wake_us;
+        } else if (dlmstp_port_timeout(mstp_port) == 0) {
+            due_us = poSharedData->Deadline_us;
+        } else {
+            break;
+        }
+        now_us = Timer_Now_us();
+        latency_us = (now_us > due_us) ? (now_us - due_us) : 0;
+        if (latency_us > UINT32_MAX) {
+            latency_us = UINT32_MAX;
+        }
+        poSharedData->Latency.count++;
+        poSharedData->Latency.total_us += latency_us;
+        if (latency_us > poSharedData->Latency.max_us) {
+            poSharedData->Latency.max_us = (uint32_t)latency_us;
+        }
+        dlmstp_port_node_fsm(mstp_port);
+        if (!received) {
+            break;
+        }
+    }
+    timeout = dlmstp_port_timeout(mstp_port);
+    poSharedData->Deadline_us = Timer_Now_us() + ((uint64_t)timeout * 1000);
+
+    return timeout;
+}
+
+/**
+ * @brief Drive the ports of a port manager thread, and wait until a port
+ *  is readable or the earliest timer of its ports expires
+ * @param pArg - port manager thread
+ * @return NULL
+ */
+static void *dlmstp_manager_task(void *pArg)
+{
+    struct dlmstp_manager_thread *manager =
+        (struct dlmstp_manager_thread *)pArg;
+    struct epoll_event events[DLMSTP_MANAGER_PORTS_MAX + 1];
+    uint64_t wake_us, value;
+    uint32_t timeout, wait_ms;
+    unsigned i;
+    int count;
+
+    for (;;) {
+        wake_us = Timer_Now_us();
+        wait_ms = Tno_token;
+        pthread_mutex_lock(&manager->mutex);
+        if (manager->stop) {
+            pthread_mutex_unlock(&manager->mutex);
+            break;
+        }
+        for (i = 0; i < manager->port_count; i++) {
+            timeout = dlmstp_manager_port_run(manager->ports[i], wake_us);
+            if (timeout < wait_ms) {
+                wait_ms = timeout;
+            }
+        }
+        pthread_mutex_unlock(&manager->mutex);
+        if (wait_ms == 0) {
+            /* a state machine is polling, such as for a reply */
+            wait_ms = 1;
+        }
+        count = epoll_wait(manager->epoll_fd, events,
+            DLMSTP_MANAGER_PORTS_MAX + 1, (int)wait_ms);
+        for (i = 0; (count > 0) && (i < (unsigned)count); i++) {
+            if (events[i].data.ptr == NULL) {
+                /* a port was added, or the thread is asked to exit */
+                (void)read(manager->event_fd, &value, sizeof(value));
             }
         }
     }
@@ -302,6 +673,197 @@ void *dlmstp_master_fsm_task(void *pArg)
     return NULL;
 }
 
+/**
+ * @brief Start the port manager, so that the ports initialized afterwards
+ *  are driven by a small pool of threads, each waiting for its ports to
+ *  be readable with epoll, instead of a thread for each port.
+ * @param threads - number of threads, up to DLMSTP_MANAGER_THREADS_MAX
+ * @return true if the threads were started
+ */
+bool dlmstp_manager_init(unsigned threads)
+{
+    struct dlmstp_manager_thread *manager;
+    struct epoll_event event = { 0 };
+    unsigned i;
+
+    if (Manager_Thread_Count > 0) {
+        return false;
+    }
+    if (threads == 0) {
+        threads = 1;
+    } else if (threads > DLMSTP_MANAGER_THREADS_MAX) {
+        threads = DLMSTP_MANAGER_THREADS_MAX;
+    }
+    for (i = 0; i < threads; i++) {
+        manager = &Manager_Threads[i];
+        manager->port_count = 0;
+        manager->stop = false;
+        manager->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        manager->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        event.events = EPOLLIN;
+        event.data.ptr = NULL;
+        if ((manager->epoll_fd < 0) || (manager->event_fd < 0) ||
+            (epoll_ctl(manager->epoll_fd, EPOLL_CTL_ADD, manager->event_fd,
+                 &event) != 0)) {
+            perror("MS/TP port manager");
+            if (manager->epoll_fd >= 0) {
+                close(manager->epoll_fd);
+            }
+            if (manager->event_fd >= 0) {
+                close(manager->event_fd);
+            }
+            break;
+        }
+        pthread_mutex_init(&manager->mutex, NULL);
+        if (pthread_create(&manager->thread, NULL, dlmstp_manager_task,
+                manager) != 0) {
+            fprintf(stderr, "Failed to start MS/TP port manager thread\n");
+            pthread_mutex_destroy(&manager->mutex);
+            close(manager->epoll_fd);
+            close(manager->event_fd);
+            break;
+        }
+        Manager_Thread_Count++;
+    }
+
+    return (Manager_Thread_Count > 0);
+}
+
+/**
+ * @brief Stop the port manager threads, after their ports are cleaned up.
+ *  The ports initialized afterwards each get their own thread.
+ */
+void dlmstp_manager_cleanup(void)
+{
+    struct dlmstp_manager_thread *manager;
+    uint64_t value = 1;
+    unsigned i;
+
+    for (i = 0; i < Manager_Thread_Count; i++) {
+        manager = &Manager_Threads[i];
+        pthread_mutex_lock(&manager->mutex);
+        manager->stop = true;
+        pthread_mutex_unlock(&manager->mutex);
+        (void)write(manager->event_fd, &value, sizeof(value));
+        pthread_join(manager->thread, NULL);
+        pthread_mutex_destroy(&manager->mutex);
+        close(manager->epoll_fd);
+        close(manager->event_fd);
+        manager->port_count = 0;
+    }
+    Manager_Thread_Count = 0;
+}
+
+/**
+ * @brief Add a port to the port manager thread with the fewest ports
+ * @param mstp_port - port specific data, with an open RS-485 handle
+ * @return true if the port was added
+ */
+static bool dlmstp_manager_port_add(struct mstp_port_struct_t *mstp_port)
+{
+    SHARED_MSTP_DATA *poSharedData;
+    struct dlmstp_manager_thread *manager = NULL;
+    struct epoll_event event = { 0 };
+    uint64_t value = 1;
+    bool status = false;
+    unsigned i;
+
+    poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+    for (i = 0; i < Manager_Thread_Count; i++) {
+        if (!manager ||
+            (Manager_Threads[i].port_count < manager->port_count)) {
+            manager = &Manager_Threads[i];
+        }
+    }
+    if (!manager) {
+        return false;
+    }
+    pthread_mutex_lock(&manager->mutex);
+    if (manager->port_count < DLMSTP_MANAGER_PORTS_MAX) {
+        event.events = EPOLLIN;
+        event.data.ptr = mstp_port;
+        if (epoll_ctl(manager->epoll_fd, EPOLL_CTL_ADD,
+                poSharedData->RS485_Handle, &event) == 0) {
+            poSharedData->Managed = true;
+            poSharedData->Deadline_us = Timer_Now_us();
+            manager->ports[manager->port_count] = mstp_port;
+            manager->port_count++;
+            status = true;
+        }
+    }
+    pthread_mutex_unlock(&manager->mutex);
+    if (status) {
+        (void)write(manager->event_fd, &value, sizeof(value));
+    }
+
+    return status;
+}
+
+/**
+ * @brief Remove a port from its port manager thread
+ * @param mstp_port - port specific data
+ */
+static void dlmstp_manager_port_remove(struct mstp_port_struct_t *mstp_port)
+{
+    SHARED_MSTP_DATA *poSharedData;
+    struct dlmstp_manager_thread *manager;
+    unsigned i, j;
+
+    poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+    for (i = 0; i < Manager_Thread_Count; i++) {
+        manager = &Manager_Threads[i];
+        pthread_mutex_lock(&manager->mutex);
+        for (j = 0; j < manager->port_count; j++) {
+            if (manager->ports[j] == mstp_port) {
+                (void)epoll_ctl(manager->epoll_fd, EPOLL_CTL_DEL,
+                    poSharedData->RS485_Handle, NULL);
+                manager->port_count--;
+                manager->ports[j] = manager->ports[manager->port_count];
+                poSharedData->Managed = false;
+                break;
+            }
+        }
+        pthread_mutex_unlock(&manager->mutex);
+    }
+}
+
+/**
+ * @brief Get the latency of running the state machines of a port
+ * @param poPort - MS/TP port with the shared data
+ * @param latency - filled with the latency statistics
+ */
+void dlmstp_port_latency(void *poPort, DLMSTP_PORT_LATENCY *latency)
+{
+    SHARED_MSTP_DATA *poSharedData;
+    struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
+    if (!mstp_port || !latency) {
+        return;
+    }
+    poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+    if (!poSharedData) {
+        return;
+    }
+    *latency = poSharedData->Latency;
+}
+
+/**
+ * @brief Reset the latency statistics of a port
+ * @param poPort - MS/TP port with the shared data
+ */
+void dlmstp_port_latency_reset(void *poPort)
+{
+    SHARED_MSTP_DATA *poSharedData;
+    struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
+    if (!mstp_port) {
+        return;
+    }
+    poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+    if (!poSharedData) {
+        return;
+    }
+    memset(&poSharedData->Latency, 0, sizeof(poSharedData->Latency));
+}
+
 void dlmstp_fill_bacnet_address(BACNET_ADDRESS *src, uint8_t mstp_address)
 {
     int i = 0;
@@ -329,37 +891,257 @@ void dlmstp_fill_bacnet_address(BACNET_ADDRESS *src, uint8_t mstp_address)
 uint16_t MSTP_Put_Receive(struct mstp_port_struct_t *mstp_port)
 {
     uint16_t pdu_len = 0;
+    DLMSTP_PACKET *pkt;
     SHARED_MSTP_DATA *poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
 
     if (!poSharedData) {
         return 0;
     }
 
-    if (!poSharedData->Receive_Packet.ready) {
+    if ((mstp_port->FrameType == FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY) ||
+        (mstp_port->FrameType ==
+            FRAME_TYPE_BACNET_EXTENDED_DATA_EXPECTING_REPLY)) {
+        /* remember the request, for matching its reply */
+        poSharedData->Reply_Request_Valid =
+            dlmstp_request_key_decode(&mstp_port->InputBuffer[0],
+                mstp_port->DataLength, mstp_port->SourceAddress,
+                &poSharedData->Reply_Request);
+    }
+    /* the MS/TP thread is the only producer, so no lock is needed */
+    pkt = (DLMSTP_PACKET *)Ringbuf_Data_Peek(&poSharedData->Receive_Queue);
+    if (pkt) {
         /* bounds check - maybe this should send an abort? */
         pdu_len = mstp_port->DataLength;
-        if (pdu_len > sizeof(poSharedData->Receive_Packet.pdu))
-            pdu_len = sizeof(poSharedData->Receive_Packet.pdu);
-        memmove((void *)&poSharedData->Receive_Packet.pdu[0],
-            (void *)&mstp_port->InputBuffer[0], pdu_len);
-        dlmstp_fill_bacnet_address(
-            &poSharedData->Receive_Packet.address, mstp_port->SourceAddress);
-        poSharedData->Receive_Packet.pdu_len = mstp_port->DataLength;
-        poSharedData->Receive_Packet.ready = true;
-        sem_post(&poSharedData->Receive_Packet_Flag);
+        if (pdu_len > sizeof(pkt->pdu)) {
+            pdu_len = sizeof(pkt->pdu);
+        }
+        memmove((void *)&pkt->pdu[0], (void *)&mstp_port->InputBuffer[0],
+            pdu_len);
+        dlmstp_fill_bacnet_address(&pkt->address, mstp_port->SourceAddress);
+        pkt->pdu_len = pdu_len;
+        pkt->ready = true;
+        if (Ringbuf_Data_Put(&poSharedData->Receive_Queue, (uint8_t *)pkt)) {
+            sem_post(&poSharedData->Receive_Packet_Flag);
+        } else {
+            pdu_len = 0;
+            poSharedData->Receive_Packet_Drops++;
+        }
+    } else {
+        /* the application has not kept up with the MS/TP thread */
+        poSharedData->Receive_Packet_Drops++;
     }
 
     return pdu_len;
 }
 
+/**
+ * @brief Get the most packets that waited in the receive queue
+ * @param poPort - MS/TP port with the shared data
+ * @return high-water mark of the receive queue
+ */
+unsigned dlmstp_receive_queue_high_water(void *poPort)
+{
+    SHARED_MSTP_DATA *poSharedData;
+    struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
+    if (!mstp_port) {
+        return 0;
+    }
+    poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+    if (!poSharedData) {
+        return 0;
+    }
+
+    return Ringbuf_Depth(&poSharedData->Receive_Queue);
+}
+
+/**
+ * @brief Get the number of received packets dropped because the
+ *  application did not empty the receive queue in time
+ * @param poPort - MS/TP port with the shared data
+ * @return number of dropped packets
+ */
+uint32_t dlmstp_receive_queue_drops(void *poPort)
+{
+    SHARED_MSTP_DATA *poSharedData;
+    struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
+    if (!mstp_port) {
+        return 0;
+    }
+    poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+    if (!poSharedData) {
+        return 0;
+    }
+
+    return poSharedData->Receive_Packet_Drops;
+}
+
+/**
+ * @brief Reset the high-water mark and drop count of the receive queue
+ * @param poPort - MS/TP port with the shared data
+ */
+void dlmstp_receive_queue_statistics_reset(void *poPort)
+{
+    SHARED_MSTP_DATA *poSharedData;
+    struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
+    if (!mstp_port) {
+        return;
+    }
+    poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+    if (!poSharedData) {
+        return;
+    }
+    (void)Ringbuf_Depth_Reset(&poSharedData->Receive_Queue);
+    poSharedData->Receive_Packet_Drops = 0;
+}
+
+/**
+ * @brief Take a sent packet from its transmit queue, and count it
+ * @param poSharedData - port specific data
+ * @param queue - queue that holds the packet
+ * @param pkt - queued packet
+ */
+static void dlmstp_transmit_packet_pop(SHARED_MSTP_DATA *poSharedData,
+    RING_BUFFER *queue,
+    struct mstp_pdu_packet *pkt)
+{
+    if (Ringbuf_Pop_Element(queue, (uint8_t *)pkt, NULL)) {
+        poSharedData->Transmit_Packet_Pops++;
+    }
+}
+
+/**
+ * @brief Give the packet of the last frame sent back to its queue, and
+ *  send from the port's own output buffer again.
+ * @param mstp_port - port specific data
+ */
+static void dlmstp_transmit_packet_release(
+    struct mstp_port_struct_t *mstp_port)
+{
+    SHARED_MSTP_DATA *poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+
+    if (poSharedData->Transmit_PDU) {
+        /* the state machine sent the frame before asking for another */
+        dlmstp_transmit_packet_pop(poSharedData,
+            poSharedData->Transmit_Queue, poSharedData->Transmit_PDU);
+        poSharedData->Transmit_PDU = NULL;
+        poSharedData->Transmit_Queue = NULL;
+    }
+    mstp_port->OutputBuffer = &poSharedData->TxBuffer[0];
+    mstp_port->OutputBufferSize = sizeof(poSharedData->TxBuffer);
+}
+
+/**
+ * @brief Build the frame of a queued packet, and lend the packet to the
+ *  port as its output buffer until the frame is sent.  The PDU is not
+ *  copied: the header and CRC are written around it.  A PDU too long
+ *  for a frame with no COBS encoding is encoded into the port's own
+ *  output buffer instead.
+ * @param mstp_port - port specific data
+ * @param queue - queue that holds the packet
+ * @param pkt - queued packet
+ * @return number of octets in the frame
+ */
+static uint16_t dlmstp_pdu_frame(struct mstp_port_struct_t *mstp_port,
+    RING_BUFFER *queue,
+    struct mstp_pdu_packet *pkt)
+{
+    SHARED_MSTP_DATA *poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+    uint16_t frame_len = 0;
+    uint8_t frame_type = 0;
+
+    if (pkt->data_expecting_reply) {
+        frame_type = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
+    } else {
+        frame_type = FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY;
+    }
+    if (pkt->length > MSTP_FRAME_NPDU_MAX) {
+        frame_len = MSTP_Create_Frame(mstp_port->OutputBuffer,
+            mstp_port->OutputBufferSize, frame_type, pkt->destination_mac,
+            mstp_port->This_Station, &pkt->frame[MSTP_FRAME_HEADER_LEN],
+            pkt->length);
+        dlmstp_transmit_packet_pop(poSharedData, queue, pkt);
+    } else {
+        frame_len = MSTP_Create_Frame(pkt->frame, sizeof(pkt->frame),
+            frame_type, pkt->destination_mac, mstp_port->This_Station,
+            &pkt->frame[MSTP_FRAME_HEADER_LEN], pkt->length);
+        mstp_port->OutputBuffer = pkt->frame;
+        mstp_port->OutputBufferSize = sizeof(pkt->frame);
+        poSharedData->Transmit_PDU = pkt;
+        poSharedData->Transmit_Queue = queue;
+    }
+
+    return frame_len;
+}
+
+/**
+ * @brief Get the most PDUs that waited in the transmit queues at once,
+ *  in the queues of each priority and the reply queue together
+ * @param poPort - MS/TP port with the shared data
+ * @return high-water mark of the transmit queues
+ */
+unsigned dlmstp_transmit_queue_high_water(void *poPort)
+{
+    SHARED_MSTP_DATA *poSharedData;
+    struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
+    if (!mstp_port) {
+        return 0;
+    }
+    poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+    if (!poSharedData) {
+        return 0;
+    }
+
+    return poSharedData->Transmit_Packet_High_Water;
+}
+
+/**
+ * @brief Get the number of PDUs dropped because a transmit queue was full
+ * @param poPort - MS/TP port with the shared data
+ * @return number of dropped PDUs
+ */
+uint32_t dlmstp_transmit_queue_drops(void *poPort)
+{
+    SHARED_MSTP_DATA *poSharedData;
+    struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
+    if (!mstp_port) {
+        return 0;
+    }
+    poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+    if (!poSharedData) {
+        return 0;
+    }
+
+    return poSharedData->Transmit_Packet_Drops;
+}
+
+/**
+ * @brief Reset the high-water marks and drop count of the transmit queues
+ * @param poPort - MS/TP port with the shared data
+ */
+void dlmstp_transmit_queue_statistics_reset(void *poPort)
+{
+    SHARED_MSTP_DATA *poSharedData;
+    struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
+    if (!mstp_port) {
+        return;
+    }
+    poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+    if (!poSharedData) {
+        return;
+    }
+    poSharedData->Transmit_Packet_High_Water = 0;
+    poSharedData->Transmit_Packet_Drops = 0;
+}
+
 /* for the MS/TP state machine to use for getting data to send */
 /* Return: amount of PDU data */
 uint16_t MSTP_Get_Send(
     struct mstp_port_struct_t *mstp_port, unsigned timeout)
 { /* milliseconds to wait for a packet */
     uint16_t pdu_len = 0;
-    uint8_t frame_type = 0;
     struct mstp_pdu_packet *pkt;
+    RING_BUFFER *queue = NULL;
+    int i;
     SHARED_MSTP_DATA *poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
 
     if (!poSharedData) {
@@ -367,21 +1149,26 @@ uint16_t MSTP_Get_Send(
     }
 
     (void)timeout;
-    if (Ringbuf_Empty(&poSharedData->PDU_Queue)) {
-        return 0;
+    dlmstp_transmit_packet_release(mstp_port);
+    /* life safety first, then critical equipment and urgent PDUs,
+       then the replies that missed their request, then normal PDUs */
+    for (i = MSTP_PDU_PRIORITY_QUEUES - 1; i >= 0; i--) {
+        if (!Ringbuf_Empty(&poSharedData->PDU_Priority_Queue[i])) {
+            queue = &poSharedData->PDU_Priority_Queue[i];
+            break;
+        }
     }
-    pkt = (struct mstp_pdu_packet *)Ringbuf_Peek(&poSharedData->PDU_Queue);
-    if (pkt->data_expecting_reply) {
-        frame_type = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
-    } else {
-        frame_type = FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY;
+    if (!queue && !Ringbuf_Empty(&poSharedData->Reply_Queue)) {
+        queue = &poSharedData->Reply_Queue;
     }
-    /* convert the PDU into the MSTP Frame */
-    pdu_len =
-        MSTP_Create_Frame(&mstp_port->OutputBuffer[0], /* <-- loading this */
-            mstp_port->OutputBufferSize, frame_type, pkt->destination_mac,
-            mstp_port->This_Station, (uint8_t *)&pkt->buffer[0], pkt->length);
-    (void)Ringbuf_Pop(&poSharedData->PDU_Queue, NULL);
+    if (!queue && !Ringbuf_Empty(&poSharedData->PDU_Queue)) {
+        queue = &poSharedData->PDU_Queue;
+    }
+    if (!queue) {
+        return 0;
+    }
+    pkt = (struct mstp_pdu_packet *)Ringbuf_Peek(queue);
+    pdu_len = dlmstp_pdu_frame(mstp_port, queue, pkt);
 
     return pdu_len;
 }
@@ -407,147 +1194,35 @@ bool dlmstp_compare_data_expecting_reply(uint8_t *request_pdu,
     uint16_t reply_pdu_len,
     uint8_t dest_address)
 {
-    uint16_t offset;
     /* One way to check the message is to compare NPDU
        src, dest, along with the APDU type, invoke id.
        Seems a bit overkill */
-    struct DER_compare_t {
-        BACNET_NPDU_DATA npdu_data;
-        BACNET_ADDRESS address;
-        uint8_t pdu_type;
-        uint8_t invoke_id;
-        uint8_t service_choice;
-    };
-    struct DER_compare_t request;
-    struct DER_compare_t reply;
-
-    /* unused parameters */
-    request_pdu_len = request_pdu_len;
-    reply_pdu_len = reply_pdu_len;
-    /* decode the request data */
-    request.address.mac[0] = src_address;
-    request.address.mac_len = 1;
-    offset = bacnet_npdu_decode(request_pdu, request_pdu_len, NULL,
-        &request.address, &request.npdu_data);
-    if (request.npdu_data.network_layer_message) {
-#if PRINT_ENABLED
-        fprintf(stderr,
-            "DLMSTP: DER Compare failed: "
-            "Request is Network message.\n");
-#endif
-        return false;
-    }
-    request.pdu_type = request_pdu[offset] & 0xF0;
-    if (request.pdu_type != PDU_TYPE_CONFIRMED_SERVICE_REQUEST) {
-#if PRINT_ENABLED
-        fprintf(stderr,
-            "DLMSTP: DER Compare failed: "
-            "Not Confirmed Request.\n");
-#endif
-        return false;
-    }
-    request.invoke_id = request_pdu[offset + 2];
-    /* segmented message? */
-    if (request_pdu[offset] & BIT(3)) {
-        request.service_choice = request_pdu[offset + 5];
-    } else {
-        request.service_choice = request_pdu[offset + 3];
-    }
-    /* decode the reply data */
-    reply.address.mac[0] = dest_address;
-    reply.address.mac_len = 1;
-    offset = bacnet_npdu_decode(
-        reply_pdu, reply_pdu_len, &reply.address, NULL, &reply.npdu_data);
-    if (reply.npdu_data.network_layer_message) {
+    struct dlmstp_reply_key request;
+    struct dlmstp_reply_key reply;
+
+    if (!dlmstp_request_key_decode(
+            request_pdu, request_pdu_len, src_address, &request)) {
 #if PRINT_ENABLED
         fprintf(stderr,
             "DLMSTP: DER Compare failed: "
-            "Reply is Network message.\n");
+            "Request is not a Confirmed Request.\n");
 #endif
         return false;
     }
-    /* reply could be a lot of things:
-       confirmed, simple ack, abort, reject, error */
-    reply.pdu_type = reply_pdu[offset] & 0xF0;
-    switch (reply.pdu_type) {
-        case PDU_TYPE_SIMPLE_ACK:
-            reply.invoke_id = reply_pdu[offset + 1];
-            reply.service_choice = reply_pdu[offset + 2];
-            break;
-        case PDU_TYPE_COMPLEX_ACK:
-            reply.invoke_id = reply_pdu[offset + 1];
-            /* segmented message? */
-            if (reply_pdu[offset] & BIT(3)) {
-                reply.service_choice = reply_pdu[offset + 4];
-            } else {
-                reply.service_choice = reply_pdu[offset + 2];
-            }
-            break;
-        case PDU_TYPE_ERROR:
-            reply.invoke_id = reply_pdu[offset + 1];
-            reply.service_choice = reply_pdu[offset + 2];
-            break;
-        case PDU_TYPE_REJECT:
-        case PDU_TYPE_ABORT:
-            reply.invoke_id = reply_pdu[offset + 1];
-            break;
-        default:
-            return false;
-    }
-    /* these don't have service choice included */
-    if ((reply.pdu_type == PDU_TYPE_REJECT) ||
-        (reply.pdu_type == PDU_TYPE_ABORT)) {
-        if (request.invoke_id != reply.invoke_id) {
-#if PRINT_ENABLED
-            fprintf(stderr,
-                "DLMSTP: DER Compare failed: "
-                "Invoke ID mismatch.\n");
-#endif
-            return false;
-        }
-    } else {
-        if (request.invoke_id != reply.invoke_id) {
-#if PRINT_ENABLED
-            fprintf(stderr,
-                "DLMSTP: DER Compare failed: "
-                "Invoke ID mismatch.\n");
-#endif
-            return false;
-        }
-        if (request.service_choice != reply.service_choice) {
-#if PRINT_ENABLED
-            fprintf(stderr,
-                "DLMSTP: DER Compare failed: "
-                "Service choice mismatch.\n");
-#endif
-            return false;
-        }
-    }
-    if (request.npdu_data.protocol_version !=
-        reply.npdu_data.protocol_version) {
+    if (!dlmstp_reply_key_decode(
+            reply_pdu, reply_pdu_len, dest_address, &reply)) {
 #if PRINT_ENABLED
         fprintf(stderr,
             "DLMSTP: DER Compare failed: "
-            "NPDU Protocol Version mismatch.\n");
-#endif
-        return false;
-    }
-#if 0
-    /* the NDPU priority doesn't get passed through the stack, and
-       all outgoing messages have NORMAL priority */
-    if (request.npdu_data.priority != reply.npdu_data.priority) {
-#if PRINT_ENABLED
-        fprintf(stderr,
-            "DLMSTP: DER Compare failed: " "NPDU Priority mismatch.\n");
+            "Reply is not a reply.\n");
 #endif
         return false;
     }
-#endif
-    if (!bacnet_address_same(&request.address, &reply.address)) {
+    if (!dlmstp_reply_key_match(&request, &reply)) {
 #if PRINT_ENABLED
         fprintf(stderr,
             "DLMSTP: DER Compare failed: "
-            "BACnet Address mismatch.\n");
+            "Reply does not match the Request.\n");
 #endif
         return false;
     }
@@ -560,8 +1235,6 @@ uint16_t MSTP_Get_Reply(
     struct mstp_port_struct_t *mstp_port, unsigned timeout)
 { /* milliseconds to wait for a packet */
     uint16_t pdu_len = 0; /* return value */
-    bool matched = false;
-    uint8_t frame_type = 0;
     struct mstp_pdu_packet *pkt;
     SHARED_MSTP_DATA *poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
 
@@ -569,41 +1242,27 @@ uint16_t MSTP_Get_Reply(
     if (!poSharedData) {
         return 0;
     }
-    if (Ringbuf_Empty(&poSharedData->PDU_Queue)) {
+    dlmstp_transmit_packet_release(mstp_port);
+    if (!poSharedData->Reply_Request_Valid) {
+        /* no reply could match, so it will be postponed */
         return 0;
     }
-    pkt = (struct mstp_pdu_packet *)Ringbuf_Peek(&poSharedData->PDU_Queue);
-    /* is this the reply to the DER? */
-    matched = dlmstp_compare_data_expecting_reply(&mstp_port->InputBuffer[0],
-        mstp_port->DataLength, mstp_port->SourceAddress,
-        (uint8_t *)&pkt->buffer[0], pkt->length, pkt->destination_mac);
-    if (!matched) {
-        /* Walk the rest of the ring buffer to see if we can find a match */
-        while (!matched &&
-            (pkt = (struct mstp_pdu_packet *)Ringbuf_Peek_Next(
-                 &poSharedData->PDU_Queue, (uint8_t *)pkt)) != NULL) {
-            matched = dlmstp_compare_data_expecting_reply(
-                &mstp_port->InputBuffer[0], mstp_port->DataLength,
-                mstp_port->SourceAddress, (uint8_t *)&pkt->buffer[0],
-                pkt->length, pkt->destination_mac);
-        }
-        if (!matched) {
-            /* Still didn't find a match so just bail out */
-            return 0;
-        }
+    /* only replies are in this queue, and their keys were decoded
+       when they were queued */
+    pkt = (struct mstp_pdu_packet *)Ringbuf_Peek(&poSharedData->Reply_Queue);
+    while (pkt &&
+        !dlmstp_reply_key_match(&poSharedData->Reply_Request,
+            &pkt->reply_key)) {
+        pkt = (struct mstp_pdu_packet *)Ringbuf_Peek_Next(
+            &poSharedData->Reply_Queue, (uint8_t *)pkt);
     }
-    if (pkt->data_expecting_reply) {
-        frame_type = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
-    } else {
-        frame_type = FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY;
+    if (!pkt) {
+        return 0;
     }
-    /* convert the PDU into the MSTP Frame */
-    pdu_len =
-        MSTP_Create_Frame(&mstp_port->OutputBuffer[0], /* <-- loading this */
-            mstp_port->OutputBufferSize, frame_type, pkt->destination_mac,
-            mstp_port->This_Station, (uint8_t *)&pkt->buffer[0], pkt->length);
-    /* This will pop the element no matter where we found it */
-    (void)Ringbuf_Pop_Element(&poSharedData->PDU_Queue, (uint8_t *)pkt, NULL);
+    /* the packet is popped once its frame is sent,
+       no matter where it was found */
+    pdu_len = dlmstp_pdu_frame(mstp_port, &poSharedData->Reply_Queue, pkt);
+    poSharedData->Reply_Request_Valid = false;
 
     return pdu_len;
 }
@@ -676,7 +1335,7 @@ void dlmstp_set_max_info_frames(void *poPort, uint8_t max_info_frames)
             }
     */
     if (max_info_frames >= 1) {
-        mstp_port->Nmax_info_frames = max_info_frames;
+        MSTP_Adaptive_Max_Info_Frames_Set(mstp_port, max_info_frames);
         /* FIXME: implement your data storage */
         /* I2C_Write_Byte(
            EEPROM_DEVICE_ADDRESS,
@@ -725,7 +1384,7 @@ void dlmstp_set_max_master(void *poPort, uint8_t max_master)
     */
     if (max_master <= 127) {
         if (mstp_port->This_Station <= max_master) {
-            mstp_port->Nmax_master = max_master;
+            MSTP_Adaptive_Max_Master_Set(mstp_port, max_master);
             /* FIXME: implement your data storage */
             /* I2C_Write_Byte(
                EEPROM_DEVICE_ADDRESS,
@@ -859,6 +1518,7 @@ bool dlmstp_init(void *poPort, char *ifname)
 {
     unsigned long hThread = 0;
     int rv = 0;
+    unsigned i;
     SHARED_MSTP_DATA *poSharedData;
     struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
     if (!mstp_port) {
@@ -875,9 +1535,28 @@ bool dlmstp_init(void *poPort, char *ifname)
     /* initialize PDU queue */
     Ringbuf_Init(&poSharedData->PDU_Queue, (uint8_t *)&poSharedData->PDU_Buffer,
         sizeof(struct mstp_pdu_packet), MSTP_PDU_PACKET_COUNT);
+    for (i = 0; i < MSTP_PDU_PRIORITY_QUEUES; i++) {
+        Ringbuf_Init(&poSharedData->PDU_Priority_Queue[i],
+            (uint8_t *)&poSharedData->PDU_Priority_Buffer[i],
+            sizeof(struct mstp_pdu_packet), MSTP_PDU_PRIORITY_PACKET_COUNT);
+    }
+    Ringbuf_Init(&poSharedData->Reply_Queue,
+        (uint8_t *)&poSharedData->Reply_Buffer, sizeof(struct mstp_pdu_packet),
+        MSTP_REPLY_PACKET_COUNT);
+    poSharedData->Reply_Request_Valid = false;
+    poSharedData->Transmit_Packet_Drops = 0;
+    poSharedData->Transmit_Packet_Puts = 0;
+    poSharedData->Transmit_Packet_Pops = 0;
+    poSharedData->Transmit_Packet_High_Water = 0;
+    poSharedData->Transmit_PDU = NULL;
+    poSharedData->Transmit_Queue = NULL;
+    poSharedData->Managed = false;
+    memset(&poSharedData->Latency, 0, sizeof(poSharedData->Latency));
     /* initialize packet queue */
-    poSharedData->Receive_Packet.ready = false;
-    poSharedData->Receive_Packet.pdu_len = 0;
+    Ringbuf_Init(&poSharedData->Receive_Queue,
+        (uint8_t *)&poSharedData->Receive_Buffer, sizeof(DLMSTP_PACKET),
+        MSTP_RECEIVE_PACKET_COUNT);
+    poSharedData->Receive_Packet_Drops = 0;
     rv = sem_init(&poSharedData->Receive_Packet_Flag, 0, 0);
     if (rv != 0) {
         fprintf(stderr,
@@ -937,9 +1616,10 @@ bool dlmstp_init(void *poPort, char *ifname)
     mstp_port->InputBufferSize = sizeof(poSharedData->RxBuffer);
     mstp_port->OutputBuffer = &poSharedData->TxBuffer[0];
     mstp_port->OutputBufferSize = sizeof(poSharedData->TxBuffer);
-    gettimeofday(&poSharedData->start, NULL);
+    Timer_Now(&poSharedData->start);
     mstp_port->SilenceTimer = Timer_Silence;
     mstp_port->SilenceTimerReset = Timer_Silence_Reset;
+    mstp_port->MillisecondTimer = Timer_Milliseconds;
     MSTP_Init(mstp_port);
 #if PRINT_ENABLED
     fprintf(stderr, "MS/TP MAC: %02X\n", mstp_port->This_Station);
@@ -947,9 +1627,14 @@ bool dlmstp_init(void *poPort, char *ifname)
     fprintf(stderr, "MS/TP Max_Info_Frames: %u\n", mstp_port->Nmax_info_frames);
 #endif
 
+    if ((Manager_Thread_Count > 0) && dlmstp_manager_port_add(mstp_port)) {
+        return true;
+    }
+    /* no port manager, or it is full: the port gets a thread of its own */
     rv = pthread_create(&hThread, NULL, dlmstp_master_fsm_task, mstp_port);
     if (rv != 0) {
         fprintf(stderr, "Failed to start Master Node FSM task\n");
+        return false;
     }
 
     return true;
@@ -48,6 +48,38 @@
 #ifndef MSTP_PDU_PACKET_COUNT
 #define MSTP_PDU_PACKET_COUNT 8
 #endif
+/* network priority PDUs are queued by priority: urgent, critical
+   equipment, and life safety; count must be a power of 2 for ringbuf */
+#define MSTP_PDU_PRIORITY_QUEUES 3
+#ifndef MSTP_PDU_PRIORITY_PACKET_COUNT
+#define MSTP_PDU_PRIORITY_PACKET_COUNT 4
+#endif
+/* replies to confirmed requests, waiting to answer a Data Expecting
+   Reply frame; count must be a power of 2 for ringbuf library */
+#ifndef MSTP_REPLY_PACKET_COUNT
+#define MSTP_REPLY_PACKET_COUNT 4
+#endif
+/* number of received packets queued for the application;
+   count must be a power of 2 for ringbuf library */
+#ifndef MSTP_RECEIVE_PACKET_COUNT
+#define MSTP_RECEIVE_PACKET_COUNT 8
+#endif
+
+/* most MS/TP ports, and threads to drive them, of the port manager */
+#ifndef DLMSTP_MANAGER_PORTS_MAX
+#define DLMSTP_MANAGER_PORTS_MAX 32
+#endif
+#ifndef DLMSTP_MANAGER_THREADS_MAX
+#define DLMSTP_MANAGER_THREADS_MAX 8
+#endif
+
+/* delay from a received frame or an expired timer until the
+   MS/TP state machines of a port run */
+typedef struct dlmstp_port_latency {
+    uint32_t count;
+    uint32_t max_us;
+    uint64_t total_us;
+} DLMSTP_PORT_LATENCY;
 
 typedef struct dlmstp_packet {
     bool ready; /* true if ready to be sent or received */
@@ -57,12 +89,25 @@ typedef struct dlmstp_packet {
     uint8_t pdu[DLMSTP_MPDU_MAX];      /* packet */
 } DLMSTP_PACKET;
 
-/* data structure for MS/TP PDU Queue */
+/* the parts of a confirmed request, or of a reply, that are compared
+   to match the reply to a Data Expecting Reply frame */
+struct dlmstp_reply_key {
+    BACNET_ADDRESS address;
+    uint8_t pdu_type;
+    uint8_t invoke_id;
+    uint8_t service_choice;
+    uint8_t protocol_version;
+};
+
+/* data structure for MS/TP PDU Queue: the PDU is written after room
+   for the frame header, so the frame is built around it in place */
 struct mstp_pdu_packet {
     bool data_expecting_reply;
+    /* decoded once when a reply is queued */
+    struct dlmstp_reply_key reply_key;
     uint8_t destination_mac;
     uint16_t length;
-    uint8_t buffer[DLMSTP_MPDU_MAX];
+    uint8_t frame[DLMSTP_MPDU_MAX];
 };
 
 typedef struct shared_mstp_data {
@@ -70,8 +115,14 @@ typedef struct shared_mstp_data {
     uint16_t MSTP_Packets;
 
     /* packet queues */
-    DLMSTP_PACKET Receive_Packet;
     DLMSTP_PACKET Transmit_Packet;
+    /* received packets, put by the MS/TP thread and
+       taken by the application thread */
+    RING_BUFFER Receive_Queue;
+    DLMSTP_PACKET Receive_Buffer[MSTP_RECEIVE_PACKET_COUNT];
+    /* number of received packets dropped because the queue was full */
+    uint32_t Receive_Packet_Drops;
+    /* counts the packets in the receive queue, to wake the application */
     /*
        RT_SEM Receive_Packet_Flag;
      */
@@ -107,11 +158,42 @@ typedef struct shared_mstp_data {
     FIFO_BUFFER Rx_FIFO;
     /* buffer size needs to be a power of 2 */
     uint8_t Rx_Buffer[4096];
+    /* start of the silence on the line, from the monotonic clock */
     struct timeval start;
+    /* true when the port is driven by the port manager */
+    bool Managed;
+    /* monotonic microseconds when the state machines next need to run */
+    uint64_t Deadline_us;
+    DLMSTP_PORT_LATENCY Latency;
 
     RING_BUFFER PDU_Queue;
 
     struct mstp_pdu_packet PDU_Buffer[MSTP_PDU_PACKET_COUNT];
+    /* PDUs of urgent, critical equipment, and life safety priority,
+       sent ahead of the normal PDU queue */
+    RING_BUFFER PDU_Priority_Queue[MSTP_PDU_PRIORITY_QUEUES];
+    struct mstp_pdu_packet PDU_Priority_Buffer[MSTP_PDU_PRIORITY_QUEUES]
+        [MSTP_PDU_PRIORITY_PACKET_COUNT];
+    /* replies to confirmed requests */
+    RING_BUFFER Reply_Queue;
+    struct mstp_pdu_packet Reply_Buffer[MSTP_REPLY_PACKET_COUNT];
+    /* number of PDUs dropped because their queue was full */
+    uint32_t Transmit_Packet_Drops;
+    /* PDUs put in the transmit queues by the application thread, and
+       taken from them by the MS/TP thread; each counter is written by
+       one thread, and their difference is the total depth */
+    uint32_t Transmit_Packet_Puts;
+    uint32_t Transmit_Packet_Pops;
+    /* the most PDUs that waited in all of the transmit queues at once */
+    unsigned Transmit_Packet_High_Water;
+    /* the packet whose frame is being sent from the output buffer,
+       and the queue it is taken from once the frame is sent */
+    struct mstp_pdu_packet *Transmit_PDU;
+    RING_BUFFER *Transmit_Queue;
+    /* the Data Expecting Reply frame being answered, decoded once
+       by the MS/TP thread when it is received */
+    bool Reply_Request_Valid;
+    struct dlmstp_reply_key Reply_Request;
 
 } SHARED_MSTP_DATA;
 
@@ -126,6 +208,22 @@ extern "C" {
     BACNET_STACK_EXPORT
     void dlmstp_reset(
         void *poShared);
+    /* ports initialized after the port manager is started are
+       driven by its threads instead of a thread per port */
+    BACNET_STACK_EXPORT
+    bool dlmstp_manager_init(
+        unsigned threads);
+    BACNET_STACK_EXPORT
+    void dlmstp_manager_cleanup(
+        void);
+    BACNET_STACK_EXPORT
+    void dlmstp_port_latency(
+        void *poShared,
+        DLMSTP_PORT_LATENCY * latency);
+    BACNET_STACK_EXPORT
+    void dlmstp_port_latency_reset(
+        void *poShared);
+
     BACNET_STACK_EXPORT
     void dlmstp_cleanup(
         void *poShared);
@@ -201,11 +299,48 @@ extern "C" {
     uint32_t dlmstp_baud_rate(
         void *poShared);
 
+    /* receive queue statistics */
+    BACNET_STACK_EXPORT
+    unsigned dlmstp_receive_queue_high_water(
+        void *poShared);
+    BACNET_STACK_EXPORT
+    uint32_t dlmstp_receive_queue_drops(
+        void *poShared);
+    BACNET_STACK_EXPORT
+    void dlmstp_receive_queue_statistics_reset(
+        void *poShared);
+    /* transmit queue statistics; frame and timing counters of the
+       port are read with MSTP_Statistics() */
+    BACNET_STACK_EXPORT
+    unsigned dlmstp_transmit_queue_high_water(
+        void *poShared);
+    BACNET_STACK_EXPORT
+    uint32_t dlmstp_transmit_queue_drops(
+        void *poShared);
+    BACNET_STACK_EXPORT
+    void dlmstp_transmit_queue_statistics_reset(
+        void *poShared);
+
     BACNET_STACK_EXPORT
     void dlmstp_fill_bacnet_address(
         BACNET_ADDRESS * src,
         uint8_t mstp_address);
 
+    /* milliseconds until the state machines of the port need to run */
+    BACNET_STACK_EXPORT
+    uint32_t dlmstp_port_timeout(
+        void *poPort);
+
+    /* true if the reply answers the Data Expecting Reply request */
+    BACNET_STACK_EXPORT
+    bool dlmstp_compare_data_expecting_reply(
+        uint8_t * request_pdu,
+        uint16_t request_pdu_len,
+        uint8_t src_address,
+        uint8_t * reply_pdu,
+        uint16_t reply_pdu_len,
+        uint8_t dest_address);
+
     BACNET_STACK_EXPORT
     bool dlmstp_sole_master(
         void);
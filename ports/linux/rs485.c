@@ -69,6 +69,7 @@
 
 #include <sys/select.h>
 #include <sys/time.h>
+#include <time.h>
 
 #include "dlmstp_linux.h"
 
@@ -375,6 +376,27 @@ bool RS485_Set_Baud_Rate(uint32_t baud)
     return valid;
 }
 
+/****************************************************************************
+ * DESCRIPTION: Start the silence of a port after a delay
+ * RETURN:      none
+ * ALGORITHM:   none
+ * NOTES:       the silence timer of the multi-port datalink uses the
+ *              monotonic clock
+ *****************************************************************************/
+static void RS485_Silence_Reset_Delay(
+    SHARED_MSTP_DATA *poSharedData, uint32_t microseconds)
+{
+    struct timespec now;
+    struct timeval delay;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    poSharedData->start.tv_sec = now.tv_sec;
+    poSharedData->start.tv_usec = now.tv_nsec / 1000;
+    delay.tv_sec = microseconds / 1000000;
+    delay.tv_usec = microseconds % 1000000;
+    timeradd(&poSharedData->start, &delay, &poSharedData->start);
+}
+
 /****************************************************************************
  * DESCRIPTION: Transmit a frame on the wire
  * RETURN:      none
@@ -438,6 +460,13 @@ void RS485_Send_Frame(
         greska = errno;
         if (written <= 0) {
             printf("write error: %s\n", strerror(greska));
+        } else if (poSharedData->Managed && (baud > 0)) {
+            /* the port manager thread drives other ports while the
+               frame is transmitted, so the silence starts after the
+               time of ten bits for each octet written */
+            RS485_Silence_Reset_Delay(poSharedData,
+                (uint32_t)(((uint64_t)written * 10ULL * 1000000ULL) / baud));
+            return;
         } else {
             /* wait until all output has been transmitted. */
             tcdrain(poSharedData->RS485_Handle);
@@ -453,82 +482,127 @@ void RS485_Send_Frame(
 }
 
 /****************************************************************************
- * DESCRIPTION: Get a byte of receive data
+ * DESCRIPTION: Get the handle and receive FIFO of a port
  * RETURN:      none
  * ALGORITHM:   none
+ * NOTES:       the single port of this module when there is no shared data
+ *****************************************************************************/
+static void RS485_Port_Receive(
+    struct mstp_port_struct_t *mstp_port, int *handle, FIFO_BUFFER **fifo)
+{
+    SHARED_MSTP_DATA *poSharedData = NULL;
+
+    if (mstp_port) {
+        poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+    }
+    if (poSharedData) {
+        *handle = poSharedData->RS485_Handle;
+        *fifo = &poSharedData->Rx_FIFO;
+    } else {
+        *handle = RS485_Handle;
+        *fifo = &Rx_FIFO;
+    }
+}
+
+/****************************************************************************
+ * DESCRIPTION: Wait for the port to be readable, and read what is there
+ * RETURN:      none
+ * ALGORITHM:   one select() and one read() for a block of received data
  * NOTES:       none
  *****************************************************************************/
-void RS485_Check_UART_Data(struct mstp_port_struct_t *mstp_port)
+static void RS485_Read_Data(int handle, FIFO_BUFFER *fifo, unsigned timeout_ms)
 {
     fd_set input;
     struct timeval waiter;
     uint8_t buf[2048];
-    int n;
-
-    SHARED_MSTP_DATA *poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
-    if (!poSharedData) {
-        if (mstp_port->ReceiveError == true) {
-            /* do nothing but wait for state machine to clear the error */
-            /* burning time, so wait a longer time */
-            waiter.tv_sec = 0;
-            waiter.tv_usec = 5000;
-        } else if (mstp_port->DataAvailable == false) {
-            /* wait for state machine to read from the DataRegister */
-            if (FIFO_Count(&Rx_FIFO) > 0) {
-                /* data is available */
-                mstp_port->DataRegister = FIFO_Get(&Rx_FIFO);
-                mstp_port->DataAvailable = true;
-                /* FIFO is giving data - just poll */
-                waiter.tv_sec = 0;
-                waiter.tv_usec = 0;
-            } else {
-                /* FIFO is empty - wait a longer time */
-                waiter.tv_sec = 0;
-                waiter.tv_usec = 5000;
-            }
-        }
-        /* grab bytes and stuff them into the FIFO every time */
-        FD_ZERO(&input);
-        FD_SET(RS485_Handle, &input);
-        n = select(RS485_Handle + 1, &input, NULL, NULL, &waiter);
-        if (n < 0) {
-            return;
+    unsigned available;
+    ssize_t n;
+
+    waiter.tv_sec = timeout_ms / 1000;
+    waiter.tv_usec = (timeout_ms % 1000) * 1000;
+    FD_ZERO(&input);
+    FD_SET(handle, &input);
+    if (select(handle + 1, &input, NULL, NULL, &waiter) <= 0) {
+        return;
+    }
+    if (FD_ISSET(handle, &input)) {
+        available = fifo->buffer_len - FIFO_Count(fifo);
+        if (available > sizeof(buf)) {
+            available = sizeof(buf);
         }
-        if (FD_ISSET(RS485_Handle, &input)) {
-            n = read(RS485_Handle, buf, sizeof(buf));
-            FIFO_Add(&Rx_FIFO, &buf[0], n);
+        n = read(handle, buf, available);
+        if (n > 0) {
+            FIFO_Add(fifo, &buf[0], (unsigned)n);
         }
-    } else {
-        if (mstp_port->ReceiveError == true) {
-            /* do nothing but wait for state machine to clear the error */
-            /* burning time, so wait a longer time */
-            waiter.tv_sec = 0;
-            waiter.tv_usec = 5000;
-        } else if (mstp_port->DataAvailable == false) {
-            /* wait for state machine to read from the DataRegister */
-            if (FIFO_Count(&poSharedData->Rx_FIFO) > 0) {
-                /* data is available */
-                mstp_port->DataRegister = FIFO_Get(&poSharedData->Rx_FIFO);
-                mstp_port->DataAvailable = true;
-                /* FIFO is giving data - just poll */
-                waiter.tv_sec = 0;
-                waiter.tv_usec = 0;
-            } else {
-                /* FIFO is empty - wait a longer time */
-                waiter.tv_sec = 0;
-                waiter.tv_usec = 5000;
-            }
+    }
+}
+
+/****************************************************************************
+ * DESCRIPTION: Get a byte of receive data
+ * RETURN:      none
+ * ALGORITHM:   none
+ * NOTES:       the port is only read when the FIFO is empty
+ *****************************************************************************/
+void RS485_Check_UART_Data(struct mstp_port_struct_t *mstp_port)
+{
+    FIFO_BUFFER *fifo;
+    int handle;
+
+    RS485_Port_Receive(mstp_port, &handle, &fifo);
+    if (mstp_port->ReceiveError == true) {
+        /* do nothing but wait for state machine to clear the error */
+        /* burning time, so wait a longer time */
+        RS485_Read_Data(handle, fifo, 5);
+    } else if (mstp_port->DataAvailable == false) {
+        if (FIFO_Empty(fifo)) {
+            /* FIFO is empty - wait for data */
+            RS485_Read_Data(handle, fifo, 5);
         }
-        /* grab bytes and stuff them into the FIFO every time */
-        FD_ZERO(&input);
-        FD_SET(poSharedData->RS485_Handle, &input);
-        n = select(poSharedData->RS485_Handle + 1, &input, NULL, NULL, &waiter);
-        if (n < 0) {
-            return;
+        /* wait for state machine to read from the DataRegister */
+        if (!FIFO_Empty(fifo)) {
+            mstp_port->DataRegister = FIFO_Get(fifo);
+            mstp_port->DataAvailable = true;
         }
-        if (FD_ISSET(poSharedData->RS485_Handle, &input)) {
-            n = read(poSharedData->RS485_Handle, buf, sizeof(buf));
-            FIFO_Add(&poSharedData->Rx_FIFO, &buf[0], n);
+    }
+}
+
+/****************************************************************************
+ * DESCRIPTION: Receive data and run the receive state machine over it
+ * RETURN:      none
+ * ALGORITHM:   blocks of data from the FIFO are fed to the receive FSM
+ * NOTES:       waits for the port to be readable only when the FIFO is
+ *              empty, and stops at the end of a frame, so that the octets
+ *              after it stay in the FIFO until the frame is handled.
+ *****************************************************************************/
+void RS485_Receive_Frame_Data(
+    struct mstp_port_struct_t *mstp_port, unsigned timeout_ms)
+{
+    uint8_t buf[512];
+    FIFO_BUFFER *fifo;
+    unsigned count;
+    uint16_t used;
+    int handle;
+
+    if (!mstp_port || mstp_port->ReceivedValidFrame ||
+        mstp_port->ReceivedInvalidFrame) {
+        return;
+    }
+    RS485_Port_Receive(mstp_port, &handle, &fifo);
+    if (FIFO_Empty(fifo)) {
+        RS485_Read_Data(handle, fifo, timeout_ms);
+    }
+    if (FIFO_Empty(fifo)) {
+        /* no data - let the state machine check its timeouts */
+        MSTP_Receive_Frame_FSM(mstp_port);
+        return;
+    }
+    while (!FIFO_Empty(fifo) && !mstp_port->ReceivedValidFrame &&
+        !mstp_port->ReceivedInvalidFrame) {
+        count = FIFO_Peek_Data(fifo, buf, sizeof(buf));
+        used = MSTP_Receive_Frame_Data(mstp_port, buf, (uint16_t)count);
+        FIFO_Pull(fifo, NULL, used);
+        if (used == 0) {
+            break;
         }
     }
 }
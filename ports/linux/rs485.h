@@ -39,6 +39,11 @@
 #include <stdint.h>
 #include "bacnet/datalink/mstp.h"
 
+/* milliseconds to wait for received data when there is none */
+#ifndef RS485_RECEIVE_WAIT_MS
+#define RS485_RECEIVE_WAIT_MS 5
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -64,6 +69,10 @@ extern "C" {
     void RS485_Check_UART_Data(
         struct mstp_port_struct_t *mstp_port); /* port specific data */
     BACNET_STACK_EXPORT
+    void RS485_Receive_Frame_Data(
+        struct mstp_port_struct_t *mstp_port, /* port specific data */
+        unsigned timeout_ms); /* time to wait for data */
+    BACNET_STACK_EXPORT
     uint32_t RS485_Get_Port_Baud_Rate(
         struct mstp_port_struct_t *mstp_port);
     BACNET_STACK_EXPORT
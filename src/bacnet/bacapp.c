@@ -1279,6 +1279,15 @@ static int decode_priority_value(uint8_t *apdu,
 #endif
 
 #if defined(BACAPP_COMPLEX_TYPES)
+/**
+ * @brief Determine the datatype of a well-known, complex property value.
+ *  This is the one mapping from property to complex datatype, and the
+ *  dense switch compiles into a constant-indexed jump table.
+ * @param object_type - object type of the property
+ * @param property - property identifier
+ * @return application tag used to decode the property value,
+ *  or -1 if the property value uses a simple application datatype
+ */
 int bacapp_known_property_tag(
     BACNET_OBJECT_TYPE object_type, BACNET_PROPERTY_ID property)
 {
@@ -1430,200 +1439,29 @@ int bacapp_decode_known_property(uint8_t *apdu,
     BACNET_OBJECT_TYPE object_type,
     BACNET_PROPERTY_ID property)
 {
-    int len = 0;
-
-    /* NOTE: */
-    /*   When adding impl for a new prop, also add its tag */
-    /*   to bacapp_known_property_tag() */
-
-    int tag = bacapp_known_property_tag(object_type, property);
-    if (tag != -1) {
-        value->tag = tag;
-    }
-
-    switch (property) {
-        case PROP_MEMBER_OF:
-        case PROP_ZONE_MEMBERS:
-        case PROP_DOOR_MEMBERS:
-        case PROP_SUBORDINATE_LIST:
-        case PROP_ACCESS_EVENT_CREDENTIAL:
-        case PROP_ACCESS_DOORS:
-        case PROP_ZONE_FROM:
-        case PROP_ZONE_TO:
-        case PROP_CREDENTIALS_IN_ZONE:
-        case PROP_LAST_CREDENTIAL_ADDED:
-        case PROP_LAST_CREDENTIAL_REMOVED:
-        case PROP_ENTRY_POINTS:
-        case PROP_EXIT_POINTS:
-        case PROP_MEMBERS:
-        case PROP_CREDENTIALS:
-        case PROP_ACCOMPANIMENT:
-        case PROP_BELONGS_TO:
-        case PROP_LAST_ACCESS_POINT:
-#ifdef BACAPP_DEVICE_OBJECT_REFERENCE
-            /* Properties using BACnetDeviceObjectReference */
-            len = bacapp_decode_device_obj_ref(
-                apdu, &value->type.Device_Object_Reference);
-#endif
-            break;
-
-        case PROP_TIME_OF_ACTIVE_TIME_RESET:
-        case PROP_TIME_OF_STATE_COUNT_RESET:
-        case PROP_CHANGE_OF_STATE_TIME:
-        case PROP_MAXIMUM_VALUE_TIMESTAMP:
-        case PROP_MINIMUM_VALUE_TIMESTAMP:
-        case PROP_VALUE_CHANGE_TIME:
-        case PROP_START_TIME:
-        case PROP_STOP_TIME:
-        case PROP_MODIFICATION_DATE:
-        case PROP_UPDATE_TIME:
-        case PROP_COUNT_CHANGE_TIME:
-        case PROP_LAST_CREDENTIAL_ADDED_TIME:
-        case PROP_LAST_CREDENTIAL_REMOVED_TIME:
-        case PROP_ACTIVATION_TIME:
-        case PROP_EXPIRATION_TIME:
-        case PROP_LAST_USE_TIME:
-#ifdef BACAPP_DATETIME
-            /* Properties using BACnetDateTime value */
-            len = bacnet_datetime_decode(
-                apdu, max_apdu_len, &value->type.Date_Time);
-#endif
-            break;
-
-        case PROP_OBJECT_PROPERTY_REFERENCE:
-        case PROP_LOG_DEVICE_OBJECT_PROPERTY:
-        case PROP_LIST_OF_OBJECT_PROPERTY_REFERENCES:
-#ifdef BACAPP_DEVICE_OBJECT_PROPERTY_REFERENCE
-            /* Properties using BACnetDeviceObjectPropertyReference */
-            len = bacnet_device_object_property_reference_decode(apdu,
-                max_apdu_len, &value->type.Device_Object_Property_Reference);
-#endif
-            break;
-
-        case PROP_MANIPULATED_VARIABLE_REFERENCE:
-        case PROP_CONTROLLED_VARIABLE_REFERENCE:
-        case PROP_INPUT_REFERENCE:
-#ifdef BACAPP_OBJECT_PROPERTY_REFERENCE
-            /* Properties using BACnetObjectPropertyReference */
-            len = bacapp_decode_obj_property_ref(
-                apdu, max_apdu_len, &value->type.Object_Property_Reference);
-#endif
-            break;
-
-        case PROP_EVENT_TIME_STAMPS:
-        case PROP_LAST_RESTORE_TIME:
-        case PROP_TIME_OF_DEVICE_RESTART:
-        case PROP_ACCESS_EVENT_TIME:
-#ifdef BACAPP_TIMESTAMP
-            /* Properties using BACnetTimeStamp */
-            len = bacnet_timestamp_decode(
-                apdu, max_apdu_len, &value->type.Time_Stamp);
-#endif
-            break;
-
-        case PROP_DEFAULT_COLOR:
-#ifdef BACAPP_XY_COLOR
-            /* Properties using BACnetxyColor */
-            len = xy_color_decode(apdu, max_apdu_len, &value->type.XY_Color);
-#endif
-            break;
-        case PROP_TRACKING_VALUE:
-        case PROP_PRESENT_VALUE:
-            if (object_type == OBJECT_COLOR) {
-#ifdef BACAPP_XY_COLOR
-                /* Properties using BACnetxyColor */
-                len =
-                    xy_color_decode(apdu, max_apdu_len, &value->type.XY_Color);
-#endif
-            } else {
-                /* Decode a "classic" simple property */
-                len = bacapp_decode_generic_property(
-                    apdu, max_apdu_len, value, property);
-            }
-            break;
-
-        case PROP_COLOR_COMMAND:
-#ifdef BACAPP_COLOR_COMMAND
-            /* Properties using BACnetColorCommand */
-            len = color_command_decode(
-                apdu, max_apdu_len, NULL, &value->type.Color_Command);
-#endif
-            break;
-
-        case PROP_LIGHTING_COMMAND:
-#ifdef BACAPP_LIGHTING_COMMAND
-            /* Properties using BACnetLightingCommand */
-            len = lighting_command_decode(
-                apdu, max_apdu_len, &value->type.Lighting_Command);
-#endif
-            break;
-
-        case PROP_PRIORITY_ARRAY:
-            /* [16] BACnetPriorityValue : 16x values (simple property) */
-            len = decode_priority_value(apdu, max_apdu_len, value, property);
-            break;
-
-        case PROP_WEEKLY_SCHEDULE:
-#ifdef BACAPP_WEEKLY_SCHEDULE
-            /* BACnetWeeklySchedule ([7] BACnetDailySchedule*/
-            len = bacnet_weeklyschedule_decode(
-                apdu, max_apdu_len, &value->type.Weekly_Schedule);
-#endif
-            break;
-
-        case PROP_RECIPIENT_LIST:
-#ifdef BACAPP_DESTINATION
-            len = bacnet_destination_decode(
-                apdu, max_apdu_len, &value->type.Destination);
-#endif
-            break;
-
-        case PROP_DATE_LIST:
-#ifdef BACAPP_CALENDAR_ENTRY
-            /* List of BACnetCalendarEntry */
-            len = bacnet_calendar_entry_decode(
-                apdu, max_apdu_len, &value->type.Calendar_Entry);
-#endif
-            break;
-
-        case PROP_EXCEPTION_SCHEDULE:
-#ifdef BACAPP_SPECIAL_EVENT
-            /* List of BACnetSpecialEvent (Schedule) */
-            len = bacnet_special_event_decode(
-                apdu, max_apdu_len, &value->type.Special_Event);
-#endif
-            break;
-
-        case PROP_EFFECTIVE_PERIOD:
-#ifdef BACAPP_DATERANGE
-            /* BACnetDateRange  (Schedule) */
-            len = bacnet_daterange_decode(
-                apdu, max_apdu_len, &value->type.Date_Range);
-#endif
-            break;
-
-            /* properties without a specific decoder - fall through to default
-             */
-
-        case PROP_LIST_OF_GROUP_MEMBERS:
-            /* Properties using ReadAccessSpecification */
-        case PROP_ACTIVE_COV_SUBSCRIPTIONS:
-            /* FIXME: BACnetCOVSubscription */
-        case PROP_TIME_SYNCHRONIZATION_RECIPIENTS:
-        case PROP_RESTART_NOTIFICATION_RECIPIENTS:
-        case PROP_UTC_TIME_SYNCHRONIZATION_RECIPIENTS:
-            /* FIXME: Properties using BACnetRecipient */
-        case PROP_DEVICE_ADDRESS_BINDING:
-        case PROP_MANUAL_SLAVE_ADDRESS_BINDING:
-        case PROP_SLAVE_ADDRESS_BINDING:
-            /* FIXME: BACnetAddressBinding */
-        case PROP_SCALE:
-        case PROP_ACTION:
-        default:
-            /* Decode a "classic" simple property */
-            len = bacapp_decode_generic_property(
-                apdu, max_apdu_len, value, property);
-            break;
+    int tag;
+    int len;
+
+    if (property == PROP_PRIORITY_ARRAY) {
+        /* [16] BACnetPriorityValue : 16x values (simple property) */
+        return decode_priority_value(apdu, max_apdu_len, value, property);
+    }
+    /* NOTE: When adding a new complex datatype, add the property
+       to bacapp_known_property_tag() and its decoder to
+       bacapp_data_decode() */
+    tag = bacapp_known_property_tag(object_type, property);
+    if (tag == -1) {
+        /* Decode a "classic" simple property */
+        return bacapp_decode_generic_property(
+            apdu, max_apdu_len, value, property);
+    }
+    value->tag = (uint8_t)tag;
+    len = bacapp_data_decode(
+        apdu, (uint32_t)max_apdu_len, (uint8_t)tag, 0, value);
+    if (len == 0) {
+        /* nothing decoded, such as an empty list: the value keeps
+           the datatype of the property */
+        value->tag = (uint8_t)tag;
     }
 
     return len;
@@ -4119,21 +4119,20 @@ int bacnet_array_encode(uint32_t object_instance,
         }
     } else if (array_index == BACNET_ARRAY_ALL) {
         /* if no index was specified, then try to encode the entire list */
-        /* into one packet. */
+        /* into one packet, in a single pass over the elements, stopping
+           at the first element that does not fit. */
         for (index = 0; index < array_size; index++) {
-            len += encoder(object_instance, index, NULL);
-        }
-        if (len > max_apdu) {
-            /* encoded size is larger than APDU size */
-            apdu_len = BACNET_STATUS_ABORT;
-        } else {
-            for (index = 0; index < array_size; index++) {
+            len = encoder(object_instance, index, NULL);
+            if ((apdu_len + len) > max_apdu) {
+                /* encoded size is larger than APDU size */
+                apdu_len = BACNET_STATUS_ABORT;
+                break;
+            }
+            if (apdu) {
                 len = encoder(object_instance, index, apdu);
-                if (apdu) {
-                    apdu += len;
-                }
-                apdu_len += len;
+                apdu += len;
             }
+            apdu_len += len;
         }
     } else if (array_index <= array_size) {
         /* index was specified; encode a single array element */
@@ -0,0 +1,1661 @@
+/**
+ * @file
+ * @brief A streaming JSON and CSV writer of BACnet application data values
+ * for bulk export, and a parser of the JSON values it writes.
+ *
+ * The writer appends to a caller buffer without allocating memory, formats
+ * numbers without the printf family, and finds enumeration names through
+ * the bactext lookup tables.  A record that does not fit is removed from
+ * the buffer, so the caller can flush the buffer and write it again.
+ *
+ * Values are written as JSON: null, true and false, numbers, strings,
+ * octet strings as hex strings, bit strings as arrays of booleans, dates
+ * as "2024-04-01", times as "13:45:30.00", object identifiers as
+ * "analog-input:1", and enumerations of well known properties by name.
+ * A '*' marks an unspecified date or time field, and REAL or DOUBLE
+ * values that are not finite are written as null.  Other complex values
+ * are written as the string from bacapp_snprintf_value().
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/bacstr.h"
+#include "bacnet/bactext.h"
+#include "bacnet/datetime.h"
+/* me! */
+#include "bacnet/bacjson.h"
+
+/* size of the text of a complex value written as a string */
+#ifndef BACJSON_TEXT_SIZE
+#define BACJSON_TEXT_SIZE 256
+#endif
+/* longest enumeration or object type name that is parsed */
+#define BACJSON_NAME_SIZE 64
+
+static const char Hex_Digits[] = "0123456789ABCDEF";
+/* powers of ten that are exact in a double */
+static const double Exact_Powers_Of_Ten[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5,
+    1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+    1e18, 1e19, 1e20, 1e21, 1e22 };
+#define BACJSON_EXACT_POWER_MAX 22
+
+/**
+ * @brief Initialize a writer with a caller buffer
+ * @param writer - writer to initialize
+ * @param buffer - buffer for the text
+ * @param size - size of the buffer, including the null terminator
+ */
+void bacjson_writer_init(BACJSON_WRITER *writer, char *buffer, size_t size)
+{
+    if (writer) {
+        writer->buffer = buffer;
+        writer->size = buffer ? size : 0;
+        writer->length = 0;
+        if (writer->size) {
+            buffer[0] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Remove all the text from the writer, after it was flushed
+ * @param writer - writer to reset
+ */
+void bacjson_writer_reset(BACJSON_WRITER *writer)
+{
+    if (writer) {
+        writer->length = 0;
+        if (writer->size) {
+            writer->buffer[0] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Get the length of the text in the writer
+ * @param writer - writer
+ * @return number of characters, excluding the null terminator
+ */
+size_t bacjson_writer_length(BACJSON_WRITER const *writer)
+{
+    return writer ? writer->length : 0;
+}
+
+/**
+ * @brief Remove the text written after a length
+ * @param writer - writer
+ * @param length - length of the text to keep
+ */
+static void bacjson_rollback(BACJSON_WRITER *writer, size_t length)
+{
+    writer->length = length;
+    if (writer->size) {
+        writer->buffer[length] = 0;
+    }
+}
+
+/**
+ * @brief Append text to the writer
+ * @param writer - writer
+ * @param text - text to append
+ * @param len - number of characters to append
+ * @return true if the text fit in the buffer
+ */
+static bool bacjson_write(BACJSON_WRITER *writer, const char *text, size_t len)
+{
+    if (len >= (writer->size - writer->length)) {
+        return false;
+    }
+    memcpy(&writer->buffer[writer->length], text, len);
+    writer->length += len;
+    writer->buffer[writer->length] = 0;
+
+    return true;
+}
+
+/**
+ * @brief Append a null terminated string to the writer
+ * @param writer - writer
+ * @param text - text to append
+ * @return true if the text fit in the buffer
+ */
+static bool bacjson_write_string(BACJSON_WRITER *writer, const char *text)
+{
+    return bacjson_write(writer, text, strlen(text));
+}
+
+/**
+ * @brief Append an unsigned number, zero padded to a width
+ * @param writer - writer
+ * @param value - number to append
+ * @param width - smallest number of digits
+ * @return true if the text fit in the buffer
+ */
+static bool bacjson_write_digits(
+    BACJSON_WRITER *writer, BACNET_UNSIGNED_INTEGER value, unsigned width)
+{
+    char text[24];
+    size_t i = sizeof(text);
+
+    do {
+        text[--i] = (char)('0' + (value % 10));
+        value /= 10;
+    } while (value || ((sizeof(text) - i) < width));
+
+    return bacjson_write(writer, &text[i], sizeof(text) - i);
+}
+
+/**
+ * @brief Append a signed number
+ * @param writer - writer
+ * @param value - number to append
+ * @return true if the text fit in the buffer
+ */
+static bool bacjson_write_signed(BACJSON_WRITER *writer, int32_t value)
+{
+    if (value < 0) {
+        return bacjson_write(writer, "-", 1) &&
+            bacjson_write_digits(writer,
+                (BACNET_UNSIGNED_INTEGER)(-(value + 1)) + 1, 1);
+    }
+
+    return bacjson_write_digits(writer, (BACNET_UNSIGNED_INTEGER)value, 1);
+}
+
+/**
+ * @brief Append a floating point number with a number of significant
+ *  digits.  Numbers that are exact with at most BACJSON_DECIMALS_MAX
+ *  decimals are written without printf; the others, and very large and
+ *  very small magnitudes, are written with the %g format.
+ * @param writer - writer
+ * @param value - number to append
+ * @param digits - number of significant digits
+ * @return true if the text fit in the buffer
+ */
+static bool bacjson_write_real(
+    BACJSON_WRITER *writer, double value, unsigned digits)
+{
+    static const uint32_t decimal_scale[BACJSON_DECIMALS_MAX + 1] = { 1, 10,
+        100, 1000, 10000, 100000, 1000000 };
+    uint64_t scaled, whole, fraction;
+    unsigned whole_digits, decimals;
+    char text[32];
+    int len;
+    bool exact = true;
+
+    if (isnan(value) || isinf(value)) {
+        /* JSON has no NaN or infinity */
+        return bacjson_write(writer, "null", 4);
+    }
+    if (value < 0.0) {
+        if (!bacjson_write(writer, "-", 1)) {
+            return false;
+        }
+        value = -value;
+    }
+    if (value < 1e15) {
+        whole = (uint64_t)value;
+        whole_digits = (whole > 0) ? 1 : 0;
+        for (scaled = whole; scaled >= 10; scaled /= 10) {
+            whole_digits++;
+        }
+        decimals = (digits > whole_digits) ? (digits - whole_digits) : 0;
+        if (decimals > BACJSON_DECIMALS_MAX) {
+            /* the digits would be cut, unless the decimals end early */
+            decimals = BACJSON_DECIMALS_MAX;
+            scaled = (uint64_t)((value * decimal_scale[decimals]) + 0.5);
+            exact = !islessgreater(
+                (double)scaled, value * decimal_scale[decimals]);
+        }
+    } else {
+        exact = false;
+    }
+    if (!exact) {
+        len = snprintf(text, sizeof(text), "%.*g", (int)digits, value);
+        if ((len <= 0) || ((size_t)len >= sizeof(text))) {
+            return false;
+        }
+        return bacjson_write(writer, text, (size_t)len);
+    }
+    scaled = (uint64_t)((value * decimal_scale[decimals]) + 0.5);
+    whole = scaled / decimal_scale[decimals];
+    fraction = scaled % decimal_scale[decimals];
+    if (!bacjson_write_digits(writer, whole, 1)) {
+        return false;
+    }
+    if (fraction == 0) {
+        return true;
+    }
+    while ((fraction % 10) == 0) {
+        fraction /= 10;
+        decimals--;
+    }
+
+    return bacjson_write(writer, ".", 1) &&
+        bacjson_write_digits(writer, fraction, decimals);
+}
+
+/**
+ * @brief Append a JSON string, escaping the characters that need it
+ * @param writer - writer
+ * @param text - characters of the string
+ * @param len - number of characters
+ * @param latin1 - true if the characters are ISO 8859-1, to convert
+ *  them to UTF-8, or false if they are UTF-8 already
+ * @return true if the text fit in the buffer
+ */
+static bool bacjson_write_quoted(
+    BACJSON_WRITER *writer, const char *text, size_t len, bool latin1)
+{
+    char escape[6];
+    size_t escape_len;
+    size_t start = 0;
+    size_t i;
+    unsigned char c;
+
+    if (!bacjson_write(writer, "\"", 1)) {
+        return false;
+    }
+    for (i = 0; i < len; i++) {
+        c = (unsigned char)text[i];
+        if ((c >= 0x20) && (c != '"') && (c != '\\') &&
+            ((c < 0x80) || !latin1)) {
+            continue;
+        }
+        if (!bacjson_write(writer, &text[start], i - start)) {
+            return false;
+        }
+        start = i + 1;
+        escape[0] = '\\';
+        escape_len = 2;
+        if (c >= 0x80) {
+            escape[0] = (char)(0xC0 | (c >> 6));
+            escape[1] = (char)(0x80 | (c & 0x3F));
+        } else if (c == '"') {
+            escape[1] = '"';
+        } else if (c == '\\') {
+            escape[1] = '\\';
+        } else if (c == '\n') {
+            escape[1] = 'n';
+        } else if (c == '\r') {
+            escape[1] = 'r';
+        } else if (c == '\t') {
+            escape[1] = 't';
+        } else {
+            escape[1] = 'u';
+            escape[2] = '0';
+            escape[3] = '0';
+            escape[4] = Hex_Digits[c >> 4];
+            escape[5] = Hex_Digits[c & 0x0F];
+            escape_len = 6;
+        }
+        if (!bacjson_write(writer, escape, escape_len)) {
+            return false;
+        }
+    }
+
+    return bacjson_write(writer, &text[start], len - start) &&
+        bacjson_write(writer, "\"", 1);
+}
+
+/**
+ * @brief Append a date or time field, or '*' if it is unspecified
+ * @param writer - writer
+ * @param value - field value
+ * @param width - number of digits
+ * @param wildcard - value of an unspecified field
+ * @return true if the text fit in the buffer
+ */
+static bool bacjson_write_field(
+    BACJSON_WRITER *writer, unsigned value, unsigned width, unsigned wildcard)
+{
+    if (value == wildcard) {
+        return bacjson_write(writer, "*", 1);
+    }
+
+    return bacjson_write_digits(writer, value, width);
+}
+
+/**
+ * @brief Append a date as YYYY-MM-DD, without quotes
+ * @param writer - writer
+ * @param bdate - date
+ * @return true if the text fit in the buffer
+ */
+static bool bacjson_write_date(BACJSON_WRITER *writer, BACNET_DATE *bdate)
+{
+    return bacjson_write_field(
+               writer, bdate->year, 4, BACNET_DATE_YEAR_EPOCH + 0xFF) &&
+        bacjson_write(writer, "-", 1) &&
+        bacjson_write_field(writer, bdate->month, 2, 0xFF) &&
+        bacjson_write(writer, "-", 1) &&
+        bacjson_write_field(writer, bdate->day, 2, 0xFF);
+}
+
+/**
+ * @brief Append a time as HH:MM:SS.hh, without quotes
+ * @param writer - writer
+ * @param btime - time
+ * @return true if the text fit in the buffer
+ */
+static bool bacjson_write_time(BACJSON_WRITER *writer, BACNET_TIME *btime)
+{
+    return bacjson_write_field(writer, btime->hour, 2, 0xFF) &&
+        bacjson_write(writer, ":", 1) &&
+        bacjson_write_field(writer, btime->min, 2, 0xFF) &&
+        bacjson_write(writer, ":", 1) &&
+        bacjson_write_field(writer, btime->sec, 2, 0xFF) &&
+        bacjson_write(writer, ".", 1) &&
+        bacjson_write_field(writer, btime->hundredths, 2, 0xFF);
+}
+
+/**
+ * @brief Append an object type by name, or by number if it has no name
+ * @param writer - writer
+ * @param object_type - object type
+ * @return true if the text fit in the buffer
+ */
+static bool bacjson_write_object_type(
+    BACJSON_WRITER *writer, unsigned object_type)
+{
+    const char *name;
+
+    name = bactext_object_type_name_default(object_type, NULL);
+    if (name) {
+        return bacjson_write_string(writer, name);
+    }
+
+    return bacjson_write_digits(writer, object_type, 1);
+}
+
+/**
+ * @brief Find the name of the enumerated value of a well known property
+ * @param object_type - object type of the property
+ * @param object_property - property identifier
+ * @param enumerated - enumerated value
+ * @return name of the value, or NULL if it is written as a number
+ */
+static const char *bacjson_enumerated_name(BACNET_OBJECT_TYPE object_type,
+    BACNET_PROPERTY_ID object_property,
+    uint32_t enumerated)
+{
+    switch (object_property) {
+        case PROP_OBJECT_TYPE:
+            return bactext_object_type_name_default(enumerated, NULL);
+        case PROP_PROPERTY_LIST:
+            return bactext_property_name_default(enumerated, NULL);
+        case PROP_UNITS:
+            return bactext_engineering_unit_name_default(enumerated, NULL);
+        case PROP_EVENT_STATE:
+            return bactext_event_state_name_default(enumerated, NULL);
+        case PROP_SEGMENTATION_SUPPORTED:
+            return bactext_segmentation_name_default(enumerated, NULL);
+        case PROP_PRESENT_VALUE:
+        case PROP_RELINQUISH_DEFAULT:
+            switch (object_type) {
+                case OBJECT_BINARY_INPUT:
+                case OBJECT_BINARY_OUTPUT:
+                case OBJECT_BINARY_VALUE:
+                    return bactext_binary_present_value_name_default(
+                        enumerated, NULL);
+                default:
+                    break;
+            }
+            break;
+        default:
+            break;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Find the enumerated value of a name of a well known property
+ * @param object_type - object type of the property
+ * @param object_property - property identifier
+ * @param name - null terminated name of the value
+ * @param enumerated [out] enumerated value
+ * @return true if the name was found
+ */
+static bool bacjson_enumerated_index(BACNET_OBJECT_TYPE object_type,
+    BACNET_PROPERTY_ID object_property,
+    const char *name,
+    unsigned *enumerated)
+{
+    switch (object_property) {
+        case PROP_OBJECT_TYPE:
+            return bactext_object_type_index(name, enumerated);
+        case PROP_PROPERTY_LIST:
+            return bactext_property_index(name, enumerated);
+        case PROP_UNITS:
+            return bactext_engineering_unit_index(name, enumerated);
+        case PROP_EVENT_STATE:
+            return bactext_event_state_index(name, enumerated);
+        case PROP_SEGMENTATION_SUPPORTED:
+            return bactext_segmentation_index(name, enumerated);
+        case PROP_PRESENT_VALUE:
+        case PROP_RELINQUISH_DEFAULT:
+            switch (object_type) {
+                case OBJECT_BINARY_INPUT:
+                case OBJECT_BINARY_OUTPUT:
+                case OBJECT_BINARY_VALUE:
+                    return bactext_binary_present_value_index(
+                        name, enumerated);
+                default:
+                    break;
+            }
+            break;
+        default:
+            break;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Append a complex value as the string from bacapp_snprintf_value()
+ * @param writer - writer
+ * @param object_type - object type of the property
+ * @param object_property - property identifier
+ * @param value - value to write
+ * @return true if the text fit in the buffer
+ */
+static bool bacjson_write_text_value(BACJSON_WRITER *writer,
+    BACNET_OBJECT_TYPE object_type,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    BACNET_OBJECT_PROPERTY_VALUE object_value = { 0 };
+    char text[BACJSON_TEXT_SIZE];
+    int len;
+
+    object_value.object_type = object_type;
+    object_value.object_property = object_property;
+    object_value.array_index = BACNET_ARRAY_ALL;
+    object_value.value = value;
+    len = bacapp_snprintf_value(text, sizeof(text), &object_value);
+    if (len < 0) {
+        return false;
+    }
+    if ((size_t)len >= sizeof(text)) {
+        len = sizeof(text) - 1;
+    }
+
+    return bacjson_write_quoted(writer, text, (size_t)len, false);
+}
+
+/**
+ * @brief Append one value
+ * @param writer - writer
+ * @param object_type - object type of the property
+ * @param object_property - property identifier
+ * @param value - value to write
+ * @return true if the text fit in the buffer
+ */
+static bool bacjson_write_value(BACJSON_WRITER *writer,
+    BACNET_OBJECT_TYPE object_type,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    const char *name;
+    uint8_t *octets;
+    size_t len, i;
+    char hex[2];
+
+    switch (value->tag) {
+#if defined(BACAPP_NULL)
+        case BACNET_APPLICATION_TAG_NULL:
+            return bacjson_write(writer, "null", 4);
+#endif
+#if defined(BACAPP_BOOLEAN)
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            return value->type.Boolean ? bacjson_write(writer, "true", 4)
+                                       : bacjson_write(writer, "false", 5);
+#endif
+#if defined(BACAPP_UNSIGNED)
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            return bacjson_write_digits(writer, value->type.Unsigned_Int, 1);
+#endif
+#if defined(BACAPP_SIGNED)
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            return bacjson_write_signed(writer, value->type.Signed_Int);
+#endif
+#if defined(BACAPP_REAL)
+        case BACNET_APPLICATION_TAG_REAL:
+            return bacjson_write_real(
+                writer, (double)value->type.Real, BACJSON_REAL_DIGITS);
+#endif
+#if defined(BACAPP_DOUBLE)
+        case BACNET_APPLICATION_TAG_DOUBLE:
+            return bacjson_write_real(
+                writer, value->type.Double, BACJSON_DOUBLE_DIGITS);
+#endif
+#if defined(BACAPP_OCTET_STRING)
+        case BACNET_APPLICATION_TAG_OCTET_STRING:
+            len = octetstring_length(&value->type.Octet_String);
+            octets = octetstring_value(&value->type.Octet_String);
+            if (!bacjson_write(writer, "\"", 1)) {
+                return false;
+            }
+            for (i = 0; i < len; i++) {
+                hex[0] = Hex_Digits[octets[i] >> 4];
+                hex[1] = Hex_Digits[octets[i] & 0x0F];
+                if (!bacjson_write(writer, hex, 2)) {
+                    return false;
+                }
+            }
+            return bacjson_write(writer, "\"", 1);
+#endif
+#if defined(BACAPP_CHARACTER_STRING)
+        case BACNET_APPLICATION_TAG_CHARACTER_STRING:
+            return bacjson_write_quoted(writer,
+                characterstring_value(&value->type.Character_String),
+                characterstring_length(&value->type.Character_String),
+                characterstring_encoding(&value->type.Character_String) !=
+                    CHARACTER_UTF8);
+#endif
+#if defined(BACAPP_BIT_STRING)
+        case BACNET_APPLICATION_TAG_BIT_STRING:
+            len = bitstring_bits_used(&value->type.Bit_String);
+            if (!bacjson_write(writer, "[", 1)) {
+                return false;
+            }
+            for (i = 0; i < len; i++) {
+                if ((i > 0) && !bacjson_write(writer, ",", 1)) {
+                    return false;
+                }
+                if (bitstring_bit(&value->type.Bit_String, (uint8_t)i)) {
+                    if (!bacjson_write(writer, "true", 4)) {
+                        return false;
+                    }
+                } else if (!bacjson_write(writer, "false", 5)) {
+                    return false;
+                }
+            }
+            return bacjson_write(writer, "]", 1);
+#endif
+#if defined(BACAPP_ENUMERATED)
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            name = bacjson_enumerated_name(
+                object_type, object_property, value->type.Enumerated);
+            if (name) {
+                return bacjson_write(writer, "\"", 1) &&
+                    bacjson_write_string(writer, name) &&
+                    bacjson_write(writer, "\"", 1);
+            }
+            return bacjson_write_digits(writer, value->type.Enumerated, 1);
+#endif
+#if defined(BACAPP_DATE)
+        case BACNET_APPLICATION_TAG_DATE:
+            return bacjson_write(writer, "\"", 1) &&
+                bacjson_write_date(writer, &value->type.Date) &&
+                bacjson_write(writer, "\"", 1);
+#endif
+#if defined(BACAPP_TIME)
+        case BACNET_APPLICATION_TAG_TIME:
+            return bacjson_write(writer, "\"", 1) &&
+                bacjson_write_time(writer, &value->type.Time) &&
+                bacjson_write(writer, "\"", 1);
+#endif
+#if defined(BACAPP_OBJECT_ID)
+        case BACNET_APPLICATION_TAG_OBJECT_ID:
+            return bacjson_write(writer, "\"", 1) &&
+                bacjson_write_object_type(
+                    writer, value->type.Object_Id.type) &&
+                bacjson_write(writer, ":", 1) &&
+                bacjson_write_digits(
+                    writer, value->type.Object_Id.instance, 1) &&
+                bacjson_write(writer, "\"", 1);
+#endif
+#if defined(BACAPP_DATETIME)
+        case BACNET_APPLICATION_TAG_DATETIME:
+            return bacjson_write(writer, "\"", 1) &&
+                bacjson_write_date(writer, &value->type.Date_Time.date) &&
+                bacjson_write(writer, "T", 1) &&
+                bacjson_write_time(writer, &value->type.Date_Time.time) &&
+                bacjson_write(writer, "\"", 1);
+#endif
+        default:
+            break;
+    }
+
+    return bacjson_write_text_value(
+        writer, object_type, object_property, value);
+}
+
+/**
+ * @brief Append a value, or an array of the values of a value list
+ * @param writer - writer
+ * @param object_type - object type of the property
+ * @param object_property - property identifier
+ * @param value - value, or first value of a list
+ * @return true if the text fit in the buffer
+ */
+static bool bacjson_write_value_list(BACJSON_WRITER *writer,
+    BACNET_OBJECT_TYPE object_type,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    if (!value->next) {
+        return bacjson_write_value(
+            writer, object_type, object_property, value);
+    }
+    if (!bacjson_write(writer, "[", 1)) {
+        return false;
+    }
+    while (value) {
+        if (!bacjson_write_value(
+                writer, object_type, object_property, value)) {
+            return false;
+        }
+        value = value->next;
+        if (value && !bacjson_write(writer, ",", 1)) {
+            return false;
+        }
+    }
+
+    return bacjson_write(writer, "]", 1);
+}
+
+/**
+ * @brief Append a value as JSON, or a JSON array of the values of a list
+ * @param writer - writer
+ * @param object_type - object type of the property, for enumeration names
+ * @param object_property - property identifier, for enumeration names
+ * @param value - value, or first value of a list
+ * @return true if the value was appended, false if it did not fit in the
+ *  buffer, which is left as it was
+ */
+bool bacjson_value_encode(BACJSON_WRITER *writer,
+    BACNET_OBJECT_TYPE object_type,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    size_t length;
+
+    if (!writer || !value || !writer->size) {
+        return false;
+    }
+    length = writer->length;
+    if (!bacjson_write_value_list(
+            writer, object_type, object_property, value)) {
+        bacjson_rollback(writer, length);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Append the name of a property, or its number if it has no name
+ * @param writer - writer
+ * @param object_property - property identifier
+ * @return true if the text fit in the buffer
+ */
+static bool bacjson_write_property(
+    BACJSON_WRITER *writer, unsigned object_property)
+{
+    const char *name;
+
+    name = bactext_property_name_default(object_property, NULL);
+    if (name) {
+        return bacjson_write_string(writer, name);
+    }
+
+    return bacjson_write_digits(writer, object_property, 1);
+}
+
+/**
+ * @brief Append a property value as a JSON object, for example
+ *  {"object-type":"analog-input","object-instance":1,
+ *  "property":"present-value","value":72.5}, with an "array-index"
+ *  member when the value is an array element.
+ * @param writer - writer
+ * @param object_value - object, property, array index and value
+ * @return true if the record was appended, false if it did not fit in
+ *  the buffer, which is left as it was
+ */
+bool bacjson_property_value_encode(
+    BACJSON_WRITER *writer, BACNET_OBJECT_PROPERTY_VALUE *object_value)
+{
+    size_t length;
+    bool status;
+
+    if (!writer || !object_value || !object_value->value || !writer->size) {
+        return false;
+    }
+    length = writer->length;
+    status = bacjson_write_string(writer, "{\"object-type\":\"") &&
+        bacjson_write_object_type(writer, object_value->object_type) &&
+        bacjson_write_string(writer, "\",\"object-instance\":") &&
+        bacjson_write_digits(writer, object_value->object_instance, 1) &&
+        bacjson_write_string(writer, ",\"property\":\"") &&
+        bacjson_write_property(writer, object_value->object_property) &&
+        bacjson_write(writer, "\"", 1);
+    if (status && (object_value->array_index != BACNET_ARRAY_ALL)) {
+        status = bacjson_write_string(writer, ",\"array-index\":") &&
+            bacjson_write_digits(writer, object_value->array_index, 1);
+    }
+    status = status && bacjson_write_string(writer, ",\"value\":") &&
+        bacjson_write_value_list(writer, object_value->object_type,
+            object_value->object_property, object_value->value) &&
+        bacjson_write(writer, "}", 1);
+    if (!status) {
+        bacjson_rollback(writer, length);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Quote the CSV field at the end of the writer in place, if it
+ *  contains a separator, quote or line break
+ * @param writer - writer
+ * @param start - offset of the field in the buffer
+ * @return true if the field fit in the buffer
+ */
+static bool bacjson_csv_quote(BACJSON_WRITER *writer, size_t start)
+{
+    char *buffer = writer->buffer;
+    size_t quotes = 0;
+    size_t from, to;
+    bool needed = false;
+    char c;
+
+    for (from = start; from < writer->length; from++) {
+        c = buffer[from];
+        if (c == '"') {
+            quotes++;
+            needed = true;
+        } else if ((c == ',') || (c == '\n') || (c == '\r')) {
+            needed = true;
+        }
+    }
+    if (!needed) {
+        return true;
+    }
+    if ((quotes + 2) >= (writer->size - writer->length)) {
+        return false;
+    }
+    /* move the field from the end, doubling the quotes */
+    from = writer->length;
+    to = writer->length + quotes + 2;
+    buffer[to] = 0;
+    buffer[--to] = '"';
+    while (from > start) {
+        c = buffer[--from];
+        buffer[--to] = c;
+        if (c == '"') {
+            buffer[--to] = '"';
+        }
+    }
+    buffer[--to] = '"';
+    writer->length += quotes + 2;
+
+    return true;
+}
+
+/**
+ * @brief Append a property value as a CSV line of object type, object
+ *  instance, property, array index (empty for the whole property) and the
+ *  JSON value, quoted when it contains a separator or quote.
+ * @param writer - writer
+ * @param object_value - object, property, array index and value
+ * @return true if the line was appended, false if it did not fit in the
+ *  buffer, which is left as it was
+ */
+bool bacjson_csv_property_value_encode(
+    BACJSON_WRITER *writer, BACNET_OBJECT_PROPERTY_VALUE *object_value)
+{
+    size_t length;
+    size_t start;
+    bool status;
+
+    if (!writer || !object_value || !object_value->value || !writer->size) {
+        return false;
+    }
+    length = writer->length;
+    status = bacjson_write_object_type(writer, object_value->object_type) &&
+        bacjson_write(writer, ",", 1) &&
+        bacjson_write_digits(writer, object_value->object_instance, 1) &&
+        bacjson_write(writer, ",", 1) &&
+        bacjson_write_property(writer, object_value->object_property) &&
+        bacjson_write(writer, ",", 1);
+    if (status && (object_value->array_index != BACNET_ARRAY_ALL)) {
+        status = bacjson_write_digits(writer, object_value->array_index, 1);
+    }
+    status = status && bacjson_write(writer, ",", 1);
+    start = writer->length;
+    status = status &&
+        bacjson_write_value_list(writer, object_value->object_type,
+            object_value->object_property, object_value->value) &&
+        bacjson_csv_quote(writer, start) && bacjson_write(writer, "\n", 1);
+    if (!status) {
+        bacjson_rollback(writer, length);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Parse a run of decimal digits
+ * @param str - text to parse
+ * @param str_len - number of characters of text
+ * @param value [out] the number
+ * @return number of characters parsed, or BACNET_STATUS_ERROR if there
+ *  are no digits or the number does not fit
+ */
+static int bacjson_unsigned_parse(
+    const char *str, size_t str_len, BACNET_UNSIGNED_INTEGER *value)
+{
+    BACNET_UNSIGNED_INTEGER result = 0;
+    unsigned digit;
+    size_t i = 0;
+
+    while ((i < str_len) && (str[i] >= '0') && (str[i] <= '9')) {
+        digit = (unsigned)(str[i] - '0');
+        if (result > ((BACNET_UNSIGNED_INTEGER_MAX - digit) / 10)) {
+            return BACNET_STATUS_ERROR;
+        }
+        result = (result * 10) + digit;
+        i++;
+    }
+    if (i == 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    *value = result;
+
+    return (int)i;
+}
+
+/**
+ * @brief Parse a JSON number.  Numbers of up to 19 significant digits
+ *  with a small exponent are converted exactly without strtod().
+ * @param str - text to parse
+ * @param str_len - number of characters of text
+ * @param value [out] the number
+ * @return number of characters parsed, or BACNET_STATUS_ERROR
+ */
+static int bacjson_real_parse(const char *str, size_t str_len, double *value)
+{
+    uint64_t mantissa = 0;
+    unsigned digits = 0;
+    int exponent = 0;
+    int exponent_value = 0;
+    bool negative = false;
+    bool exponent_negative = false;
+    bool exact = true;
+    bool found = false;
+    double result;
+    char text[64];
+    size_t i = 0;
+
+    if ((i < str_len) && (str[i] == '-')) {
+        negative = true;
+        i++;
+    }
+    while ((i < str_len) && (str[i] >= '0') && (str[i] <= '9')) {
+        found = true;
+        if (digits < 19) {
+            mantissa = (mantissa * 10) + (uint64_t)(str[i] - '0');
+            if (mantissa) {
+                digits++;
+            }
+        } else {
+            exponent++;
+            exact = false;
+        }
+        i++;
+    }
+    if ((i < str_len) && (str[i] == '.')) {
+        i++;
+        while ((i < str_len) && (str[i] >= '0') && (str[i] <= '9')) {
+            found = true;
+            if (digits < 19) {
+                mantissa = (mantissa * 10) + (uint64_t)(str[i] - '0');
+                if (mantissa) {
+                    digits++;
+                }
+                exponent--;
+            } else {
+                exact = false;
+            }
+            i++;
+        }
+    }
+    if (!found) {
+        return BACNET_STATUS_ERROR;
+    }
+    if ((i < str_len) && ((str[i] == 'e') || (str[i] == 'E'))) {
+        i++;
+        if ((i < str_len) && ((str[i] == '-') || (str[i] == '+'))) {
+            exponent_negative = (str[i] == '-');
+            i++;
+        }
+        found = false;
+        while ((i < str_len) && (str[i] >= '0') && (str[i] <= '9')) {
+            found = true;
+            if (exponent_value < 10000) {
+                exponent_value = (exponent_value * 10) + (str[i] - '0');
+            }
+            i++;
+        }
+        if (!found) {
+            return BACNET_STATUS_ERROR;
+        }
+        exponent += exponent_negative ? -exponent_value : exponent_value;
+    }
+    if (exact && (mantissa <= (UINT64_C(1) << 53)) &&
+        (exponent >= -BACJSON_EXACT_POWER_MAX) &&
+        (exponent <= BACJSON_EXACT_POWER_MAX)) {
+        result = (double)mantissa;
+        if (exponent < 0) {
+            result /= Exact_Powers_Of_Ten[-exponent];
+        } else {
+            result *= Exact_Powers_Of_Ten[exponent];
+        }
+        *value = negative ? -result : result;
+    } else {
+        if (i >= sizeof(text)) {
+            return BACNET_STATUS_ERROR;
+        }
+        memcpy(text, str, i);
+        text[i] = 0;
+        *value = strtod(text, NULL);
+    }
+
+    return (int)i;
+}
+
+/**
+ * @brief Parse four hex digits
+ * @param str - text to parse, at least four characters
+ * @param value [out] the number
+ * @return true if the characters are hex digits
+ */
+static bool bacjson_hex4_parse(const char *str, unsigned *value)
+{
+    unsigned result = 0;
+    unsigned i;
+    char c;
+
+    for (i = 0; i < 4; i++) {
+        c = str[i];
+        result <<= 4;
+        if ((c >= '0') && (c <= '9')) {
+            result |= (unsigned)(c - '0');
+        } else if ((c >= 'a') && (c <= 'f')) {
+            result |= (unsigned)(c - 'a' + 10);
+        } else if ((c >= 'A') && (c <= 'F')) {
+            result |= (unsigned)(c - 'A' + 10);
+        } else {
+            return false;
+        }
+    }
+    *value = result;
+
+    return true;
+}
+
+/**
+ * @brief Parse a JSON string into a UTF-8 character string
+ * @param str - text to parse, starting at the opening quote
+ * @param str_len - number of characters of text
+ * @param char_string [out] the string
+ * @return number of characters parsed, or BACNET_STATUS_ERROR
+ */
+static int bacjson_string_parse(
+    const char *str, size_t str_len, BACNET_CHARACTER_STRING *char_string)
+{
+    unsigned code, low;
+    char utf8[4];
+    size_t utf8_len;
+    size_t start;
+    size_t i = 0;
+
+    if ((str_len < 2) || (str[0] != '"')) {
+        return BACNET_STATUS_ERROR;
+    }
+    characterstring_init(char_string, CHARACTER_UTF8, NULL, 0);
+    i++;
+    start = i;
+    while (i < str_len) {
+        if (str[i] == '"') {
+            if (!characterstring_append(char_string, &str[start], i - start)) {
+                return BACNET_STATUS_ERROR;
+            }
+            return (int)(i + 1);
+        }
+        if ((unsigned char)str[i] < 0x20) {
+            return BACNET_STATUS_ERROR;
+        }
+        if (str[i] != '\\') {
+            i++;
+            continue;
+        }
+        if (!characterstring_append(char_string, &str[start], i - start) ||
+            ((i + 1) >= str_len)) {
+            return BACNET_STATUS_ERROR;
+        }
+        i++;
+        utf8_len = 1;
+        switch (str[i]) {
+            case '"':
+            case '\\':
+            case '/':
+                utf8[0] = str[i];
+                break;
+            case 'b':
+                utf8[0] = '\b';
+                break;
+            case 'f':
+                utf8[0] = '\f';
+                break;
+            case 'n':
+                utf8[0] = '\n';
+                break;
+            case 'r':
+                utf8[0] = '\r';
+                break;
+            case 't':
+                utf8[0] = '\t';
+                break;
+            case 'u':
+                if (((i + 5) > str_len) ||
+                    !bacjson_hex4_parse(&str[i + 1], &code)) {
+                    return BACNET_STATUS_ERROR;
+                }
+                i += 4;
+                if ((code >= 0xD800) && (code <= 0xDBFF) &&
+                    ((i + 7) <= str_len) && (str[i + 1] == '\\') &&
+                    (str[i + 2] == 'u') &&
+                    bacjson_hex4_parse(&str[i + 3], &low) &&
+                    (low >= 0xDC00) && (low <= 0xDFFF)) {
+                    /* surrogate pair */
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+                if (code < 0x80) {
+                    utf8[0] = (char)code;
+                } else if (code < 0x800) {
+                    utf8[0] = (char)(0xC0 | (code >> 6));
+                    utf8[1] = (char)(0x80 | (code & 0x3F));
+                    utf8_len = 2;
+                } else if (code < 0x10000) {
+                    utf8[0] = (char)(0xE0 | (code >> 12));
+                    utf8[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+                    utf8[2] = (char)(0x80 | (code & 0x3F));
+                    utf8_len = 3;
+                } else {
+                    utf8[0] = (char)(0xF0 | (code >> 18));
+                    utf8[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+                    utf8[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+                    utf8[3] = (char)(0x80 | (code & 0x3F));
+                    utf8_len = 4;
+                }
+                break;
+            default:
+                return BACNET_STATUS_ERROR;
+        }
+        if (!characterstring_append(char_string, utf8, utf8_len)) {
+            return BACNET_STATUS_ERROR;
+        }
+        i++;
+        start = i;
+    }
+
+    return BACNET_STATUS_ERROR;
+}
+
+/**
+ * @brief Parse a hex string into an octet string
+ * @param str - text to parse, starting at the opening quote
+ * @param str_len - number of characters of text
+ * @param octet_string [out] the octet string
+ * @return number of characters parsed, or BACNET_STATUS_ERROR
+ */
+static int bacjson_octet_string_parse(
+    const char *str, size_t str_len, BACNET_OCTET_STRING *octet_string)
+{
+    unsigned nibble[2];
+    uint8_t octet;
+    unsigned n;
+    size_t i = 1;
+    char c;
+
+    if ((str_len < 2) || (str[0] != '"')) {
+        return BACNET_STATUS_ERROR;
+    }
+    octetstring_init(octet_string, NULL, 0);
+    while ((i < str_len) && (str[i] != '"')) {
+        if ((i + 1) >= str_len) {
+            return BACNET_STATUS_ERROR;
+        }
+        for (n = 0; n < 2; n++) {
+            c = str[i + n];
+            if ((c >= '0') && (c <= '9')) {
+                nibble[n] = (unsigned)(c - '0');
+            } else if ((c >= 'a') && (c <= 'f')) {
+                nibble[n] = (unsigned)(c - 'a' + 10);
+            } else if ((c >= 'A') && (c <= 'F')) {
+                nibble[n] = (unsigned)(c - 'A' + 10);
+            } else {
+                return BACNET_STATUS_ERROR;
+            }
+        }
+        octet = (uint8_t)((nibble[0] << 4) | nibble[1]);
+        if (!octetstring_append(octet_string, &octet, 1)) {
+            return BACNET_STATUS_ERROR;
+        }
+        i += 2;
+    }
+    if (i >= str_len) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    return (int)(i + 1);
+}
+
+/**
+ * @brief Skip JSON white space
+ * @param str - text
+ * @param str_len - number of characters of text
+ * @param i - offset to start from
+ * @return offset of the first character that is not white space
+ */
+static size_t bacjson_skip_space(const char *str, size_t str_len, size_t i)
+{
+    while ((i < str_len) &&
+        ((str[i] == ' ') || (str[i] == '\t') || (str[i] == '\n') ||
+            (str[i] == '\r'))) {
+        i++;
+    }
+
+    return i;
+}
+
+/**
+ * @brief Parse a literal word, such as true, false or null
+ * @param str - text to parse
+ * @param str_len - number of characters of text
+ * @param word - the word to match
+ * @return true if the text starts with the word
+ */
+static bool bacjson_word_parse(
+    const char *str, size_t str_len, const char *word)
+{
+    size_t len = strlen(word);
+
+    return (str_len >= len) && (memcmp(str, word, len) == 0);
+}
+
+/**
+ * @brief Parse an array of booleans into a bit string
+ * @param str - text to parse, starting at the opening bracket
+ * @param str_len - number of characters of text
+ * @param bit_string [out] the bit string
+ * @return number of characters parsed, or BACNET_STATUS_ERROR
+ */
+static int bacjson_bit_string_parse(
+    const char *str, size_t str_len, BACNET_BIT_STRING *bit_string)
+{
+    unsigned bit = 0;
+    size_t i = 1;
+    bool value;
+
+    if ((str_len < 2) || (str[0] != '[')) {
+        return BACNET_STATUS_ERROR;
+    }
+    bitstring_init(bit_string);
+    i = bacjson_skip_space(str, str_len, i);
+    if ((i < str_len) && (str[i] == ']')) {
+        return (int)(i + 1);
+    }
+    while (i < str_len) {
+        if (bacjson_word_parse(&str[i], str_len - i, "true")) {
+            value = true;
+            i += 4;
+        } else if (bacjson_word_parse(&str[i], str_len - i, "false")) {
+            value = false;
+            i += 5;
+        } else {
+            return BACNET_STATUS_ERROR;
+        }
+        if (bit >= (MAX_BITSTRING_BYTES * 8)) {
+            return BACNET_STATUS_ERROR;
+        }
+        bitstring_set_bit(bit_string, (uint8_t)bit, value);
+        bit++;
+        i = bacjson_skip_space(str, str_len, i);
+        if ((i < str_len) && (str[i] == ']')) {
+            return (int)(i + 1);
+        }
+        if ((i >= str_len) || (str[i] != ',')) {
+            return BACNET_STATUS_ERROR;
+        }
+        i = bacjson_skip_space(str, str_len, i + 1);
+    }
+
+    return BACNET_STATUS_ERROR;
+}
+
+/**
+ * @brief Copy a quoted name, without escapes, into a null terminated buffer
+ * @param str - text to parse, starting at the opening quote
+ * @param str_len - number of characters of text
+ * @param stop - character that ends the name, besides the closing quote
+ * @param name [out] buffer for the name, of BACJSON_NAME_SIZE characters
+ * @return number of characters of the name after the quote, or
+ *  BACNET_STATUS_ERROR if the name is too long or not terminated
+ */
+static int bacjson_name_parse(
+    const char *str, size_t str_len, char stop, char *name)
+{
+    size_t i = 1;
+
+    while ((i < str_len) && (str[i] != '"') && (str[i] != stop)) {
+        if ((i - 1) >= (BACJSON_NAME_SIZE - 1)) {
+            return BACNET_STATUS_ERROR;
+        }
+        name[i - 1] = str[i];
+        i++;
+    }
+    if (i >= str_len) {
+        return BACNET_STATUS_ERROR;
+    }
+    name[i - 1] = 0;
+
+    return (int)(i - 1);
+}
+
+/**
+ * @brief Parse a date or time field, or '*' for unspecified
+ * @param str - text to parse
+ * @param str_len - number of characters of text
+ * @param wildcard - value of an unspecified field
+ * @param maximum - largest value of the field
+ * @param value [out] field value
+ * @return number of characters parsed, or BACNET_STATUS_ERROR
+ */
+static int bacjson_field_parse(const char *str,
+    size_t str_len,
+    unsigned wildcard,
+    unsigned maximum,
+    unsigned *value)
+{
+    BACNET_UNSIGNED_INTEGER number = 0;
+    int len;
+
+    if ((str_len > 0) && (str[0] == '*')) {
+        *value = wildcard;
+        return 1;
+    }
+    len = bacjson_unsigned_parse(str, str_len, &number);
+    if ((len <= 0) || (number > maximum)) {
+        return BACNET_STATUS_ERROR;
+    }
+    *value = (unsigned)number;
+
+    return len;
+}
+
+/**
+ * @brief Parse a date as YYYY-MM-DD, without quotes
+ * @param str - text to parse
+ * @param str_len - number of characters of text
+ * @param bdate [out] the date
+ * @return number of characters parsed, or BACNET_STATUS_ERROR
+ */
+static int bacjson_date_parse(
+    const char *str, size_t str_len, BACNET_DATE *bdate)
+{
+    unsigned field[3];
+    static const unsigned wildcard[3] = { BACNET_DATE_YEAR_EPOCH + 0xFF, 0xFF,
+        0xFF };
+    static const unsigned maximum[3] = { BACNET_DATE_YEAR_EPOCH + 0xFF, 0xFF,
+        0xFF };
+    size_t i = 0;
+    unsigned n;
+    int len;
+
+    for (n = 0; n < 3; n++) {
+        if (n > 0) {
+            if ((i >= str_len) || (str[i] != '-')) {
+                return BACNET_STATUS_ERROR;
+            }
+            i++;
+        }
+        len = bacjson_field_parse(
+            &str[i], str_len - i, wildcard[n], maximum[n], &field[n]);
+        if (len <= 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        i += (size_t)len;
+    }
+    if (field[0] < BACNET_DATE_YEAR_EPOCH) {
+        return BACNET_STATUS_ERROR;
+    }
+    if ((field[0] != wildcard[0]) && (field[1] >= 1) && (field[1] <= 12) &&
+        (field[2] >= 1) && (field[2] <= 31)) {
+        datetime_set_date(
+            bdate, (uint16_t)field[0], (uint8_t)field[1], (uint8_t)field[2]);
+    } else {
+        bdate->year = (uint16_t)field[0];
+        bdate->month = (uint8_t)field[1];
+        bdate->day = (uint8_t)field[2];
+        bdate->wday = 0xFF;
+    }
+
+    return (int)i;
+}
+
+/**
+ * @brief Parse a time as HH:MM:SS.hh, without quotes.  The seconds and
+ *  hundredths are optional.
+ * @param str - text to parse
+ * @param str_len - number of characters of text
+ * @param btime [out] the time
+ * @return number of characters parsed, or BACNET_STATUS_ERROR
+ */
+static int bacjson_time_parse(
+    const char *str, size_t str_len, BACNET_TIME *btime)
+{
+    unsigned field[4] = { 0, 0, 0, 0 };
+    static const char separator[4] = { 0, ':', ':', '.' };
+    static const unsigned maximum[4] = { 23, 59, 59, 99 };
+    size_t i = 0;
+    unsigned n;
+    int len;
+
+    for (n = 0; n < 4; n++) {
+        if (n > 0) {
+            if ((i >= str_len) || (str[i] != separator[n])) {
+                if (n < 2) {
+                    return BACNET_STATUS_ERROR;
+                }
+                break;
+            }
+            i++;
+        }
+        len = bacjson_field_parse(
+            &str[i], str_len - i, 0xFF, maximum[n], &field[n]);
+        if (len <= 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        i += (size_t)len;
+    }
+    btime->hour = (uint8_t)field[0];
+    btime->min = (uint8_t)field[1];
+    btime->sec = (uint8_t)field[2];
+    btime->hundredths = (uint8_t)field[3];
+
+    return (int)i;
+}
+
+/**
+ * @brief Parse an object identifier as "type:instance", where the type is
+ *  a name or a number
+ * @param str - text to parse, starting at the opening quote
+ * @param str_len - number of characters of text
+ * @param object_id [out] the object identifier
+ * @return number of characters parsed, or BACNET_STATUS_ERROR
+ */
+static int bacjson_object_id_parse(
+    const char *str, size_t str_len, BACNET_OBJECT_ID *object_id)
+{
+    BACNET_UNSIGNED_INTEGER number = 0;
+    char name[BACJSON_NAME_SIZE];
+    unsigned object_type = 0;
+    size_t i;
+    int len;
+
+    if ((str_len < 2) || (str[0] != '"')) {
+        return BACNET_STATUS_ERROR;
+    }
+    if ((str[1] >= '0') && (str[1] <= '9')) {
+        len = bacjson_unsigned_parse(&str[1], str_len - 1, &number);
+        if ((len <= 0) || (number > BACNET_MAX_OBJECT)) {
+            return BACNET_STATUS_ERROR;
+        }
+        object_type = (unsigned)number;
+    } else {
+        len = bacjson_name_parse(str, str_len, ':', name);
+        if ((len <= 0) || !bactext_object_type_index(name, &object_type)) {
+            return BACNET_STATUS_ERROR;
+        }
+    }
+    i = 1 + (size_t)len;
+    if ((i >= str_len) || (str[i] != ':')) {
+        return BACNET_STATUS_ERROR;
+    }
+    i++;
+    len = bacjson_unsigned_parse(&str[i], str_len - i, &number);
+    if ((len <= 0) || (number > BACNET_MAX_INSTANCE)) {
+        return BACNET_STATUS_ERROR;
+    }
+    i += (size_t)len;
+    if ((i >= str_len) || (str[i] != '"')) {
+        return BACNET_STATUS_ERROR;
+    }
+    object_id->type = (uint16_t)object_type;
+    object_id->instance = (uint32_t)number;
+
+    return (int)(i + 1);
+}
+
+/**
+ * @brief Parse a quoted value with an inner parser, such as a date
+ * @param len - number of characters parsed inside the quotes, or
+ *  BACNET_STATUS_ERROR
+ * @param str - text, starting at the opening quote
+ * @param str_len - number of characters of text
+ * @return number of characters parsed including the quotes, or
+ *  BACNET_STATUS_ERROR
+ */
+static int bacjson_quoted_end(int len, const char *str, size_t str_len)
+{
+    if ((len <= 0) || ((size_t)(len + 1) >= str_len) ||
+        (str[len + 1] != '"')) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    return len + 2;
+}
+
+/**
+ * @brief Parse a JSON value written by bacjson_value_encode() into an
+ *  application data value of a known datatype, for bulk imports.  This is
+ *  the JSON counterpart of bacapp_parse_application_data(), without the
+ *  scanf family: numbers are parsed in place and the text does not need a
+ *  null terminator.
+ * @param str - text to parse, with optional leading white space
+ * @param str_len - number of characters of text
+ * @param tag - application tag of the value
+ * @param object_type - object type of the property, for enumeration names
+ * @param object_property - property identifier, for enumeration names
+ * @param value [out] the value
+ * @return number of characters parsed, or BACNET_STATUS_ERROR if the text
+ *  is not a value of the datatype
+ */
+int bacjson_value_parse(const char *str,
+    size_t str_len,
+    BACNET_APPLICATION_TAG tag,
+    BACNET_OBJECT_TYPE object_type,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    BACNET_UNSIGNED_INTEGER number = 0;
+    char name[BACJSON_NAME_SIZE];
+    unsigned enumerated = 0;
+    bool negative = false;
+    double real = 0.0;
+    size_t offset, skip;
+    int len = BACNET_STATUS_ERROR;
+
+    if (!str || !value) {
+        return BACNET_STATUS_ERROR;
+    }
+    skip = bacjson_skip_space(str, str_len, 0);
+    str += skip;
+    str_len -= skip;
+    value->tag = tag;
+    value->context_specific = false;
+    switch (tag) {
+#if defined(BACAPP_NULL)
+        case BACNET_APPLICATION_TAG_NULL:
+            if (bacjson_word_parse(str, str_len, "null")) {
+                len = 4;
+            }
+            break;
+#endif
+#if defined(BACAPP_BOOLEAN)
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            if (bacjson_word_parse(str, str_len, "true")) {
+                value->type.Boolean = true;
+                len = 4;
+            } else if (bacjson_word_parse(str, str_len, "false")) {
+                value->type.Boolean = false;
+                len = 5;
+            }
+            break;
+#endif
+#if defined(BACAPP_UNSIGNED)
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            len = bacjson_unsigned_parse(str, str_len, &number);
+            value->type.Unsigned_Int = number;
+            break;
+#endif
+#if defined(BACAPP_SIGNED)
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            if ((str_len > 0) && (str[0] == '-')) {
+                negative = true;
+            }
+            len = bacjson_unsigned_parse(
+                &str[negative], str_len - negative, &number);
+            if ((len <= 0) ||
+                (number > (negative ? UINT32_C(2147483648)
+                                    : UINT32_C(2147483647)))) {
+                len = BACNET_STATUS_ERROR;
+            } else if (negative) {
+                value->type.Signed_Int = (int32_t)(-(int64_t)number);
+                len++;
+            } else {
+                value->type.Signed_Int = (int32_t)number;
+            }
+            break;
+#endif
+#if defined(BACAPP_REAL)
+        case BACNET_APPLICATION_TAG_REAL:
+            len = bacjson_real_parse(str, str_len, &real);
+            value->type.Real = (float)real;
+            break;
+#endif
+#if defined(BACAPP_DOUBLE)
+        case BACNET_APPLICATION_TAG_DOUBLE:
+            len = bacjson_real_parse(str, str_len, &real);
+            value->type.Double = real;
+            break;
+#endif
+#if defined(BACAPP_OCTET_STRING)
+        case BACNET_APPLICATION_TAG_OCTET_STRING:
+            len = bacjson_octet_string_parse(
+                str, str_len, &value->type.Octet_String);
+            break;
+#endif
+#if defined(BACAPP_CHARACTER_STRING)
+        case BACNET_APPLICATION_TAG_CHARACTER_STRING:
+            len = bacjson_string_parse(
+                str, str_len, &value->type.Character_String);
+            break;
+#endif
+#if defined(BACAPP_BIT_STRING)
+        case BACNET_APPLICATION_TAG_BIT_STRING:
+            len = bacjson_bit_string_parse(
+                str, str_len, &value->type.Bit_String);
+            break;
+#endif
+#if defined(BACAPP_ENUMERATED)
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            if ((str_len > 0) && (str[0] == '"')) {
+                len = bacjson_name_parse(str, str_len, '"', name);
+                if ((len > 0) &&
+                    bacjson_enumerated_index(
+                        object_type, object_property, name, &enumerated)) {
+                    value->type.Enumerated = enumerated;
+                    len += 2;
+                } else {
+                    len = BACNET_STATUS_ERROR;
+                }
+            } else {
+                len = bacjson_unsigned_parse(str, str_len, &number);
+                if (number > UINT32_MAX) {
+                    len = BACNET_STATUS_ERROR;
+                }
+                value->type.Enumerated = (uint32_t)number;
+            }
+            break;
+#endif
+#if defined(BACAPP_DATE)
+        case BACNET_APPLICATION_TAG_DATE:
+            if ((str_len > 0) && (str[0] == '"')) {
+                len = bacjson_quoted_end(
+                    bacjson_date_parse(&str[1], str_len - 1, &value->type.Date),
+                    str, str_len);
+            }
+            break;
+#endif
+#if defined(BACAPP_TIME)
+        case BACNET_APPLICATION_TAG_TIME:
+            if ((str_len > 0) && (str[0] == '"')) {
+                len = bacjson_quoted_end(
+                    bacjson_time_parse(&str[1], str_len - 1, &value->type.Time),
+                    str, str_len);
+            }
+            break;
+#endif
+#if defined(BACAPP_OBJECT_ID)
+        case BACNET_APPLICATION_TAG_OBJECT_ID:
+            len = bacjson_object_id_parse(
+                str, str_len, &value->type.Object_Id);
+            break;
+#endif
+#if defined(BACAPP_DATETIME)
+        case BACNET_APPLICATION_TAG_DATETIME:
+            if ((str_len > 0) && (str[0] == '"')) {
+                len = bacjson_date_parse(
+                    &str[1], str_len - 1, &value->type.Date_Time.date);
+                if ((len > 0) && ((size_t)(len + 1) < str_len) &&
+                    (str[len + 1] == 'T')) {
+                    offset = (size_t)len + 2;
+                    len = bacjson_time_parse(&str[offset], str_len - offset,
+                        &value->type.Date_Time.time);
+                    if (len > 0) {
+                        len = bacjson_quoted_end(
+                            (int)(offset - 1) + len, str, str_len);
+                    }
+                } else {
+                    len = BACNET_STATUS_ERROR;
+                }
+            }
+            break;
+#endif
+        default:
+            break;
+    }
+    if (len <= 0) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    return (int)skip + len;
+}
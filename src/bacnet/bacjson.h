@@ -0,0 +1,74 @@
+/**
+ * @file
+ * @brief API for a streaming JSON and CSV writer of BACnet application
+ * data values, and a parser of the JSON values it writes.
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_JSON_H
+#define BACNET_JSON_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+
+/* significant digits written for REAL and DOUBLE values,
+   enough for a REAL to be read back unchanged */
+#ifndef BACJSON_REAL_DIGITS
+#define BACJSON_REAL_DIGITS 9
+#endif
+#ifndef BACJSON_DOUBLE_DIGITS
+#define BACJSON_DOUBLE_DIGITS 15
+#endif
+/* most digits written after the decimal point */
+#ifndef BACJSON_DECIMALS_MAX
+#define BACJSON_DECIMALS_MAX 6
+#endif
+
+/* a caller buffer that JSON or CSV text is appended to */
+typedef struct bacjson_writer_t {
+    char *buffer; /* text, always null terminated */
+    size_t size; /* size of the buffer, including the null terminator */
+    size_t length; /* number of characters of text in the buffer */
+} BACJSON_WRITER;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void bacjson_writer_init(BACJSON_WRITER *writer, char *buffer, size_t size);
+BACNET_STACK_EXPORT
+void bacjson_writer_reset(BACJSON_WRITER *writer);
+BACNET_STACK_EXPORT
+size_t bacjson_writer_length(BACJSON_WRITER const *writer);
+
+BACNET_STACK_EXPORT
+bool bacjson_value_encode(BACJSON_WRITER *writer,
+    BACNET_OBJECT_TYPE object_type,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_APPLICATION_DATA_VALUE *value);
+BACNET_STACK_EXPORT
+bool bacjson_property_value_encode(
+    BACJSON_WRITER *writer, BACNET_OBJECT_PROPERTY_VALUE *object_value);
+BACNET_STACK_EXPORT
+bool bacjson_csv_property_value_encode(
+    BACJSON_WRITER *writer, BACNET_OBJECT_PROPERTY_VALUE *object_value);
+
+BACNET_STACK_EXPORT
+int bacjson_value_parse(const char *str,
+    size_t str_len,
+    BACNET_APPLICATION_TAG tag,
+    BACNET_OBJECT_TYPE object_type,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_APPLICATION_DATA_VALUE *value);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
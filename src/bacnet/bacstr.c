@@ -391,7 +391,6 @@ bool characterstring_init(BACNET_CHARACTER_STRING *char_string,
     size_t length)
 {
     bool status = false; /* return value */
-    size_t i; /* counter */
 
     if (char_string) {
         char_string->length = 0;
@@ -400,19 +399,12 @@ bool characterstring_init(BACNET_CHARACTER_STRING *char_string,
            note: assumes printable characters */
         if (length <= CHARACTER_STRING_CAPACITY) {
             if (value) {
-                for (i = 0; i < MAX_CHARACTER_STRING_BYTES; i++) {
-                    if (i < length) {
-                        char_string->value[char_string->length] = value[i];
-                        char_string->length++;
-                    } else {
-                        char_string->value[i] = 0;
-                    }
-                }
-            } else {
-                for (i = 0; i < MAX_CHARACTER_STRING_BYTES; i++) {
-                    char_string->value[i] = 0;
-                }
+                memmove(char_string->value, value, length);
+                char_string->length = length;
             }
+            /* clear the unused bytes, which also terminates the string */
+            memset(&char_string->value[char_string->length], 0,
+                MAX_CHARACTER_STRING_BYTES - char_string->length);
             status = true;
         }
     }
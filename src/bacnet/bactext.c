@@ -43,6 +43,51 @@
 static const char *ASHRAE_Reserved_String = "Reserved for Use by ASHRAE";
 static const char *Vendor_Proprietary_String = "Vendor Proprietary Value";
 
+#if BACTEXT_INDEX_TABLES
+/* direct lookup tables for the longest lists */
+static const char *Object_Type_Table[OBJECT_PROPRIETARY_MIN];
+static const char *Property_Table[PROP_RESERVED_RANGE_MAX + 1];
+static const char *Engineering_Unit_Table[UNITS_RESERVED_RANGE_MAX + 1];
+static INDTEXT_INDEX Object_Type_Index;
+static INDTEXT_INDEX Property_Index;
+static INDTEXT_INDEX Engineering_Unit_Index;
+static bool Index_Tables_Ready;
+#define BACTEXT_INDEX(index_table) (&(index_table))
+#else
+/* without lookup tables, the lists are searched */
+#define BACTEXT_INDEX(index_table) NULL
+#endif
+
+/**
+ * @brief Find the string of an index in one of the longest lists, with
+ *  the lookup table once it is built
+ * @param index_table - lookup table of the list
+ * @param data_list - list of index and text pairs
+ * @param index - index to find
+ * @param default_string - string to return if the index is not found
+ * @return the matching string, or default_string if not found
+ */
+static const char *bactext_index_name_default(INDTEXT_INDEX *index_table,
+    INDTEXT_DATA *data_list,
+    unsigned index,
+    const char *default_string)
+{
+    const char *pString;
+
+#if BACTEXT_INDEX_TABLES
+    if (Index_Tables_Ready) {
+        pString = indtext_index_by_index(index_table, index);
+    } else {
+        pString = indtext_by_index(data_list, index);
+    }
+#else
+    (void)index_table;
+    pString = indtext_by_index(data_list, index);
+#endif
+
+    return pString ? pString : default_string;
+}
+
 /* Search for a text value first based on the corresponding text list, then by
  * attempting to convert to an integer value. */
 static bool bactext_strtol_index(
@@ -245,9 +290,17 @@ INDTEXT_DATA bacnet_object_type_names[] = { { OBJECT_ANALOG_INPUT,
 
 const char *bactext_object_type_name(unsigned index)
 {
-    return indtext_by_index_split_default(bacnet_object_type_names, index,
-        OBJECT_PROPRIETARY_MIN, ASHRAE_Reserved_String,
-        Vendor_Proprietary_String);
+    return bactext_index_name_default(BACTEXT_INDEX(Object_Type_Index),
+        bacnet_object_type_names, index,
+        (index < OBJECT_PROPRIETARY_MIN) ? ASHRAE_Reserved_String
+                                         : Vendor_Proprietary_String);
+}
+
+const char *bactext_object_type_name_default(
+    unsigned index, const char *default_string)
+{
+    return bactext_index_name_default(BACTEXT_INDEX(Object_Type_Index),
+        bacnet_object_type_names, index, default_string);
 }
 
 bool bactext_object_type_index(const char *search_name, unsigned *found_index)
@@ -767,7 +820,7 @@ const char *bactext_property_name(unsigned index)
     if (bactext_property_name_proprietary(index)) {
         return Vendor_Proprietary_String;
     } else {
-        return indtext_by_index_default(
+        return bactext_index_name_default(BACTEXT_INDEX(Property_Index),
             bacnet_property_names, index, ASHRAE_Reserved_String);
     }
 }
@@ -775,7 +828,7 @@ const char *bactext_property_name(unsigned index)
 const char *bactext_property_name_default(
     unsigned index, const char *default_string)
 {
-    return indtext_by_index_default(
+    return bactext_index_name_default(BACTEXT_INDEX(Property_Index),
         bacnet_property_names, index, default_string);
 }
 
@@ -1049,13 +1102,21 @@ const char *bactext_engineering_unit_name(unsigned index)
     if (bactext_engineering_unit_name_proprietary(index)) {
         return Vendor_Proprietary_String;
     } else if (index <= UNITS_RESERVED_RANGE_MAX2) {
-        return indtext_by_index_default(
+        return bactext_index_name_default(
+            BACTEXT_INDEX(Engineering_Unit_Index),
             bacnet_engineering_unit_names, index, ASHRAE_Reserved_String);
     }
 
     return ASHRAE_Reserved_String;
 }
 
+const char *bactext_engineering_unit_name_default(
+    unsigned index, const char *default_string)
+{
+    return bactext_index_name_default(BACTEXT_INDEX(Engineering_Unit_Index),
+        bacnet_engineering_unit_names, index, default_string);
+}
+
 bool bactext_engineering_unit_index(
     const char *search_name, unsigned *found_index)
 {
@@ -1474,6 +1535,13 @@ const char *bactext_event_state_name(unsigned index)
         bacnet_event_state_names, index, ASHRAE_Reserved_String);
 }
 
+const char *bactext_event_state_name_default(
+    unsigned index, const char *default_string)
+{
+    return indtext_by_index_default(
+        bacnet_event_state_names, index, default_string);
+}
+
 bool bactext_event_state_index(const char *search_name, unsigned *found_index)
 {
     return indtext_by_istring(
@@ -1530,6 +1598,13 @@ const char *bactext_binary_present_value_name(unsigned index)
         bacnet_binary_present_value_names, index, ASHRAE_Reserved_String);
 }
 
+const char *bactext_binary_present_value_name_default(
+    unsigned index, const char *default_string)
+{
+    return indtext_by_index_default(
+        bacnet_binary_present_value_names, index, default_string);
+}
+
 bool bactext_binary_present_value_index(
     const char *search_name, unsigned *found_index)
 {
@@ -1608,6 +1683,13 @@ const char *bactext_segmentation_name(unsigned index)
         bacnet_segmentation_names, index, ASHRAE_Reserved_String);
 }
 
+const char *bactext_segmentation_name_default(
+    unsigned index, const char *default_string)
+{
+    return indtext_by_index_default(
+        bacnet_segmentation_names, index, default_string);
+}
+
 bool bactext_segmentation_index(const char *search_name, unsigned *found_index)
 {
     return indtext_by_istring(
@@ -1810,3 +1892,25 @@ const char *bactext_device_communications_name(unsigned index)
     return indtext_by_index_default(
         bacnet_device_communications_names, index, ASHRAE_Reserved_String);
 }
+
+/**
+ * @brief Build the direct lookup tables of the object type, property and
+ *  engineering unit names.  Until then, the names are found by searching
+ *  the lists.  Call this once at startup, before names are looked up from
+ *  other threads: the lookups never build the tables themselves.
+ */
+void bactext_index_init(void)
+{
+#if BACTEXT_INDEX_TABLES
+    if (Index_Tables_Ready) {
+        return;
+    }
+    indtext_index_init(&Object_Type_Index, bacnet_object_type_names,
+        Object_Type_Table, OBJECT_PROPRIETARY_MIN);
+    indtext_index_init(&Property_Index, bacnet_property_names, Property_Table,
+        PROP_RESERVED_RANGE_MAX + 1);
+    indtext_index_init(&Engineering_Unit_Index, bacnet_engineering_unit_names,
+        Engineering_Unit_Table, UNITS_RESERVED_RANGE_MAX + 1);
+    Index_Tables_Ready = true;
+#endif
+}
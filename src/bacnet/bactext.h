@@ -29,6 +29,12 @@
 #define BACTEXT_PRINT_ENABLED
 #endif
 
+/* direct lookup tables for the object type, property and unit names,
+   built by bactext_index_init(), at the cost of about 2K pointers of RAM */
+#ifndef BACTEXT_INDEX_TABLES
+#define BACTEXT_INDEX_TABLES 0
+#endif
+
 #include <stdbool.h>
 #include <stdint.h>
 /* BACnet Stack defines - first */
@@ -40,6 +46,10 @@
 extern "C" {
 #endif /* __cplusplus */
 
+    BACNET_STACK_EXPORT
+    void bactext_index_init(
+        void);
+
     BACNET_STACK_EXPORT
     const char *bactext_confirmed_service_name(
         unsigned index);
@@ -57,6 +67,10 @@ extern "C" {
     const char *bactext_object_type_name(
         unsigned index);
     BACNET_STACK_EXPORT
+    const char *bactext_object_type_name_default(
+        unsigned index,
+        const char *default_string);
+    BACNET_STACK_EXPORT
     bool bactext_object_type_index(
         const char *search_name,
         unsigned *found_index);
@@ -95,6 +109,10 @@ extern "C" {
     const char *bactext_engineering_unit_name(
         unsigned index);
     BACNET_STACK_EXPORT
+    const char *bactext_engineering_unit_name_default(
+        unsigned index,
+        const char *default_string);
+    BACNET_STACK_EXPORT
     bool bactext_engineering_unit_index(
         const char *search_name,
         unsigned *found_index);
@@ -131,6 +149,10 @@ extern "C" {
     const char *bactext_event_state_name(
         unsigned index);
     BACNET_STACK_EXPORT
+    const char *bactext_event_state_name_default(
+        unsigned index,
+        const char *default_string);
+    BACNET_STACK_EXPORT
     bool bactext_event_state_index(
         const char *search_name, unsigned *found_index);
     BACNET_STACK_EXPORT
@@ -145,6 +167,10 @@ extern "C" {
     const char *bactext_binary_present_value_name(
         unsigned index);
     BACNET_STACK_EXPORT
+    const char *bactext_binary_present_value_name_default(
+        unsigned index,
+        const char *default_string);
+    BACNET_STACK_EXPORT
     const char *bactext_binary_polarity_name(
         unsigned index);
     BACNET_STACK_EXPORT
@@ -160,6 +186,10 @@ extern "C" {
     BACNET_STACK_EXPORT
     const char *bactext_segmentation_name(
         unsigned index);
+    BACNET_STACK_EXPORT
+    const char *bactext_segmentation_name_default(
+        unsigned index,
+        const char *default_string);
     BACNET_STACK_EXPORT
 	bool bactext_segmentation_index(
 		const char *search_name,
@@ -33,6 +33,7 @@
 ####COPYRIGHTEND####*/
 
 #include <stdio.h> /* for standard i/o, like printing */
+#include <stdlib.h> /* for calloc */
 #include <stdint.h> /* for standard integer types uint8_t etc. */
 #include <stdbool.h> /* for the standard bool type. */
 #include <string.h> /* for memcpy */
@@ -41,6 +42,7 @@
 #include "bacnet/datalink/bip.h"
 #include "bacnet/datalink/bvlc.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/keylist.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/bbmd/h_bbmd.h"
 
@@ -93,6 +95,39 @@ static BACNET_IP_BROADCAST_DISTRIBUTION_TABLE_ENTRY
 #define MAX_FD_ENTRIES 128
 #endif
 static BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY FD_Table[MAX_FD_ENTRIES];
+/* Broadcast forwarding limits - zero disables the limit */
+static uint16_t BBMD_Rate_Limit;
+static uint16_t BBMD_Rate_Burst;
+static uint16_t BBMD_Duplicate_Seconds;
+/* number of broadcast sources that are tracked */
+#ifndef BBMD_SOURCE_ENTRIES_MAX
+#define BBMD_SOURCE_ENTRIES_MAX 256
+#endif
+/* seconds that a source is tracked after its last broadcast */
+#ifndef BBMD_SOURCE_IDLE_SECONDS
+#define BBMD_SOURCE_IDLE_SECONDS 300
+#endif
+/* number of recently forwarded broadcasts that are remembered */
+#ifndef BBMD_DUPLICATE_ENTRIES_MAX
+#define BBMD_DUPLICATE_ENTRIES_MAX 256
+#endif
+struct bbmd_source {
+    BACNET_IP_ADDRESS addr;
+    uint16_t tokens;
+    uint16_t idle_seconds;
+    BVLC_BBMD_COUNTERS counters;
+};
+/* broadcast sources, keyed by a hash of their IPv4 address and port */
+static OS_Keylist BBMD_Source_List;
+/* shared by the sources that do not fit in the source list */
+static struct bbmd_source BBMD_Source_Overflow;
+struct bbmd_duplicate {
+    uint16_t npdu_len;
+    uint16_t age_seconds;
+};
+/* recently forwarded broadcasts, keyed by a hash of origin and NPDU */
+static OS_Keylist BBMD_Duplicate_List;
+static BVLC_BBMD_COUNTERS BBMD_Counters;
 #endif
 
 /**
@@ -260,6 +295,330 @@ void bvlc_bdt_restore_local(void)
 #endif
 #endif
 
+#if BBMD_ENABLED
+/**
+ * @brief Get the key of a broadcast source
+ * @param addr - B/IP address of the source
+ * @return key for the source list
+ */
+static KEY bbmd_source_key(const BACNET_IP_ADDRESS *addr)
+{
+    KEY key = 2166136261UL;
+    unsigned i;
+
+    for (i = 0; i < IP_ADDRESS_MAX; i++) {
+        key ^= addr->address[i];
+        key *= 16777619UL;
+    }
+    key ^= (addr->port >> 8);
+    key *= 16777619UL;
+    key ^= (addr->port & 0xFF);
+    key *= 16777619UL;
+
+    return key;
+}
+
+/**
+ * @brief Find a broadcast source in a run of sources with the same key
+ * @param addr - B/IP address of the source
+ * @param key - key of the source
+ * @param index - index of a source with the key
+ * @param step - direction to search the run, +1 or -1
+ * @return the source, or NULL if it is not in the run
+ */
+static struct bbmd_source *bbmd_source_run_find(
+    const BACNET_IP_ADDRESS *addr, KEY key, int index, int step)
+{
+    struct bbmd_source *source;
+    KEY list_key = 0;
+
+    while (Keylist_Index_Key(BBMD_Source_List, index, &list_key) &&
+        (list_key == key)) {
+        source = Keylist_Data_Index(BBMD_Source_List, index);
+        if (source && !bvlc_address_different(&source->addr, addr)) {
+            return source;
+        }
+        index += step;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Find a tracked broadcast source
+ * @param addr - B/IP address of the source
+ * @return the source, or NULL if it is not tracked
+ */
+static struct bbmd_source *bbmd_source_lookup(const BACNET_IP_ADDRESS *addr)
+{
+    struct bbmd_source *source;
+    KEY key;
+    int index;
+
+    key = bbmd_source_key(addr);
+    index = Keylist_Index(BBMD_Source_List, key);
+    if (index < 0) {
+        return NULL;
+    }
+    source = bbmd_source_run_find(addr, key, index, -1);
+    if (!source) {
+        source = bbmd_source_run_find(addr, key, index + 1, 1);
+    }
+
+    return source;
+}
+
+/**
+ * @brief Find a broadcast source, and start to track it if it is new
+ * @param addr - B/IP address of the source
+ * @return the source, or the shared overflow source if there is no room
+ *  to track it
+ */
+static struct bbmd_source *bbmd_source_find(const BACNET_IP_ADDRESS *addr)
+{
+    struct bbmd_source *source;
+
+    source = bbmd_source_lookup(addr);
+    if (source) {
+        return source;
+    }
+    if (Keylist_Count(BBMD_Source_List) >= BBMD_SOURCE_ENTRIES_MAX) {
+        return &BBMD_Source_Overflow;
+    }
+    source = calloc(1, sizeof(struct bbmd_source));
+    if (!source) {
+        return &BBMD_Source_Overflow;
+    }
+    bvlc_address_copy(&source->addr, addr);
+    source->tokens = BBMD_Rate_Burst;
+    if (Keylist_Data_Add(BBMD_Source_List, bbmd_source_key(addr), source) <
+        0) {
+        free(source);
+        return &BBMD_Source_Overflow;
+    }
+
+    return source;
+}
+
+/**
+ * @brief Refill the rate limit of a broadcast source
+ * @param source - the broadcast source
+ * @param seconds - number of elapsed seconds since the last refill
+ */
+static void bbmd_source_refill(struct bbmd_source *source, uint16_t seconds)
+{
+    uint32_t tokens;
+
+    tokens = source->tokens + ((uint32_t)BBMD_Rate_Limit * seconds);
+    if (tokens > BBMD_Rate_Burst) {
+        tokens = BBMD_Rate_Burst;
+    }
+    source->tokens = (uint16_t)tokens;
+}
+
+/**
+ * @brief Hash the origin and the NPDU of a broadcast (FNV-1a)
+ * @param origin - B/IP address of the device that originated the broadcast
+ * @param npdu - the NPDU
+ * @param npdu_len - number of bytes in the NPDU
+ * @return key for the duplicate list
+ */
+static KEY bbmd_duplicate_key(
+    const BACNET_IP_ADDRESS *origin, const uint8_t *npdu, uint16_t npdu_len)
+{
+    KEY key = 2166136261UL;
+    unsigned i;
+
+    for (i = 0; i < IP_ADDRESS_MAX; i++) {
+        key ^= origin->address[i];
+        key *= 16777619UL;
+    }
+    key ^= (origin->port >> 8);
+    key *= 16777619UL;
+    key ^= (origin->port & 0xFF);
+    key *= 16777619UL;
+    for (i = 0; i < npdu_len; i++) {
+        key ^= npdu[i];
+        key *= 16777619UL;
+    }
+
+    return key;
+}
+
+/**
+ * @brief Check a broadcast against the forwarding limits, and count it
+ *  for the B/IP node that originated it
+ * @param origin - B/IP address of the device that originated the broadcast
+ * @param npdu - the NPDU
+ * @param npdu_len - number of bytes in the NPDU
+ * @return true if the broadcast may be forwarded
+ */
+static bool bbmd_forward_allowed(
+    const BACNET_IP_ADDRESS *origin, const uint8_t *npdu, uint16_t npdu_len)
+{
+    struct bbmd_source *source;
+    struct bbmd_duplicate *duplicate = NULL;
+    KEY key = 0;
+
+    source = bbmd_source_find(origin);
+    source->idle_seconds = 0;
+    if (BBMD_Duplicate_Seconds) {
+        key = bbmd_duplicate_key(origin, npdu, npdu_len);
+        duplicate = Keylist_Data(BBMD_Duplicate_List, key);
+        if (duplicate && (duplicate->npdu_len == npdu_len)) {
+            BBMD_Counters.duplicates++;
+            source->counters.duplicates++;
+            debug_print_bip("Dropped duplicate broadcast from", origin);
+            return false;
+        }
+    }
+    if (BBMD_Rate_Limit) {
+        if (source->tokens == 0) {
+            BBMD_Counters.rate_limited++;
+            source->counters.rate_limited++;
+            debug_print_bip("Dropped rate limited broadcast from", origin);
+            return false;
+        }
+        source->tokens--;
+    }
+    if (BBMD_Duplicate_Seconds && !duplicate &&
+        (Keylist_Count(BBMD_Duplicate_List) < BBMD_DUPLICATE_ENTRIES_MAX)) {
+        duplicate = calloc(1, sizeof(struct bbmd_duplicate));
+        if (duplicate) {
+            duplicate->npdu_len = npdu_len;
+            if (Keylist_Data_Add(BBMD_Duplicate_List, key, duplicate) < 0) {
+                free(duplicate);
+            }
+        }
+    }
+    BBMD_Counters.forwarded++;
+    source->counters.forwarded++;
+
+    return true;
+}
+
+/**
+ * @brief Refill the rate limits of the broadcast sources, and forget
+ *  the sources and broadcasts that are no longer needed
+ * @param seconds - number of elapsed seconds since the last call
+ */
+static void bbmd_forward_limit_timer(uint16_t seconds)
+{
+    struct bbmd_source *source;
+    struct bbmd_duplicate *duplicate;
+    int index;
+
+    bbmd_source_refill(&BBMD_Source_Overflow, seconds);
+    index = Keylist_Count(BBMD_Source_List);
+    while (index > 0) {
+        index--;
+        source = Keylist_Data_Index(BBMD_Source_List, index);
+        if (!source) {
+            continue;
+        }
+        bbmd_source_refill(source, seconds);
+        if ((seconds < BBMD_SOURCE_IDLE_SECONDS) &&
+            (source->idle_seconds < (BBMD_SOURCE_IDLE_SECONDS - seconds))) {
+            source->idle_seconds += seconds;
+        } else if (source->tokens == BBMD_Rate_Burst) {
+            (void)Keylist_Data_Delete_By_Index(BBMD_Source_List, index);
+            free(source);
+        }
+    }
+    index = Keylist_Count(BBMD_Duplicate_List);
+    while (index > 0) {
+        index--;
+        duplicate = Keylist_Data_Index(BBMD_Duplicate_List, index);
+        if (!duplicate) {
+            continue;
+        }
+        if ((seconds < BBMD_Duplicate_Seconds) &&
+            (duplicate->age_seconds < (BBMD_Duplicate_Seconds - seconds))) {
+            duplicate->age_seconds += seconds;
+        } else {
+            (void)Keylist_Data_Delete_By_Index(BBMD_Duplicate_List, index);
+            free(duplicate);
+        }
+    }
+}
+
+/**
+ * @brief Limit the broadcasts that each B/IP node may have forwarded
+ *  to the peer BBMDs and foreign devices
+ * @param broadcasts_per_second - broadcasts a node may have forwarded
+ *  each second, or 0 for no limit
+ * @param burst - broadcasts a node may have forwarded at once,
+ *  or 0 for the same as broadcasts_per_second
+ */
+void bvlc_bbmd_rate_limit_set(uint16_t broadcasts_per_second, uint16_t burst)
+{
+    struct bbmd_source *source;
+    int index;
+
+    if (burst < broadcasts_per_second) {
+        burst = broadcasts_per_second;
+    }
+    BBMD_Rate_Limit = broadcasts_per_second;
+    BBMD_Rate_Burst = burst;
+    BBMD_Source_Overflow.tokens = burst;
+    for (index = 0; index < Keylist_Count(BBMD_Source_List); index++) {
+        source = Keylist_Data_Index(BBMD_Source_List, index);
+        if (source) {
+            source->tokens = burst;
+        }
+    }
+}
+
+/**
+ * @brief Forward a broadcast only once when the same broadcast from
+ *  the same origin is received again within a number of seconds
+ * @param seconds - number of seconds to remember a forwarded broadcast,
+ *  or 0 to forward every copy
+ */
+void bvlc_bbmd_duplicate_window_set(uint16_t seconds)
+{
+    BBMD_Duplicate_Seconds = seconds;
+    if (!seconds) {
+        Keylist_Data_Free(BBMD_Duplicate_List);
+    }
+}
+
+/**
+ * @brief Get the forwarding counters of the broadcasts originated by
+ *  a B/IP node
+ * @param addr - B/IP address and port of the node
+ * @param counters - the counters, returned
+ * @return true if the node is tracked
+ */
+bool bvlc_bbmd_source_counters(
+    const BACNET_IP_ADDRESS *addr, BVLC_BBMD_COUNTERS *counters)
+{
+    struct bbmd_source *source;
+
+    if (!addr || !counters) {
+        return false;
+    }
+    source = bbmd_source_lookup(addr);
+    if (!source) {
+        return false;
+    }
+    *counters = source->counters;
+
+    return true;
+}
+
+/**
+ * @brief Get the forwarding counters of all the broadcasts received
+ * @param counters - the counters, returned
+ */
+void bvlc_bbmd_counters(BVLC_BBMD_COUNTERS *counters)
+{
+    if (counters) {
+        *counters = BBMD_Counters;
+    }
+}
+#endif
+
 /** A timer function that is called about once a second.
  *
  * @param seconds - number of elapsed seconds since the last call
@@ -268,6 +627,7 @@ void bvlc_maintenance_timer(uint16_t seconds)
 {
 #if BBMD_ENABLED
     bvlc_foreign_device_table_maintenance_timer(&FD_Table[0], seconds);
+    bbmd_forward_limit_timer(seconds);
 #else
     (void)seconds;
 #endif
@@ -950,21 +1310,24 @@ int bvlc_bbmd_enabled_handler(BACNET_IP_ADDRESS *addr,
                     debug_print_string("Dropped Forwarded-NPDU from me!");
                     break;
                 }
-                if (bbmd_bdt_member_mask_is_unicast(addr)) {
-                    /*  Upon receipt of a BVLL Forwarded-NPDU message
-                        from a BBMD which is in the receiving BBMD's BDT,
-                        a BBMD shall construct a BVLL Forwarded-NPDU and
-                        transmit it via broadcast to B/IPv4 devices in the
-                        local broadcast domain. */
-                    bip_get_broadcast_addr(&broadcast_address);
-                    bip_send_mpdu(&broadcast_address, mtu, mtu_len);
-                }
-                /*  In addition, the constructed BVLL Forwarded-NPDU
-                    message shall be unicast to each foreign device in
-                    the BBMD's FDT. */
                 offset = header_len + function_len - npdu_len;
                 npdu = &mtu[offset];
-                (void)bbmd_fdt_forward_npdu(&fwd_address, npdu, npdu_len, false);
+                if (bbmd_forward_allowed(&fwd_address, npdu, npdu_len)) {
+                    if (bbmd_bdt_member_mask_is_unicast(addr)) {
+                        /*  Upon receipt of a BVLL Forwarded-NPDU message
+                            from a BBMD which is in the receiving BBMD's BDT,
+                            a BBMD shall construct a BVLL Forwarded-NPDU and
+                            transmit it via broadcast to B/IPv4 devices in
+                            the local broadcast domain. */
+                        bip_get_broadcast_addr(&broadcast_address);
+                        bip_send_mpdu(&broadcast_address, mtu, mtu_len);
+                    }
+                    /*  In addition, the constructed BVLL Forwarded-NPDU
+                        message shall be unicast to each foreign device in
+                        the BBMD's FDT. */
+                    (void)bbmd_fdt_forward_npdu(
+                        &fwd_address, npdu, npdu_len, false);
+                }
                 /* prepare the message for me! */
                 bvlc_ip_address_to_bacnet_local(src, &fwd_address);
                 debug_print_npdu("Forwarded-NPDU", offset, npdu_len);
@@ -1065,7 +1428,11 @@ int bvlc_bbmd_enabled_handler(BACNET_IP_ADDRESS *addr,
                it shall return a BVLC-Result message to the foreign device
                with a result code of X'0060' indicating that the forwarding
                attempt was unsuccessful */
-            npdu_len = bbmd_forward_npdu(addr, pdu, pdu_len);
+            if (bbmd_forward_allowed(addr, pdu, pdu_len)) {
+                npdu_len = bbmd_forward_npdu(addr, pdu, pdu_len);
+            } else {
+                npdu_len = 0;
+            }
             if (npdu_len > 0) {
                 (void)bbmd_fdt_forward_npdu(addr, pdu, pdu_len, false);
                 (void)bbmd_bdt_forward_npdu(addr, pdu, pdu_len, false);
@@ -1132,7 +1499,7 @@ int bvlc_bbmd_enabled_handler(BACNET_IP_ADDRESS *addr,
                     offset = 0;
                     debug_print_string("Dropped Original-Broadcast-NPDU: "
                                        "Confirmed Service!");
-                } else {
+                } else if (bbmd_forward_allowed(addr, npdu, npdu_len)) {
                     (void)bbmd_fdt_forward_npdu(addr, npdu, npdu_len, true);
                     (void)bbmd_bdt_forward_npdu(addr, npdu, npdu_len, true);
                     debug_print_npdu(
@@ -1408,6 +1775,17 @@ void bvlc_init(void)
     bvlc_broadcast_distribution_table_link_array(
         &BBMD_Table[0], MAX_BBMD_ENTRIES);
     bvlc_foreign_device_table_link_array(&FD_Table[0], MAX_FD_ENTRIES);
+    if (!BBMD_Source_List) {
+        BBMD_Source_List = Keylist_Create();
+    }
+    if (!BBMD_Duplicate_List) {
+        BBMD_Duplicate_List = Keylist_Create();
+    }
+    Keylist_Data_Free(BBMD_Source_List);
+    Keylist_Data_Free(BBMD_Duplicate_List);
+    memset(&BBMD_Source_Overflow, 0, sizeof(BBMD_Source_Overflow));
+    BBMD_Source_Overflow.tokens = BBMD_Rate_Burst;
+    memset(&BBMD_Counters, 0, sizeof(BBMD_Counters));
 #else
     debug_print_string("Initializing (BBMD Disabled).");
 #endif
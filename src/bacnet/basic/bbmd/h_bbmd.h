@@ -37,6 +37,16 @@
 /* BACnet Stack API */
 #include "bacnet/datalink/bvlc.h"
 
+/* counters of the broadcasts that a BBMD received for forwarding */
+typedef struct BVLC_BBMD_Counters {
+    /* forwarded to the peer BBMDs, foreign devices or local subnet */
+    uint32_t forwarded;
+    /* dropped because the node sent too many broadcasts */
+    uint32_t rate_limited;
+    /* dropped because the same broadcast was already forwarded */
+    uint32_t duplicates;
+} BVLC_BBMD_COUNTERS;
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -155,6 +165,26 @@ void bvlc_set_global_address_for_nat(const BACNET_IP_ADDRESS *addr);
 BACNET_STACK_EXPORT
 void bvlc_disable_nat(void);
 
+/* Limit the broadcasts forwarded for each B/IP node. 0 disables the limit.
+ */
+BACNET_STACK_EXPORT
+void bvlc_bbmd_rate_limit_set(uint16_t broadcasts_per_second, uint16_t burst);
+
+/* Forward the same broadcast only once within a number of seconds.
+ * 0 disables the check.
+ */
+BACNET_STACK_EXPORT
+void bvlc_bbmd_duplicate_window_set(uint16_t seconds);
+
+/* Get the forwarding counters for a B/IP node */
+BACNET_STACK_EXPORT
+bool bvlc_bbmd_source_counters(
+    const BACNET_IP_ADDRESS *addr, BVLC_BBMD_COUNTERS *counters);
+
+/* Get the forwarding counters for all B/IP nodes */
+BACNET_STACK_EXPORT
+void bvlc_bbmd_counters(BVLC_BBMD_COUNTERS *counters);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
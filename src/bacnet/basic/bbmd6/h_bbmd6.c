@@ -33,6 +33,7 @@
 ####COPYRIGHTEND####*/
 
 #include <stdio.h> /* for standard i/o, like printing */
+#include <stdlib.h> /* for realloc */
 #include <stdint.h> /* for standard integer types uint8_t etc. */
 #include <stdbool.h> /* for the standard bool type. */
 #include <string.h> /* for memcpy */
@@ -82,17 +83,36 @@ static uint16_t Remote_BBMD_TTL_Seconds;
 /* local buffer & length for sending */
 static uint8_t BVLC6_Buffer[BIP6_MPDU_MAX];
 static uint16_t BVLC6_Buffer_Len;
-/* Broadcast Distribution Table */
+/* Broadcast Distribution Table - grows as peers are added, up to */
 #ifndef MAX_BBMD6_ENTRIES
 #define MAX_BBMD6_ENTRIES 128
 #endif
-static BACNET_IP6_BROADCAST_DISTRIBUTION_TABLE_ENTRY
-    BBMD_Table[MAX_BBMD6_ENTRIES];
-/* Foreign Device Table */
+/* the valid entries, packed at the front of the table */
+static BACNET_IP6_ADDRESS *BBMD_Table;
+static unsigned BBMD_Table_Count;
+static unsigned BBMD_Table_Size;
+/* Foreign Device Table - grows as foreign devices register, up to */
 #ifndef MAX_FD6_ENTRIES
 #define MAX_FD6_ENTRIES 128
 #endif
-static BACNET_IP6_FOREIGN_DEVICE_TABLE_ENTRY FD_Table[MAX_FD6_ENTRIES];
+struct bbmd6_fdt_entry {
+    BACNET_IP6_ADDRESS bip6_address;
+    /* requested time-to-live value */
+    uint16_t ttl_seconds;
+    /* BBMD6_Seconds when the entry is purged */
+    uint32_t purge_seconds;
+};
+/* the valid entries, packed at the front of the table */
+static struct bbmd6_fdt_entry *FD_Table;
+static unsigned FD_Table_Count;
+static unsigned FD_Table_Size;
+/* seconds counted by the maintenance timer */
+static uint32_t BBMD6_Seconds;
+/* the earliest purge time in the Foreign Device Table */
+static uint32_t FD_Table_Purge_Seconds;
+/* the destinations of a forwarded message */
+static BACNET_IP6_ADDRESS *BBMD6_Dest_List;
+static unsigned BBMD6_Dest_List_Size;
 #endif
 
 /**
@@ -113,23 +133,26 @@ void bvlc6_maintenance_timer(uint16_t seconds)
 #if defined(BACDL_BIP6) && BBMD6_ENABLED
     unsigned i = 0;
 
-    for (i = 0; i < MAX_FD6_ENTRIES; i++) {
-        if (FD_Table[i].valid) {
-            if (FD_Table[i].ttl_seconds_remaining) {
-                if (FD_Table[i].ttl_seconds_remaining < seconds) {
-                    FD_Table[i].ttl_seconds_remaining = 0;
-                } else {
-                    FD_Table[i].ttl_seconds_remaining -= seconds;
-                }
-                if (FD_Table[i].ttl_seconds_remaining == 0) {
-                    FD_Table[i].valid = false;
+    BBMD6_Seconds += seconds;
+    /* the table is only walked when an entry is due to be purged */
+    if (FD_Table_Count && (BBMD6_Seconds >= FD_Table_Purge_Seconds)) {
+        FD_Table_Purge_Seconds = UINT32_MAX;
+        i = 0;
+        while (i < FD_Table_Count) {
+            if (BBMD6_Seconds >= FD_Table[i].purge_seconds) {
+                PRINTF("BVLC6: Purged Foreign Device %u.\n", i);
+                FD_Table_Count--;
+                FD_Table[i] = FD_Table[FD_Table_Count];
+            } else {
+                if (FD_Table[i].purge_seconds < FD_Table_Purge_Seconds) {
+                    FD_Table_Purge_Seconds = FD_Table[i].purge_seconds;
                 }
+                i++;
             }
         }
     }
-#else
-    (void)seconds;    
 #endif
+    VMAC_Timer(seconds);
 }
 
 /**
@@ -219,7 +242,8 @@ static void bbmd6_add_vmac(uint32_t device_id, BACNET_IP6_ADDRESS *addr)
             vmac = VMAC_Find_By_Key(device_id);
             if (vmac) {
                 /* device ID already exists. Update MAC. */
-                memmove(vmac, &new_vmac, sizeof(struct vmac_data));
+                VMAC_Delete(device_id);
+                VMAC_Add(device_id, &new_vmac);
                 PRINTF("BVLC6: VMAC for %u [", 
                     (unsigned int)device_id);
                 for (i = 0; i < new_vmac.mac_len; i++) {
@@ -300,6 +324,300 @@ static bool bbmd6_address_from_bacnet_address(
     return status;
 }
 
+#if defined(BACDL_BIP6) && BBMD6_ENABLED
+/**
+ * @brief Grow a table to hold one more entry
+ * @param table - the table, which may be moved
+ * @param size - the number of entries the table holds, which is updated
+ * @param count - the number of entries in use
+ * @param entry_size - the size of an entry
+ * @param max_entries - the maximum number of entries
+ * @return true if the table has room for one more entry
+ */
+static bool bbmd6_table_reserve(void **table,
+    unsigned *size,
+    unsigned count,
+    size_t entry_size,
+    unsigned max_entries)
+{
+    void *new_table;
+    unsigned new_size;
+
+    if (count < *size) {
+        return true;
+    }
+    if (count >= max_entries) {
+        return false;
+    }
+    new_size = *size ? (*size * 2) : 8;
+    if (new_size > max_entries) {
+        new_size = max_entries;
+    }
+    new_table = realloc(*table, new_size * entry_size);
+    if (!new_table) {
+        return false;
+    }
+    *table = new_table;
+    *size = new_size;
+
+    return true;
+}
+
+/**
+ * @brief Find a peer BBMD in the Broadcast Distribution Table
+ * @param addr - B/IPv6 address of the peer
+ * @return index of the entry, or -1 if not found
+ */
+static int bbmd6_bdt_index(BACNET_IP6_ADDRESS *addr)
+{
+    unsigned i;
+
+    for (i = 0; i < BBMD_Table_Count; i++) {
+        if (!bvlc6_address_different(&BBMD_Table[i], addr)) {
+            return (int)i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Find a foreign device in the Foreign Device Table
+ * @param addr - B/IPv6 address of the foreign device
+ * @return index of the entry, or -1 if not found
+ */
+static int bbmd6_fdt_index(BACNET_IP6_ADDRESS *addr)
+{
+    unsigned i;
+
+    for (i = 0; i < FD_Table_Count; i++) {
+        if (!bvlc6_address_different(&FD_Table[i].bip6_address, addr)) {
+            return (int)i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Add or renew a foreign device registration
+ * @param addr - B/IPv6 address of the foreign device
+ * @param ttl_seconds - requested time-to-live
+ * @return true if the foreign device is registered
+ */
+static bool bbmd6_fdt_register(BACNET_IP6_ADDRESS *addr, uint16_t ttl_seconds)
+{
+    struct bbmd6_fdt_entry *entry;
+    uint32_t remaining;
+    int index;
+
+    index = bbmd6_fdt_index(addr);
+    if (index < 0) {
+        if (!bbmd6_table_reserve((void **)&FD_Table, &FD_Table_Size,
+                FD_Table_Count, sizeof(struct bbmd6_fdt_entry),
+                MAX_FD6_ENTRIES)) {
+            return false;
+        }
+        index = (int)FD_Table_Count;
+        FD_Table_Count++;
+        bvlc6_address_copy(&FD_Table[index].bip6_address, addr);
+    }
+    entry = &FD_Table[index];
+    entry->ttl_seconds = ttl_seconds;
+    /* plus a grace period of 30 seconds, with a maximum of 65535 */
+    remaining = (uint32_t)ttl_seconds + 30;
+    if (remaining > 65535) {
+        remaining = 65535;
+    }
+    entry->purge_seconds = BBMD6_Seconds + remaining;
+    if ((FD_Table_Count == 1) ||
+        (entry->purge_seconds < FD_Table_Purge_Seconds)) {
+        FD_Table_Purge_Seconds = entry->purge_seconds;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Remove a foreign device from the Foreign Device Table
+ * @param addr - B/IPv6 address of the foreign device
+ * @return true if the foreign device was in the table
+ */
+static bool bbmd6_fdt_delete(BACNET_IP6_ADDRESS *addr)
+{
+    int index;
+
+    index = bbmd6_fdt_index(addr);
+    if (index < 0) {
+        return false;
+    }
+    FD_Table_Count--;
+    FD_Table[index] = FD_Table[FD_Table_Count];
+
+    return true;
+}
+
+/**
+ * @brief Unicast a message to the peer BBMDs and the foreign devices
+ * @param mtu - the bytes of the message to send
+ * @param mtu_len - the number of bytes of the message to send
+ * @param bdt - true to send to each peer in the Broadcast Distribution Table
+ * @param exclude - B/IPv6 address to skip, such as the originator,
+ *  or NULL to send to all
+ */
+static void bbmd6_send_pdu_tables(uint8_t *mtu,
+    uint16_t mtu_len,
+    bool bdt,
+    BACNET_IP6_ADDRESS *exclude)
+{
+    BACNET_IP6_ADDRESS my_addr = { 0 };
+    BACNET_IP6_ADDRESS *dest;
+    unsigned count = 0;
+    unsigned i = 0;
+
+    if (!mtu || !mtu_len) {
+        return;
+    }
+    i = FD_Table_Count;
+    if (bdt) {
+        i += BBMD_Table_Count;
+    }
+    if (i > BBMD6_Dest_List_Size) {
+        dest = realloc(BBMD6_Dest_List, i * sizeof(BACNET_IP6_ADDRESS));
+        if (!dest) {
+            return;
+        }
+        BBMD6_Dest_List = dest;
+        BBMD6_Dest_List_Size = i;
+    }
+    bip6_get_addr(&my_addr);
+    if (bdt) {
+        for (i = 0; i < BBMD_Table_Count; i++) {
+            dest = &BBMD_Table[i];
+            if (bvlc6_address_different(&my_addr, dest) &&
+                (!exclude || bvlc6_address_different(exclude, dest))) {
+                bvlc6_address_copy(&BBMD6_Dest_List[count], dest);
+                count++;
+            }
+        }
+    }
+    for (i = 0; i < FD_Table_Count; i++) {
+        dest = &FD_Table[i].bip6_address;
+        if (bvlc6_address_different(&my_addr, dest) &&
+            (!exclude || bvlc6_address_different(exclude, dest))) {
+            bvlc6_address_copy(&BBMD6_Dest_List[count], dest);
+            count++;
+        }
+    }
+    if (count) {
+        bip6_send_mpdu_list(BBMD6_Dest_List, count, mtu, mtu_len);
+    }
+}
+
+/**
+ * @brief Add a peer BBMD to the Broadcast Distribution Table
+ * @param addr - B/IPv6 address of the peer
+ * @return true if the peer is in the table
+ */
+bool bvlc6_bdt_entry_add(BACNET_IP6_ADDRESS *addr)
+{
+    if (!addr) {
+        return false;
+    }
+    if (bbmd6_bdt_index(addr) >= 0) {
+        return true;
+    }
+    if (!bbmd6_table_reserve((void **)&BBMD_Table, &BBMD_Table_Size,
+            BBMD_Table_Count, sizeof(BACNET_IP6_ADDRESS),
+            MAX_BBMD6_ENTRIES)) {
+        return false;
+    }
+    bvlc6_address_copy(&BBMD_Table[BBMD_Table_Count], addr);
+    BBMD_Table_Count++;
+
+    return true;
+}
+
+/**
+ * @brief Remove a peer BBMD from the Broadcast Distribution Table
+ * @param addr - B/IPv6 address of the peer
+ * @return true if the peer was in the table
+ */
+bool bvlc6_bdt_entry_delete(BACNET_IP6_ADDRESS *addr)
+{
+    int index;
+
+    if (!addr) {
+        return false;
+    }
+    index = bbmd6_bdt_index(addr);
+    if (index < 0) {
+        return false;
+    }
+    BBMD_Table_Count--;
+    bvlc6_address_copy(&BBMD_Table[index], &BBMD_Table[BBMD_Table_Count]);
+
+    return true;
+}
+
+/**
+ * @brief Get the number of peers in the Broadcast Distribution Table
+ * @return number of peer BBMDs
+ */
+unsigned bvlc6_bdt_count(void)
+{
+    return BBMD_Table_Count;
+}
+
+/**
+ * @brief Get the number of registered foreign devices
+ * @return number of entries in the Foreign Device Table
+ */
+unsigned bvlc6_fdt_count(void)
+{
+    return FD_Table_Count;
+}
+
+/**
+ * @brief Get the seconds remaining before a foreign device is purged
+ * @param addr - B/IPv6 address of the foreign device
+ * @return seconds remaining, or 0 if the device is not registered
+ */
+uint16_t bvlc6_fdt_seconds_remaining(BACNET_IP6_ADDRESS *addr)
+{
+    int index;
+
+    if (!addr) {
+        return 0;
+    }
+    index = bbmd6_fdt_index(addr);
+    if (index < 0) {
+        return 0;
+    }
+
+    return (uint16_t)(FD_Table[index].purge_seconds - BBMD6_Seconds);
+}
+
+/**
+ * @brief Free the memory used by the BBMD tables
+ */
+static void bbmd6_tables_cleanup(void)
+{
+    free(BBMD_Table);
+    BBMD_Table = NULL;
+    BBMD_Table_Count = 0;
+    BBMD_Table_Size = 0;
+    free(FD_Table);
+    FD_Table = NULL;
+    FD_Table_Count = 0;
+    FD_Table_Size = 0;
+    free(BBMD6_Dest_List);
+    BBMD6_Dest_List = NULL;
+    BBMD6_Dest_List_Size = 0;
+}
+
+#endif
+
 /**
  * The common send function for BACnet/IPv6 application layer
  *
@@ -318,6 +636,9 @@ int bvlc6_send_pdu(BACNET_ADDRESS *dest,
     unsigned pdu_len)
 {
     BACNET_IP6_ADDRESS bvlc_dest = { 0 };
+#if defined(BACDL_BIP6) && BBMD6_ENABLED
+    BACNET_IP6_ADDRESS my_addr = { 0 };
+#endif
     uint8_t mtu[BIP6_MPDU_MAX] = { 0 };
     uint16_t mtu_len = 0;
     uint32_t vmac_src = 0;
@@ -342,6 +663,14 @@ int bvlc6_send_pdu(BACNET_ADDRESS *dest,
             mtu_len = bvlc6_encode_original_broadcast(
                 mtu, sizeof(mtu), vmac_src, pdu, pdu_len);
             PRINTF("BVLC6: Sent Original-Broadcast-NPDU.\n");
+#if defined(BACDL_BIP6) && BBMD6_ENABLED
+            /* as a BBMD, also forward it to the peers and foreign devices */
+            bip6_get_addr(&my_addr);
+            BVLC6_Buffer_Len = bvlc6_encode_forwarded_npdu(&BVLC6_Buffer[0],
+                sizeof(BVLC6_Buffer), vmac_src, &my_addr, pdu, pdu_len);
+            bbmd6_send_pdu_tables(
+                &BVLC6_Buffer[0], BVLC6_Buffer_Len, true, NULL);
+#endif
         }
     } else if ((dest->net > 0) && (dest->len == 0)) {
         /* net > 0 and net < 65535 are network specific broadcast if len = 0 */
@@ -371,101 +700,6 @@ int bvlc6_send_pdu(BACNET_ADDRESS *dest,
     return bip6_send_mpdu(&bvlc_dest, mtu, mtu_len);
 }
 
-#if defined(BACDL_BIP6) && BBMD6_ENABLED
-/**
- * The send function for Broacast Distribution Table
- *
- * @param addr - Points to a #BACNET_IP6_ADDRESS structure containing the
- *  source IPv6 address.
- * @param vmac_src - Source-Virtual-Address
- * @param npdu - the bytes of NPDU+APDU data to send
- * @param npdu_len - the number of bytes of NPDU+APDU data to send
- */
-static void bbmd6_send_pdu_bdt(uint8_t *mtu, unsigned int mtu_len)
-{
-    BACNET_IP6_ADDRESS my_addr = { 0 };
-    unsigned i = 0; /* loop counter */
-
-    if (mtu) {
-        bip6_get_addr(&my_addr);
-        for (i = 0; i < MAX_BBMD_ENTRIES; i++) {
-            if (BBMD_Table[i].valid) {
-                if (bvlc6_address_different(
-                        &my_addr, &BBMD_Table[i].bip6_address)) {
-                    bip6_send_mpdu(&BBMD_Table[i].bip6_address, mtu, mtu_len);
-                }
-            }
-        }
-    }
-}
-
-/**
- * The send function for Broacast Distribution Table
- *
- * @param addr - Points to a #BACNET_IP6_ADDRESS structure containing the
- *  source IPv6 address.
- * @param vmac_src - Source-Virtual-Address
- * @param npdu - the bytes of NPDU+APDU data to send
- * @param npdu_len - the number of bytes of NPDU+APDU data to send
- */
-static void bbmd6_send_pdu_fdt(uint8_t *mtu, unsigned int mtu_len)
-{
-    BACNET_IP6_ADDRESS my_addr = { 0 };
-    unsigned i = 0; /* loop counter */
-
-    if (mtu) {
-        bip6_get_addr(&my_addr);
-        for (i = 0; i < MAX_FD_ENTRIES; i++) {
-            if (FD_Table[i].valid) {
-                if (bvlc6_address_different(
-                        &my_addr, &FD_Table[i].bip6_address)) {
-                    bip6_send_mpdu(&FD_Table[i].bip6_address, mtu, mtu_len);
-                }
-            }
-        }
-    }
-}
-
-/**
- * The Forward NPDU send function for Broacast Distribution Table
- *
- * @param addr - Points to a #BACNET_IP6_ADDRESS structure containing the
- *  source IPv6 address.
- * @param vmac_src - Source-Virtual-Address
- * @param npdu - the bytes of NPDU+APDU data to send
- * @param npdu_len - the number of bytes of NPDU+APDU data to send
- */
-static void bbmd6_send_forward_npdu(BACNET_IP6_ADDRESS *address,
-    uint32_t vmac_src,
-    uint8_t *npdu,
-    unsigned int npdu_len)
-{
-    uint8_t mtu[BIP6_MPDU_MAX] = { 0 };
-    uint16_t mtu_len = 0;
-    unsigned i = 0; /* loop counter */
-
-    for (i = 0; i < MAX_BBMD_ENTRIES; i++) {
-        if (BBMD_Table[i].valid) {
-            if (bbmd6_address_match_self(&BBMD_Table[i].bip6_address)) {
-                /* don't forward to our selves */
-            } else {
-                bip6_send_mpdu(&BBMD_Table[i].bip6_address, mtu, mtu_len);
-            }
-        }
-    }
-    for (i = 0; i < MAX_FD_ENTRIES; i++) {
-        if (FD_Table[i].valid) {
-            if (bbmd6_address_match_self(&FD_Table[i].bip6_address)) {
-                /* don't forward to our selves */
-            } else {
-                bip6_send_mpdu(&FD_Table[i].bip6_address, mtu, mtu_len);
-            }
-        }
-    }
-}
-
-#endif
-
 /**
  * The Result Code send function for BACnet/IPv6 application layer
  *
@@ -838,7 +1072,6 @@ int bvlc6_bbmd_disabled_handler(BACNET_IP6_ADDRESS *addr,
 }
 
 #if defined(BACDL_BIP6) && BBMD6_ENABLED
-#warning FIXME: Needs ported to IPv6
 /**
  * Use this handler when you are a BBMD.
  * Sets the BVLC6_Function_Code in case it is needed later.
@@ -870,7 +1103,9 @@ int bvlc6_bbmd_enabled_handler(BACNET_IP6_ADDRESS *addr,
     uint16_t npdu_len = 0;
     bool send_result = false;
     uint16_t offset = 0;
-    BACNET_IP6_ADDRESS fwd_address = { { 0 } };
+    uint16_t ttl_seconds = 0;
+    BACNET_IP6_ADDRESS fwd_address = { 0 };
+    BACNET_IP6_ADDRESS bvlc_dest = { 0 };
 
     header_len =
         bvlc6_decode_header(mtu, mtu_len, &message_type, &message_length);
@@ -894,16 +1129,53 @@ int bvlc6_bbmd_enabled_handler(BACNET_IP6_ADDRESS *addr,
                 }
                 break;
             case BVLC6_REGISTER_FOREIGN_DEVICE:
-                result_code = BVLC6_RESULT_REGISTER_FOREIGN_DEVICE_NAK;
+                function_len = bvlc6_decode_register_foreign_device(
+                    pdu, pdu_len, &vmac_src, &ttl_seconds);
+                if (function_len && bbmd6_fdt_register(addr, ttl_seconds)) {
+                    bbmd6_add_vmac(vmac_src, addr);
+                    result_code = BVLC6_RESULT_SUCCESSFUL_COMPLETION;
+                } else {
+                    result_code = BVLC6_RESULT_REGISTER_FOREIGN_DEVICE_NAK;
+                }
                 send_result = true;
                 break;
             case BVLC6_DELETE_FOREIGN_DEVICE:
-                result_code = BVLC6_RESULT_DELETE_FOREIGN_DEVICE_NAK;
+                function_len = bvlc6_decode_delete_foreign_device(
+                    pdu, pdu_len, &vmac_src, &fwd_address);
+                if (function_len && bbmd6_fdt_delete(&fwd_address)) {
+                    result_code = BVLC6_RESULT_SUCCESSFUL_COMPLETION;
+                } else {
+                    result_code = BVLC6_RESULT_DELETE_FOREIGN_DEVICE_NAK;
+                }
                 send_result = true;
                 break;
             case BVLC6_DISTRIBUTE_BROADCAST_TO_NETWORK:
-                result_code = BVLC6_RESULT_DISTRIBUTE_BROADCAST_TO_NETWORK_NAK;
-                send_result = true;
+                function_len = bvlc6_decode_distribute_broadcast_to_network(
+                    pdu, pdu_len, &vmac_src, NULL, 0, &npdu_len);
+                if (function_len && (bbmd6_fdt_index(addr) >= 0)) {
+                    offset = header_len + (function_len - npdu_len);
+                    npdu = &mtu[offset];
+                    /*  Upon receipt of a BVLL Distribute-Broadcast-To-Network
+                        message from a registered foreign device, the
+                        receiving BBMD shall transmit a BVLL Forwarded-NPDU
+                        message on its local multicast domain, and unicast
+                        it to each entry in its BDT and to each foreign
+                        device in its FDT other than the originating one. */
+                    BVLC6_Buffer_Len = bvlc6_encode_forwarded_npdu(
+                        &BVLC6_Buffer[0], sizeof(BVLC6_Buffer), vmac_src,
+                        addr, npdu, npdu_len);
+                    bip6_get_broadcast_addr(&bvlc_dest);
+                    bip6_send_mpdu(
+                        &bvlc_dest, &BVLC6_Buffer[0], BVLC6_Buffer_Len);
+                    bbmd6_send_pdu_tables(
+                        &BVLC6_Buffer[0], BVLC6_Buffer_Len, true, addr);
+                    bbmd6_add_vmac(vmac_src, addr);
+                    bvlc6_vmac_address_set(src, vmac_src);
+                } else {
+                    result_code =
+                        BVLC6_RESULT_DISTRIBUTE_BROADCAST_TO_NETWORK_NAK;
+                    send_result = true;
+                }
                 break;
             case BVLC6_ORIGINAL_UNICAST_NPDU:
                 /* This message is used to send directed NPDUs to
@@ -955,8 +1227,8 @@ int bvlc6_bbmd_enabled_handler(BACNET_IP6_ADDRESS *addr,
                         BVLC6_Buffer_Len = bvlc6_encode_forwarded_npdu(
                             &BVLC6_Buffer[0], sizeof(BVLC6_Buffer), vmac_src,
                             addr, npdu, npdu_len);
-                        bbmd6_send_pdu_bdt(&BVLC6_Buffer[0], BVLC6_Buffer_Len);
-                        bbmd6_send_pdu_fdt(&BVLC6_Buffer[0], BVLC6_Buffer_Len);
+                        bbmd6_send_pdu_tables(&BVLC6_Buffer[0],
+                            BVLC6_Buffer_Len, true, NULL);
                     }
                     if (!bbmd6_address_match_self(addr)) {
                         /* The Virtual MAC address table shall be updated
@@ -971,7 +1243,9 @@ int bvlc6_bbmd_enabled_handler(BACNET_IP6_ADDRESS *addr,
                 PRINTF("BIP6: Received Forwarded-NPDU.\n");
                 function_len = bvlc6_decode_forwarded_npdu(
                     pdu, pdu_len, &vmac_src, &fwd_address, NULL, 0, &npdu_len);
-                if (function_len) {
+                if (function_len && (bbmd6_bdt_index(addr) < 0)) {
+                    PRINTF("BIP6: Dropped Forwarded-NPDU not from a peer.\n");
+                } else if (function_len) {
                     offset = header_len + (function_len - npdu_len);
                     npdu = &mtu[offset];
                     /*  Upon receipt of a BVLL Forwarded-NPDU message
@@ -980,8 +1254,8 @@ int bvlc6_bbmd_enabled_handler(BACNET_IP6_ADDRESS *addr,
                         transmit it via multicast to B/IPv6 devices in the
                         local multicast domain. */
                     BVLC6_Buffer_Len = bvlc6_encode_forwarded_npdu(
-                        &BVLC6_Buffer[0], sizeof(BVLC6_Buffer), vmac_src, addr,
-                        npdu, npdu_len);
+                        &BVLC6_Buffer[0], sizeof(BVLC6_Buffer), vmac_src,
+                        &fwd_address, npdu, npdu_len);
                     bip6_get_broadcast_addr(&bvlc_dest);
                     bip6_send_mpdu(
                         &bvlc_dest, &BVLC6_Buffer[0], BVLC6_Buffer_Len);
@@ -992,7 +1266,8 @@ int bvlc6_bbmd_enabled_handler(BACNET_IP6_ADDRESS *addr,
                         from a BBMD which is in the receiving BBMD's BDT,
                         no BVLC-Result shall be returned and the message
                         shall be discarded. */
-                    bbmd6_send_pdu_fdt(&BVLC6_Buffer[0], BVLC6_Buffer_Len);
+                    bbmd6_send_pdu_tables(
+                        &BVLC6_Buffer[0], BVLC6_Buffer_Len, false, NULL);
                     if (!bbmd6_address_match_self(addr)) {
                         /* The Virtual MAC address table shall be updated
                            using the respective parameter values of the
@@ -1133,6 +1408,9 @@ uint8_t bvlc6_get_function_code(void)
 void bvlc6_cleanup(void)
 {
     VMAC_Cleanup();
+#if defined(BACDL_BIP6) && BBMD6_ENABLED
+    bbmd6_tables_cleanup();
+#endif
 }
 
 /**
@@ -1146,7 +1424,8 @@ void bvlc6_init(void)
     bvlc6_address_set(
         &Remote_BBMD, 0, 0, 0, 0, 0, 0, 0, BIP6_MULTICAST_GROUP_ID);
 #if defined(BACDL_BIP6) && BBMD6_ENABLED
-    memset(&BBMD_Table, 0, sizeof(BBMD_Table));
-    memset(&FD_Table, 0, sizeof(FD_Table));
+    bbmd6_tables_cleanup();
+    BBMD6_Seconds = 0;
+    FD_Table_Purge_Seconds = 0;
 #endif
 }
@@ -61,6 +61,22 @@ extern "C" {
         uint8_t *mtu,
         uint16_t mtu_len);
 
+    BACNET_STACK_EXPORT
+    bool bvlc6_bdt_entry_add(
+        BACNET_IP6_ADDRESS *addr);
+    BACNET_STACK_EXPORT
+    bool bvlc6_bdt_entry_delete(
+        BACNET_IP6_ADDRESS *addr);
+    BACNET_STACK_EXPORT
+    unsigned bvlc6_bdt_count(
+        void);
+    BACNET_STACK_EXPORT
+    unsigned bvlc6_fdt_count(
+        void);
+    BACNET_STACK_EXPORT
+    uint16_t bvlc6_fdt_seconds_remaining(
+        BACNET_IP6_ADDRESS *addr);
+
     BACNET_STACK_EXPORT
     int bvlc6_send_pdu(BACNET_ADDRESS *dest,
         BACNET_NPDU_DATA *npdu_data,
@@ -73,8 +73,22 @@ void VMAC_Debug_Enable(void)
 /* This module is used to handle the virtual MAC address binding that */
 /* occurs in BACnet for ZigBee or IPv6. */
 
+/* VMAC entry - the address data must be first */
+struct vmac_entry {
+    struct vmac_data vmac;
+    uint32_t device_id;
+    /* key of the entry in the address data list */
+    KEY data_key;
+    /* seconds since the entry was added or last found by its address */
+    uint32_t age_seconds;
+};
+
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist VMAC_List;
+/* Key List for the same data sorted by a hash of the address data */
+static OS_Keylist VMAC_Data_List;
+/* seconds before an entry not found by its address is removed, 0=never */
+static uint32_t VMAC_Lifetime;
 
 /**
  * Returns the number of VMAC in the list
@@ -84,6 +98,73 @@ unsigned int VMAC_Count(void)
     return (unsigned int)Keylist_Count(VMAC_List);
 }
 
+/**
+ * @brief Hash the VMAC address data into a key (FNV-1a)
+ * @param vmac - VMAC address
+ * @return key for the address data list
+ */
+static KEY VMAC_Data_Key(struct vmac_data *vmac)
+{
+    KEY key = 2166136261UL;
+    unsigned int i;
+
+    for (i = 0; (i < vmac->mac_len) && (i < VMAC_MAC_MAX); i++) {
+        key ^= vmac->mac[i];
+        key *= 16777619UL;
+    }
+
+    return key;
+}
+
+/**
+ * @brief Find the index of an entry in the address data list
+ * @param entry - VMAC entry
+ * @return index of the entry, or -1 if it is not in the list
+ */
+static int VMAC_Data_Index(struct vmac_entry *entry)
+{
+    KEY key = 0;
+    int index;
+    int i;
+
+    index = Keylist_Index(VMAC_Data_List, entry->data_key);
+    if (index < 0) {
+        return -1;
+    }
+    /* entries with the same key are next to each other */
+    for (i = index; Keylist_Index_Key(VMAC_Data_List, i, &key) &&
+         (key == entry->data_key);
+         i--) {
+        if (Keylist_Data_Index(VMAC_Data_List, i) == entry) {
+            return i;
+        }
+    }
+    for (i = index + 1; Keylist_Index_Key(VMAC_Data_List, i, &key) &&
+         (key == entry->data_key);
+         i++) {
+        if (Keylist_Data_Index(VMAC_Data_List, i) == entry) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Remove an entry from the address data list, and free it
+ * @param entry - VMAC entry that was removed from the VMAC list
+ */
+static void VMAC_Entry_Free(struct vmac_entry *entry)
+{
+    int index;
+
+    index = VMAC_Data_Index(entry);
+    if (index >= 0) {
+        (void)Keylist_Data_Delete_By_Index(VMAC_Data_List, index);
+    }
+    free(entry);
+}
+
 /**
  * Adds a VMAC to the list
  *
@@ -95,14 +176,16 @@ unsigned int VMAC_Count(void)
 bool VMAC_Add(uint32_t device_id, struct vmac_data *src)
 {
     bool status = false;
+    struct vmac_entry *entry = NULL;
     struct vmac_data *pVMAC = NULL;
     int index = 0;
     size_t i = 0;
 
-    pVMAC = Keylist_Data(VMAC_List, device_id);
-    if (!pVMAC) {
-        pVMAC = calloc(1, sizeof(struct vmac_data));
-        if (pVMAC) {
+    entry = Keylist_Data(VMAC_List, device_id);
+    if (!entry) {
+        entry = calloc(1, sizeof(struct vmac_entry));
+        if (entry) {
+            pVMAC = &entry->vmac;
             /* copy the MAC into the data store */
             for (i = 0; i < sizeof(pVMAC->mac); i++) {
                 if (i < src->mac_len) {
@@ -112,10 +195,21 @@ bool VMAC_Add(uint32_t device_id, struct vmac_data *src)
                 }
             }
             pVMAC->mac_len = src->mac_len;
-            index = Keylist_Data_Add(VMAC_List, device_id, pVMAC);
+            entry->device_id = device_id;
+            entry->data_key = VMAC_Data_Key(pVMAC);
+            index = Keylist_Data_Add(VMAC_List, device_id, entry);
+            if (index >= 0) {
+                index = Keylist_Data_Add(
+                    VMAC_Data_List, entry->data_key, entry);
+                if (index < 0) {
+                    (void)Keylist_Data_Delete(VMAC_List, device_id);
+                }
+            }
             if (index >= 0) {
                 status = true;
                 PRINTF("VMAC %u added.\n", (unsigned int)device_id);
+            } else {
+                free(entry);
             }
         }
     }
@@ -133,11 +227,11 @@ bool VMAC_Add(uint32_t device_id, struct vmac_data *src)
 bool VMAC_Delete(uint32_t device_id)
 {
     bool status = false;
-    struct vmac_data *pVMAC;
+    struct vmac_entry *entry;
 
-    pVMAC = Keylist_Data_Delete(VMAC_List, device_id);
-    if (pVMAC) {
-        free(pVMAC);
+    entry = Keylist_Data_Delete(VMAC_List, device_id);
+    if (entry) {
+        VMAC_Entry_Free(entry);
         status = true;
     }
 
@@ -153,7 +247,14 @@ bool VMAC_Delete(uint32_t device_id)
  */
 struct vmac_data *VMAC_Find_By_Key(uint32_t device_id)
 {
-    return Keylist_Data(VMAC_List, device_id);
+    struct vmac_entry *entry;
+
+    entry = Keylist_Data(VMAC_List, device_id);
+    if (!entry) {
+        return NULL;
+    }
+
+    return &entry->vmac;
 }
 
 /** Compare the VMAC address
@@ -220,7 +321,35 @@ bool VMAC_Match(struct vmac_data *vmac1, struct vmac_data *vmac2)
 }
 
 /**
- * Finds a VMAC in the list by seeking a matching VMAC address
+ * @brief Find an entry with matching address data in a run of entries
+ *  that have the same key in the address data list
+ * @param vmac - VMAC address that will be sought
+ * @param key - key of the VMAC address
+ * @param index - index of an entry with the key
+ * @param step - 1 to search up the list, -1 to search down
+ * @return the entry, or NULL if not found
+ */
+static struct vmac_entry *VMAC_Data_Run_Find(
+    struct vmac_data *vmac, KEY key, int index, int step)
+{
+    struct vmac_entry *entry;
+    KEY list_key = 0;
+
+    while (Keylist_Index_Key(VMAC_Data_List, index, &list_key) &&
+        (list_key == key)) {
+        entry = Keylist_Data_Index(VMAC_Data_List, index);
+        if (entry && VMAC_Match(vmac, &entry->vmac)) {
+            return entry;
+        }
+        index += step;
+    }
+
+    return NULL;
+}
+
+/**
+ * Finds a VMAC in the list by seeking a matching VMAC address,
+ * and restarts the age of the entry that is found
  *
  * @param vmac - VMAC address that will be sought
  * @param device_id - BACnet device object instance number
@@ -230,57 +359,114 @@ bool VMAC_Match(struct vmac_data *vmac1, struct vmac_data *vmac2)
 bool VMAC_Find_By_Data(struct vmac_data *vmac, uint32_t *device_id)
 {
     bool status = false;
-    struct vmac_data *list_vmac;
-    int count = 0;
-    int index = 0;
+    struct vmac_entry *entry = NULL;
+    KEY key;
+    int index;
 
-    count = Keylist_Count(VMAC_List);
-    while (count) {
-        index = count - 1;
-        list_vmac = Keylist_Data_Index(VMAC_List, index);
-        if (list_vmac) {
-            if (VMAC_Match(vmac, list_vmac)) {
-                status = Keylist_Index_Key(VMAC_List, index, device_id);
-                break;
-            }
+    if (!vmac) {
+        return false;
+    }
+    key = VMAC_Data_Key(vmac);
+    index = Keylist_Index(VMAC_Data_List, key);
+    if (index >= 0) {
+        entry = VMAC_Data_Run_Find(vmac, key, index, -1);
+        if (!entry) {
+            entry = VMAC_Data_Run_Find(vmac, key, index + 1, 1);
         }
-        count--;
+    }
+    if (entry) {
+        entry->age_seconds = 0;
+        if (device_id) {
+            *device_id = entry->device_id;
+        }
+        status = true;
     }
 
     return status;
 }
 
+/**
+ * @brief Set the number of seconds that an entry is kept after it was
+ *  added or last found by its address
+ * @param seconds - lifetime of an entry, or 0 to keep entries until deleted
+ */
+void VMAC_Lifetime_Set(uint32_t seconds)
+{
+    VMAC_Lifetime = seconds;
+}
+
+/**
+ * @brief Get the number of seconds that an entry is kept after it was
+ *  added or last found by its address
+ * @return lifetime of an entry, or 0 if entries are kept until deleted
+ */
+uint32_t VMAC_Lifetime_Get(void)
+{
+    return VMAC_Lifetime;
+}
+
+/**
+ * @brief Age the entries, and remove those that outlived the lifetime
+ * @param seconds - number of seconds elapsed since the previous call
+ */
+void VMAC_Timer(uint16_t seconds)
+{
+    struct vmac_entry *entry;
+    int index;
+
+    if (!VMAC_Lifetime) {
+        return;
+    }
+    index = Keylist_Count(VMAC_List);
+    while (index > 0) {
+        index--;
+        entry = Keylist_Data_Index(VMAC_List, index);
+        if (!entry) {
+            continue;
+        }
+        if ((seconds < VMAC_Lifetime) &&
+            (entry->age_seconds < (VMAC_Lifetime - seconds))) {
+            entry->age_seconds += seconds;
+        } else {
+            PRINTF("VMAC %lu expired.\n", (unsigned long)entry->device_id);
+            (void)Keylist_Data_Delete_By_Index(VMAC_List, index);
+            VMAC_Entry_Free(entry);
+        }
+    }
+}
+
 /**
  * Cleans up the memory used by the VMAC list data
  */
 void VMAC_Cleanup(void)
 {
-    struct vmac_data *pVMAC;
+    struct vmac_entry *entry;
     const int index = 0;
     unsigned i = 0;
 
     if (VMAC_List) {
         do {
+            entry = Keylist_Data_Delete_By_Index(VMAC_List, index);
+            if (entry) {
 #if PRINT_ENABLED
-            uint32_t device_id;
-            Keylist_Index_Key(VMAC_List, index, &device_id);
-#endif
-            pVMAC = Keylist_Data_Delete_By_Index(VMAC_List, index);
-            if (pVMAC) {
-#if PRINT_ENABLED
-                PRINTF("VMAC List: %lu [", (unsigned long)device_id);
+                PRINTF("VMAC List: %lu [", (unsigned long)entry->device_id);
                 /* print the MAC */
-                for (i = 0; i < pVMAC->mac_len; i++) {
-                    PRINTF("%02X", pVMAC->mac[i]);
+                for (i = 0; i < entry->vmac.mac_len; i++) {
+                    PRINTF("%02X", entry->vmac.mac[i]);
                 }
                 PRINTF("]\n");
 #endif
-                free(pVMAC);
+                free(entry);
             }
-        } while (pVMAC);
+        } while (entry);
         Keylist_Delete(VMAC_List);
         VMAC_List = NULL;
     }
+    if (VMAC_Data_List) {
+        /* the entries were freed with the VMAC list */
+        Keylist_Delete(VMAC_Data_List);
+        VMAC_Data_List = NULL;
+    }
 }
 
 /**
@@ -289,7 +475,8 @@ void VMAC_Cleanup(void)
 void VMAC_Init(void)
 {
     VMAC_List = Keylist_Create();
-    if (VMAC_List) {
+    VMAC_Data_List = Keylist_Create();
+    if (VMAC_List && VMAC_Data_List) {
         atexit(VMAC_Cleanup);
         PRINTF("VMAC List initialized.\n");
     }
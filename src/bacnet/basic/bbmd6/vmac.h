@@ -47,6 +47,12 @@ extern "C" {
         struct vmac_data *vmac1,
         struct vmac_data *vmac2);
     BACNET_STACK_EXPORT
+    void VMAC_Lifetime_Set(uint32_t seconds);
+    BACNET_STACK_EXPORT
+    uint32_t VMAC_Lifetime_Get(void);
+    BACNET_STACK_EXPORT
+    void VMAC_Timer(uint16_t seconds);
+    BACNET_STACK_EXPORT
     void VMAC_Cleanup(void);
     BACNET_STACK_EXPORT
     void VMAC_Init(void);
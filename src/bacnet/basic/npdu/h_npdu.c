@@ -222,7 +222,7 @@ static void network_control_handler(BACNET_ADDRESS *src,
 void npdu_handler(BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len)
 {
     int apdu_offset = 0;
-    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_VIEW view;
     BACNET_NPDU_DATA npdu_data = { 0 };
 
     if (pdu_len < 1) {
@@ -231,34 +231,32 @@ void npdu_handler(BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len)
 
     /* only handle the version that we know how to handle */
     if (pdu[0] == BACNET_PROTOCOL_VERSION) {
-        apdu_offset =
-            bacnet_npdu_decode(&pdu[0], pdu_len, &dest, src, &npdu_data);
-        if (npdu_data.network_layer_message) {
-            if ((dest.net == 0) || (dest.net == BACNET_BROADCAST_NETWORK)) {
-                network_control_handler(src, &npdu_data, &pdu[apdu_offset],
-                    (uint16_t)(pdu_len - apdu_offset));
-            } else {
-                debug_printf("NPDU: message for router. Discarded!\n");
-            }
-        } else if ((apdu_offset > 0) && (apdu_offset < pdu_len)) {
-            if ((dest.net == 0) || (dest.net == BACNET_BROADCAST_NETWORK)) {
-                /* only handle the version that we know how to handle */
-                /* and we are not a router, so ignore messages with
-                   routing information cause they are not for us */
-                if ((dest.net == BACNET_BROADCAST_NETWORK) &&
-                    ((pdu[apdu_offset] & 0xF0) ==
-                        PDU_TYPE_CONFIRMED_SERVICE_REQUEST)) {
-                    /* hack for 5.4.5.1 - IDLE */
-                    /* ConfirmedBroadcastReceived */
-                    /* then enter IDLE - ignore the PDU */
-                } else {
-                    apdu_handler(src, &pdu[apdu_offset],
-                        (uint16_t)(pdu_len - apdu_offset));
-                }
-            } else {
+        apdu_offset = bacnet_npdu_view_decode(&pdu[0], pdu_len, &view);
+        if (apdu_offset <= 0) {
+            debug_printf("NPDU: Decoding failed; Discarded!\n");
+        } else if ((view.dnet != 0) &&
+            (view.dnet != BACNET_BROADCAST_NETWORK)) {
+            /* we are not a router, so ignore messages with
+               routing information cause they are not for us */
 #if PRINT_ENABLED
-                printf("NPDU: DNET=%u.  Discarded!\n", (unsigned)dest.net);
+            printf("NPDU: DNET=%u.  Discarded!\n", (unsigned)view.dnet);
 #endif
+        } else if (NPDU_VIEW_NETWORK_MESSAGE(&view)) {
+            npdu_view_source(&pdu[0], &view, src);
+            npdu_view_npdu_data(&pdu[0], &view, &npdu_data);
+            network_control_handler(src, &npdu_data, &pdu[apdu_offset],
+                (uint16_t)(pdu_len - apdu_offset));
+        } else if (apdu_offset < pdu_len) {
+            if ((view.dnet == BACNET_BROADCAST_NETWORK) &&
+                ((pdu[apdu_offset] & 0xF0) ==
+                    PDU_TYPE_CONFIRMED_SERVICE_REQUEST)) {
+                /* hack for 5.4.5.1 - IDLE */
+                /* ConfirmedBroadcastReceived */
+                /* then enter IDLE - ignore the PDU */
+            } else {
+                npdu_view_source(&pdu[0], &view, src);
+                apdu_handler(src, &pdu[apdu_offset],
+                    (uint16_t)(pdu_len - apdu_offset));
             }
         }
     } else {
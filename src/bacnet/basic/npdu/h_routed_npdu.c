@@ -35,6 +35,7 @@
 #include "bacnet/npdu.h"
 #include "bacnet/apdu.h"
 #include "bacnet/bactext.h"
+#include "bacnet/dcc.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/basic/services.h"
@@ -47,6 +48,65 @@
 /** @file h_routed_npdu.c  Handles messages at the NPDU level of the BACnet
  * stack, including routing and network control messages. */
 
+/* handlers of broadcast unconfirmed requests that answer for every
+   routed Device at once */
+static unconfirmed_function
+    Routed_Broadcast_Function[MAX_BACNET_UNCONFIRMED_SERVICE];
+
+/** Set a handler for an unconfirmed service request that is broadcast to
+ * the gateway and its routed Devices, such as Who-Is or Who-Has.  The
+ * handler is called once for the broadcast, and answers for every Device,
+ * instead of the APDU being handled again for each Device.
+ * @see handler_who_is_unicast_for_routing, handler_who_has_for_routing
+ *
+ * @param service_choice [in] The unconfirmed service.
+ * @param pFunction [in] The handler, or NULL to handle the APDU once for
+ *                       each Device.
+ */
+void routed_apdu_set_broadcast_handler(
+    BACNET_UNCONFIRMED_SERVICE service_choice, unconfirmed_function pFunction)
+{
+    if (service_choice < MAX_BACNET_UNCONFIRMED_SERVICE) {
+        Routed_Broadcast_Function[service_choice] = pFunction;
+    }
+}
+
+/** Handle an APDU broadcast to every Device once, if it is an unconfirmed
+ * request with a handler set by routed_apdu_set_broadcast_handler().
+ *
+ * @param src [in] The BACNET_ADDRESS of the message's source.
+ * @param apdu [in] The apdu portion of the request, to be processed.
+ * @param apdu_len [in] The total (remaining) length of the apdu.
+ * @return True if the APDU was handled.
+ */
+static bool routed_apdu_broadcast_handler(
+    BACNET_ADDRESS *src, uint8_t *apdu, uint16_t apdu_len)
+{
+    unconfirmed_function pFunction = NULL;
+
+    if ((apdu_len < 2) ||
+        ((apdu[0] & 0xF0) != PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST) ||
+        (apdu[1] >= MAX_BACNET_UNCONFIRMED_SERVICE)) {
+        return false;
+    }
+    pFunction = Routed_Broadcast_Function[apdu[1]];
+    if (!pFunction) {
+        return false;
+    }
+    /* only Who-Is and Who-Has are answered while initiation is disabled */
+    if (dcc_communication_disabled()) {
+        return true;
+    }
+    if (dcc_communication_initiation_disabled() &&
+        (apdu[1] != SERVICE_UNCONFIRMED_WHO_IS) &&
+        (apdu[1] != SERVICE_UNCONFIRMED_WHO_HAS)) {
+        return true;
+    }
+    pFunction(&apdu[2], (uint16_t)(apdu_len - 2), src);
+
+    return true;
+}
+
 /** Handler to manage the Network Layer Control Messages received in a packet.
  *  This handler is called if the NCPI bit 7 indicates that this packet is a
  *  network layer message and there is no further DNET to pass it to.
@@ -230,6 +290,11 @@ static void routed_apdu_handler(BACNET_ADDRESS *src,
         return;
     }
 
+    if ((dest->net == BACNET_BROADCAST_NETWORK) &&
+        routed_apdu_broadcast_handler(src, apdu, apdu_len)) {
+        /* decoded and answered once for every Device */
+        return;
+    }
     while (Routed_Device_GetNext(dest, DNET_list, &cursor)) {
         apdu_handler(src, apdu, apdu_len);
         bGotOne = true;
@@ -277,15 +342,18 @@ void routing_npdu_handler(
 {
     int apdu_offset = 0;
     BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_VIEW view;
     BACNET_NPDU_DATA npdu_data = { 0 };
 
     /* only handle the version that we know how to handle */
     if (pdu[0] == BACNET_PROTOCOL_VERSION) {
-        apdu_offset = bacnet_npdu_decode(pdu, pdu_len, &dest, src, &npdu_data);
+        apdu_offset = bacnet_npdu_view_decode(pdu, pdu_len, &view);
         if (apdu_offset <= 0) {
             debug_printf("NPDU: Decoding failed; Discarded!\n");
-        } else if (npdu_data.network_layer_message) {
-            if ((dest.net == 0) || (dest.net == BACNET_BROADCAST_NETWORK)) {
+        } else if (NPDU_VIEW_NETWORK_MESSAGE(&view)) {
+            if ((view.dnet == 0) || (view.dnet == BACNET_BROADCAST_NETWORK)) {
+                npdu_view_source(pdu, &view, src);
+                npdu_view_npdu_data(pdu, &view, &npdu_data);
                 network_control_handler(src, DNET_list, &npdu_data,
                     &pdu[apdu_offset], (uint16_t)(pdu_len - apdu_offset));
             } else {
@@ -295,7 +363,9 @@ void routing_npdu_handler(
                  * since only routers can handle it (even if for our DNET) */
             }
         } else if (apdu_offset <= pdu_len) {
-            if ((dest.net == 0) || (npdu_data.hop_count > 1)) {
+            if ((view.dnet == 0) || (view.hop_count > 1)) {
+                npdu_view_source(pdu, &view, src);
+                npdu_view_destination(pdu, &view, &dest);
                 routed_apdu_handler(src, &dest, DNET_list, &pdu[apdu_offset],
                     (uint16_t)(pdu_len - apdu_offset));
             }
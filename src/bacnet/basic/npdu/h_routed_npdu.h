@@ -36,6 +36,7 @@
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/apdu.h"
+#include "bacnet/basic/service/h_apdu.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -48,6 +49,11 @@ extern "C" {
         uint8_t * pdu,
         uint16_t pdu_len);
 
+    BACNET_STACK_EXPORT
+    void routed_apdu_set_broadcast_handler(
+        BACNET_UNCONFIRMED_SERVICE service_choice,
+        unconfirmed_function pFunction);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -26,6 +26,7 @@
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/object/property_cache.h"
 /* me! */
 #include "bacnet/basic/object/ai.h"
 
@@ -209,7 +210,7 @@ void Analog_Input_Present_Value_Set(uint32_t object_instance, float value)
 bool Analog_Input_Object_Name(
     uint32_t object_instance, BACNET_CHARACTER_STRING *object_name)
 {
-    static char text_string[32] = "";
+    char text_string[32] = "";
     bool status = false;
     struct analog_input_descr *pObject;
 
@@ -245,6 +246,8 @@ bool Analog_Input_Name_Set(uint32_t object_instance, char *new_name)
     if (pObject) {
         status = true;
         pObject->Object_Name = new_name;
+        PROPERTY_CACHE_INVALIDATE(
+            Object_Type, object_instance, PROP_OBJECT_NAME);
     }
 
     return status;
@@ -307,6 +310,8 @@ bool Analog_Input_Description_Set(uint32_t object_instance, char *new_name)
     if (pObject) {
         if (new_name) {
             pObject->Description = new_name;
+            PROPERTY_CACHE_INVALIDATE(
+                Object_Type, object_instance, PROP_DESCRIPTION);
             status = true;
         }
     }
@@ -448,6 +453,7 @@ bool Analog_Input_Units_Set(uint32_t object_instance, uint16_t units)
     pObject = Analog_Input_Object(object_instance);
     if (pObject) {
         pObject->Units = units;
+        PROPERTY_CACHE_INVALIDATE(Object_Type, object_instance, PROP_UNITS);
         status = true;
     }
 
@@ -1498,6 +1504,7 @@ bool Analog_Input_Delete(uint32_t object_instance)
     struct analog_input_descr *pObject = NULL;
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
+    PROPERTY_CACHE_INVALIDATE(Object_Type, object_instance, PROP_ALL);
     if (pObject) {
         free(pObject);
         status = true;
@@ -1514,6 +1521,7 @@ void Analog_Input_Cleanup(void)
     struct analog_input_descr *pObject;
 
     if (Object_List) {
+        PROPERTY_CACHE_INVALIDATE_TYPE(Object_Type);
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
@@ -52,6 +52,7 @@
 #include "bacnet/wp.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/object/property_cache.h"
 /* me! */
 #include "ao.h"
 
@@ -540,6 +541,8 @@ bool Analog_Output_Name_Set(uint32_t object_instance, char *new_name)
     if (pObject && new_name) {
         status = true;
         pObject->Object_Name = new_name;
+        PROPERTY_CACHE_INVALIDATE(
+            Object_Type, object_instance, PROP_OBJECT_NAME);
     }
 
     return status;
@@ -581,6 +584,7 @@ bool Analog_Output_Units_Set(uint32_t object_instance, uint16_t units)
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         pObject->Units = units;
+        PROPERTY_CACHE_INVALIDATE(Object_Type, object_instance, PROP_UNITS);
         status = true;
     }
 
@@ -777,6 +781,8 @@ bool Analog_Output_Description_Set(uint32_t object_instance, char *new_name)
     if (pObject && new_name) {
         status = true;
         pObject->Description = new_name;
+        PROPERTY_CACHE_INVALIDATE(
+            Object_Type, object_instance, PROP_DESCRIPTION);
     }
 
     return status;
@@ -1247,6 +1253,7 @@ bool Analog_Output_Delete(uint32_t object_instance)
     struct object_data *pObject = NULL;
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
+    PROPERTY_CACHE_INVALIDATE(Object_Type, object_instance, PROP_ALL);
     if (pObject) {
         free(pObject);
         status = true;
@@ -1263,6 +1270,7 @@ void Analog_Output_Cleanup(void)
     struct object_data *pObject;
 
     if (Object_List) {
+        PROPERTY_CACHE_INVALIDATE_TYPE(Object_Type);
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
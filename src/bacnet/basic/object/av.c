@@ -23,6 +23,7 @@
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/object/property_cache.h"
 /* me! */
 #include "bacnet/basic/object/av.h"
 
@@ -237,7 +238,7 @@ float Analog_Value_Present_Value(uint32_t object_instance)
 bool Analog_Value_Object_Name(
     uint32_t object_instance, BACNET_CHARACTER_STRING *object_name)
 {
-    static char text_string[32] = "";
+    char text_string[32] = "";
     bool status = false;
     struct analog_value_descr *pObject;
 
@@ -273,6 +274,8 @@ bool Analog_Value_Name_Set(uint32_t object_instance, char *new_name)
     if (pObject) {
         status = true;
         pObject->Object_Name = new_name;
+        PROPERTY_CACHE_INVALIDATE(
+            Object_Type, object_instance, PROP_OBJECT_NAME);
     }
 
     return status;
@@ -331,6 +334,8 @@ bool Analog_Value_Description_Set(uint32_t object_instance, char *new_name)
     if (pObject) {
         status = true;
         pObject->Description = new_name;
+        PROPERTY_CACHE_INVALIDATE(
+            Object_Type, object_instance, PROP_DESCRIPTION);
     }
 
     return status;
@@ -520,6 +525,7 @@ bool Analog_Value_Units_Set(uint32_t object_instance, uint16_t units)
     pObject = Analog_Value_Object(object_instance);
     if (pObject) {
 		pObject->Units = units;
+		PROPERTY_CACHE_INVALIDATE(Object_Type, object_instance, PROP_UNITS);
 		status = true;
 	}
 
@@ -1629,6 +1635,7 @@ bool Analog_Value_Delete(uint32_t object_instance)
     struct analog_value_descr *pObject = NULL;
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
+    PROPERTY_CACHE_INVALIDATE(Object_Type, object_instance, PROP_ALL);
     if (pObject) {
         free(pObject);
         status = true;
@@ -1645,6 +1652,7 @@ void Analog_Value_Cleanup(void)
     struct analog_value_descr *pObject;
 
     if (Object_List) {
+        PROPERTY_CACHE_INVALIDATE_TYPE(Object_Type);
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
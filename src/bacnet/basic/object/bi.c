@@ -23,6 +23,7 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/object/property_cache.h"
 /* me! */
 #include "bacnet/basic/object/bi.h"
 
@@ -464,7 +465,7 @@ static bool Binary_Input_Present_Value_Write(
 bool Binary_Input_Object_Name(
     uint32_t object_instance, BACNET_CHARACTER_STRING *object_name)
 {
-    static char text_string[32] = ""; /* okay for single thread */
+    char text_string[32] = "";
     bool status = false;
     struct object_data *pObject;
 
@@ -498,6 +499,8 @@ bool Binary_Input_Name_Set(uint32_t object_instance, char *new_name)
         if (new_name) {
             status = true;
             pObject->Object_Name = new_name;
+            PROPERTY_CACHE_INVALIDATE(
+                Object_Type, object_instance, PROP_OBJECT_NAME);
         }
     }
 
@@ -579,6 +582,8 @@ bool Binary_Input_Description_Set(uint32_t object_instance, char *new_name)
     if (pObject) {
         status = true;
         pObject->Description = new_name;
+        PROPERTY_CACHE_INVALIDATE(
+            Object_Type, object_instance, PROP_DESCRIPTION);
     }
 
     return status;
@@ -953,6 +958,7 @@ void Binary_Input_Cleanup(void)
     struct object_data *pObject;
 
     if (Object_List) {
+        PROPERTY_CACHE_INVALIDATE_TYPE(Object_Type);
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
@@ -975,6 +981,7 @@ bool Binary_Input_Delete(uint32_t object_instance)
     struct object_data *pObject;
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
+    PROPERTY_CACHE_INVALIDATE(Object_Type, object_instance, PROP_ALL);
     if (pObject) {
         free(pObject);
         status = true;
@@ -21,6 +21,7 @@
 #include "bacnet/rp.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/object/property_cache.h"
 /* me! */
 #include "bacnet/basic/object/bv.h"
 
@@ -464,7 +465,7 @@ static bool Binary_Value_Present_Value_Write(uint32_t object_instance,
 bool Binary_Value_Object_Name(
     uint32_t object_instance, BACNET_CHARACTER_STRING *object_name)
 {
-    static char text_string[32] = ""; /* okay for single thread */
+    char text_string[32] = "";
     bool status = false;
     struct object_data *pObject;
 
@@ -499,6 +500,8 @@ bool Binary_Value_Name_Set(uint32_t object_instance, char *new_name)
         if (new_name) {
             status = true;
             pObject->Object_Name = new_name;
+            PROPERTY_CACHE_INVALIDATE(
+                Object_Type, object_instance, PROP_OBJECT_NAME);
         }
     }
 
@@ -580,6 +583,8 @@ bool Binary_Value_Description_Set(uint32_t object_instance, char *new_name)
     if (pObject) {
         status = true;
         pObject->Description = new_name;
+        PROPERTY_CACHE_INVALIDATE(
+            Object_Type, object_instance, PROP_DESCRIPTION);
     }
 
     return status;
@@ -973,6 +978,7 @@ void Binary_Value_Cleanup(void)
     struct object_data *pObject;
 
     if (Object_List) {
+        PROPERTY_CACHE_INVALIDATE_TYPE(Object_Type);
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
@@ -993,6 +999,7 @@ bool Binary_Value_Delete(uint32_t object_instance)
     struct object_data *pObject;
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
+    PROPERTY_CACHE_INVALIDATE(Object_Type, object_instance, PROP_ALL);
     if (pObject) {
         free(pObject);
         status = true;
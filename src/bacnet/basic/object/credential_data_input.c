@@ -138,7 +138,7 @@ unsigned Credential_Data_Input_Instance_To_Index(uint32_t object_instance)
 bool Credential_Data_Input_Object_Name(
     uint32_t object_instance, BACNET_CHARACTER_STRING *object_name)
 {
-    static char text_string[32] = ""; /* okay for single thread */
+    char text_string[32] = "";
     bool status = false;
 
     if (object_instance < MAX_CREDENTIAL_DATA_INPUTS) {
@@ -67,6 +67,7 @@
 #include "bacnet/basic/object/color_object.h"
 #include "bacnet/basic/object/color_temperature.h"
 #endif
+#include "bacnet/basic/object/property_cache.h"
 
 /* local forward (semi-private) and external prototypes */
 int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata);
@@ -690,6 +691,7 @@ bool Device_Set_Object_Instance_Number(uint32_t object_id)
     if (object_id <= BACNET_MAX_INSTANCE) {
         /* Make the change and update the database revision */
         Object_Instance_Number = object_id;
+        PROPERTY_CACHE_INVALIDATE_TYPE(OBJECT_DEVICE);
         Device_Inc_Database_Revision();
     } else {
         status = false;
@@ -722,6 +724,8 @@ bool Device_Set_Object_Name(BACNET_CHARACTER_STRING *object_name)
     if (!characterstring_same(&My_Object_Name, object_name)) {
         /* Make the change and update the database revision */
         status = characterstring_copy(&My_Object_Name, object_name);
+        PROPERTY_CACHE_INVALIDATE(
+            OBJECT_DEVICE, Object_Instance_Number, PROP_OBJECT_NAME);
         Device_Inc_Database_Revision();
     }
 
@@ -730,6 +734,9 @@ bool Device_Set_Object_Name(BACNET_CHARACTER_STRING *object_name)
 
 bool Device_Object_Name_ANSI_Init(const char *value)
 {
+    PROPERTY_CACHE_INVALIDATE(
+        OBJECT_DEVICE, Object_Instance_Number, PROP_OBJECT_NAME);
+
     return characterstring_init_ansi(&My_Object_Name, value);
 }
 
@@ -874,6 +881,8 @@ bool Device_Set_Description(const char *name, size_t length)
     if (length < sizeof(Description)) {
         memmove(Description, name, length);
         Description[length] = 0;
+        PROPERTY_CACHE_INVALIDATE(
+            OBJECT_DEVICE, Object_Instance_Number, PROP_DESCRIPTION);
         status = true;
     }
 
@@ -1131,25 +1140,46 @@ bool Device_Object_Name_Copy(BACNET_OBJECT_TYPE object_type,
     return found;
 }
 
-static void Update_Current_Time(void)
+/**
+ * @brief Get the current time from the OS, or the stored values if there
+ *  is no OS time.  Only the caller's copies are written, so the time can
+ *  be read from more than one thread.
+ * @param bdate - [out] local date
+ * @param btime - [out] local time
+ * @param utc_offset - [out] BACnet UTC offset in minutes
+ * @param dst_active - [out] true if daylight savings time is in effect
+ */
+static void Update_Current_Time(BACNET_DATE *bdate,
+    BACNET_TIME *btime,
+    int16_t *utc_offset,
+    bool *dst_active)
 {
-    datetime_local(
-        &Local_Date, &Local_Time, &UTC_Offset, &Daylight_Savings_Status);
+    *bdate = Local_Date;
+    *btime = Local_Time;
+    *utc_offset = UTC_Offset;
+    *dst_active = Daylight_Savings_Status;
+    datetime_local(bdate, btime, utc_offset, dst_active);
 }
 
 void Device_getCurrentDateTime(BACNET_DATE_TIME *DateTime)
 {
-    Update_Current_Time();
+    int16_t utc_offset;
+    bool dst_active;
 
-    DateTime->date = Local_Date;
-    DateTime->time = Local_Time;
+    Update_Current_Time(
+        &DateTime->date, &DateTime->time, &utc_offset, &dst_active);
 }
 
 int32_t Device_UTC_Offset(void)
 {
-    Update_Current_Time();
+    BACNET_DATE_TIME bdatetime;
+    int16_t utc_offset;
+    bool dst_active;
+
+    Update_Current_Time(
+        &bdatetime.date, &bdatetime.time, &utc_offset, &dst_active);
 
-    return UTC_Offset;
+    return utc_offset;
 }
 
 void Device_UTC_Offset_Set(int16_t offset)
@@ -1159,7 +1189,14 @@ void Device_UTC_Offset_Set(int16_t offset)
 
 bool Device_Daylight_Savings_Status(void)
 {
-    return Daylight_Savings_Status;
+    BACNET_DATE_TIME bdatetime;
+    int16_t utc_offset;
+    bool dst_active;
+
+    Update_Current_Time(
+        &bdatetime.date, &bdatetime.time, &utc_offset, &dst_active);
+
+    return dst_active;
 }
 
 #if defined(BACNET_TIME_MASTER)
@@ -1248,6 +1285,9 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
     uint8_t *apdu = NULL;
     struct object_functions *pObject = NULL;
     uint16_t apdu_max = 0;
+    BACNET_DATE_TIME bdatetime;
+    int16_t utc_offset = 0;
+    bool dst_active = false;
 
     if ((rpdata == NULL) || (rpdata->application_data == NULL) ||
         (rpdata->application_data_len == 0)) {
@@ -1305,21 +1345,24 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
                 encode_application_character_string(&apdu[0], &char_string);
             break;
         case PROP_LOCAL_TIME:
-            Update_Current_Time();
-            apdu_len = encode_application_time(&apdu[0], &Local_Time);
+            Update_Current_Time(&bdatetime.date, &bdatetime.time,
+                &utc_offset, &dst_active);
+            apdu_len = encode_application_time(&apdu[0], &bdatetime.time);
             break;
         case PROP_UTC_OFFSET:
-            Update_Current_Time();
-            apdu_len = encode_application_signed(&apdu[0], UTC_Offset);
+            Update_Current_Time(&bdatetime.date, &bdatetime.time,
+                &utc_offset, &dst_active);
+            apdu_len = encode_application_signed(&apdu[0], utc_offset);
             break;
         case PROP_LOCAL_DATE:
-            Update_Current_Time();
-            apdu_len = encode_application_date(&apdu[0], &Local_Date);
+            Update_Current_Time(&bdatetime.date, &bdatetime.time,
+                &utc_offset, &dst_active);
+            apdu_len = encode_application_date(&apdu[0], &bdatetime.date);
             break;
         case PROP_DAYLIGHT_SAVINGS_STATUS:
-            Update_Current_Time();
-            apdu_len =
-                encode_application_boolean(&apdu[0], Daylight_Savings_Status);
+            Update_Current_Time(&bdatetime.date, &bdatetime.time,
+                &utc_offset, &dst_active);
+            apdu_len = encode_application_boolean(&apdu[0], dst_active);
             break;
         case PROP_PROTOCOL_VERSION:
             apdu_len = encode_application_unsigned(
@@ -1517,7 +1560,18 @@ int Device_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     if (pObject != NULL) {
         if (pObject->Object_Valid_Instance &&
             pObject->Object_Valid_Instance(rpdata->object_instance)) {
+#if defined(BACNET_PROPERTY_CACHE)
+            apdu_len = Property_Cache_Read(rpdata);
+            if (apdu_len > 0) {
+                return apdu_len;
+            }
+#endif
             apdu_len = Read_Property_Common(pObject, rpdata);
+#if defined(BACNET_PROPERTY_CACHE)
+            if (apdu_len > 0) {
+                (void)Property_Cache_Store(rpdata, apdu_len);
+            }
+#endif
         } else {
             rpdata->error_class = ERROR_CLASS_OBJECT;
             rpdata->error_code = ERROR_CODE_UNKNOWN_OBJECT;
@@ -1898,6 +1952,11 @@ bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                 } else {
                     status = pObject->Object_Write_Property(wp_data);
                 }
+                if (status) {
+                    /* a write may change any of the cached values */
+                    PROPERTY_CACHE_INVALIDATE(wp_data->object_type,
+                        wp_data->object_instance, PROP_ALL);
+                }
             } else {
                 wp_data->error_class = ERROR_CLASS_PROPERTY;
                 wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
@@ -2138,6 +2197,8 @@ bool Device_Delete_Object(BACNET_DELETE_OBJECT_DATA *data)
             /* The object being deleted must already exist */
             status = pObject->Object_Delete(data->object_instance);
             if (status) {
+                PROPERTY_CACHE_INVALIDATE(
+                    data->object_type, data->object_instance, PROP_ALL);
                 Device_Inc_Database_Revision();
             } else {
                 /* The object exists but cannot be deleted. */
@@ -2219,6 +2280,9 @@ void Device_Init(object_functions_t *object_table)
     struct object_functions *pObject = NULL;
     characterstring_init_ansi(&My_Object_Name, "SimpleServer");
     datetime_init();
+#if defined(BACNET_PROPERTY_CACHE)
+    Property_Cache_Cleanup();
+#endif
     if (object_table) {
         Object_Table = object_table;
     } else {
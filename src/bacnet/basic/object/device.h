@@ -527,6 +527,10 @@ extern "C" {
         int *DNET_list);
 
     BACNET_STACK_EXPORT
+    bool Routed_Device_Instance_Next(
+        uint32_t * instance,
+        uint32_t high_limit);
+    BACNET_STACK_EXPORT
     uint32_t Routed_Device_Index_To_Instance(
         unsigned index);
     BACNET_STACK_EXPORT
@@ -28,6 +28,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
@@ -59,6 +60,7 @@
 #if defined(BACFILE)
 #include "bacnet/basic/object/bacfile.h" /* object list dependency */
 #endif
+#include "bacnet/basic/sys/keylist.h"
 /* os specific includes */
 #include "bacnet/basic/sys/mstimer.h"
 
@@ -84,10 +86,23 @@ bool Routed_Device_Write_Property_Local(BACNET_WRITE_PROPERTY_DATA *wp_data);
  * and extending the regular Device Object functionality.
  ****************************************************************************/
 
-/** Model the gateway as the main Device, with (two) remote
- * Devices that are reached via its routing capabilities.
+/** A Device in the table, with its place in the table */
+struct routed_device {
+    uint16_t index;
+    DEVICE_OBJECT_DATA data;
+};
+
+/** Model the gateway as the main Device, with the remote Devices that
+ * are reached via its routing capabilities.  The table grows as Devices
+ * are added, keyed by index, and is indexed by Device instance and by
+ * virtual MAC address so that a routed APDU finds its Device without
+ * a scan of the table.
  */
-DEVICE_OBJECT_DATA Devices[MAX_NUM_DEVICES];
+static OS_Keylist Device_List;
+static OS_Keylist Device_Instance_List;
+static OS_Keylist Device_Address_List;
+/** Returned while the table is empty */
+static DEVICE_OBJECT_DATA Empty_Device;
 /** Keep track of the number of managed devices, including the gateway */
 uint16_t Num_Managed_Devices = 0;
 /** Which Device entry are we currently managing.
@@ -97,29 +112,141 @@ uint16_t Num_Managed_Devices = 0;
  */
 uint16_t iCurrent_Device_Idx = 0;
 
+/** Get the Device at an index in the table.
+ * @param idx [in] Index into the table of Devices.
+ * @return The Device, or NULL if the idx is not in the table.
+ */
+static struct routed_device *Routed_Device_Entry(int idx)
+{
+    return (struct routed_device *)Keylist_Data_Index(Device_List, idx);
+}
+
+/** Get the Device that the current request is addressing.
+ * @return The Device Object data; never NULL.
+ */
+static DEVICE_OBJECT_DATA *Routed_Device_Current(void)
+{
+    struct routed_device *entry;
+
+    entry = Routed_Device_Entry(iCurrent_Device_Idx);
+    if (entry) {
+        return &entry->data;
+    }
+
+    return &Empty_Device;
+}
+
+/** Make a key for the index of virtual MAC addresses.
+ * Addresses of up to four octets each have their own key.
+ * @param dlen [in] Length of the address.
+ * @param dadr [in] The address.
+ * @return The key of the address.
+ */
+static KEY Routed_Device_Address_Key(uint8_t dlen, const uint8_t *dadr)
+{
+    KEY key = dlen;
+    uint8_t i;
+
+    for (i = 0; i < dlen; i++) {
+        key = (key << 8) | (key >> 24);
+        key ^= dadr[i];
+    }
+
+    return key;
+}
+
+/** See if a routed Device has the given virtual MAC address.
+ * @param pDev [in] The Device.
+ * @param dlen [in] Length of the address.
+ * @param dadr [in] The address.
+ * @return True if the Device has the address.
+ */
+static bool Routed_Device_Address_Same(
+    DEVICE_OBJECT_DATA *pDev, uint8_t dlen, const uint8_t *dadr)
+{
+    return (memcmp(pDev->bacDevAddr.adr, dadr, dlen) == 0);
+}
+
+/** Find the routed Device with the given virtual MAC address.
+ * The addresses are set by the application after the Devices are added,
+ * so the index learns each address the first time it is looked up, and
+ * checks the address of the Device it finds each time.
+ * @param dlen [in] Length of the address; not zero.
+ * @param dadr [in] The address.
+ * @return The Device, or NULL if no routed Device has the address.
+ */
+static struct routed_device *Routed_Device_Address_Find(
+    uint8_t dlen, const uint8_t *dadr)
+{
+    struct routed_device *entry;
+    KEY key;
+    int i;
+
+    key = Routed_Device_Address_Key(dlen, dadr);
+    entry = (struct routed_device *)Keylist_Data(Device_Address_List, key);
+    if (entry && Routed_Device_Address_Same(&entry->data, dlen, dadr)) {
+        return entry;
+    }
+    if (entry) {
+        /* the Device has another address now */
+        (void)Keylist_Data_Delete(Device_Address_List, key);
+    }
+    /* the gateway Device is not reached by a virtual MAC address */
+    for (i = 1; i < Num_Managed_Devices; i++) {
+        entry = Routed_Device_Entry(i);
+        if (entry && Routed_Device_Address_Same(&entry->data, dlen, dadr)) {
+            (void)Keylist_Data_Add(Device_Address_List, key, entry);
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
 /* void Routing_Device_Init(uint32_t first_object_instance) is
  * found in device.c
  */
 
-/** Add a Device to our table of Devices[].
+/** Add a Device to our table of Devices.
  * The first entry must be the gateway device.
  * @param Object_Instance [in] Set the new Device to this instance number.
  * @param sObject_Name [in] Use this Object Name for the Device.
  * @param sDescription [in] Set this Description for the Device.
- * @return The index of this instance in the Devices[] array, or UINT16_MAX if
- *         there isn't enough room to add this Device.
+ * @return The index of this instance in the table of Devices, or UINT16_MAX
+ *         if there isn't enough memory to add this Device.
  */
 uint16_t Add_Routed_Device(uint32_t Object_Instance,
     BACNET_CHARACTER_STRING *sObject_Name,
     const char *sDescription)
 {
     int i = Num_Managed_Devices;
-    if (i < MAX_NUM_DEVICES) {
-        DEVICE_OBJECT_DATA *pDev = &Devices[i];
+    struct routed_device *entry = NULL;
+
+    if (!Device_List) {
+        Device_List = Keylist_Create();
+        Device_Instance_List = Keylist_Create();
+        Device_Address_List = Keylist_Create();
+    }
+    if (Device_List && Device_Instance_List && Device_Address_List &&
+        (i < UINT16_MAX)) {
+        entry = calloc(1, sizeof(struct routed_device));
+    }
+    if (entry && (Keylist_Data_Add(Device_List, i, entry) < 0)) {
+        free(entry);
+        entry = NULL;
+    }
+    if (entry) {
+        DEVICE_OBJECT_DATA *pDev = &entry->data;
+        entry->index = i;
         Num_Managed_Devices++;
         iCurrent_Device_Idx = i;
         pDev->bacObj.mObject_Type = OBJECT_DEVICE;
         pDev->bacObj.Object_Instance_Number = Object_Instance;
+        /* the first Device with an instance number is the one found */
+        if (!Keylist_Data(Device_Instance_List, Object_Instance)) {
+            (void)Keylist_Data_Add(
+                Device_Instance_List, Object_Instance, entry);
+        }
         if (sObject_Name != NULL) {
             Routed_Device_Set_Object_Name(sObject_Name->encoding,
                 sObject_Name->value, sObject_Name->length);
@@ -140,7 +267,7 @@ uint16_t Add_Routed_Device(uint32_t Object_Instance,
 }
 
 /** Return the Device Object descriptive data for the indicated entry.
- * @param idx [in] Index into Devices[] array being requested.
+ * @param idx [in] Index into the table of Devices being requested.
  *                 0 is for the main, gateway Device entry.
  *                 -1 is a special case meaning "whichever iCurrent_Device_Idx
  *                 is currently set to"
@@ -150,18 +277,22 @@ uint16_t Add_Routed_Device(uint32_t Object_Instance,
  */
 DEVICE_OBJECT_DATA *Get_Routed_Device_Object(int idx)
 {
+    struct routed_device *entry;
+
     if (idx == -1) {
-        return &Devices[iCurrent_Device_Idx];
-    } else if ((idx >= 0) && (idx < MAX_NUM_DEVICES)) {
+        return Routed_Device_Current();
+    }
+    entry = Routed_Device_Entry(idx);
+    if (entry) {
         iCurrent_Device_Idx = idx;
-        return &Devices[idx];
+        return &entry->data;
     } else {
         return NULL;
     }
 }
 
 /** Return the BACnet address for the indicated entry.
- * @param idx [in] Index into Devices[] array being requested.
+ * @param idx [in] Index into the table of Devices being requested.
  *                 0 is for the main, gateway Device entry.
  *                 -1 is a special case meaning "whichever iCurrent_Device_Idx
  *                 is currently set to"
@@ -171,11 +302,11 @@ DEVICE_OBJECT_DATA *Get_Routed_Device_Object(int idx)
  */
 BACNET_ADDRESS *Get_Routed_Device_Address(int idx)
 {
-    if (idx == -1) {
-        return &Devices[iCurrent_Device_Idx].bacDevAddr;
-    } else if ((idx >= 0) && (idx < MAX_NUM_DEVICES)) {
-        iCurrent_Device_Idx = idx;
-        return &Devices[idx].bacDevAddr;
+    DEVICE_OBJECT_DATA *pDev;
+
+    pDev = Get_Routed_Device_Object(idx);
+    if (pDev) {
+        return &pDev->bacDevAddr;
     } else {
         return NULL;
     }
@@ -191,7 +322,7 @@ BACNET_ADDRESS *Get_Routed_Device_Address(int idx)
 void routed_get_my_address(BACNET_ADDRESS *my_address)
 {
     if (my_address) {
-        memcpy(my_address, &Devices[iCurrent_Device_Idx].bacDevAddr,
+        memcpy(my_address, &Routed_Device_Current()->bacDevAddr,
             sizeof(BACNET_ADDRESS));
     }
 }
@@ -202,7 +333,7 @@ void routed_get_my_address(BACNET_ADDRESS *my_address)
  * given idx if a match is found, for use in the subsequent routing handling
  * functions here.
  *
- * @param idx [in] Index into Devices[] array being requested.
+ * @param idx [in] Index into the table of Devices being requested.
  *                 0 is for the main, gateway Device entry.
  * @param address_len [in] Length of the mac_adress[] field.
  *         If 0, then this is a MAC broadcast.  Otherwise, size is determined
@@ -216,22 +347,17 @@ void routed_get_my_address(BACNET_ADDRESS *my_address)
 bool Routed_Device_Address_Lookup(int idx, uint8_t dlen, uint8_t *dadr)
 {
     bool result = false;
-    DEVICE_OBJECT_DATA *pDev;
-    int i;
+    struct routed_device *entry;
 
-    if ((idx >= 0) && (idx < MAX_NUM_DEVICES)) {
-        pDev = &Devices[idx];
+    entry = Routed_Device_Entry(idx);
+    if (entry) {
         if (dlen == 0) {
             /* Automatic match */
             iCurrent_Device_Idx = idx;
             result = true;
         } else if (dadr != NULL) {
-            for (i = 0; i < dlen; i++) {
-                if (pDev->bacDevAddr.adr[i] != dadr[i]) {
-                    break;
-                }
-            }
-            if (i == dlen) { /* Success! */
+            if (Routed_Device_Address_Same(&entry->data, dlen, dadr)) {
+                /* Success! */
                 iCurrent_Device_Idx = idx;
                 result = true;
             }
@@ -271,11 +397,12 @@ bool Routed_Device_GetNext(BACNET_ADDRESS *dest, int *DNET_list, int *cursor)
     int dnet = DNET_list[0]; /* Get the DNET of our virtual network */
     int idx = *cursor;
     bool bSuccess = false;
+    struct routed_device *entry;
 
     /* First, see if the index is out of range.
      * Eg, last call to GetNext may have been the last successful one.
      */
-    if ((idx < 0) || (idx >= MAX_NUM_DEVICES)) {
+    if ((idx < 0) || (idx >= Num_Managed_Devices)) {
         idx = -1;
 
         /* Next, see if it's a BACnet broadcast.
@@ -305,18 +432,24 @@ bool Routed_Device_GetNext(BACNET_ADDRESS *dest, int *DNET_list, int *cursor)
         if (idx == 0) { /* Step over this case (starting point) */
             idx = 1;
         }
-        while (idx < MAX_NUM_DEVICES) {
-            bSuccess =
-                Routed_Device_Address_Lookup(idx++, dest->len, dest->adr);
-            if (bSuccess) {
-                break; /* We don't need to keep looking */
+        if (dest->len == 0) {
+            /* Just take the entry indexed by the cursor */
+            bSuccess = Routed_Device_Address_Lookup(idx++, 0, NULL);
+        } else {
+            /* Only one Device has the address */
+            entry = Routed_Device_Address_Find(dest->len, dest->adr);
+            if (entry) {
+                iCurrent_Device_Idx = entry->index;
+                bSuccess = true;
             }
+            idx = -1;
         }
     }
 
     if (!bSuccess) {
         *cursor = -1;
-    } else if (idx == MAX_NUM_DEVICES) { /* No more to GetNext */
+    } else if ((idx < 0) || (idx >= Num_Managed_Devices)) {
+        /* No more to GetNext */
         *cursor = -1;
     } else {
         *cursor = idx;
@@ -362,25 +495,25 @@ bool Routed_Device_Is_Valid_Network(uint16_t dest_net, int *DNET_list)
 uint32_t Routed_Device_Index_To_Instance(unsigned index)
 {
     index = index;
-    return Devices[iCurrent_Device_Idx].bacObj.Object_Instance_Number;
+    return Routed_Device_Current()->bacObj.Object_Instance_Number;
 }
 
 /**
  * For a given object instance-number, determines a 1..N-1 index
- * of Device objects where N is MAX_NUM_DEVICES
+ * of Device objects where N is the number of managed Devices
  *
  * @param  object_instance - object-instance number of the object
  * @return  index for the given instance-number, or 0 if not valid.
  */
 static uint32_t Routed_Device_Instance_To_Index(uint32_t Instance_Number)
 {
-    int i;
+    struct routed_device *entry;
 
-    for (i = 0; i < MAX_NUM_DEVICES; i++) {
-        if (Devices[i].bacObj.Object_Instance_Number == Instance_Number) {
-            /* Found Instance, so return the Device Index Number */
-            return i;
-        }
+    entry = (struct routed_device *)Keylist_Data(
+        Device_Instance_List, Instance_Number);
+    if (entry) {
+        /* Found Instance, so return the Device Index Number */
+        return entry->index;
     }
 
     /* We did not find instance... so simply return an Index of 0
@@ -388,6 +521,50 @@ static uint32_t Routed_Device_Instance_To_Index(uint32_t Instance_Number)
     return 0;
 }
 
+/** Find the routed Device with the lowest instance number in a range,
+ * by a search of the index of Device instances, and make it the current
+ * Device.  Call again with one more than the instance found to find the
+ * next Device in the range.
+ *
+ * @param instance [in,out] The lowest instance number to find; returned
+ *                 with the instance number of the Device found.
+ * @param high_limit [in] The highest instance number to find.
+ * @return True if a Device was found in the range.
+ */
+bool Routed_Device_Instance_Next(uint32_t *instance, uint32_t high_limit)
+{
+    struct routed_device *entry;
+    KEY key = 0;
+    int low = 0;
+    int high;
+    int middle;
+
+    if (!instance || (*instance > high_limit)) {
+        return false;
+    }
+    /* the first index with a key of at least the instance */
+    high = Keylist_Count(Device_Instance_List);
+    while (low < high) {
+        middle = low + ((high - low) / 2);
+        if (Keylist_Index_Key(Device_Instance_List, middle, &key) &&
+            (key < *instance)) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (!Keylist_Index_Key(Device_Instance_List, low, &key) ||
+        (key > high_limit)) {
+        return false;
+    }
+    entry = (struct routed_device *)Keylist_Data_Index(
+        Device_Instance_List, low);
+    iCurrent_Device_Idx = entry->index;
+    *instance = key;
+
+    return true;
+}
+
 /**
  * Determines if a given Device instance is valid
  *
@@ -400,7 +577,7 @@ bool Routed_Device_Valid_Object_Instance_Number(uint32_t object_id)
     DEVICE_OBJECT_DATA *pDev = NULL;
 
     iCurrent_Device_Idx = Routed_Device_Instance_To_Index(object_id);
-    pDev = &Devices[iCurrent_Device_Idx];
+    pDev = Routed_Device_Current();
     if (pDev->bacObj.Object_Instance_Number == object_id) {
         valid = true;
     }
@@ -411,7 +588,7 @@ bool Routed_Device_Valid_Object_Instance_Number(uint32_t object_id)
 bool Routed_Device_Name(
     uint32_t object_instance, BACNET_CHARACTER_STRING *object_name)
 {
-    DEVICE_OBJECT_DATA *pDev = &Devices[iCurrent_Device_Idx];
+    DEVICE_OBJECT_DATA *pDev = Routed_Device_Current();
     if (object_instance == pDev->bacObj.Object_Instance_Number) {
         return characterstring_init_ansi(object_name, pDev->bacObj.Object_Name);
     }
@@ -430,7 +607,7 @@ int Routed_Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
     int apdu_len = 0; /* return value */
     BACNET_CHARACTER_STRING char_string;
     uint8_t *apdu = NULL;
-    DEVICE_OBJECT_DATA *pDev = &Devices[iCurrent_Device_Idx];
+    DEVICE_OBJECT_DATA *pDev = Routed_Device_Current();
 
     if ((rpdata == NULL) || (rpdata->application_data == NULL) ||
         (rpdata->application_data_len == 0)) {
@@ -531,16 +708,49 @@ bool Routed_Device_Write_Property_Local(BACNET_WRITE_PROPERTY_DATA *wp_data)
  */
 uint32_t Routed_Device_Object_Instance_Number(void)
 {
-    return Devices[iCurrent_Device_Idx].bacObj.Object_Instance_Number;
+    return Routed_Device_Current()->bacObj.Object_Instance_Number;
+}
+
+/** Move a Device in the index of Device instances.
+ * @param entry [in] The Device, with its old instance number.
+ * @param object_id [in] The new instance number.
+ */
+static void Routed_Device_Instance_Move(
+    struct routed_device *entry, uint32_t object_id)
+{
+    struct routed_device *other;
+    uint32_t old_id = entry->data.bacObj.Object_Instance_Number;
+    int i;
+
+    if (Keylist_Data(Device_Instance_List, old_id) == entry) {
+        (void)Keylist_Data_Delete(Device_Instance_List, old_id);
+        /* another Device may have had the same instance number */
+        for (i = 0; i < Num_Managed_Devices; i++) {
+            other = Routed_Device_Entry(i);
+            if (other && (other != entry) &&
+                (other->data.bacObj.Object_Instance_Number == old_id)) {
+                (void)Keylist_Data_Add(Device_Instance_List, old_id, other);
+                break;
+            }
+        }
+    }
+    if (!Keylist_Data(Device_Instance_List, object_id)) {
+        (void)Keylist_Data_Add(Device_Instance_List, object_id, entry);
+    }
 }
 
 bool Routed_Device_Set_Object_Instance_Number(uint32_t object_id)
 {
     bool status = true; /* return value */
+    struct routed_device *entry;
 
     if (object_id <= BACNET_MAX_INSTANCE) {
         /* Make the change and update the database revision */
-        Devices[iCurrent_Device_Idx].bacObj.Object_Instance_Number = object_id;
+        entry = Routed_Device_Entry(iCurrent_Device_Idx);
+        if (entry) {
+            Routed_Device_Instance_Move(entry, object_id);
+        }
+        Routed_Device_Current()->bacObj.Object_Instance_Number = object_id;
         Routed_Device_Inc_Database_Revision();
     } else {
         status = false;
@@ -559,7 +769,7 @@ bool Routed_Device_Set_Object_Name(
     uint8_t encoding, const char *value, size_t length)
 {
     bool status = false; /*return value */
-    DEVICE_OBJECT_DATA *pDev = &Devices[iCurrent_Device_Idx];
+    DEVICE_OBJECT_DATA *pDev = Routed_Device_Current();
 
     if ((encoding == CHARACTER_UTF8) && (length < MAX_DEV_NAME_LEN)) {
         /* Make the change and update the database revision */
@@ -575,7 +785,7 @@ bool Routed_Device_Set_Object_Name(
 bool Routed_Device_Set_Description(const char *name, size_t length)
 {
     bool status = false; /*return value */
-    DEVICE_OBJECT_DATA *pDev = &Devices[iCurrent_Device_Idx];
+    DEVICE_OBJECT_DATA *pDev = Routed_Device_Current();
 
     if (length < MAX_DEV_DESC_LEN) {
         memmove(pDev->Description, name, length);
@@ -593,7 +803,7 @@ bool Routed_Device_Set_Description(const char *name, size_t length)
  */
 void Routed_Device_Inc_Database_Revision(void)
 {
-    DEVICE_OBJECT_DATA *pDev = &Devices[iCurrent_Device_Idx];
+    DEVICE_OBJECT_DATA *pDev = Routed_Device_Current();
     pDev->Database_Revision++;
 }
 
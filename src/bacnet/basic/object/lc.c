@@ -252,7 +252,7 @@ static BACNET_SHED_STATE Load_Control_Present_Value(uint32_t object_instance)
 bool Load_Control_Object_Name(
     uint32_t object_instance, BACNET_CHARACTER_STRING *object_name)
 {
-    static char text_string[32] = ""; /* okay for single thread */
+    char text_string[32] = "";
     bool status = false;
 
     if (object_instance < MAX_LOAD_CONTROLS) {
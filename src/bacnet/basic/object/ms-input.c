@@ -22,6 +22,7 @@
 #include "bacnet/wp.h"
 #include "bacnet/basic/sys/keylist.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/object/property_cache.h"
 /* me! */
 #include "bacnet/basic/object/ms-input.h"
 
@@ -489,6 +490,8 @@ bool Multistate_Input_Name_Set(uint32_t object_instance, char *new_name)
     if (pObject && new_name) {
         status = true;
         pObject->Object_Name = new_name;
+        PROPERTY_CACHE_INVALIDATE(
+            Object_Type, object_instance, PROP_OBJECT_NAME);
     }
 
     return status;
@@ -605,6 +608,8 @@ bool Multistate_Input_Description_Set(uint32_t object_instance, char *new_name)
     if (pObject && new_name) {
         status = true;
         pObject->Description = new_name;
+        PROPERTY_CACHE_INVALIDATE(
+            Object_Type, object_instance, PROP_DESCRIPTION);
     }
 
     return status;
@@ -908,6 +913,7 @@ bool Multistate_Input_Delete(uint32_t object_instance)
     struct object_data *pObject = NULL;
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
+    PROPERTY_CACHE_INVALIDATE(Object_Type, object_instance, PROP_ALL);
     if (pObject) {
         free(pObject);
         status = true;
@@ -924,6 +930,7 @@ void Multistate_Input_Cleanup(void)
     struct object_data *pObject;
 
     if (Object_List) {
+        PROPERTY_CACHE_INVALIDATE_TYPE(Object_Type);
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
@@ -51,6 +51,7 @@
 #include "bacnet/wp.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/object/property_cache.h"
 /* me! */
 #include "mso.h"
 
@@ -632,6 +633,8 @@ bool Multistate_Output_Name_Set(uint32_t object_instance, char *new_name)
     if (pObject && new_name) {
         status = true;
         pObject->Object_Name = new_name;
+        PROPERTY_CACHE_INVALIDATE(
+            Object_Type, object_instance, PROP_OBJECT_NAME);
     }
 
     return status;
@@ -835,6 +838,8 @@ bool Multistate_Output_Description_Set(uint32_t object_instance, char *new_name)
     if (pObject && new_name) {
         status = true;
         pObject->Description = new_name;
+        PROPERTY_CACHE_INVALIDATE(
+            Object_Type, object_instance, PROP_DESCRIPTION);
     }
 
     return status;
@@ -1188,6 +1193,7 @@ bool Multistate_Output_Delete(uint32_t object_instance)
     struct object_data *pObject = NULL;
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
+    PROPERTY_CACHE_INVALIDATE(Object_Type, object_instance, PROP_ALL);
     if (pObject) {
         free(pObject);
         status = true;
@@ -1204,6 +1210,7 @@ void Multistate_Output_Cleanup(void)
     struct object_data *pObject;
 
     if (Object_List) {
+        PROPERTY_CACHE_INVALIDATE_TYPE(Object_Type);
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
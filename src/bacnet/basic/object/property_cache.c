@@ -0,0 +1,352 @@
+/**
+ * @file
+ * @brief A cache of encoded property values for static and slow-changing
+ * object properties, so that repeated ReadProperty and ReadPropertyMultiple
+ * of the same values become a copy instead of an encode.
+ *
+ * The cache is enabled per object type.  Entries are dropped by a successful
+ * WriteProperty or DeleteObject in the device object, and by the object
+ * setters that use PROPERTY_CACHE_INVALIDATE().  Only enable the cache for
+ * object types whose setters invalidate the cache, or call
+ * Property_Cache_Invalidate() after changing a cached property value.
+ *
+ * A read that misses stores the value, so when properties are read from
+ * more than one thread, set lock functions with Property_Cache_Lock_Set().
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/sys/keylist.h"
+/* me! */
+#include "bacnet/basic/object/property_cache.h"
+
+/* the properties that are cached, in slot order */
+static const BACNET_PROPERTY_ID Cache_Properties[] = { PROP_OBJECT_IDENTIFIER,
+    PROP_OBJECT_NAME, PROP_OBJECT_TYPE, PROP_DESCRIPTION, PROP_UNITS,
+    PROP_PROPERTY_LIST };
+#define PROPERTY_CACHE_SLOTS \
+    (sizeof(Cache_Properties) / sizeof(Cache_Properties[0]))
+
+struct property_cache_object {
+    uint8_t *value[PROPERTY_CACHE_SLOTS];
+    uint16_t value_len[PROPERTY_CACHE_SLOTS];
+};
+
+/* key sorted list of cached objects */
+static OS_Keylist Cache_List;
+/* object types with caching enabled - one bit per object type */
+static uint8_t Cache_Object_Types[(MAX_BACNET_OBJECT_TYPE + 7) / 8];
+/* optional lock for applications that read from more than one thread */
+static property_cache_lock_function Cache_Lock;
+static property_cache_lock_function Cache_Unlock;
+
+/**
+ * @brief Set the functions that serialize access to the cache, for
+ *  applications that read properties from more than one thread.
+ * @param lock - function that acquires the lock, or NULL for none
+ * @param unlock - function that releases the lock, or NULL for none
+ */
+void Property_Cache_Lock_Set(
+    property_cache_lock_function lock, property_cache_lock_function unlock)
+{
+    Cache_Lock = lock;
+    Cache_Unlock = unlock;
+}
+
+static void Property_Cache_Lock(void)
+{
+    if (Cache_Lock) {
+        Cache_Lock();
+    }
+}
+
+static void Property_Cache_Unlock(void)
+{
+    if (Cache_Unlock) {
+        Cache_Unlock();
+    }
+}
+
+/**
+ * @brief Find the cache slot for a property
+ * @param object_property - property identifier
+ * @return slot index, or -1 if the property is not cached
+ */
+static int Property_Cache_Slot(BACNET_PROPERTY_ID object_property)
+{
+    unsigned slot;
+
+    for (slot = 0; slot < PROPERTY_CACHE_SLOTS; slot++) {
+        if (Cache_Properties[slot] == object_property) {
+            return (int)slot;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Free the cached values of an object
+ * @param pObject - cached object
+ */
+static void Property_Cache_Object_Free(struct property_cache_object *pObject)
+{
+    unsigned slot;
+
+    if (pObject) {
+        for (slot = 0; slot < PROPERTY_CACHE_SLOTS; slot++) {
+            free(pObject->value[slot]);
+        }
+        free(pObject);
+    }
+}
+
+/**
+ * @brief Drop all the cached values of an object type, with the lock held
+ * @param object_type - object type
+ */
+static void Property_Cache_Object_Type_Drop(BACNET_OBJECT_TYPE object_type)
+{
+    struct property_cache_object *pObject;
+    KEY key;
+    int index;
+
+    if (!Cache_List) {
+        return;
+    }
+    index = Keylist_Count(Cache_List);
+    while (index > 0) {
+        index--;
+        if (Keylist_Index_Key(Cache_List, index, &key) &&
+            (KEY_DECODE_TYPE(key) == (int)object_type)) {
+            pObject = Keylist_Data_Delete_By_Index(Cache_List, index);
+            Property_Cache_Object_Free(pObject);
+        }
+    }
+}
+
+/**
+ * @brief Enable or disable the cache for an object type.
+ *  Disabling the cache drops the cached values of that object type.
+ * @param object_type - object type
+ * @param enable - true to cache the values of this object type
+ */
+void Property_Cache_Enable(BACNET_OBJECT_TYPE object_type, bool enable)
+{
+    unsigned index = (unsigned)object_type;
+
+    if (index >= MAX_BACNET_OBJECT_TYPE) {
+        return;
+    }
+    Property_Cache_Lock();
+    if (enable) {
+        Cache_Object_Types[index / 8] |= (uint8_t)(1 << (index % 8));
+    } else {
+        Property_Cache_Object_Type_Drop(object_type);
+        Cache_Object_Types[index / 8] &= (uint8_t)~(1 << (index % 8));
+    }
+    Property_Cache_Unlock();
+}
+
+/**
+ * @brief Determine if the cache is enabled for an object type
+ * @param object_type - object type
+ * @return true if the values of this object type are cached
+ */
+bool Property_Cache_Enabled(BACNET_OBJECT_TYPE object_type)
+{
+    unsigned index = (unsigned)object_type;
+
+    if (index >= MAX_BACNET_OBJECT_TYPE) {
+        return false;
+    }
+
+    return (Cache_Object_Types[index / 8] & (1 << (index % 8))) != 0;
+}
+
+/**
+ * @brief Determine if a property value is one that can be cached
+ * @param object_property - property identifier
+ * @return true if the property value can be cached
+ */
+bool Property_Cache_Property(BACNET_PROPERTY_ID object_property)
+{
+    return Property_Cache_Slot(object_property) >= 0;
+}
+
+/**
+ * @brief Copy a cached property value into the ReadProperty data
+ * @param rpdata [in,out] Structure with the requested Object and Property
+ *  info on entry, and the encoded value on return if it was cached.
+ * @return number of bytes copied, or 0 if the value is not cached or
+ *  does not fit in the application data buffer
+ */
+int Property_Cache_Read(BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    struct property_cache_object *pObject;
+    int slot;
+    int len = 0;
+
+    if (!rpdata || !rpdata->application_data ||
+        (rpdata->array_index != BACNET_ARRAY_ALL) ||
+        !Property_Cache_Enabled(rpdata->object_type)) {
+        return 0;
+    }
+    slot = Property_Cache_Slot(rpdata->object_property);
+    if (slot < 0) {
+        return 0;
+    }
+    Property_Cache_Lock();
+    pObject = Keylist_Data(Cache_List,
+        KEY_ENCODE(rpdata->object_type, rpdata->object_instance));
+    if (pObject && pObject->value[slot] &&
+        (pObject->value_len[slot] <= rpdata->application_data_len)) {
+        len = pObject->value_len[slot];
+        memcpy(rpdata->application_data, pObject->value[slot], (size_t)len);
+    }
+    Property_Cache_Unlock();
+
+    return len;
+}
+
+/**
+ * @brief Store the encoded property value from a ReadProperty
+ * @param rpdata [in] Structure with the requested Object and Property info
+ *  and the encoded value in the application data
+ * @param apdu_len - number of bytes of encoded value
+ * @return true if the value was stored in the cache
+ */
+bool Property_Cache_Store(BACNET_READ_PROPERTY_DATA *rpdata, int apdu_len)
+{
+    struct property_cache_object *pObject = NULL;
+    KEY key;
+    uint8_t *value;
+    int slot;
+    bool status = false;
+
+    if (!rpdata || !rpdata->application_data || (apdu_len <= 0) ||
+        (apdu_len > PROPERTY_CACHE_VALUE_MAX) ||
+        (rpdata->array_index != BACNET_ARRAY_ALL) ||
+        !Property_Cache_Enabled(rpdata->object_type)) {
+        return false;
+    }
+    slot = Property_Cache_Slot(rpdata->object_property);
+    if (slot < 0) {
+        return false;
+    }
+    key = KEY_ENCODE(rpdata->object_type, rpdata->object_instance);
+    Property_Cache_Lock();
+    if (!Cache_List) {
+        Cache_List = Keylist_Create();
+    }
+    if (Cache_List) {
+        pObject = Keylist_Data(Cache_List, key);
+        if (!pObject) {
+            pObject = calloc(1, sizeof(struct property_cache_object));
+            if (pObject && (Keylist_Data_Add(Cache_List, key, pObject) < 0)) {
+                free(pObject);
+                pObject = NULL;
+            }
+        }
+    }
+    if (pObject) {
+        value = realloc(pObject->value[slot], (size_t)apdu_len);
+        if (value) {
+            memcpy(value, rpdata->application_data, (size_t)apdu_len);
+            pObject->value[slot] = value;
+            pObject->value_len[slot] = (uint16_t)apdu_len;
+            status = true;
+        }
+    }
+    Property_Cache_Unlock();
+
+    return status;
+}
+
+/**
+ * @brief Drop a cached property value, or all cached values of an object
+ * @param object_type - object type
+ * @param object_instance - object-instance number of the object
+ * @param object_property - property identifier, or PROP_ALL for every
+ *  cached property of the object
+ */
+void Property_Cache_Invalidate(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property)
+{
+    struct property_cache_object *pObject;
+    KEY key;
+    int slot;
+
+    key = KEY_ENCODE(object_type, object_instance);
+    slot = Property_Cache_Slot(object_property);
+    Property_Cache_Lock();
+    if (!Cache_List) {
+        /* nothing is cached */
+    } else if (object_property == PROP_ALL) {
+        pObject = Keylist_Data_Delete(Cache_List, key);
+        Property_Cache_Object_Free(pObject);
+    } else if (slot >= 0) {
+        pObject = Keylist_Data(Cache_List, key);
+        if (pObject) {
+            free(pObject->value[slot]);
+            pObject->value[slot] = NULL;
+            pObject->value_len[slot] = 0;
+        }
+    }
+    Property_Cache_Unlock();
+}
+
+/**
+ * @brief Drop all the cached values of an object type
+ * @param object_type - object type
+ */
+void Property_Cache_Invalidate_Object_Type(BACNET_OBJECT_TYPE object_type)
+{
+    Property_Cache_Lock();
+    Property_Cache_Object_Type_Drop(object_type);
+    Property_Cache_Unlock();
+}
+
+/**
+ * @brief Get the number of objects with cached values
+ * @return number of objects in the cache
+ */
+unsigned Property_Cache_Count(void)
+{
+    unsigned count = 0;
+
+    Property_Cache_Lock();
+    if (Cache_List) {
+        count = (unsigned)Keylist_Count(Cache_List);
+    }
+    Property_Cache_Unlock();
+
+    return count;
+}
+
+/**
+ * @brief Drop all the cached values and free the cache
+ */
+void Property_Cache_Cleanup(void)
+{
+    struct property_cache_object *pObject;
+
+    Property_Cache_Lock();
+    if (Cache_List) {
+        do {
+            pObject = Keylist_Data_Pop(Cache_List);
+            Property_Cache_Object_Free(pObject);
+        } while (pObject);
+        Keylist_Delete(Cache_List);
+        Cache_List = NULL;
+    }
+    Property_Cache_Unlock();
+}
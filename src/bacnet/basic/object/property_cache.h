@@ -0,0 +1,75 @@
+/**
+ * @file
+ * @brief API for a cache of encoded property values for static and
+ * slow-changing object properties
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_PROPERTY_CACHE_H
+#define BACNET_PROPERTY_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacenum.h"
+#include "bacnet/rp.h"
+
+/* largest encoded property value that is stored in the cache */
+#ifndef PROPERTY_CACHE_VALUE_MAX
+#define PROPERTY_CACHE_VALUE_MAX 255
+#endif
+
+/* Object modules call these from their setters so that the cache can be
+   compiled out of builds that do not use it. */
+#if defined(BACNET_PROPERTY_CACHE)
+#define PROPERTY_CACHE_INVALIDATE(object_type, object_instance, property) \
+    Property_Cache_Invalidate(object_type, object_instance, property)
+#define PROPERTY_CACHE_INVALIDATE_TYPE(object_type) \
+    Property_Cache_Invalidate_Object_Type(object_type)
+#else
+#define PROPERTY_CACHE_INVALIDATE(object_type, object_instance, property) \
+    (void)0
+#define PROPERTY_CACHE_INVALIDATE_TYPE(object_type) (void)0
+#endif
+
+/* lock or unlock function for readers in more than one thread */
+typedef void (*property_cache_lock_function)(void);
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void Property_Cache_Lock_Set(
+    property_cache_lock_function lock, property_cache_lock_function unlock);
+
+BACNET_STACK_EXPORT
+void Property_Cache_Enable(BACNET_OBJECT_TYPE object_type, bool enable);
+BACNET_STACK_EXPORT
+bool Property_Cache_Enabled(BACNET_OBJECT_TYPE object_type);
+BACNET_STACK_EXPORT
+bool Property_Cache_Property(BACNET_PROPERTY_ID object_property);
+
+BACNET_STACK_EXPORT
+int Property_Cache_Read(BACNET_READ_PROPERTY_DATA *rpdata);
+BACNET_STACK_EXPORT
+bool Property_Cache_Store(BACNET_READ_PROPERTY_DATA *rpdata, int apdu_len);
+
+BACNET_STACK_EXPORT
+void Property_Cache_Invalidate(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property);
+BACNET_STACK_EXPORT
+void Property_Cache_Invalidate_Object_Type(BACNET_OBJECT_TYPE object_type);
+BACNET_STACK_EXPORT
+unsigned Property_Cache_Count(void);
+BACNET_STACK_EXPORT
+void Property_Cache_Cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
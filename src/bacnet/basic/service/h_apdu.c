@@ -103,8 +103,62 @@ static BACNET_SERVICES_SUPPORTED
 
 /* Confirmed Function Handlers */
 /* If they are not set, they are handled by a reject message */
+#if defined(BACNET_CONFIRMED_SERVICE_HANDLERS)
+/* constant table from the compile-time configuration in bacnet-config.h */
+#define APDU_CONFIRMED_FUNCTION_CASE(service, handler) \
+    case service:                                      \
+        return handler;
+
+/**
+ * @brief Get the handler function for the given confirmed service from
+ *  the compile-time configuration.
+ *
+ * @param service_choice Service, see SERVICE_CONFIRMED_X enumeration.
+ * @return the handler function, or NULL if the service is not handled
+ */
+static confirmed_function apdu_confirmed_function(uint8_t service_choice)
+{
+    switch (service_choice) {
+        BACNET_CONFIRMED_SERVICE_HANDLERS(APDU_CONFIRMED_FUNCTION_CASE)
+        default:
+            break;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Set a handler function for the given confirmed service.
+ *  The handlers are fixed by BACNET_CONFIRMED_SERVICE_HANDLERS in this
+ *  build, so this does nothing.
+ *
+ * @param service_choice Service, see SERVICE_CONFIRMED_X enumeration.
+ * @param pFunction  Pointer to the function, being in charge of the service.
+ */
+void apdu_set_confirmed_handler(
+    BACNET_CONFIRMED_SERVICE service_choice, confirmed_function pFunction)
+{
+    (void)service_choice;
+    (void)pFunction;
+}
+#else
 static confirmed_function Confirmed_Function[MAX_BACNET_CONFIRMED_SERVICE];
 
+/**
+ * @brief Get the handler function for the given confirmed service.
+ *
+ * @param service_choice Service, see SERVICE_CONFIRMED_X enumeration.
+ * @return the handler function, or NULL if the service is not handled
+ */
+static confirmed_function apdu_confirmed_function(uint8_t service_choice)
+{
+    if (service_choice < MAX_BACNET_CONFIRMED_SERVICE) {
+        return Confirmed_Function[service_choice];
+    }
+
+    return NULL;
+}
+
 /**
  * @brief Set a handler function for the given confirmed service.
  *
@@ -118,26 +172,108 @@ void apdu_set_confirmed_handler(
         Confirmed_Function[service_choice] = pFunction;
     }
 }
+#endif
+
+/* Optional dispatcher that can take confirmed requests before the handlers */
+static confirmed_dispatch_function Confirmed_Dispatch;
+
+/**
+ * @brief Set a function that is offered each confirmed service request
+ *  after the DeviceCommunicationControl check, before the handler for the
+ *  service is called.  Used to hand requests to worker threads.
+ *
+ * @param pFunction  Pointer to the dispatch function, or NULL to call the
+ *                   handlers directly.
+ */
+void apdu_set_confirmed_dispatch(confirmed_dispatch_function pFunction)
+{
+    Confirmed_Dispatch = pFunction;
+}
 
 /* Allow the APDU handler to automatically reject */
+#if defined(BACNET_UNRECOGNIZED_SERVICE_HANDLER)
+static const confirmed_function Unrecognized_Service_Handler =
+    BACNET_UNRECOGNIZED_SERVICE_HANDLER;
+#else
 static confirmed_function Unrecognized_Service_Handler;
+#endif
 
 /**
  * @brief Set a handler function called for an unsupported service.
+ *  When the handler is fixed by BACNET_UNRECOGNIZED_SERVICE_HANDLER,
+ *  this does nothing.
  *
  * @param pFunction  Pointer to the function, being in charge,
  *                   if a unsupported service has been requested.
  */
 void apdu_set_unrecognized_service_handler_handler(confirmed_function pFunction)
 {
+#if defined(BACNET_UNRECOGNIZED_SERVICE_HANDLER)
+    (void)pFunction;
+#else
     Unrecognized_Service_Handler = pFunction;
+#endif
 }
 
 /* Unconfirmed Function Handlers */
 /* If they are not set, they are not handled */
+#if defined(BACNET_UNCONFIRMED_SERVICE_HANDLERS)
+/* constant table from the compile-time configuration in bacnet-config.h */
+#define APDU_UNCONFIRMED_FUNCTION_CASE(service, handler) \
+    case service:                                        \
+        return handler;
+
+/**
+ * @brief Get the handler function for the given unconfirmed service from
+ *  the compile-time configuration.
+ *
+ * @param service_choice Service, see SERVICE_UNCONFIRMED_X enumeration.
+ * @return the handler function, or NULL if the service is not handled
+ */
+static unconfirmed_function apdu_unconfirmed_function(uint8_t service_choice)
+{
+    switch (service_choice) {
+        BACNET_UNCONFIRMED_SERVICE_HANDLERS(APDU_UNCONFIRMED_FUNCTION_CASE)
+        default:
+            break;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Set a handler function for the given unconfirmed service.
+ *  The handlers are fixed by BACNET_UNCONFIRMED_SERVICE_HANDLERS in this
+ *  build, so this does nothing.
+ *
+ * @param service_choice Service, see SERVICE_UNCONFIRMED_X enumeration.
+ * @param pFunction  Pointer to the function, being in charge of the service.
+ */
+void apdu_set_unconfirmed_handler(
+    BACNET_UNCONFIRMED_SERVICE service_choice, unconfirmed_function pFunction)
+{
+    (void)service_choice;
+    (void)pFunction;
+}
+#else
 static unconfirmed_function
     Unconfirmed_Function[MAX_BACNET_UNCONFIRMED_SERVICE];
 
+/**
+ * @brief Get the handler function for the given unconfirmed service.
+ *
+ * @param service_choice Service, see SERVICE_UNCONFIRMED_X enumeration.
+ * @return the handler function, or NULL if the service is not handled
+ */
+static unconfirmed_function apdu_unconfirmed_function(uint8_t service_choice)
+{
+    if (service_choice < MAX_BACNET_UNCONFIRMED_SERVICE) {
+        return Unconfirmed_Function[service_choice];
+    }
+
+    return NULL;
+}
+
 /**
  * @brief Set a handler function for the given unconfirmed service.
  *
@@ -151,6 +287,7 @@ void apdu_set_unconfirmed_handler(
         Unconfirmed_Function[service_choice] = pFunction;
     }
 }
+#endif
 
 /**
  * @brief Checks if the given service is supported or not.
@@ -170,7 +307,7 @@ bool apdu_service_supported(BACNET_SERVICES_SUPPORTED service_supported)
         for (i = 0; i < MAX_BACNET_CONFIRMED_SERVICE; i++) {
             if (confirmed_service_supported[i] == service_supported) {
                 found = true;
-                if (Confirmed_Function[i] != NULL) {
+                if (apdu_confirmed_function((uint8_t)i) != NULL) {
 #ifdef BAC_ROUTING
                     /* Check to see if the current Device supports this service.
                      */
@@ -190,7 +327,7 @@ bool apdu_service_supported(BACNET_SERVICES_SUPPORTED service_supported)
             /* is it an unconfirmed service? */
             for (i = 0; i < MAX_BACNET_UNCONFIRMED_SERVICE; i++) {
                 if (unconfirmed_service_supported[i] == service_supported) {
-                    if (Unconfirmed_Function[i] != NULL) {
+                    if (apdu_unconfirmed_function((uint8_t)i) != NULL) {
                         status = true;
                     }
                     break;
@@ -563,6 +700,8 @@ void apdu_handler(BACNET_ADDRESS *src,
     uint8_t *service_request = NULL;
     uint16_t service_request_len = 0;
     int len = 0; /* counts where we are in PDU */
+    confirmed_function confirmed_handler = NULL;
+    unconfirmed_function unconfirmed_handler = NULL;
 #if !BACNET_SVC_SERVER
     uint8_t invoke_id = 0;
     BACNET_CONFIRMED_SERVICE_ACK_DATA service_ack_data = { 0 };
@@ -590,10 +729,15 @@ void apdu_handler(BACNET_ADDRESS *src,
                        initiated. */
                     break;
                 }
-                if ((service_choice < MAX_BACNET_CONFIRMED_SERVICE) &&
-                    (Confirmed_Function[service_choice])) {
-                    Confirmed_Function[service_choice](service_request,
-                        service_request_len, src, &service_data);
+                if (Confirmed_Dispatch &&
+                    Confirmed_Dispatch(service_choice, service_request,
+                        service_request_len, src, &service_data)) {
+                    break;
+                }
+                confirmed_handler = apdu_confirmed_function(service_choice);
+                if (confirmed_handler) {
+                    confirmed_handler(service_request, service_request_len,
+                        src, &service_data);
                 } else if (Unrecognized_Service_Handler) {
                     Unrecognized_Service_Handler(service_request,
                         service_request_len, src, &service_data);
@@ -615,11 +759,10 @@ void apdu_handler(BACNET_ADDRESS *src,
                         processed. */
                     break;
                 }
-                if (service_choice < MAX_BACNET_UNCONFIRMED_SERVICE) {
-                    if (Unconfirmed_Function[service_choice]) {
-                        Unconfirmed_Function[service_choice](
-                            service_request, service_request_len, src);
-                    }
+                unconfirmed_handler = apdu_unconfirmed_function(service_choice);
+                if (unconfirmed_handler) {
+                    unconfirmed_handler(
+                        service_request, service_request_len, src);
                 }
                 break;
 #if !BACNET_SVC_SERVER
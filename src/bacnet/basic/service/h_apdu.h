@@ -74,6 +74,19 @@ extern "C" {
         BACNET_ADDRESS * src,
         BACNET_CONFIRMED_SERVICE_DATA * service_data);
 
+/* confirmed service dispatcher, called before the confirmed function
+   handler.  Returns true if the request was taken, for example by queueing
+   it to a worker thread, and false to let the handler process it.
+   The service_request points into the receive buffer, so it must be
+   copied if it is used after returning. */
+    typedef bool (
+        *confirmed_dispatch_function) (
+        uint8_t service_choice,
+        uint8_t * service_request,
+        uint16_t service_len,
+        BACNET_ADDRESS * src,
+        BACNET_CONFIRMED_SERVICE_DATA * service_data);
+
 /* generic confirmed simple ack function handler */
     typedef void (
         *confirmed_simple_ack_function) (
@@ -139,6 +152,10 @@ extern "C" {
     void apdu_set_unrecognized_service_handler_handler(
         confirmed_function pFunction);
 
+    BACNET_STACK_EXPORT
+    void apdu_set_confirmed_dispatch(
+        confirmed_dispatch_function pFunction);
+
     BACNET_STACK_EXPORT
     void apdu_set_confirmed_handler(
         BACNET_CONFIRMED_SERVICE service_choice,
@@ -49,11 +49,12 @@
 
 /** @file h_rp.c  Handles Read Property requests. */
 
-/** Handler for a ReadProperty Service request.
+/** Encode the response to a ReadProperty Service request.
  * @ingroup DSRP
- * This handler will be invoked by apdu_handler() if it has been enabled
- * by a call to apdu_set_confirmed_handler().
- * This handler builds a response packet, which is
+ * The response is encoded into the given buffer instead of the shared
+ * Handler_Transmit_Buffer, so this may be called from more than one thread
+ * as long as the object data is protected from concurrent writes.
+ * The response is
  * - an Abort if
  *   - the message is segmented
  *   - if decoding fails
@@ -64,39 +65,30 @@
  *
  * @param service_request [in] The contents of the service request.
  * @param service_len [in] The length of the service_request.
- * @param src [in] BACNET_ADDRESS of the source of the message
  * @param service_data [in] The BACNET_CONFIRMED_SERVICE_DATA information
  *                          decoded from the APDU header of this message.
+ * @param apdu [out] Buffer to hold the response APDU.
+ * @param apdu_size [in] Size of the response APDU buffer.
+ *
+ * @return number of bytes encoded into the APDU buffer
  */
-void handler_read_property(uint8_t *service_request,
+int handler_read_property_encode(uint8_t *service_request,
     uint16_t service_len,
-    BACNET_ADDRESS *src,
-    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+    BACNET_CONFIRMED_SERVICE_DATA *service_data,
+    uint8_t *apdu,
+    size_t apdu_size)
 {
     BACNET_READ_PROPERTY_DATA rpdata;
     int len = 0;
-    int pdu_len = 0;
     int apdu_len = -1;
-    int npdu_len = -1;
-    BACNET_NPDU_DATA npdu_data;
     bool error = true; /* assume that there is an error */
-    int bytes_sent = 0;
-    BACNET_ADDRESS my_address;
 
+    if (!service_data || !apdu) {
+        return 0;
+    }
     /* configure default error code as an abort since it is common */
     rpdata.error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
-    /* encode the NPDU portion of the packet */
-    datalink_get_my_address(&my_address);
-    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
-    npdu_len = npdu_encode_pdu(
-        &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
-    if (npdu_len <= 0) {
-        /* If 0 or negative, there were problems with the data or encoding. */
-        len = BACNET_STATUS_ABORT;
-#if PRINT_ENABLED
-        fprintf(stderr, "RP: npdu_encode_pdu error.  Sending Abort!\n");
-#endif
-    } else if (service_data->segmented_message) {
+    if (service_data->segmented_message) {
         /* we don't support segmentation - send an abort */
         len = BACNET_STATUS_ABORT;
 #if PRINT_ENABLED
@@ -141,19 +133,24 @@ void handler_read_property(uint8_t *service_request,
                 rpdata.object_instance = Network_Port_Index_To_Instance(0);
             }
 #endif
-            apdu_len =
-                rp_ack_encode_apdu_init(&Handler_Transmit_Buffer[npdu_len],
-                    service_data->invoke_id, &rpdata);
+            apdu_len = rp_ack_encode_apdu_init(
+                &apdu[0], service_data->invoke_id, &rpdata);
             /* configure our storage */
-            rpdata.application_data =
-                &Handler_Transmit_Buffer[npdu_len + apdu_len];
-            rpdata.application_data_len =
-                sizeof(Handler_Transmit_Buffer) - (npdu_len + apdu_len);
+            rpdata.application_data = &apdu[apdu_len];
+            if (apdu_size > (size_t)apdu_len) {
+                rpdata.application_data_len = (int)(apdu_size - apdu_len);
+            } else {
+                rpdata.application_data_len = 0;
+            }
             len = Device_Read_Property(&rpdata);
+            if ((len >= 0) && ((size_t)(apdu_len + len + 1) > apdu_size)) {
+                /* no room for the closing tag */
+                rpdata.error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+                len = BACNET_STATUS_ABORT;
+            }
             if (len >= 0) {
                 apdu_len += len;
-                len = rp_ack_encode_apdu_object_property_end(
-                    &Handler_Transmit_Buffer[npdu_len + apdu_len]);
+                len = rp_ack_encode_apdu_object_property_end(&apdu[apdu_len]);
                 apdu_len += len;
                 if (apdu_len > service_data->max_resp) {
                     /* too big for the sender - send an abort!
@@ -190,23 +187,22 @@ void handler_read_property(uint8_t *service_request,
     }
 
     if (error) {
+        apdu_len = 0;
         if (len == BACNET_STATUS_ABORT) {
-            apdu_len = abort_encode_apdu(&Handler_Transmit_Buffer[npdu_len],
-                service_data->invoke_id,
+            apdu_len = abort_encode_apdu(&apdu[0], service_data->invoke_id,
                 abort_convert_error_code(rpdata.error_code), true);
 #if PRINT_ENABLED
             fprintf(stderr, "RP: Sending Abort!\n");
 #endif
         } else if (len == BACNET_STATUS_ERROR) {
-            apdu_len = bacerror_encode_apdu(&Handler_Transmit_Buffer[npdu_len],
-                service_data->invoke_id, SERVICE_CONFIRMED_READ_PROPERTY,
-                rpdata.error_class, rpdata.error_code);
+            apdu_len = bacerror_encode_apdu(&apdu[0], service_data->invoke_id,
+                SERVICE_CONFIRMED_READ_PROPERTY, rpdata.error_class,
+                rpdata.error_code);
 #if PRINT_ENABLED
             fprintf(stderr, "RP: Sending Error!\n");
 #endif
         } else if (len == BACNET_STATUS_REJECT) {
-            apdu_len = reject_encode_apdu(&Handler_Transmit_Buffer[npdu_len],
-                service_data->invoke_id,
+            apdu_len = reject_encode_apdu(&apdu[0], service_data->invoke_id,
                 reject_convert_error_code(rpdata.error_code));
 #if PRINT_ENABLED
             fprintf(stderr, "RP: Sending Reject!\n");
@@ -214,6 +210,49 @@ void handler_read_property(uint8_t *service_request,
         }
     }
 
+    return apdu_len;
+}
+
+/** Handler for a ReadProperty Service request.
+ * @ingroup DSRP
+ * This handler will be invoked by apdu_handler() if it has been enabled
+ * by a call to apdu_set_confirmed_handler().
+ * This handler builds a response packet with
+ * handler_read_property_encode() and sends it.
+ *
+ * @param service_request [in] The contents of the service request.
+ * @param service_len [in] The length of the service_request.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param service_data [in] The BACNET_CONFIRMED_SERVICE_DATA information
+ *                          decoded from the APDU header of this message.
+ */
+void handler_read_property(uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    int pdu_len = 0;
+    int apdu_len = 0;
+    int npdu_len = -1;
+    BACNET_NPDU_DATA npdu_data;
+    int bytes_sent = 0;
+    BACNET_ADDRESS my_address;
+
+    /* encode the NPDU portion of the packet */
+    datalink_get_my_address(&my_address);
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    npdu_len = npdu_encode_pdu(
+        &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
+    if (npdu_len <= 0) {
+        /* If 0 or negative, there were problems with the data or encoding. */
+#if PRINT_ENABLED
+        fprintf(stderr, "RP: npdu_encode_pdu error.\n");
+#endif
+        return;
+    }
+    apdu_len = handler_read_property_encode(service_request, service_len,
+        service_data, &Handler_Transmit_Buffer[npdu_len],
+        sizeof(Handler_Transmit_Buffer) - npdu_len);
     pdu_len = npdu_len + apdu_len;
     bytes_sent = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
@@ -51,8 +51,6 @@
 
 /** @file h_rpm.c  Handles Read Property Multiple requests. */
 
-static uint8_t Temp_Buf[MAX_APDU] = { 0 };
-
 static BACNET_PROPERTY_ID RPM_Object_Property(
     struct special_property_list_t *pPropertyList,
     BACNET_PROPERTY_ID special_property,
@@ -105,32 +103,113 @@ static unsigned RPM_Object_Property_Count(
     return count;
 }
 
+/** Encode the RPM object identifier and opening tag of the results
+   directly into the response, or return false if there is no room. */
+static bool RPM_Encode_Object_Begin(
+    MEMCOPY_WRITER *writer, BACNET_RPM_DATA *rpmdata)
+{
+    uint8_t *apdu;
+    int len;
+
+    len = rpm_ack_encode_apdu_object_begin(NULL, rpmdata);
+    apdu = memcopy_writer_reserve(writer, len);
+    if (apdu) {
+        len = rpm_ack_encode_apdu_object_begin(apdu, rpmdata);
+    }
+
+    return memcopy_writer_advance(writer, len);
+}
+
+/** Encode the RPM closing tag of the results directly into the response,
+   or return false if there is no room. */
+static bool RPM_Encode_Object_End(MEMCOPY_WRITER *writer)
+{
+    uint8_t *apdu;
+    int len;
+
+    len = rpm_ack_encode_apdu_object_end(NULL);
+    apdu = memcopy_writer_reserve(writer, len);
+    if (apdu) {
+        len = rpm_ack_encode_apdu_object_end(apdu);
+    }
+
+    return memcopy_writer_advance(writer, len);
+}
+
+/** Encode the RPM property identifier and optional array index directly
+   into the response, or return false if there is no room. */
+static bool RPM_Encode_Property_Reference(MEMCOPY_WRITER *writer,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index)
+{
+    uint8_t *apdu;
+    int len;
+
+    len = rpm_ack_encode_apdu_object_property(
+        NULL, object_property, array_index);
+    apdu = memcopy_writer_reserve(writer, len);
+    if (apdu) {
+        len = rpm_ack_encode_apdu_object_property(
+            apdu, object_property, array_index);
+    }
+
+    return memcopy_writer_advance(writer, len);
+}
+
+/** Encode the RPM property access error directly into the response,
+   or return false if there is no room. */
+static bool RPM_Encode_Property_Error(MEMCOPY_WRITER *writer,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    uint8_t *apdu;
+    int len;
+
+    len = rpm_ack_encode_apdu_object_property_error(
+        NULL, error_class, error_code);
+    apdu = memcopy_writer_reserve(writer, len);
+    if (apdu) {
+        len = rpm_ack_encode_apdu_object_property_error(
+            apdu, error_class, error_code);
+    }
+
+    return memcopy_writer_advance(writer, len);
+}
+
 /** Encode the RPM property returning the length of the encoding,
-   or 0 if there is no room to fit the encoding.  */
-static int RPM_Encode_Property(
-    uint8_t *apdu, uint16_t offset, uint16_t max_apdu, BACNET_RPM_DATA *rpmdata)
+   or a negative BACNET_STATUS value if there is no room to fit the
+   encoding.  The property value is read by the object directly into
+   the response buffer, between the opening and closing tags, so that
+   it is encoded only once. */
+static int RPM_Encode_Property(MEMCOPY_WRITER *writer, BACNET_RPM_DATA *rpmdata)
 {
     int len = 0;
-    size_t copy_len = 0;
-    int apdu_len = 0;
+    size_t mark = 0;
+    size_t value_mark = 0;
+    uint8_t *apdu = NULL;
     BACNET_READ_PROPERTY_DATA rpdata;
 
-    len = rpm_ack_encode_apdu_object_property(
-        &Temp_Buf[0], rpmdata->object_property, rpmdata->array_index);
-    copy_len = memcopy(&apdu[0], &Temp_Buf[0], offset, len, max_apdu);
-    if (copy_len == 0) {
+    mark = memcopy_writer_mark(writer);
+    if (!RPM_Encode_Property_Reference(
+            writer, rpmdata->object_property, rpmdata->array_index)) {
+        rpmdata->error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+        return BACNET_STATUS_ABORT;
+    }
+    /* Tag 4: propertyValue - room for the opening and closing tags */
+    value_mark = memcopy_writer_mark(writer);
+    apdu = memcopy_writer_reserve(writer, 2);
+    if (!apdu) {
         rpmdata->error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
         return BACNET_STATUS_ABORT;
     }
-    apdu_len += len;
     rpdata.error_class = ERROR_CLASS_OBJECT;
     rpdata.error_code = ERROR_CODE_UNKNOWN_OBJECT;
     rpdata.object_type = rpmdata->object_type;
     rpdata.object_instance = rpmdata->object_instance;
     rpdata.object_property = rpmdata->object_property;
     rpdata.array_index = rpmdata->array_index;
-    rpdata.application_data = &Temp_Buf[0];
-    rpdata.application_data_len = sizeof(Temp_Buf);
+    rpdata.application_data = &apdu[1];
+    rpdata.application_data_len = memcopy_writer_remaining(writer) - 2;
 
     if ((rpmdata->object_property == PROP_ALL) ||
         (rpmdata->object_property == PROP_REQUIRED) ||
@@ -147,35 +226,32 @@ static int RPM_Encode_Property(
             /* pass along aborts and rejects for now */
             return len; /* Ie, Abort */
         }
-        /* error was returned - encode that for the response */
-        len = rpm_ack_encode_apdu_object_property_error(
-            &Temp_Buf[0], rpdata.error_class, rpdata.error_code);
-        copy_len =
-            memcopy(&apdu[0], &Temp_Buf[0], offset + apdu_len, len, max_apdu);
-
-        if (copy_len == 0) {
+        /* error was returned - encode that for the response
+           over anything the object may have left behind */
+        memcopy_writer_rollback(writer, value_mark);
+        if (!RPM_Encode_Property_Error(
+                writer, rpdata.error_class, rpdata.error_code)) {
             rpmdata->error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
             return BACNET_STATUS_ABORT;
         }
-    } else if ((offset + apdu_len + 1 + len + 1) < max_apdu) {
+    } else if ((size_t)(1 + len + 1) <= memcopy_writer_remaining(writer)) {
         /* enough room to fit the property value and tags */
         len = rpm_ack_encode_apdu_object_property_value(
-            &apdu[offset + apdu_len], &Temp_Buf[0], len);
+            apdu, rpdata.application_data, len);
+        memcopy_writer_advance(writer, len);
     } else {
         /* not enough room - abort! */
         rpmdata->error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
         return BACNET_STATUS_ABORT;
     }
-    apdu_len += len;
 
-    return apdu_len;
+    return (int)(memcopy_writer_length(writer) - mark);
 }
 
-/** Handler for a ReadPropertyMultiple Service request.
+/** Encode the response to a ReadPropertyMultiple Service request.
  * @ingroup DSRPM
- * This handler will be invoked by apdu_handler() if it has been enabled
- * by a call to apdu_set_confirmed_handler().
- * This handler builds a response packet, which is
+ * The response is encoded in a single pass directly into the given
+ * buffer, which is
  * - an Abort if
  *   - the message is segmented
  *   - if decoding fails
@@ -186,351 +262,334 @@ static int RPM_Encode_Property(
  *
  * @param service_request [in] The contents of the service request.
  * @param service_len [in] The length of the service_request.
- * @param src [in] BACNET_ADDRESS of the source of the message
  * @param service_data [in] The BACNET_CONFIRMED_SERVICE_DATA information
  *                          decoded from the APDU header of this message.
+ * @param apdu [out] Buffer to hold the response APDU.
+ * @param apdu_size [in] Size of the response APDU buffer.
+ *
+ * @return number of bytes encoded into the APDU buffer
  */
-void handler_read_property_multiple(uint8_t *service_request,
+int handler_read_property_multiple_encode(uint8_t *service_request,
     uint16_t service_len,
-    BACNET_ADDRESS *src,
-    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+    BACNET_CONFIRMED_SERVICE_DATA *service_data,
+    uint8_t *apdu,
+    size_t apdu_size)
 {
     bool berror = false;
     int len = 0;
-    uint16_t copy_len = 0;
     uint16_t decode_len = 0;
-    int pdu_len = 0;
-    BACNET_NPDU_DATA npdu_data;
-    int bytes_sent;
-    BACNET_ADDRESS my_address;
     BACNET_RPM_DATA rpmdata;
+    MEMCOPY_WRITER writer;
     int apdu_len = 0;
-    int npdu_len = 0;
     int error = 0;
 
-    if (service_data && (service_len > 0)) {
-        /* jps_debug - see if we are utilizing all the buffer */
-        /* memset(&Handler_Transmit_Buffer[0], 0xff,
-         * sizeof(Handler_Transmit_Buffer)); */
-        /* encode the NPDU portion of the packet */
-        datalink_get_my_address(&my_address);
-        npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
-        npdu_len = npdu_encode_pdu(
-            &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
-
-        if (service_data->segmented_message) {
-            rpmdata.error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
-            error = BACNET_STATUS_ABORT;
+    if (!service_data || !apdu) {
+        return 0;
+    }
+    if (apdu_size > MAX_APDU) {
+        apdu_size = MAX_APDU;
+    }
+    memcopy_writer_init(&writer, apdu, apdu_size);
+    if (service_data->segmented_message) {
+        rpmdata.error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+        error = BACNET_STATUS_ABORT;
 #if PRINT_ENABLED
-            fprintf(stderr, "RPM: Segmented message. Sending Abort!\r\n");
+        fprintf(stderr, "RPM: Segmented message. Sending Abort!\r\n");
 #endif
-        } else {
-            /* decode apdu request & encode apdu reply
-               encode complex ack, invoke id, service choice */
-            apdu_len = rpm_ack_encode_apdu_init(
-                &Handler_Transmit_Buffer[npdu_len], service_data->invoke_id);
-
-            for (;;) {
-                /* Start by looking for an object ID */
-                len = rpm_decode_object_id(&service_request[decode_len],
-                    service_len - decode_len, &rpmdata);
-                if (len >= 0) {
-                    /* Got one so skip to next stage */
-                    decode_len += len;
-                } else {
-                    /* bad encoding - skip to error/reject/abort handling */
+    } else {
+        /* decode apdu request & encode apdu reply
+           encode complex ack, invoke id, service choice */
+        len = rpm_ack_encode_apdu_init(
+            memcopy_writer_reserve(&writer, 3), service_data->invoke_id);
+        memcopy_writer_advance(&writer, len);
+        for (;;) {
+            /* Start by looking for an object ID */
+            len = rpm_decode_object_id(&service_request[decode_len],
+                service_len - decode_len, &rpmdata);
+            if (len >= 0) {
+                /* Got one so skip to next stage */
+                decode_len += len;
+            } else {
+                /* bad encoding - skip to error/reject/abort handling */
 #if PRINT_ENABLED
-                    fprintf(stderr, "RPM: Bad Encoding.\n");
+                fprintf(stderr, "RPM: Bad Encoding.\n");
 #endif
-                    error = len;
-                    berror = true;
-                    break;
-                }
+                error = len;
+                berror = true;
+                break;
+            }
 
-                /* Test for case of indefinite Device object instance */
-                if ((rpmdata.object_type == OBJECT_DEVICE) &&
-                    (rpmdata.object_instance == BACNET_MAX_INSTANCE)) {
-                    rpmdata.object_instance = Device_Object_Instance_Number();
-                }
+            /* Test for case of indefinite Device object instance */
+            if ((rpmdata.object_type == OBJECT_DEVICE) &&
+                (rpmdata.object_instance == BACNET_MAX_INSTANCE)) {
+                rpmdata.object_instance = Device_Object_Instance_Number();
+            }
 #if (BACNET_PROTOCOL_REVISION >= 17)
-                /* When the object-type in the Object Identifier parameter
-                   contains the value NETWORK_PORT and the instance in the
-                   'Object Identifier' parameter contains the value 4194303,
-                   the responding BACnet-user shall treat the Object Identifier
-                   as if it correctly matched the local Network Port object
-                   representing the network port through which the request was
-                   received. This allows the network port instance of the
-                   network port that was used to receive the request to be
-                   determined. */
-                if ((rpmdata.object_type == OBJECT_NETWORK_PORT) &&
-                    (rpmdata.object_instance == BACNET_MAX_INSTANCE)) {
-                    rpmdata.object_instance = Network_Port_Index_To_Instance(0);
-                }
+            /* When the object-type in the Object Identifier parameter
+               contains the value NETWORK_PORT and the instance in the
+               'Object Identifier' parameter contains the value 4194303,
+               the responding BACnet-user shall treat the Object Identifier
+               as if it correctly matched the local Network Port object
+               representing the network port through which the request was
+               received. This allows the network port instance of the
+               network port that was used to receive the request to be
+               determined. */
+            if ((rpmdata.object_type == OBJECT_NETWORK_PORT) &&
+                (rpmdata.object_instance == BACNET_MAX_INSTANCE)) {
+                rpmdata.object_instance = Network_Port_Index_To_Instance(0);
+            }
 #endif
 
-                /* Stick this object id into the reply - if it will fit */
-                len = rpm_ack_encode_apdu_object_begin(&Temp_Buf[0], &rpmdata);
-                copy_len = memcopy(&Handler_Transmit_Buffer[npdu_len],
-                    &Temp_Buf[0], apdu_len, len, MAX_APDU);
-                if (copy_len == 0) {
+            /* Stick this object id into the reply - if it will fit */
+            if (!RPM_Encode_Object_Begin(&writer, &rpmdata)) {
 #if PRINT_ENABLED
-                    fprintf(stderr, "RPM: Response too big!\r\n");
+                fprintf(stderr, "RPM: Response too big!\r\n");
+#endif
+                rpmdata.error_code =
+                    ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+                error = BACNET_STATUS_ABORT;
+                berror = true;
+                break;
+            }
+            /* do each property of this object of the RPM request */
+            for (;;) {
+                /* Fetch a property */
+                len = rpm_decode_object_property(&service_request[decode_len],
+                    service_len - decode_len, &rpmdata);
+                if (len < 0) {
+                    /* bad encoding - skip to error/reject/abort handling */
+#if PRINT_ENABLED
+                    fprintf(stderr, "RPM: Bad Encoding.\n");
 #endif
-                    rpmdata.error_code =
-                        ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
-                    error = BACNET_STATUS_ABORT;
+                    error = len;
                     berror = true;
-                    break;
+                    break; /* The berror flag ensures that both loops will
+                            */
+                    /* be broken! */
                 }
-
-                apdu_len += copy_len;
-                /* do each property of this object of the RPM request */
-                for (;;) {
-                    /* Fetch a property */
-                    len =
-                        rpm_decode_object_property(&service_request[decode_len],
-                            service_len - decode_len, &rpmdata);
-                    if (len < 0) {
-                        /* bad encoding - skip to error/reject/abort handling */
+                decode_len += len;
+                /* handle the special properties */
+                if ((rpmdata.object_property == PROP_ALL) ||
+                    (rpmdata.object_property == PROP_REQUIRED) ||
+                    (rpmdata.object_property == PROP_OPTIONAL)) {
+                    struct special_property_list_t property_list;
+                    unsigned property_count = 0;
+                    unsigned index = 0;
+                    BACNET_PROPERTY_ID special_object_property;
+
+                    if (!Device_Valid_Object_Id(
+                            rpmdata.object_type, rpmdata.object_instance)) {
+                        len = RPM_Encode_Property(&writer, &rpmdata);
+                        if (len <= 0) {
 #if PRINT_ENABLED
-                        fprintf(stderr, "RPM: Bad Encoding.\n");
+                            fprintf(stderr, "RPM: Too full for property!\r\n");
 #endif
-                        error = len;
-                        berror = true;
-                        break; /* The berror flag ensures that both loops will
-                                */
-                        /* be broken! */
-                    }
-                    decode_len += len;
-                    /* handle the special properties */
-                    if ((rpmdata.object_property == PROP_ALL) ||
-                        (rpmdata.object_property == PROP_REQUIRED) ||
-                        (rpmdata.object_property == PROP_OPTIONAL)) {
-                        struct special_property_list_t property_list;
-                        unsigned property_count = 0;
-                        unsigned index = 0;
-                        BACNET_PROPERTY_ID special_object_property;
-
-                        if (!Device_Valid_Object_Id(rpmdata.object_type,
-                                                    rpmdata.object_instance)) {
-                            len = RPM_Encode_Property(
-                                &Handler_Transmit_Buffer[npdu_len],
-                                (uint16_t)apdu_len, MAX_APDU, &rpmdata);
-                            if (len > 0) {
-                                apdu_len += len;
-                            } else {
+                            error = len;
+                            /* The berror flag ensures that
+                               both loops will be broken! */
+                            berror = true;
+                            break;
+                        }
+                    } else if (rpmdata.array_index != BACNET_ARRAY_ALL) {
+                        /* No array index options for this special property.
+                           Encode error for this object property response */
+                        if (!RPM_Encode_Property_Reference(&writer,
+                                rpmdata.object_property, rpmdata.array_index)) {
 #if PRINT_ENABLED
-                                fprintf(stderr,
-                                        "RPM: Too full for property!\r\n");
+                            fprintf(stderr,
+                                "RPM: Too full to encode property!\r\n");
 #endif
-                                error = len;
-                                /* The berror flag ensures that
-                                   both loops will be broken! */
-                                berror = true;
-                                break;
-                            }
-                        } else if (rpmdata.array_index != BACNET_ARRAY_ALL) {
-
-                            /* No array index options for this special property.
-                               Encode error for this object property response */
-                            len = rpm_ack_encode_apdu_object_property(
-                                &Temp_Buf[0], rpmdata.object_property,
-                                rpmdata.array_index);
-
-                            copy_len =
-                                memcopy(&Handler_Transmit_Buffer[npdu_len],
-                                    &Temp_Buf[0], apdu_len, len, MAX_APDU);
-
-                            if (copy_len == 0) {
+                            rpmdata.error_code =
+                                ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+                            error = BACNET_STATUS_ABORT;
+                            berror = true;
+                            break; /* The berror flag ensures that both */
+                            /* loops will be broken! */
+                        }
+                        if (!RPM_Encode_Property_Error(&writer,
+                                ERROR_CLASS_PROPERTY,
+                                ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY)) {
 #if PRINT_ENABLED
-                                fprintf(stderr,
-                                    "RPM: Too full to encode property!\r\n");
+                            fprintf(
+                                stderr, "RPM: Too full to encode error!\r\n");
 #endif
-                                rpmdata.error_code =
-                                    ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
-                                error = BACNET_STATUS_ABORT;
-                                berror = true;
-                                break; /* The berror flag ensures that both */
-                                /* loops will be broken! */
-                            }
-
-                            apdu_len += len;
-                            len = rpm_ack_encode_apdu_object_property_error(
-                                &Temp_Buf[0], ERROR_CLASS_PROPERTY,
-                                ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY);
-
-                            copy_len =
-                                memcopy(&Handler_Transmit_Buffer[npdu_len],
-                                    &Temp_Buf[0], apdu_len, len, MAX_APDU);
-
-                            if (copy_len == 0) {
+                            rpmdata.error_code =
+                                ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+                            error = BACNET_STATUS_ABORT;
+                            berror = true;
+                            break; /* The berror flag ensures that both */
+                            /* loops will be broken! */
+                        }
+                    } else {
+                        special_object_property = rpmdata.object_property;
+                        Device_Objects_Property_List(rpmdata.object_type,
+                            rpmdata.object_instance, &property_list);
+                        property_count = RPM_Object_Property_Count(
+                            &property_list, special_object_property);
+
+                        if (property_count == 0) {
+                            /* This only happens with the OPTIONAL property
+                             */
+                            /* 135-2016bl-2. Clarify ReadPropertyMultiple
+                               response on OPTIONAL when empty. */
+                            /* If no optional properties are supported then
+                               an empty 'List of Results' shall be returned
+                               for the specified property, except if the
+                               object does not exist. */
+                            if (!Device_Valid_Object_Id(rpmdata.object_type,
+                                    rpmdata.object_instance)) {
+                                len = RPM_Encode_Property(&writer, &rpmdata);
+                                if (len <= 0) {
 #if PRINT_ENABLED
-                                fprintf(stderr,
-                                    "RPM: Too full to encode error!\r\n");
+                                    fprintf(stderr,
+                                        "RPM: Too full for property!\r\n");
 #endif
-                                rpmdata.error_code =
-                                    ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
-                                error = BACNET_STATUS_ABORT;
-                                berror = true;
-                                break; /* The berror flag ensures that both */
-                                /* loops will be broken! */
+                                    error = len;
+                                    /* The berror flag ensures that
+                                       both loops will be broken! */
+                                    berror = true;
+                                    break;
+                                }
                             }
-                            apdu_len += len;
                         } else {
-                            special_object_property = rpmdata.object_property;
-                            Device_Objects_Property_List(rpmdata.object_type,
-                                rpmdata.object_instance, &property_list);
-                            property_count = RPM_Object_Property_Count(
-                                &property_list, special_object_property);
-
-                            if (property_count == 0) {
-                                /* This only happens with the OPTIONAL property
-                                 */
-                                /* 135-2016bl-2. Clarify ReadPropertyMultiple
-                                   response on OPTIONAL when empty. */
-                                /* If no optional properties are supported then
-                                   an empty 'List of Results' shall be returned
-                                   for the specified property, except if the
-                                   object does not exist. */
-                                if (!Device_Valid_Object_Id(rpmdata.object_type,
-                                  rpmdata.object_instance)) {
-                                    len = RPM_Encode_Property(
-                                        &Handler_Transmit_Buffer[npdu_len],
-                                        (uint16_t)apdu_len, MAX_APDU, &rpmdata);
-                                    if (len > 0) {
-                                        apdu_len += len;
-                                    } else {
+                            for (index = 0; index < property_count; index++) {
+                                rpmdata.object_property = RPM_Object_Property(
+                                    &property_list, special_object_property,
+                                    index);
+                                len = RPM_Encode_Property(&writer, &rpmdata);
+                                if (len <= 0) {
 #if PRINT_ENABLED
-                                        fprintf(stderr,
-                                            "RPM: Too full for property!\r\n");
-#endif
-                                        error = len;
-                                        /* The berror flag ensures that
-                                           both loops will be broken! */
-                                        berror = true;
-                                        break;
-                                    }
-                                }
-                            } else {
-                                for (index = 0; index < property_count;
-                                     index++) {
-                                    rpmdata.object_property =
-                                        RPM_Object_Property(&property_list,
-                                            special_object_property, index);
-                                    len = RPM_Encode_Property(
-                                        &Handler_Transmit_Buffer[npdu_len],
-                                        (uint16_t)apdu_len, MAX_APDU, &rpmdata);
-                                    if (len > 0) {
-                                        apdu_len += len;
-                                    } else {
-#if PRINT_ENABLED
-                                        fprintf(stderr,
-                                            "RPM: Too full for property!\r\n");
+                                    fprintf(stderr,
+                                        "RPM: Too full for property!\r\n");
 #endif
-                                        error = len;
-                                        berror = true;
-                                        break; /* The berror flag ensures that
-                                                */
-                                        /* both loops will be broken! */
-                                    }
+                                    error = len;
+                                    berror = true;
+                                    break; /* The berror flag ensures that
+                                            */
+                                    /* both loops will be broken! */
                                 }
                             }
                         }
-                    } else {
-                        /* handle an individual property */
-                        len = RPM_Encode_Property(
-                            &Handler_Transmit_Buffer[npdu_len],
-                            (uint16_t)apdu_len, MAX_APDU, &rpmdata);
-                        if (len > 0) {
-                            apdu_len += len;
-                        } else {
-#if PRINT_ENABLED
-                            fprintf(stderr,
-                                "RPM: Too full for individual property!\r\n");
-#endif
-                            error = len;
-                            berror = true;
-                            break; /* The berror flag ensures that both loops */
-                            /* will be broken! */
-                        }
                     }
-
-                    if (decode_is_closing_tag_number(
-                            &service_request[decode_len], 1)) {
-                        /* Reached end of property list so cap the result list
-                         */
-                        decode_len++;
-                        len = rpm_ack_encode_apdu_object_end(&Temp_Buf[0]);
-                        copy_len = memcopy(&Handler_Transmit_Buffer[npdu_len],
-                            &Temp_Buf[0], apdu_len, len, MAX_APDU);
-                        if (copy_len == 0) {
+                } else {
+                    /* handle an individual property */
+                    len = RPM_Encode_Property(&writer, &rpmdata);
+                    if (len <= 0) {
 #if PRINT_ENABLED
-                            fprintf(stderr,
-                                "RPM: Too full to encode object end!\r\n");
+                        fprintf(stderr,
+                            "RPM: Too full for individual property!\r\n");
 #endif
-                            rpmdata.error_code =
-                                ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
-                            error = BACNET_STATUS_ABORT;
-                            berror = true;
-                            break; /* The berror flag ensures that both loops */
-                            /* will be broken! */
-                        } else {
-                            apdu_len += copy_len;
-                        }
-                        break; /* finished with this property list */
+                        error = len;
+                        berror = true;
+                        break; /* The berror flag ensures that both loops */
+                        /* will be broken! */
                     }
-                } /* for(;;) */
+                }
                 if (berror) {
                     break;
                 }
-                if (decode_len >= service_len) {
-                    /* Reached the end so finish up */
-                    break;
+                if (decode_is_closing_tag_number(
+                        &service_request[decode_len], 1)) {
+                    /* Reached end of property list so cap the result list
+                     */
+                    decode_len++;
+                    if (!RPM_Encode_Object_End(&writer)) {
+#if PRINT_ENABLED
+                        fprintf(
+                            stderr, "RPM: Too full to encode object end!\r\n");
+#endif
+                        rpmdata.error_code =
+                            ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+                        error = BACNET_STATUS_ABORT;
+                        berror = true;
+                    }
+                    break; /* finished with this property list */
                 }
             } /* for(;;) */
-
-            /* If not having an error so far, check the remaining space. */
-            if (!berror) {
-                if (apdu_len > service_data->max_resp) {
-                    /* too big for the sender - send an abort */
-                    rpmdata.error_code =
-                        ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
-                    error = BACNET_STATUS_ABORT;
+            if (berror) {
+                break;
+            }
+            if (decode_len >= service_len) {
+                /* Reached the end so finish up */
+                break;
+            }
+        } /* for(;;) */
+
+        /* If not having an error so far, check the remaining space. */
+        if (!berror) {
+            if (memcopy_writer_length(&writer) > service_data->max_resp) {
+                /* too big for the sender - send an abort */
+                rpmdata.error_code =
+                    ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+                error = BACNET_STATUS_ABORT;
 #if PRINT_ENABLED
-                    fprintf(
-                        stderr, "RPM: Message too large.  Sending Abort!\n");
+                fprintf(stderr, "RPM: Message too large.  Sending Abort!\n");
 #endif
-                }
             }
         }
-
-        /* Error fallback. */
-        if (error) {
-            if (error == BACNET_STATUS_ABORT) {
-                apdu_len = abort_encode_apdu(&Handler_Transmit_Buffer[npdu_len],
-                    service_data->invoke_id,
-                    abort_convert_error_code(rpmdata.error_code), true);
+    }
+    apdu_len = (int)memcopy_writer_length(&writer);
+    /* Error fallback. */
+    if (error) {
+        if (error == BACNET_STATUS_ABORT) {
+            apdu_len = abort_encode_apdu(apdu, service_data->invoke_id,
+                abort_convert_error_code(rpmdata.error_code), true);
 #if PRINT_ENABLED
-                fprintf(stderr, "RPM: Sending Abort!\n");
+            fprintf(stderr, "RPM: Sending Abort!\n");
 #endif
-            } else if (error == BACNET_STATUS_ERROR) {
-                apdu_len = bacerror_encode_apdu(
-                    &Handler_Transmit_Buffer[npdu_len], service_data->invoke_id,
-                    SERVICE_CONFIRMED_READ_PROP_MULTIPLE, rpmdata.error_class,
-                    rpmdata.error_code);
+        } else if (error == BACNET_STATUS_ERROR) {
+            apdu_len = bacerror_encode_apdu(apdu, service_data->invoke_id,
+                SERVICE_CONFIRMED_READ_PROP_MULTIPLE, rpmdata.error_class,
+                rpmdata.error_code);
 #if PRINT_ENABLED
-                fprintf(stderr, "RPM: Sending Error!\n");
+            fprintf(stderr, "RPM: Sending Error!\n");
 #endif
-            } else if (error == BACNET_STATUS_REJECT) {
-                apdu_len = reject_encode_apdu(
-                    &Handler_Transmit_Buffer[npdu_len], service_data->invoke_id,
-                    reject_convert_error_code(rpmdata.error_code));
+        } else if (error == BACNET_STATUS_REJECT) {
+            apdu_len = reject_encode_apdu(apdu, service_data->invoke_id,
+                reject_convert_error_code(rpmdata.error_code));
 #if PRINT_ENABLED
-                fprintf(stderr, "RPM: Sending Reject!\n");
+            fprintf(stderr, "RPM: Sending Reject!\n");
 #endif
-            }
         }
+    }
+
+    return apdu_len;
+}
 
+/** Handler for a ReadPropertyMultiple Service request.
+ * @ingroup DSRPM
+ * This handler will be invoked by apdu_handler() if it has been enabled
+ * by a call to apdu_set_confirmed_handler().
+ * This handler builds a response packet using
+ * handler_read_property_multiple_encode() and sends it.
+ *
+ * @param service_request [in] The contents of the service request.
+ * @param service_len [in] The length of the service_request.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param service_data [in] The BACNET_CONFIRMED_SERVICE_DATA information
+ *                          decoded from the APDU header of this message.
+ */
+void handler_read_property_multiple(uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    int pdu_len = 0;
+    BACNET_NPDU_DATA npdu_data;
+    int bytes_sent;
+    BACNET_ADDRESS my_address;
+    int apdu_len = 0;
+    int npdu_len = 0;
+
+    if (service_data && (service_len > 0)) {
+        /* encode the NPDU portion of the packet */
+        datalink_get_my_address(&my_address);
+        npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+        npdu_len = npdu_encode_pdu(
+            &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
+        apdu_len = handler_read_property_multiple_encode(service_request,
+            service_len, service_data, &Handler_Transmit_Buffer[npdu_len],
+            sizeof(Handler_Transmit_Buffer) - npdu_len);
         pdu_len = apdu_len + npdu_len;
         bytes_sent = datalink_send_pdu(
             src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
@@ -47,6 +47,13 @@ extern "C" {
         uint16_t service_len,
         BACNET_ADDRESS * src,
         BACNET_CONFIRMED_SERVICE_DATA * service_data);
+    BACNET_STACK_EXPORT
+    int handler_read_property_multiple_encode(
+        uint8_t * service_request,
+        uint16_t service_len,
+        BACNET_CONFIRMED_SERVICE_DATA * service_data,
+        uint8_t * apdu,
+        size_t apdu_size);
 
 #ifdef __cplusplus
 }
@@ -37,6 +37,7 @@
 /* some demo stuff needed */
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/arena.h"
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/datalink/datalink.h"
@@ -44,8 +45,39 @@
 #define PRINTF debug_aprintf
 #define PERROR debug_perror
 
+/* optional arena for decoding the ACK */
+static ARENA_BUFFER *RPM_Ack_Arena;
+
 /** @file h_rpm_a.c  Handles Read Property Multiple Acknowledgments. */
 
+/**
+ * @brief Allocate zeroed memory for the linked list of RPM data
+ * @param arena - arena to allocate from, or NULL to use the heap
+ * @param size - number of bytes to allocate
+ * @return pointer to the memory, or NULL if there is none
+ */
+static void *rpm_ack_calloc(ARENA_BUFFER *arena, size_t size)
+{
+    if (arena) {
+        return Arena_Alloc(arena, size);
+    }
+
+    return calloc(1, size);
+}
+
+/**
+ * @brief Free memory of the linked list of RPM data.  Memory from an arena
+ *  is released all at once by resetting the arena.
+ * @param arena - arena the memory came from, or NULL for the heap
+ * @param data - memory to free
+ */
+static void rpm_ack_free(ARENA_BUFFER *arena, void *data)
+{
+    if (!arena) {
+        free(data);
+    }
+}
+
 /** Decode the received RPM data and make a linked list of the results.
  * @ingroup DSRPM
  *
@@ -57,6 +89,30 @@
  */
 int rpm_ack_decode_service_request(
     uint8_t *apdu, int apdu_len, BACNET_READ_ACCESS_DATA *read_access_data)
+{
+    return rpm_ack_decode_service_request_arena(
+        apdu, apdu_len, read_access_data, NULL);
+}
+
+/** Decode the received RPM data and make a linked list of the results,
+ * with the list elements allocated from an arena instead of the heap.
+ * Do not use rpm_data_free() on the list: reset the arena when the data
+ * is no longer needed.  The size of the arena bounds the memory used by
+ * one ACK: running out of memory is a decoding error, so that a partial
+ * list is never returned as complete.
+ * @ingroup DSRPM
+ *
+ * @param apdu [in] The received apdu data.
+ * @param apdu_len [in] Total length of the apdu.
+ * @param read_access_data [out] Pointer to the head of the linked list
+ * 			where the RPM data is to be stored.
+ * @param arena [in] Arena for the list elements, or NULL to use the heap
+ * @return The number of bytes decoded, or -1 on error
+ */
+int rpm_ack_decode_service_request_arena(uint8_t *apdu,
+    int apdu_len,
+    BACNET_READ_ACCESS_DATA *read_access_data,
+    ARENA_BUFFER *arena)
 {
     int decoded_len = 0; /* return value */
     uint32_t error_value = 0; /* decoded error value */
@@ -83,7 +139,7 @@ int rpm_ack_decode_service_request(
             old_rpm_object->next = NULL;
             if (rpm_object != read_access_data) {
                 /* don't free original */
-                free(rpm_object);
+                rpm_ack_free(arena, rpm_object);
                 rpm_object = NULL;
             }
             break;
@@ -91,8 +147,13 @@ int rpm_ack_decode_service_request(
         decoded_len += len;
         apdu_len -= len;
         apdu += len;
-        rpm_property = calloc(1, sizeof(BACNET_PROPERTY_REFERENCE));
+        rpm_property =
+            rpm_ack_calloc(arena, sizeof(BACNET_PROPERTY_REFERENCE));
         rpm_object->listOfProperties = rpm_property;
+        if (!rpm_property) {
+            /* note: caller will free the memory */
+            return BACNET_STATUS_ERROR;
+        }
         old_rpm_property = rpm_property;
         while (rpm_property && apdu_len) {
             len = rpm_ack_decode_object_property(apdu, apdu_len,
@@ -104,7 +165,7 @@ int rpm_ack_decode_service_request(
                     /* was this the only property in the list? */
                     rpm_object->listOfProperties = NULL;
                 }
-                free(rpm_property);
+                rpm_ack_free(arena, rpm_property);
                 rpm_property = NULL;
                 break;
             }
@@ -120,8 +181,13 @@ int rpm_ack_decode_service_request(
                 apdu++;
                 /* note: if this is an array, there will be
                    more than one element to decode */
-                value = calloc(1, sizeof(BACNET_APPLICATION_DATA_VALUE));
+                value = rpm_ack_calloc(
+                    arena, sizeof(BACNET_APPLICATION_DATA_VALUE));
                 rpm_property->value = value;
+                if (!value) {
+                    /* note: caller will free the memory */
+                    return BACNET_STATUS_ERROR;
+                }
 
                 /* Special case for an empty array - we decode it as null */
                 if (apdu_len && decode_is_closing_tag_number(apdu, 4)) {
@@ -162,9 +228,12 @@ int rpm_ack_decode_service_request(
                             break;
                         } else if (len > 0) {
                             old_value = value;
-                            value = calloc(
-                                1, sizeof(BACNET_APPLICATION_DATA_VALUE));
+                            value = rpm_ack_calloc(arena,
+                                sizeof(BACNET_APPLICATION_DATA_VALUE));
                             old_value->next = value;
+                            if (!value) {
+                                return BACNET_STATUS_ERROR;
+                            }
                         } else {
                             PERROR("RPM Ack: decoded %s:%s len=%d\n",
                                 bactext_object_type_name(
@@ -212,8 +281,12 @@ int rpm_ack_decode_service_request(
                 }
             }
             old_rpm_property = rpm_property;
-            rpm_property = calloc(1, sizeof(BACNET_PROPERTY_REFERENCE));
+            rpm_property =
+                rpm_ack_calloc(arena, sizeof(BACNET_PROPERTY_REFERENCE));
             old_rpm_property->next = rpm_property;
+            if (!rpm_property) {
+                return BACNET_STATUS_ERROR;
+            }
         }
         len = rpm_decode_object_end(apdu, apdu_len);
         if (len) {
@@ -223,8 +296,12 @@ int rpm_ack_decode_service_request(
         }
         if (apdu_len) {
             old_rpm_object = rpm_object;
-            rpm_object = calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
+            rpm_object =
+                rpm_ack_calloc(arena, sizeof(BACNET_READ_ACCESS_DATA));
             old_rpm_object->next = rpm_object;
+            if (!rpm_object) {
+                return BACNET_STATUS_ERROR;
+            }
         }
     }
 
@@ -347,6 +424,16 @@ BACNET_READ_ACCESS_DATA *rpm_data_free(BACNET_READ_ACCESS_DATA *rpm_data)
     return rpm_data;
 }
 
+/**
+ * @brief Set an arena for handler_read_property_multiple_ack() to decode
+ *  each ACK into, instead of the heap.  The arena is reset after each ACK.
+ * @param arena - arena for the decoded data, or NULL to use the heap
+ */
+void handler_read_property_multiple_ack_arena_set(ARENA_BUFFER *arena)
+{
+    RPM_Ack_Arena = arena;
+}
+
 /** Handler for a ReadPropertyMultiple ACK.
  * @ingroup DSRPM
  * For each read property, print out the ACK'd data for debugging,
@@ -369,6 +456,21 @@ void handler_read_property_multiple_ack(uint8_t *service_request,
     (void)src;
     (void)service_data; /* we could use these... */
 
+    if (RPM_Ack_Arena) {
+        rpm_data = Arena_Alloc(RPM_Ack_Arena, sizeof(BACNET_READ_ACCESS_DATA));
+        len = rpm_ack_decode_service_request_arena(
+            service_request, service_len, rpm_data, RPM_Ack_Arena);
+        if (len > 0) {
+            while (rpm_data) {
+                rpm_ack_print_data(rpm_data);
+                rpm_data = rpm_data->next;
+            }
+        } else {
+            PERROR("RPM Ack Malformed!\n");
+        }
+        Arena_Reset(RPM_Ack_Arena);
+        return;
+    }
     rpm_data = calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
     if (rpm_data) {
         len = rpm_ack_decode_service_request(
@@ -37,6 +37,7 @@
 /* BACnet Stack API */
 #include "bacnet/apdu.h"
 #include "bacnet/rpm.h"
+#include "bacnet/basic/sys/arena.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -49,11 +50,20 @@ extern "C" {
         BACNET_ADDRESS * src,
         BACNET_CONFIRMED_SERVICE_ACK_DATA * service_data);
     BACNET_STACK_EXPORT
+    void handler_read_property_multiple_ack_arena_set(
+        ARENA_BUFFER * arena);
+    BACNET_STACK_EXPORT
     int rpm_ack_decode_service_request(
         uint8_t * apdu,
         int apdu_len,
         BACNET_READ_ACCESS_DATA * read_access_data);
     BACNET_STACK_EXPORT
+    int rpm_ack_decode_service_request_arena(
+        uint8_t * apdu,
+        int apdu_len,
+        BACNET_READ_ACCESS_DATA * read_access_data,
+        ARENA_BUFFER * arena);
+    BACNET_STACK_EXPORT
     void rpm_ack_print_data(
         BACNET_READ_ACCESS_DATA * rpm_data);
     BACNET_STACK_EXPORT
@@ -116,6 +116,10 @@ void handler_who_has(
  * with broadcast I-Have response.
  * Will respond if the device Object ID matches, and we have
  * the Object or Object Name requested.
+ * The request is decoded once.  The routed Devices share the objects
+ * of the gateway, so those are searched once; only the Device objects
+ * are checked for each Device in the range, which are found in the
+ * index of Device instances.
  *
  * @ingroup DMDOB
  * @param service_request [in] The received message to be handled.
@@ -127,25 +131,62 @@ void handler_who_has_for_routing(
 {
     int len = 0;
     BACNET_WHO_HAS_DATA data;
-    int32_t dev_instance;
-    int cursor = 0; /* Starting hint */
-    int my_list[2] = { 0, -1 }; /* Not really used, so dummy values */
-    BACNET_ADDRESS bcast_net;
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t object_instance = 0;
+    BACNET_CHARACTER_STRING object_name;
+    DEVICE_OBJECT_DATA *pDev;
+    uint32_t dev_instance = 0;
+    uint32_t high_limit = BACNET_MAX_INSTANCE;
+    bool found = false;
 
     (void)src;
     len = whohas_decode_service_request(service_request, service_len, &data);
-    if (len > 0) {
-        /* Go through all devices, starting with the root gateway Device */
-        memset(&bcast_net, 0, sizeof(BACNET_ADDRESS));
-        bcast_net.net =
-            BACNET_BROADCAST_NETWORK; /* That's all we have to set */
-        while (Routed_Device_GetNext(&bcast_net, my_list, &cursor)) {
-            dev_instance = Device_Object_Instance_Number();
-            if ((data.low_limit == -1) || (data.high_limit == -1) ||
-                ((dev_instance >= data.low_limit) &&
-                    (dev_instance <= data.high_limit)))
-                match_name_or_object(&data);
+    if (len <= 0) {
+        return;
+    }
+    if ((data.low_limit != -1) && (data.high_limit != -1)) {
+        dev_instance = (uint32_t)data.low_limit;
+        high_limit = (uint32_t)data.high_limit;
+    }
+    /* search the shared objects once, from the gateway Device */
+    (void)Get_Routed_Device_Object(0);
+    if (data.is_object_name) {
+        found = Device_Valid_Object_Name(
+            &data.object.name, &object_type, &object_instance);
+        characterstring_copy(&object_name, &data.object.name);
+    } else if (data.object.identifier.type != OBJECT_DEVICE) {
+        object_type = (BACNET_OBJECT_TYPE)data.object.identifier.type;
+        object_instance = data.object.identifier.instance;
+        found = Device_Object_Name_Copy(
+            object_type, object_instance, &object_name);
+    }
+    if (found && (object_type == OBJECT_DEVICE)) {
+        /* a Device object is not shared */
+        found = false;
+    }
+    while (Routed_Device_Instance_Next(&dev_instance, high_limit)) {
+        pDev = Get_Routed_Device_Object(-1);
+        if (found) {
+            Send_I_Have(dev_instance, object_type, object_instance,
+                &object_name);
+        } else if (data.is_object_name) {
+            if (characterstring_ansi_same(
+                    &data.object.name, pDev->bacObj.Object_Name)) {
+                Send_I_Have(dev_instance, OBJECT_DEVICE, dev_instance,
+                    &data.object.name);
+            }
+        } else if ((data.object.identifier.type == OBJECT_DEVICE) &&
+            (data.object.identifier.instance == dev_instance)) {
+            characterstring_init_ansi(&object_name, pDev->bacObj.Object_Name);
+            Send_I_Have(dev_instance, OBJECT_DEVICE, dev_instance,
+                &object_name);
+        }
+        if (dev_instance == high_limit) {
+            break;
         }
+        dev_instance++;
     }
+    /* leave the gateway Device as the current Device */
+    (void)Get_Routed_Device_Object(0);
 }
 #endif /* BAC_ROUTING */
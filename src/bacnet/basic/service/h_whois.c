@@ -30,6 +30,7 @@
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
+#include "bacnet/bacaddr.h"
 #include "bacnet/bacdcode.h"
 #include "bacnet/whois.h"
 #include "bacnet/iam.h"
@@ -106,9 +107,59 @@ void handler_who_is_unicast(
    virtual Router did not insert the SADRs of the virtual devices on the virtual
    network without it */
 
+/* Who-Is requests still being answered, a few I-Am at a time */
+#ifndef WHO_IS_ROUTING_BATCH_MAX
+#define WHO_IS_ROUTING_BATCH_MAX 4
+#endif
+struct who_is_routing_batch {
+    bool active;
+    bool is_unicast;
+    uint32_t next_instance;
+    uint32_t high_limit;
+    BACNET_ADDRESS dest;
+};
+static struct who_is_routing_batch
+    Who_Is_Routing_Batch[WHO_IS_ROUTING_BATCH_MAX];
+/* I-Am sent per second for Who-Is requests, or 0 to send them at once */
+static unsigned Who_Is_Routing_Rate;
+/* I-Am that may be sent now, in thousandths */
+static uint32_t Who_Is_Routing_Credit;
+/* Who-Is requests not answered because every batch was busy */
+static uint32_t Who_Is_Routing_Drops;
+
+/** Local function to send the I-Am of the next routed Device in the
+ * range of a Who-Is request.
+ *
+ * @param batch [in,out] The Who-Is request being answered; no longer
+ *                       active once every Device in its range has been.
+ */
+static void who_is_routing_batch_send(struct who_is_routing_batch *batch)
+{
+    if (Routed_Device_Instance_Next(
+            &batch->next_instance, batch->high_limit)) {
+        if (batch->is_unicast) {
+            Send_I_Am_Unicast(&Handler_Transmit_Buffer[0], &batch->dest);
+        } else {
+            Send_I_Am(&Handler_Transmit_Buffer[0]);
+        }
+        if (batch->next_instance < batch->high_limit) {
+            batch->next_instance++;
+        } else {
+            batch->active = false;
+        }
+    } else {
+        batch->active = false;
+    }
+    /* leave the gateway Device as the current Device */
+    (void)Get_Routed_Device_Object(0);
+}
+
 /** Local function to check Who-Is requests against our Device IDs.
  * Will check the gateway (root Device) and all virtual routed
  * Devices against the range and respond for each that matches.
+ * The request is decoded once, and the Devices in its range are found
+ * in the index of Device instances.  If a rate is set, the responses
+ * are sent a few at a time by handler_who_is_for_routing_task().
  *
  * @param service_request [in] The received message to be handled.
  * @param service_len [in] Length of the service_request message.
@@ -125,10 +176,8 @@ static void check_who_is_for_routing(uint8_t *service_request,
     int len = 0;
     int32_t low_limit = 0;
     int32_t high_limit = 0;
-    int32_t dev_instance;
-    int cursor = 0; /* Starting hint */
-    int my_list[2] = { 0, -1 }; /* Not really used, so dummy values */
-    BACNET_ADDRESS bcast_net;
+    struct who_is_routing_batch batch = { 0 };
+    unsigned i;
 
     len = whois_decode_service_request(
         service_request, service_len, &low_limit, &high_limit);
@@ -136,21 +185,95 @@ static void check_who_is_for_routing(uint8_t *service_request,
         /* Invalid; just leave */
         return;
     }
-    /* Go through all devices, starting with the root gateway Device */
-    memset(&bcast_net, 0, sizeof(BACNET_ADDRESS));
-    bcast_net.net = BACNET_BROADCAST_NETWORK; /* That's all we have to set */
-
-    while (Routed_Device_GetNext(&bcast_net, my_list, &cursor)) {
-        dev_instance = Device_Object_Instance_Number();
+    batch.active = true;
+    batch.is_unicast = is_unicast;
+    if (len == 0) {
         /* If len == 0, no limits and always respond */
-        if ((len == 0) ||
-            ((dev_instance >= low_limit) && (dev_instance <= high_limit))) {
-            if (is_unicast)
-                Send_I_Am_Unicast(&Handler_Transmit_Buffer[0], src);
-            else
-                Send_I_Am(&Handler_Transmit_Buffer[0]);
+        batch.next_instance = 0;
+        batch.high_limit = BACNET_MAX_INSTANCE;
+    } else {
+        batch.next_instance = (uint32_t)low_limit;
+        batch.high_limit = (uint32_t)high_limit;
+    }
+    if (src) {
+        bacnet_address_copy(&batch.dest, src);
+    }
+    if (Who_Is_Routing_Rate == 0) {
+        while (batch.active) {
+            who_is_routing_batch_send(&batch);
+        }
+        return;
+    }
+    for (i = 0; i < WHO_IS_ROUTING_BATCH_MAX; i++) {
+        if (!Who_Is_Routing_Batch[i].active) {
+            Who_Is_Routing_Batch[i] = batch;
+            return;
         }
     }
+    /* every batch is busy; the client will ask again */
+    Who_Is_Routing_Drops++;
+}
+
+/** Set the rate at which the I-Am responses to Who-Is requests are sent
+ * for the gateway and its virtual routed Devices.  At a rate, the I-Am
+ * are sent by handler_who_is_for_routing_task() instead of all at once
+ * when the Who-Is is received.
+ *
+ * @param i_am_per_second [in] The number of I-Am sent each second, or 0
+ *                             to send them all at once.
+ */
+void handler_who_is_for_routing_rate_set(unsigned i_am_per_second)
+{
+    Who_Is_Routing_Rate = i_am_per_second;
+    Who_Is_Routing_Credit = 0;
+}
+
+/** Send the I-Am responses that are due for the Who-Is requests being
+ * answered at the rate set by handler_who_is_for_routing_rate_set().
+ * Call it on every pass of the main loop.
+ *
+ * @param milliseconds [in] The time since it was last called.
+ */
+void handler_who_is_for_routing_task(uint16_t milliseconds)
+{
+    uint32_t credit_max;
+    bool pending = true;
+    unsigned i;
+
+    if (Who_Is_Routing_Rate == 0) {
+        return;
+    }
+    Who_Is_Routing_Credit += (uint32_t)milliseconds * Who_Is_Routing_Rate;
+    /* send no more at once than are due in a second */
+    credit_max = Who_Is_Routing_Rate * 1000UL;
+    if (Who_Is_Routing_Credit > credit_max) {
+        Who_Is_Routing_Credit = credit_max;
+    }
+    while (pending && (Who_Is_Routing_Credit >= 1000UL)) {
+        pending = false;
+        for (i = 0; i < WHO_IS_ROUTING_BATCH_MAX; i++) {
+            if (Who_Is_Routing_Batch[i].active) {
+                who_is_routing_batch_send(&Who_Is_Routing_Batch[i]);
+                Who_Is_Routing_Credit -= 1000UL;
+                pending = true;
+                break;
+            }
+        }
+    }
+    if (!pending) {
+        /* no credit is saved up while there is nothing to send */
+        Who_Is_Routing_Credit = 0;
+    }
+}
+
+/** Get the number of Who-Is requests that were not answered because
+ * WHO_IS_ROUTING_BATCH_MAX requests were already being answered.
+ *
+ * @return The number of dropped Who-Is requests.
+ */
+uint32_t handler_who_is_for_routing_drops(void)
+{
+    return Who_Is_Routing_Drops;
 }
 
 /** Handler for Who-Is requests in the virtual routing setup,
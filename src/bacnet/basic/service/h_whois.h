@@ -65,6 +65,18 @@ extern "C" {
         uint16_t service_len,
         BACNET_ADDRESS * src);
 
+    BACNET_STACK_EXPORT
+    void handler_who_is_for_routing_rate_set(
+        unsigned i_am_per_second);
+
+    BACNET_STACK_EXPORT
+    void handler_who_is_for_routing_task(
+        uint16_t milliseconds);
+
+    BACNET_STACK_EXPORT
+    uint32_t handler_who_is_for_routing_drops(
+        void);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -0,0 +1,109 @@
+/**
+ * @file
+ * @brief A bump allocator of scratch memory for decoding or encoding one
+ * request.  Each allocation takes the next aligned bytes of a block of
+ * memory supplied by the caller, and nothing is freed individually: the
+ * whole block is released by Arena_Reset() once the request is handled.
+ * The size of the block bounds the memory used by any one request, and
+ * Arena_Peak() reports the most that was ever needed.
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+/* me! */
+#include "bacnet/basic/sys/arena.h"
+
+/**
+ * @brief Initialize an arena with a block of memory
+ * @param arena - arena to initialize
+ * @param data - block of memory, owned by the caller, or NULL
+ * @param size - size, in bytes, of the block of memory
+ */
+void Arena_Init(ARENA_BUFFER *arena, void *data, size_t size)
+{
+    if (arena) {
+        arena->data = data;
+        arena->size = data ? size : 0;
+        arena->used = 0;
+        arena->peak = 0;
+    }
+}
+
+/**
+ * @brief Allocate zeroed memory from the arena
+ * @param arena - arena to allocate from
+ * @param size - number of bytes to allocate
+ * @return pointer to the memory, aligned to ARENA_ALIGNMENT,
+ *  or NULL if the arena does not have room for it
+ */
+void *Arena_Alloc(ARENA_BUFFER *arena, size_t size)
+{
+    uintptr_t address;
+    size_t padding;
+    uint8_t *memory;
+
+    if (!arena || !arena->data || (size == 0)) {
+        return NULL;
+    }
+    address = (uintptr_t)&arena->data[arena->used];
+    padding = (size_t)((ARENA_ALIGNMENT - (address % ARENA_ALIGNMENT)) %
+        ARENA_ALIGNMENT);
+    if ((padding > (arena->size - arena->used)) ||
+        (size > (arena->size - arena->used - padding))) {
+        return NULL;
+    }
+    memory = &arena->data[arena->used + padding];
+    arena->used += padding + size;
+    if (arena->used > arena->peak) {
+        arena->peak = arena->used;
+    }
+    memset(memory, 0, size);
+
+    return memory;
+}
+
+/**
+ * @brief Release all the memory allocated from the arena
+ * @param arena - arena to reset
+ */
+void Arena_Reset(ARENA_BUFFER *arena)
+{
+    if (arena) {
+        arena->used = 0;
+    }
+}
+
+/**
+ * @brief Get the number of bytes allocated since the last reset
+ * @param arena - arena
+ * @return number of bytes in use, including alignment padding
+ */
+size_t Arena_Used(ARENA_BUFFER const *arena)
+{
+    return arena ? arena->used : 0;
+}
+
+/**
+ * @brief Get the number of bytes left in the arena
+ * @param arena - arena
+ * @return number of bytes not yet allocated
+ */
+size_t Arena_Available(ARENA_BUFFER const *arena)
+{
+    return arena ? (arena->size - arena->used) : 0;
+}
+
+/**
+ * @brief Get the largest number of bytes used since the arena was
+ *  initialized, to size the block of memory for a request
+ * @param arena - arena
+ * @return number of bytes
+ */
+size_t Arena_Peak(ARENA_BUFFER const *arena)
+{
+    return arena ? arena->peak : 0;
+}
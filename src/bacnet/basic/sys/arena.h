@@ -0,0 +1,51 @@
+/**
+ * @file
+ * @brief API for a bump allocator of scratch memory for decoding or encoding
+ * one request, released all at once by a reset after the request is handled.
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_ARENA_H
+#define BACNET_SYS_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* alignment of each allocation, in bytes, a power of two */
+#ifndef ARENA_ALIGNMENT
+#define ARENA_ALIGNMENT 8
+#endif
+
+struct arena_buffer_t {
+    uint8_t *data; /* block of memory owned by the caller */
+    size_t size; /* size, in bytes, of the block of memory */
+    size_t used; /* number of bytes allocated since the last reset */
+    size_t peak; /* largest number of bytes used since initialization */
+};
+typedef struct arena_buffer_t ARENA_BUFFER;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void Arena_Init(ARENA_BUFFER *arena, void *data, size_t size);
+BACNET_STACK_EXPORT
+void *Arena_Alloc(ARENA_BUFFER *arena, size_t size);
+BACNET_STACK_EXPORT
+void Arena_Reset(ARENA_BUFFER *arena);
+BACNET_STACK_EXPORT
+size_t Arena_Used(ARENA_BUFFER const *arena);
+BACNET_STACK_EXPORT
+size_t Arena_Available(ARENA_BUFFER const *arena);
+BACNET_STACK_EXPORT
+size_t Arena_Peak(ARENA_BUFFER const *arena);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -172,6 +172,38 @@ uint8_t FIFO_Peek(FIFO_BUFFER const *b)
     return 0;
 }
 
+/**
+ * Copies one or more bytes from the front of the FIFO without removing
+ * them, so that a consumer can use only some of them and then remove
+ * those with FIFO_Pull() and a NULL buffer.
+ *
+ * @param b - pointer to FIFO_BUFFER structure
+ * @param buffer [out] - buffer to hold the copied bytes
+ * @param length [in] - number of bytes to copy from the FIFO
+ *
+ * @return      the number of bytes actually copied from the FIFO
+ */
+unsigned FIFO_Peek_Data(FIFO_BUFFER const *b, uint8_t *buffer, unsigned length)
+{
+    unsigned count;
+    unsigned tail;
+    unsigned index;
+
+    count = FIFO_Count(b);
+    if (count > length) {
+        count = length;
+    }
+    if (!buffer) {
+        return 0;
+    }
+    tail = b->tail;
+    for (index = 0; index < count; index++) {
+        buffer[index] = b->buffer[(tail + index) % b->buffer_len];
+    }
+
+    return count;
+}
+
 /**
  * Gets a byte from the front of the FIFO, and removes it.
  * Use FIFO_Empty() or FIFO_Available() function to see if there is
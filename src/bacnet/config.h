@@ -46,7 +46,9 @@
 #endif
 #endif
 
-/* Enable the Gateway (Routing) functionality here, if desired. */
+/* Enable the Gateway (Routing) functionality here, if desired.
+   The table of routed Devices grows as Devices are added; this is the
+   number of Devices that the gateway example creates. */
 #if !defined(MAX_NUM_DEVICES)
 #ifdef BAC_ROUTING
 #define MAX_NUM_DEVICES 32       /* Eg, Gateway + 31 remote devices */
@@ -287,6 +289,24 @@
 #define BACNET_SVC_SERVER 1
 #endif
 
+/*
+** Compile-time service dispatch: define these in bacnet-config.h to
+** replace the handler tables that apdu_set_confirmed_handler() and
+** apdu_set_unconfirmed_handler() fill at runtime with a constant switch in
+** apdu_handler().  The setters do nothing in such a build, so do not call
+** them; the handlers and codecs of services that are not listed are then
+** not referenced, and a linker with section garbage collection drops them.
+** Without BACNET_UNRECOGNIZED_SERVICE_HANDLER, the unrecognized service
+** handler is still set with apdu_set_unrecognized_service_handler_handler().
+**
+** #define BACNET_CONFIRMED_SERVICE_HANDLERS(X) \
+**     X(SERVICE_CONFIRMED_READ_PROPERTY, handler_read_property) \
+**     X(SERVICE_CONFIRMED_WRITE_PROPERTY, handler_write_property)
+** #define BACNET_UNCONFIRMED_SERVICE_HANDLERS(X) \
+**     X(SERVICE_UNCONFIRMED_WHO_IS, handler_who_is)
+** #define BACNET_UNRECOGNIZED_SERVICE_HANDLER handler_unrecognized_service
+*/
+
 #ifndef BACNET_USE_OCTETSTRING  /* Do we need any octet strings? */
 #define BACNET_USE_OCTETSTRING 0
 #endif
@@ -104,6 +104,11 @@ BACNET_STACK_EXPORT
 uint32_t cobs_crc32k(
     uint8_t dataValue,
     uint32_t crc);
+BACNET_STACK_EXPORT
+uint32_t cobs_crc32k_span(
+    const uint8_t *data,
+    size_t length,
+    uint32_t crc);
 
 BACNET_STACK_EXPORT
 size_t cobs_crc32k_encode(
@@ -41,6 +41,11 @@ extern "C" {
     uint16_t CRC_Calc_Data(
         uint8_t dataValue,
         uint16_t crcValue);
+    BACNET_STACK_EXPORT
+    uint16_t CRC_Calc_Data_Span(
+        const uint8_t *data,
+        size_t length,
+        uint16_t crcValue);
 
 #ifdef __cplusplus
 }
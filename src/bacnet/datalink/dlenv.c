@@ -39,6 +39,9 @@
 #if (BACNET_PROTOCOL_REVISION >= 17)
 #include "bacnet/basic/object/netport.h"
 #endif
+#if defined(BACDL_BIP6)
+#include "bacnet/basic/bbmd6/vmac.h"
+#endif
 
 /** @file dlenv.c  Initialize the DataLink configuration. */
 /* timer used to renew Foreign Device Registration */
@@ -283,14 +286,8 @@ static int bbmd_register_as_foreign_device(void)
 static int bbmd6_register_as_foreign_device(void)
 {
     int retval = 0;
-    bool bdt_entry_valid = false;
-    uint16_t bdt_entry_port = 0;
     char *pEnv = NULL;
-    unsigned a[4] = { 0 };
-    char bbmd_env[32] = "";
-    unsigned entry_number = 0;
     long long_value = 0;
-    int c;
     BACNET_IP6_ADDRESS bip6_addr = { 0 };
     uint16_t bip6_port = 0xBAC0;
 
@@ -309,20 +306,15 @@ static int bbmd6_register_as_foreign_device(void)
         }
     }
     pEnv = getenv("BACNET_BBMD6_ADDRESS");
-    if (bvlc6_address_from_ascii(pEnv, &bip6_addr)) {
-        if (BIP_DL_Debug) {
-            fprintf(stderr,
-                "Registering with BBMD6 at %s for %u seconds\n",
-                pEnv, (unsigned)bip6_port, (unsigned)BBMD_TTL_Seconds);
-        }
+    if (pEnv && bvlc6_address_from_ascii(&bip6_addr, pEnv)) {
+        bip6_addr.port = bip6_port;
         retval = bvlc6_register_with_bbmd(&bip6_addr, BBMD_TTL_Seconds);
         if (retval < 0) {
             fprintf(stderr, "FAILED to Register with BBMD6 at %s:%u\n",
-                pEnv, (unsigned)BBMD_Address.port);
+                pEnv, (unsigned)bip6_port);
         }
         BBMD_Timer_Seconds = BBMD_TTL_Seconds;
     }
-    BBMD_Result = retval;
 
     return retval;
 }
@@ -544,6 +536,12 @@ void dlenv_maintenance_timer(uint16_t elapsed_seconds)
  *       entry 1..128 (optional)
  *   - BACNET_IP_NAT_ADDR - dotted IPv4 address of the public facing router
  *   - BACNET_IP_BROADCAST_BIND_ADDR - dotted IPv4 address to bind broadcasts
+ *   - BACNET_BBMD_RATE_LIMIT - number of broadcasts each second that the
+ *       BBMD forwards for a B/IP node. Default is 0 (no limit).
+ *   - BACNET_BBMD_RATE_BURST - number of broadcasts that the BBMD forwards
+ *       at once for a B/IP node. Defaults to BACNET_BBMD_RATE_LIMIT.
+ *   - BACNET_BBMD_DUPLICATE_WINDOW - number of seconds in which the BBMD
+ *       forwards the same broadcast only once. Default is 0 (disabled).
  * - BACDL_MSTP: (BACnet MS/TP)
  *   - BACNET_MAX_INFO_FRAMES
  *   - BACNET_MAX_MASTER
@@ -553,6 +551,8 @@ void dlenv_maintenance_timer(uint16_t elapsed_seconds)
  *   - BACNET_BIP6_PORT - UDP/IP port number (0..65534) used for BACnet/IPv6
  *     communications.  Default is 47808 (0xBAC0).
  *   - BACNET_BIP6_BROADCAST - FF05::BAC0 or FF02::BAC0 or ...
+ *   - BACNET_BIP6_VMAC_LIFETIME - number of seconds that a VMAC address
+ *     is kept after it was last heard from.  Default is 0 (forever).
  */
 void dlenv_init(void)
 {
@@ -589,6 +589,10 @@ void dlenv_init(void)
     } else {
         bip6_set_port(0xBAC0);
     }
+    pEnv = getenv("BACNET_BIP6_VMAC_LIFETIME");
+    if (pEnv) {
+        VMAC_Lifetime_Set((uint32_t)strtoul(pEnv, NULL, 0));
+    }
 #endif
 #if defined(BACDL_BIP)
     BACNET_IP_ADDRESS addr;
@@ -627,6 +631,23 @@ void dlenv_init(void)
             bvlc_set_global_address_for_nat(&addr);
         }
     }
+#if BBMD_ENABLED
+    pEnv = getenv("BACNET_BBMD_RATE_LIMIT");
+    if (pEnv) {
+        uint16_t rate = (uint16_t)strtol(pEnv, NULL, 0);
+        uint16_t burst = 0;
+
+        pEnv = getenv("BACNET_BBMD_RATE_BURST");
+        if (pEnv) {
+            burst = (uint16_t)strtol(pEnv, NULL, 0);
+        }
+        bvlc_bbmd_rate_limit_set(rate, burst);
+    }
+    pEnv = getenv("BACNET_BBMD_DUPLICATE_WINDOW");
+    if (pEnv) {
+        bvlc_bbmd_duplicate_window_set((uint16_t)strtol(pEnv, NULL, 0));
+    }
+#endif
 #elif defined(BACDL_MSTP)
     pEnv = getenv("BACNET_MAX_INFO_FRAMES");
     if (pEnv) {
@@ -104,6 +104,15 @@ static inline void printf_master(const char *format, ...)
 }
 #endif
 
+#if MSTP_STATISTICS_ENABLED
+#define MSTP_STATISTICS_COUNT(port, counter) ((port)->Statistics.counter++)
+#define MSTP_STATISTICS_FRAME(port, counters, frame_type) \
+    MSTP_Statistics_Frame((port)->Statistics.counters, frame_type)
+#else
+#define MSTP_STATISTICS_COUNT(port, counter) ((void)0)
+#define MSTP_STATISTICS_FRAME(port, counters, frame_type) ((void)0)
+#endif
+
 /* MS/TP Frame Format */
 /* All frames are of the following format: */
 /* */
@@ -180,7 +189,8 @@ void MSTP_Fill_BACnet_Address(BACNET_ADDRESS *src, uint8_t mstp_address)
  * @param frame_type - type of frame to send - see defines
  * @param destination - destination address
  * @param source - source address
- * @param data - any data to be sent - may be null
+ * @param data - any data to be sent - may be null, or already in place
+ *  at &buffer[MSTP_FRAME_HEADER_LEN] for frames that are not COBS encoded
  * @param data_len - number of bytes of data
  * @return number of bytes encoded, or 0 on error
  */
@@ -244,10 +254,11 @@ uint16_t MSTP_Create_Frame(uint8_t *buffer,
         if ((8 + data_len + 2) > buffer_size) {
              return 0;
         }
-        for (index = 8; index < (data_len + 8); index++, data++) {
-            buffer[index] = *data;
-            crc16 = CRC_Calc_Data(buffer[index], crc16);
+        if (data != &buffer[MSTP_FRAME_HEADER_LEN]) {
+            memmove(&buffer[MSTP_FRAME_HEADER_LEN], data, data_len);
         }
+        crc16 = CRC_Calc_Data_Span(&buffer[8], data_len, crc16);
+        index = 8 + data_len;
         crc16 = ~crc16;
         buffer[index] = crc16 & 0xFF; /* LSB first */
         buffer[index+1] = crc16 >> 8;
@@ -273,6 +284,58 @@ uint16_t MSTP_Create_Frame(uint8_t *buffer,
     return index; /* returns the frame length */
 }
 
+/**
+ * @brief Get the bin of a statistics histogram for a time
+ * @param milliseconds - time to be counted
+ * @return bin 0 for 0 ms, bin N for 2^(N-1) to 2^N - 1 ms, and the last
+ *  bin for all the longer times
+ */
+unsigned MSTP_Statistics_Histogram_Bin(uint32_t milliseconds)
+{
+    unsigned bin = 0;
+
+    while (milliseconds && (bin < (MSTP_STATISTICS_HISTOGRAM_BINS - 1))) {
+        milliseconds >>= 1;
+        bin++;
+    }
+
+    return bin;
+}
+
+#if MSTP_STATISTICS_ENABLED
+/**
+ * @brief Count a frame by its frame type
+ * @param counters - frame counters of the statistics
+ * @param frame_type - type of the frame
+ */
+static void MSTP_Statistics_Frame(uint32_t *counters, uint8_t frame_type)
+{
+    if (frame_type <= FRAME_TYPE_REPLY_POSTPONED) {
+        counters[frame_type]++;
+    } else if ((frame_type >= Nmin_COBS_type) &&
+        (frame_type <= Nmax_COBS_type)) {
+        counters[MSTP_STATISTICS_FRAME_EXTENDED]++;
+    } else {
+        counters[MSTP_STATISTICS_FRAME_OTHER]++;
+    }
+}
+#endif
+
+/**
+ * @brief Send a frame from the output buffer, and count it
+ * @param mstp_port - port to send from
+ * @param length - number of octets in the frame
+ */
+static void MSTP_Send_Output_Frame(
+    struct mstp_port_struct_t *mstp_port, uint16_t length)
+{
+    if (length > 2) {
+        MSTP_STATISTICS_FRAME(
+            mstp_port, tx_frames, mstp_port->OutputBuffer[2]);
+    }
+    MSTP_Send_Frame(mstp_port, (uint8_t *)&mstp_port->OutputBuffer[0], length);
+}
+
 /**
  * @brief Send an MS/TP Frame
  * @param mstp_port - port to send from
@@ -295,7 +358,7 @@ void MSTP_Create_And_Send_Frame(struct mstp_port_struct_t *mstp_port,
         MSTP_Create_Frame(mstp_port->OutputBuffer, mstp_port->OutputBufferSize,
             frame_type, destination, source, data, data_len);
 
-    MSTP_Send_Frame(mstp_port, (uint8_t *)&mstp_port->OutputBuffer[0], len);
+    MSTP_Send_Output_Frame(mstp_port, len);
     /* FIXME: be sure to reset SilenceTimer() after each octet is sent! */
 }
 
@@ -306,6 +369,8 @@ void MSTP_Create_And_Send_Frame(struct mstp_port_struct_t *mstp_port,
 void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
 {
     MSTP_RECEIVE_STATE receive_state = mstp_port->receive_state;
+    bool valid_frame = mstp_port->ReceivedValidFrame;
+    bool invalid_frame = mstp_port->ReceivedInvalidFrame;
 
     printf_receive(
         "MSTP Rx: State=%s Data=%02X hCRC=%02X Index=%u EC=%u DateLen=%u "
@@ -445,6 +510,7 @@ void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
                         /* indicate that an error has occurred during
                            the reception of a frame */
                         mstp_port->ReceivedInvalidFrame = true;
+                        MSTP_STATISTICS_COUNT(mstp_port, header_crc_errors);
                         printf_receive_error("MSTP: Rx Header: BadCRC [%02X]\n",
                             mstp_port->DataRegister);
                         /* wait for the start of the next frame. */
@@ -564,17 +630,21 @@ void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
                     mstp_port->DataCRCActualLSB = mstp_port->DataRegister;
                     printf_receive_data("%s",
                         mstptext_frame_type((unsigned)mstp_port->FrameType));
-                    if (((mstp_port->Index + 1) < mstp_port->InputBufferSize) &&
+                    if (((mstp_port->Index + 1) <=
+                            mstp_port->InputBufferSize) &&
                         (mstp_port->FrameType >= Nmin_COBS_type) &&
                         (mstp_port->FrameType <= Nmax_COBS_type)) {
+                        /* decoded in place: the decoded data is never
+                           longer than the encoded data before it */
                         mstp_port->DataLength = cobs_frame_decode(
-                            &mstp_port->InputBuffer[mstp_port->Index + 1],
+                            mstp_port->InputBuffer,
                             mstp_port->InputBufferSize,
                             mstp_port->InputBuffer, mstp_port->Index + 1);
                         if (mstp_port->DataLength > 0) {
                             mstp_port->ReceivedValidFrame = true;
                         } else {
                             mstp_port->ReceivedInvalidFrame = true;
+                            MSTP_STATISTICS_COUNT(mstp_port, data_crc_errors);
                         }
                     } else {
                         /* STATE DATA CRC - no need for new state */
@@ -584,6 +654,7 @@ void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
                             mstp_port->ReceivedValidFrame = true;
                         } else {
                             mstp_port->ReceivedInvalidFrame = true;
+                            MSTP_STATISTICS_COUNT(mstp_port, data_crc_errors);
                             printf_receive_error(
                                 "MSTP: Rx Data: BadCRC [%02X]\n",
                                 mstp_port->DataRegister);
@@ -603,6 +674,12 @@ void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
             mstp_port->receive_state = MSTP_RECEIVE_STATE_IDLE;
             break;
     }
+    if (!valid_frame && mstp_port->ReceivedValidFrame) {
+        MSTP_STATISTICS_FRAME(mstp_port, rx_frames, mstp_port->FrameType);
+    }
+    if (!invalid_frame && mstp_port->ReceivedInvalidFrame) {
+        MSTP_STATISTICS_COUNT(mstp_port, rx_invalid_frames);
+    }
     if ((receive_state != MSTP_RECEIVE_STATE_IDLE) &&
         (mstp_port->receive_state == MSTP_RECEIVE_STATE_IDLE)) {
         printf_receive_data("\n");
@@ -611,6 +688,373 @@ void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
     return;
 }
 
+/**
+ * @brief Feed a block of received octets to the receive state machine,
+ *  instead of one octet at a time through the DataRegister.  The data
+ *  octets of a frame are copied and added to the data CRC as a span.
+ *  Feeding stops at the end of a frame, so that the frame can be handled
+ *  before the octets that follow it.
+ * @param mstp_port MSTP port context data
+ * @param data received octets
+ * @param data_len number of received octets
+ * @return number of octets consumed by the receive state machine
+ */
+uint16_t MSTP_Receive_Frame_Data(struct mstp_port_struct_t *mstp_port,
+    const uint8_t *data,
+    uint16_t data_len)
+{
+    uint16_t offset = 0;
+    uint32_t span, i;
+
+    if (!mstp_port || !data) {
+        return 0;
+    }
+    while ((offset < data_len) && !mstp_port->ReceivedValidFrame &&
+        !mstp_port->ReceivedInvalidFrame) {
+        if (((mstp_port->receive_state == MSTP_RECEIVE_STATE_DATA) ||
+                (mstp_port->receive_state == MSTP_RECEIVE_STATE_SKIP_DATA)) &&
+            (mstp_port->Index < mstp_port->DataLength) &&
+            !mstp_port->ReceiveError && !mstp_port->DataAvailable &&
+            (mstp_port->SilenceTimer((void *)mstp_port) <=
+                mstp_port->Tframe_abort)) {
+            /* DataOctet - the span of data octets up to the data CRC */
+            span = mstp_port->DataLength - mstp_port->Index;
+            if (span > (uint32_t)(data_len - offset)) {
+                span = data_len - offset;
+            }
+            mstp_port->DataCRC =
+                CRC_Calc_Data_Span(&data[offset], span, mstp_port->DataCRC);
+            if (mstp_port->Index < mstp_port->InputBufferSize) {
+                i = mstp_port->InputBufferSize - mstp_port->Index;
+                if (i > span) {
+                    i = span;
+                }
+                memcpy(&mstp_port->InputBuffer[mstp_port->Index],
+                    &data[offset], i);
+            }
+            mstp_port->Index += span;
+            offset += (uint16_t)span;
+            mstp_port->SilenceTimerReset((void *)mstp_port);
+        } else {
+            mstp_port->DataRegister = data[offset];
+            mstp_port->DataAvailable = true;
+            MSTP_Receive_Frame_FSM(mstp_port);
+            if (mstp_port->DataAvailable) {
+                /* the octet was not consumed, such as after a timeout,
+                   and is fed again */
+                mstp_port->DataAvailable = false;
+                continue;
+            }
+            offset++;
+        }
+    }
+
+    return offset;
+}
+
+/**
+ * @brief Note a master node seen passing the token or polling for masters
+ * @param mstp_port MSTP port context data
+ * @param address - MAC address of the master node
+ */
+static void MSTP_Adaptive_Master_Seen(
+    struct mstp_port_struct_t *mstp_port, uint8_t address)
+{
+    MSTP_ADAPTIVE *adaptive = &mstp_port->Adaptive;
+
+    if (adaptive->enabled && (address <= adaptive->max_master) &&
+        (address > adaptive->highest_master)) {
+        adaptive->highest_master = address;
+    }
+}
+
+/**
+ * @brief At the end of a window, set Nmax_master to the highest master
+ *  seen and a margin, or to the configured Max_Master while the full
+ *  range is polled now and then for new masters.
+ * @param mstp_port MSTP port context data
+ */
+static void MSTP_Adaptive_Max_Master_Tune(struct mstp_port_struct_t *mstp_port)
+{
+    MSTP_ADAPTIVE *adaptive = &mstp_port->Adaptive;
+    unsigned max_master;
+
+    max_master = adaptive->highest_master;
+    if (mstp_port->This_Station > max_master) {
+        max_master = mstp_port->This_Station;
+    }
+    if (mstp_port->Next_Station > max_master) {
+        max_master = mstp_port->Next_Station;
+    }
+    max_master += MSTP_ADAPTIVE_MASTER_MARGIN;
+    if (max_master > adaptive->max_master) {
+        max_master = adaptive->max_master;
+    }
+    if (adaptive->sweep) {
+        if (mstp_port->Poll_Station > max_master) {
+            adaptive->sweep_above = true;
+        } else if (adaptive->sweep_above ||
+            (mstp_port->Next_Station > mstp_port->This_Station)) {
+            /* the poll station has wrapped around, or this node
+               does not poll the addresses above the highest master */
+            adaptive->sweep = false;
+        }
+    } else {
+        adaptive->sweep_windows++;
+        if (adaptive->sweep_windows >= MSTP_ADAPTIVE_SWEEP_WINDOWS) {
+            adaptive->sweep_windows = 0;
+            adaptive->sweep = true;
+            adaptive->sweep_above = false;
+        }
+    }
+    if (adaptive->sweep) {
+        mstp_port->Nmax_master = adaptive->max_master;
+    } else if (mstp_port->Poll_Station <= max_master) {
+        mstp_port->Nmax_master = (uint8_t)max_master;
+    }
+    adaptive->highest_master = 0;
+    adaptive->window_tokens = 0;
+}
+
+/**
+ * @brief Measure the token rotation time, and count the window of the
+ *  adaptive tuning, when this node receives the token
+ * @param mstp_port MSTP port context data
+ */
+static void MSTP_Token_Received(struct mstp_port_struct_t *mstp_port)
+{
+    MSTP_TOKEN_ROTATION *rotation = &mstp_port->Token_Rotation;
+    uint32_t now, elapsed;
+
+    if (mstp_port->MillisecondTimer) {
+        now = mstp_port->MillisecondTimer((void *)mstp_port);
+        if (rotation->started) {
+            elapsed = now - rotation->start_ms;
+            rotation->count++;
+            rotation->last_ms = elapsed;
+            if (elapsed > rotation->max_ms) {
+                rotation->max_ms = elapsed;
+            }
+            rotation->total_ms += elapsed;
+            MSTP_STATISTICS_COUNT(mstp_port,
+                token_rotation[MSTP_Statistics_Histogram_Bin(elapsed)]);
+        }
+        rotation->start_ms = now;
+        rotation->started = true;
+    }
+    if (mstp_port->Adaptive.enabled) {
+        mstp_port->Adaptive.window_tokens++;
+        if (mstp_port->Adaptive.window_tokens >= MSTP_ADAPTIVE_WINDOW_TOKENS) {
+            MSTP_Adaptive_Max_Master_Tune(mstp_port);
+        }
+    }
+}
+
+/**
+ * @brief Double Nmax_info_frames when the token is used up again and
+ *  again, and bring it back toward the configured Max_Info_Frames when
+ *  the transmit queue empties before it is used up.
+ * @param mstp_port MSTP port context data
+ * @param busy - true if this token was used up by sending
+ *  Nmax_info_frames frames
+ */
+static void MSTP_Adaptive_Token_Used(
+    struct mstp_port_struct_t *mstp_port, bool busy)
+{
+    MSTP_ADAPTIVE *adaptive = &mstp_port->Adaptive;
+    unsigned max_info_frames;
+
+    if (!adaptive->enabled) {
+        return;
+    }
+    if (busy) {
+        adaptive->idle_tokens = 0;
+        adaptive->busy_tokens++;
+        if (adaptive->busy_tokens >= MSTP_ADAPTIVE_BUSY_TOKENS) {
+            adaptive->busy_tokens = 0;
+            max_info_frames = mstp_port->Nmax_info_frames * 2U;
+            if (max_info_frames > MSTP_ADAPTIVE_INFO_FRAMES_MAX) {
+                max_info_frames = MSTP_ADAPTIVE_INFO_FRAMES_MAX;
+            }
+            if (max_info_frames > mstp_port->Nmax_info_frames) {
+                mstp_port->Nmax_info_frames = (uint8_t)max_info_frames;
+            }
+        }
+    } else {
+        adaptive->busy_tokens = 0;
+        adaptive->idle_tokens++;
+        if (adaptive->idle_tokens >= MSTP_ADAPTIVE_IDLE_TOKENS) {
+            adaptive->idle_tokens = 0;
+            if (mstp_port->Nmax_info_frames > adaptive->max_info_frames) {
+                mstp_port->Nmax_info_frames--;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Enable or disable the tuning of Nmax_master and Nmax_info_frames
+ *  from the traffic seen on the line.  The values when it is enabled are
+ *  kept as the configured Max_Master, the most that is polled, and the
+ *  configured Max_Info_Frames, the least that is used, and are restored
+ *  when it is disabled.  Enable it after MSTP_Init().
+ * @param mstp_port MSTP port context data
+ * @param enable - true to enable the tuning
+ */
+void MSTP_Adaptive_Enable(struct mstp_port_struct_t *mstp_port, bool enable)
+{
+    MSTP_ADAPTIVE *adaptive;
+
+    if (!mstp_port) {
+        return;
+    }
+    adaptive = &mstp_port->Adaptive;
+    if (enable && !adaptive->enabled) {
+        memset(adaptive, 0, sizeof(*adaptive));
+        adaptive->max_master = mstp_port->Nmax_master;
+        adaptive->max_info_frames = mstp_port->Nmax_info_frames;
+        adaptive->enabled = true;
+    } else if (!enable && adaptive->enabled) {
+        mstp_port->Nmax_master = adaptive->max_master;
+        mstp_port->Nmax_info_frames = adaptive->max_info_frames;
+        adaptive->enabled = false;
+    }
+}
+
+/**
+ * @brief Determine if Nmax_master and Nmax_info_frames are tuned
+ * @param mstp_port MSTP port context data
+ * @return true if the tuning is enabled
+ */
+bool MSTP_Adaptive_Enabled(struct mstp_port_struct_t *mstp_port)
+{
+    return mstp_port && mstp_port->Adaptive.enabled;
+}
+
+/**
+ * @brief Set the configured Max_Master, which is the most that is polled
+ *  when the tuning is enabled
+ * @param mstp_port MSTP port context data
+ * @param max_master - Max_Master, 0..127
+ */
+void MSTP_Adaptive_Max_Master_Set(
+    struct mstp_port_struct_t *mstp_port, uint8_t max_master)
+{
+    if (!mstp_port) {
+        return;
+    }
+    if (mstp_port->Adaptive.enabled) {
+        mstp_port->Adaptive.max_master = max_master;
+        if (mstp_port->Nmax_master <= max_master) {
+            /* tuned at the end of the window */
+            return;
+        }
+    }
+    mstp_port->Nmax_master = max_master;
+}
+
+/**
+ * @brief Set the configured Max_Info_Frames, which is the least that is
+ *  used when the tuning is enabled
+ * @param mstp_port MSTP port context data
+ * @param max_info_frames - Max_Info_Frames
+ */
+void MSTP_Adaptive_Max_Info_Frames_Set(
+    struct mstp_port_struct_t *mstp_port, uint8_t max_info_frames)
+{
+    if (!mstp_port) {
+        return;
+    }
+    if (mstp_port->Adaptive.enabled) {
+        mstp_port->Adaptive.max_info_frames = max_info_frames;
+        if (mstp_port->Nmax_info_frames >= max_info_frames) {
+            return;
+        }
+    }
+    mstp_port->Nmax_info_frames = max_info_frames;
+}
+
+/**
+ * @brief Get the token rotation time counters
+ * @param mstp_port MSTP port context data
+ * @param rotation - the counters are copied here
+ */
+void MSTP_Token_Rotation(
+    struct mstp_port_struct_t *mstp_port, MSTP_TOKEN_ROTATION *rotation)
+{
+    if (mstp_port && rotation) {
+        *rotation = mstp_port->Token_Rotation;
+    }
+}
+
+/**
+ * @brief Reset the token rotation time counters
+ * @param mstp_port MSTP port context data
+ */
+void MSTP_Token_Rotation_Reset(struct mstp_port_struct_t *mstp_port)
+{
+    if (mstp_port) {
+        mstp_port->Token_Rotation.count = 0;
+        mstp_port->Token_Rotation.last_ms = 0;
+        mstp_port->Token_Rotation.max_ms = 0;
+        mstp_port->Token_Rotation.total_ms = 0;
+    }
+}
+
+/**
+ * @brief Count the time from sending a Data Expecting Reply frame until
+ *  a reply to it is received
+ * @param mstp_port MSTP port context data
+ */
+static void MSTP_Reply_Latency(struct mstp_port_struct_t *mstp_port)
+{
+#if MSTP_STATISTICS_ENABLED
+    uint32_t elapsed;
+
+    if (mstp_port->MillisecondTimer) {
+        elapsed = mstp_port->MillisecondTimer((void *)mstp_port) -
+            mstp_port->Reply_Wait_Start;
+        mstp_port->Statistics
+            .reply_latency[MSTP_Statistics_Histogram_Bin(elapsed)]++;
+    }
+#else
+    (void)mstp_port;
+#endif
+}
+
+/**
+ * @brief Get the frame and timing counters of the port
+ * @param mstp_port MSTP port context data
+ * @param statistics - the counters are copied here, or zeroed when
+ *  MSTP_STATISTICS_ENABLED is 0
+ */
+void MSTP_Statistics(
+    struct mstp_port_struct_t *mstp_port, MSTP_STATISTICS *statistics)
+{
+    if (mstp_port && statistics) {
+#if MSTP_STATISTICS_ENABLED
+        *statistics = mstp_port->Statistics;
+#else
+        memset(statistics, 0, sizeof(*statistics));
+#endif
+    }
+}
+
+/**
+ * @brief Reset the frame and timing counters of the port
+ * @param mstp_port MSTP port context data
+ */
+void MSTP_Statistics_Reset(struct mstp_port_struct_t *mstp_port)
+{
+#if MSTP_STATISTICS_ENABLED
+    if (mstp_port) {
+        memset(&mstp_port->Statistics, 0, sizeof(mstp_port->Statistics));
+    }
+#else
+    (void)mstp_port;
+#endif
+}
+
 /**
  * @brief Finite State Machine for receiving an MSTP frame
  * @param mstp_port MSTP port context data
@@ -680,6 +1124,12 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                     mstp_port->DataLength, mstp_port->FrameCount,
                     mstp_port->SilenceTimer((void *)mstp_port),
                     mstptext_frame_type((unsigned)mstp_port->FrameType));
+                if ((mstp_port->FrameType == FRAME_TYPE_TOKEN) ||
+                    (mstp_port->FrameType == FRAME_TYPE_POLL_FOR_MASTER)) {
+                    /* only master nodes pass the token or poll */
+                    MSTP_Adaptive_Master_Seen(
+                        mstp_port, mstp_port->SourceAddress);
+                }
                 if (mstp_port->SourceAddress == mstp_port->This_Station) {
                     /* DuplicateNode */
                     if (mstp_port->ZeroConfigEnabled) {
@@ -704,6 +1154,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                             mstp_port->ReceivedValidFrame = false;
                             mstp_port->FrameCount = 0;
                             mstp_port->SoleMaster = false;
+                            MSTP_Token_Received(mstp_port);
                             mstp_port->master_state =
                                 MSTP_MASTER_STATE_USE_TOKEN;
                             transition_now = true;
@@ -771,6 +1222,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                 Tno_token) {
                 /* LostToken */
                 /* assume that the token has been lost */
+                MSTP_STATISTICS_COUNT(mstp_port, lost_tokens);
                 mstp_port->EventCount = 0; /* Addendum 135-2004d-8 */
                 mstp_port->master_state = MSTP_MASTER_STATE_NO_TOKEN;
                 /* set the receive frame flags to false in case we received
@@ -788,15 +1240,24 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
             length = (unsigned)MSTP_Get_Send(mstp_port, 0);
             if (length < 1) {
                 /* NothingToSend */
+                MSTP_Adaptive_Token_Used(mstp_port, false);
                 mstp_port->FrameCount = mstp_port->Nmax_info_frames;
                 mstp_port->master_state = MSTP_MASTER_STATE_DONE_WITH_TOKEN;
                 transition_now = true;
             } else {
                 uint8_t frame_type = mstp_port->OutputBuffer[2];
                 uint8_t destination = mstp_port->OutputBuffer[3];
-                MSTP_Send_Frame(mstp_port,
-                    (uint8_t *)&mstp_port->OutputBuffer[0], (uint16_t)length);
+                MSTP_Send_Output_Frame(mstp_port, (uint16_t)length);
+#if MSTP_STATISTICS_ENABLED
+                if (mstp_port->MillisecondTimer) {
+                    mstp_port->Reply_Wait_Start =
+                        mstp_port->MillisecondTimer((void *)mstp_port);
+                }
+#endif
                 mstp_port->FrameCount++;
+                if (mstp_port->FrameCount >= mstp_port->Nmax_info_frames) {
+                    MSTP_Adaptive_Token_Used(mstp_port, true);
+                }
                 switch (frame_type) {
                     case FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY:
                         if (destination == MSTP_BROADCAST_ADDRESS) {
@@ -831,6 +1292,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                 mstp_port->Treply_timeout) {
                 /* ReplyTimeout */
                 /* assume that the request has failed */
+                MSTP_STATISTICS_COUNT(mstp_port, reply_timeouts);
                 mstp_port->FrameCount = mstp_port->Nmax_info_frames;
                 mstp_port->master_state = MSTP_MASTER_STATE_DONE_WITH_TOKEN;
                 /* Any retry of the data frame shall await the next entry */
@@ -850,6 +1312,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                 } else if (mstp_port->ReceivedValidFrame == true) {
                     if (mstp_port->DestinationAddress ==
                         mstp_port->This_Station) {
+                        MSTP_Reply_Latency(mstp_port);
                         switch (mstp_port->FrameType) {
                             case FRAME_TYPE_REPLY_POSTPONED:
                                 /* ReceivedReplyPostponed */
@@ -996,6 +1459,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                 if (mstp_port->RetryCount < Nretry_token) {
                     /* RetrySendToken */
                     mstp_port->RetryCount++;
+                    MSTP_STATISTICS_COUNT(mstp_port, token_retries);
                     /* Transmit a Token frame to NS */
                     MSTP_Create_And_Send_Frame(mstp_port, FRAME_TYPE_TOKEN,
                         mstp_port->Next_Station, mstp_port->This_Station, NULL,
@@ -1089,6 +1553,8 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                         FRAME_TYPE_REPLY_TO_POLL_FOR_MASTER)) {
                     /* ReceivedReplyToPFM */
                     mstp_port->SoleMaster = false;
+                    MSTP_Adaptive_Master_Seen(
+                        mstp_port, mstp_port->SourceAddress);
                     mstp_port->Next_Station = mstp_port->SourceAddress;
                     mstp_port->EventCount = 0;
                     /* Transmit a Token frame to NS */
@@ -1175,8 +1641,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                 /* then call MSTP_Create_And_Send_Frame to transmit the reply
                  * frame  */
                 /* and enter the IDLE state to wait for the next frame. */
-                MSTP_Send_Frame(mstp_port,
-                    (uint8_t *)&mstp_port->OutputBuffer[0], (uint16_t)length);
+                MSTP_Send_Output_Frame(mstp_port, (uint16_t)length);
                 mstp_port->master_state = MSTP_MASTER_STATE_IDLE;
                 /* clear our flag we were holding for comparison */
                 mstp_port->ReceivedValidFrame = false;
@@ -1271,9 +1736,7 @@ void MSTP_Slave_Node_FSM(struct mstp_port_struct_t *mstp_port)
                 * reply frame  */
             /* and enter the IDLE state to wait for the next frame.
                 */
-            MSTP_Send_Frame(mstp_port,
-                (uint8_t *)&mstp_port->OutputBuffer[0],
-                (uint16_t)length);
+            MSTP_Send_Output_Frame(mstp_port, (uint16_t)length);
             /* clear our flag we were holding for comparison */
             mstp_port->ReceivedValidFrame = false;
         } else if (mstp_port->SilenceTimer((void *)mstp_port) >
@@ -1665,6 +2128,12 @@ void MSTP_Init(struct mstp_port_struct_t *mstp_port)
         mstp_port->SoleMaster = false;
         mstp_port->SourceAddress = 0;
         mstp_port->TokenCount = 0;
+        memset(&mstp_port->Token_Rotation, 0,
+            sizeof(mstp_port->Token_Rotation));
+        memset(&mstp_port->Adaptive, 0, sizeof(mstp_port->Adaptive));
+#if MSTP_STATISTICS_ENABLED
+        memset(&mstp_port->Statistics, 0, sizeof(mstp_port->Statistics));
+#endif
         /* zero config */
         mstp_port->Zero_Config_State = MSTP_ZERO_CONFIG_STATE_INIT;
     }
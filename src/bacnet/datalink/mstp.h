@@ -43,6 +43,104 @@
 /* size of the buffer used to send and validate a unique test request */
 #define MSTP_UUID_SIZE 16
 
+/* tokens received by this node in each window of the adaptive tuning
+   of Max_Master */
+#ifndef MSTP_ADAPTIVE_WINDOW_TOKENS
+#define MSTP_ADAPTIVE_WINDOW_TOKENS Npoll
+#endif
+/* addresses above the highest master seen that are still polled */
+#ifndef MSTP_ADAPTIVE_MASTER_MARGIN
+#define MSTP_ADAPTIVE_MASTER_MARGIN 2
+#endif
+/* windows between polls of the full range of the configured Max_Master,
+   which find masters added above the highest master seen */
+#ifndef MSTP_ADAPTIVE_SWEEP_WINDOWS
+#define MSTP_ADAPTIVE_SWEEP_WINDOWS 120
+#endif
+/* consecutive tokens that use up Max_Info_Frames before it is doubled */
+#ifndef MSTP_ADAPTIVE_BUSY_TOKENS
+#define MSTP_ADAPTIVE_BUSY_TOKENS 4
+#endif
+/* consecutive tokens with frames left unsent before it is decreased */
+#ifndef MSTP_ADAPTIVE_IDLE_TOKENS
+#define MSTP_ADAPTIVE_IDLE_TOKENS 32
+#endif
+/* the most Max_Info_Frames of the adaptive tuning */
+#ifndef MSTP_ADAPTIVE_INFO_FRAMES_MAX
+#define MSTP_ADAPTIVE_INFO_FRAMES_MAX 16
+#endif
+
+/* token rotation time of a master node: from receiving the token until
+   receiving it again, in milliseconds */
+typedef struct mstp_token_rotation {
+    uint32_t count;
+    uint32_t last_ms;
+    uint32_t max_ms;
+    uint64_t total_ms;
+    /* when the token was last received */
+    uint32_t start_ms;
+    bool started;
+} MSTP_TOKEN_ROTATION;
+
+/* optional frame and timing counters of each port, see MSTP_Statistics():
+   about 200 octets per port, and a few counters updated with each frame */
+#ifndef MSTP_STATISTICS_ENABLED
+#define MSTP_STATISTICS_ENABLED 0
+#endif
+/* frame counters: the standard frame types 0 to 7, the extended data
+   frames, and any other frame type */
+#define MSTP_STATISTICS_FRAME_EXTENDED 8
+#define MSTP_STATISTICS_FRAME_OTHER 9
+#define MSTP_STATISTICS_FRAME_TYPES 10
+/* histogram bins of milliseconds: 0, 1, 2-3, 4-7, and so on, and the
+   last bin for all the longer times */
+#ifndef MSTP_STATISTICS_HISTOGRAM_BINS
+#define MSTP_STATISTICS_HISTOGRAM_BINS 12
+#endif
+
+/* counters of the frames and timing of an MS/TP port, kept by the
+   state machines */
+typedef struct mstp_statistics {
+    uint32_t rx_frames[MSTP_STATISTICS_FRAME_TYPES];
+    uint32_t tx_frames[MSTP_STATISTICS_FRAME_TYPES];
+    /* frames received with an error, including the CRC errors */
+    uint32_t rx_invalid_frames;
+    uint32_t header_crc_errors;
+    uint32_t data_crc_errors;
+    /* tokens sent again because the next station did not use them */
+    uint32_t token_retries;
+    uint32_t lost_tokens;
+    /* Data Expecting Reply frames sent that had no reply */
+    uint32_t reply_timeouts;
+    /* token rotation time */
+    uint32_t token_rotation[MSTP_STATISTICS_HISTOGRAM_BINS];
+    /* time from sending a Data Expecting Reply frame until its reply,
+       or Reply Postponed, is received */
+    uint32_t reply_latency[MSTP_STATISTICS_HISTOGRAM_BINS];
+} MSTP_STATISTICS;
+
+/* state of the optional tuning of Max_Master and Max_Info_Frames from
+   the traffic seen on the line */
+typedef struct mstp_adaptive {
+    bool enabled;
+    /* Max_Master and Max_Info_Frames as configured */
+    uint8_t max_master;
+    uint8_t max_info_frames;
+    /* highest master node address seen in this window */
+    uint8_t highest_master;
+    /* tokens received in this window */
+    uint8_t window_tokens;
+    /* windows since the last poll of the full Max_Master range */
+    uint8_t sweep_windows;
+    /* true while polling the full Max_Master range, and once the poll
+       station has passed the tuned Max_Master */
+    bool sweep;
+    bool sweep_above;
+    /* consecutive tokens that used up Max_Info_Frames, or did not */
+    uint8_t busy_tokens;
+    uint8_t idle_tokens;
+} MSTP_ADAPTIVE;
+
 struct mstp_port_struct_t {
     MSTP_RECEIVE_STATE receive_state;
     /* When a master node is powered up or reset, */
@@ -226,6 +324,18 @@ struct mstp_port_struct_t {
       turnaround_time_milliseconds = (Tturnaround*1000UL)/RS485_Baud; */
     uint8_t Tturnaround_timeout;
 
+    /* A free running timer with millisecond resolution, used to measure
+       the token rotation time.  Optional: NULL if there is none. */
+    uint32_t (*MillisecondTimer)(void *pArg);
+    MSTP_TOKEN_ROTATION Token_Rotation;
+    /* optional tuning of Nmax_master and Nmax_info_frames */
+    MSTP_ADAPTIVE Adaptive;
+#if MSTP_STATISTICS_ENABLED
+    MSTP_STATISTICS Statistics;
+    /* when the last data frame was sent, to measure the reply latency */
+    uint32_t Reply_Wait_Start;
+#endif
+
     /*Platform-specific port data */
     void *UserData;
 };
@@ -239,6 +349,10 @@ void MSTP_Init(struct mstp_port_struct_t *mstp_port);
 BACNET_STACK_EXPORT
 void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port);
 BACNET_STACK_EXPORT
+uint16_t MSTP_Receive_Frame_Data(struct mstp_port_struct_t *mstp_port,
+    const uint8_t *data,
+    uint16_t data_len);
+BACNET_STACK_EXPORT
 bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port);
 BACNET_STACK_EXPORT
 void MSTP_Slave_Node_FSM(struct mstp_port_struct_t *mstp_port);
@@ -268,6 +382,29 @@ void MSTP_Create_And_Send_Frame(
 BACNET_STACK_EXPORT
 void MSTP_Fill_BACnet_Address(BACNET_ADDRESS *src, uint8_t mstp_address);
 
+BACNET_STACK_EXPORT
+void MSTP_Adaptive_Enable(struct mstp_port_struct_t *mstp_port, bool enable);
+BACNET_STACK_EXPORT
+bool MSTP_Adaptive_Enabled(struct mstp_port_struct_t *mstp_port);
+BACNET_STACK_EXPORT
+void MSTP_Adaptive_Max_Master_Set(
+    struct mstp_port_struct_t *mstp_port, uint8_t max_master);
+BACNET_STACK_EXPORT
+void MSTP_Adaptive_Max_Info_Frames_Set(
+    struct mstp_port_struct_t *mstp_port, uint8_t max_info_frames);
+BACNET_STACK_EXPORT
+void MSTP_Token_Rotation(struct mstp_port_struct_t *mstp_port,
+    MSTP_TOKEN_ROTATION *rotation);
+BACNET_STACK_EXPORT
+void MSTP_Token_Rotation_Reset(struct mstp_port_struct_t *mstp_port);
+BACNET_STACK_EXPORT
+void MSTP_Statistics(struct mstp_port_struct_t *mstp_port,
+    MSTP_STATISTICS *statistics);
+BACNET_STACK_EXPORT
+void MSTP_Statistics_Reset(struct mstp_port_struct_t *mstp_port);
+BACNET_STACK_EXPORT
+unsigned MSTP_Statistics_Histogram_Bin(uint32_t milliseconds);
+
 BACNET_STACK_EXPORT
 void MSTP_Zero_Config_UUID_Init(struct mstp_port_struct_t *mstp_port);
 
@@ -62,6 +62,9 @@
 #define CRC32K_RESIDUE (0x0843323B)
 /* frame specific data */
 #define MSTP_PREAMBLE_X55 (0x55)
+/* octets of the frame header before the data: preamble, frame type,
+   destination, source, length, and header CRC */
+#define MSTP_FRAME_HEADER_LEN 8
 /* The length of the data portion of a Test_Request, Test_Response,
    BACnet Data Expecting Reply, or BACnet Data Not Expecting Reply frame 
    may range from 0 to 501 octets. 
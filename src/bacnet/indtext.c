@@ -181,3 +181,59 @@ unsigned indtext_count(INDTEXT_DATA *data_list)
     }
     return count;
 }
+
+/**
+ * @brief Build a direct lookup table of the strings of a list, so that
+ *  the strings of the indexes below the table size are found in one step.
+ * @param index_table - lookup table to initialize
+ * @param data_list - list of index and text pairs
+ * @param table - storage for the lookup table, owned by the caller
+ * @param table_size - number of entries in the storage
+ */
+void indtext_index_init(INDTEXT_INDEX *index_table,
+    INDTEXT_DATA *data_list,
+    const char **table,
+    unsigned table_size)
+{
+    unsigned i;
+
+    if (!index_table) {
+        return;
+    }
+    index_table->data_list = data_list;
+    index_table->table = table;
+    index_table->table_size = table ? table_size : 0;
+    for (i = 0; i < index_table->table_size; i++) {
+        table[i] = NULL;
+    }
+    if (data_list) {
+        /* the first string of an index wins, as in the list search */
+        while (data_list->pString) {
+            if ((data_list->index < index_table->table_size) &&
+                (!table[data_list->index])) {
+                table[data_list->index] = data_list->pString;
+            }
+            data_list++;
+        }
+    }
+}
+
+/**
+ * @brief For a given index, return the matching string from a lookup
+ *  table, searching the list for indexes beyond the table.
+ * @param index_table - lookup table from indtext_index_init()
+ * @param index - index to find
+ * @return the matching string, or NULL if not found
+ */
+const char *indtext_index_by_index(
+    INDTEXT_INDEX const *index_table, unsigned index)
+{
+    if (!index_table) {
+        return NULL;
+    }
+    if (index < index_table->table_size) {
+        return index_table->table[index];
+    }
+
+    return indtext_by_index(index_table->data_list, index);
+}
@@ -36,6 +36,13 @@ typedef const struct {
     const char *pString;        /* text pair - use NULL to end the list */
 } INDTEXT_DATA;
 
+/* direct lookup table of the strings of an index and text list */
+typedef struct indtext_index_t {
+    INDTEXT_DATA *data_list;    /* list searched beyond the table */
+    const char **table;         /* string of each index, or NULL */
+    unsigned table_size;        /* number of entries in the table */
+} INDTEXT_INDEX;
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -99,6 +106,20 @@ extern "C" {
     unsigned indtext_count(
         INDTEXT_DATA * data_list);
 
+/* builds a lookup table of the strings of the indexes below table_size */
+    BACNET_STACK_EXPORT
+    void indtext_index_init(
+        INDTEXT_INDEX * index_table,
+        INDTEXT_DATA * data_list,
+        const char **table,
+        unsigned table_size);
+/* for a given index, return the matching string from the lookup table
+   or the list, or NULL if not found */
+    BACNET_STACK_EXPORT
+    const char *indtext_index_by_index(
+        INDTEXT_INDEX const *index_table,
+        unsigned index);
+
 
 #if !defined(__BORLANDC__) && !defined(_MSC_VER)
     int stricmp(
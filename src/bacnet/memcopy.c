@@ -119,3 +119,150 @@ size_t memcopy(void *dest,
     return 0;
 }
 #endif
+
+/**
+ * Initialize a bounded writer for a destination buffer.
+ *
+ * @param writer - bounded writer to initialize
+ * @param buffer - pointer to the destination buffer
+ * @param size - sizeof the destination buffer
+ */
+void memcopy_writer_init(MEMCOPY_WRITER *writer, uint8_t *buffer, size_t size)
+{
+    if (writer) {
+        writer->buffer = buffer;
+        writer->size = buffer ? size : 0;
+        writer->length = 0;
+        writer->overflow = false;
+    }
+}
+
+/**
+ * Get the number of bytes written into the buffer.
+ *
+ * @param writer - bounded writer
+ * @return number of bytes in use
+ */
+size_t memcopy_writer_length(MEMCOPY_WRITER const *writer)
+{
+    return (writer ? writer->length : 0);
+}
+
+/**
+ * Get the number of bytes still available in the buffer.
+ *
+ * @param writer - bounded writer
+ * @return number of bytes that can still be written
+ */
+size_t memcopy_writer_remaining(MEMCOPY_WRITER const *writer)
+{
+    size_t remaining = 0;
+
+    if (writer && (writer->length < writer->size)) {
+        remaining = writer->size - writer->length;
+    }
+
+    return remaining;
+}
+
+/**
+ * Determine if any encoding did not fit since the last rollback.
+ *
+ * @param writer - bounded writer
+ * @return true if the writer overflowed
+ */
+bool memcopy_writer_overflow(MEMCOPY_WRITER const *writer)
+{
+    return (writer ? writer->overflow : true);
+}
+
+/**
+ * Get a pointer to the next len bytes of the buffer without using them.
+ * The caller encodes in place and then calls memcopy_writer_advance().
+ *
+ * @param writer - bounded writer
+ * @param len - number of bytes that must be available
+ * @return pointer to the write position, or NULL if len bytes
+ *  are not available, in which case the overflow flag is set.
+ */
+uint8_t *memcopy_writer_reserve(MEMCOPY_WRITER *writer, size_t len)
+{
+    if (!writer) {
+        return NULL;
+    }
+    if (writer->overflow || !writer->buffer ||
+        !memcopylen(writer->length, writer->size, len)) {
+        writer->overflow = true;
+        return NULL;
+    }
+
+    return &writer->buffer[writer->length];
+}
+
+/**
+ * Use len bytes that were encoded in place at the write position.
+ *
+ * @param writer - bounded writer
+ * @param len - number of bytes encoded at the write position
+ * @return true if the bytes fit, false if the writer overflowed
+ */
+bool memcopy_writer_advance(MEMCOPY_WRITER *writer, size_t len)
+{
+    if (!memcopy_writer_reserve(writer, len)) {
+        return false;
+    }
+    writer->length += len;
+
+    return true;
+}
+
+/**
+ * Copy len bytes from src to the write position.
+ *
+ * @param writer - bounded writer
+ * @param src - pointer to the source buffer
+ * @param len - number of bytes to copy
+ * @return true if the bytes fit, false if the writer overflowed
+ */
+bool memcopy_writer_append(MEMCOPY_WRITER *writer, const void *src, size_t len)
+{
+    uint8_t *dest;
+
+    dest = memcopy_writer_reserve(writer, len);
+    if (!dest) {
+        return false;
+    }
+    if (len > 0) {
+        memmove(dest, src, len);
+    }
+    writer->length += len;
+
+    return true;
+}
+
+/**
+ * Get a mark of the current write position for a later rollback.
+ *
+ * @param writer - bounded writer
+ * @return mark of the current write position
+ */
+size_t memcopy_writer_mark(MEMCOPY_WRITER const *writer)
+{
+    return memcopy_writer_length(writer);
+}
+
+/**
+ * Discard everything written after a mark, and clear the overflow flag.
+ *
+ * @param writer - bounded writer
+ * @param mark - write position from memcopy_writer_mark()
+ */
+void memcopy_writer_rollback(MEMCOPY_WRITER *writer, size_t mark)
+{
+    if (writer) {
+        if (mark < writer->length) {
+            writer->length = mark;
+        }
+        writer->overflow = false;
+    }
+}
@@ -26,11 +26,26 @@
 
 /* Functional Description: Memory copy function */
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 
+/**
+ * Bounded writer used to encode directly into a final APDU buffer.
+ * The writer tracks the bytes in use and latches an overflow flag
+ * when an encoding would not fit, so that callers can roll back
+ * to a previous mark instead of encoding into a scratch buffer.
+ */
+struct memcopy_writer_t {
+    uint8_t *buffer; /* start of the destination buffer */
+    size_t size; /* capacity, in bytes, of the destination buffer */
+    size_t length; /* number of bytes in use */
+    bool overflow; /* true if an encoding did not fit */
+};
+typedef struct memcopy_writer_t MEMCOPY_WRITER;
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -46,6 +61,41 @@ extern "C" {
         size_t len,
         size_t max);
 
+    BACNET_STACK_EXPORT
+    void memcopy_writer_init(
+        MEMCOPY_WRITER * writer,
+        uint8_t * buffer,
+        size_t size);
+    BACNET_STACK_EXPORT
+    size_t memcopy_writer_length(
+        MEMCOPY_WRITER const *writer);
+    BACNET_STACK_EXPORT
+    size_t memcopy_writer_remaining(
+        MEMCOPY_WRITER const *writer);
+    BACNET_STACK_EXPORT
+    bool memcopy_writer_overflow(
+        MEMCOPY_WRITER const *writer);
+    BACNET_STACK_EXPORT
+    uint8_t *memcopy_writer_reserve(
+        MEMCOPY_WRITER * writer,
+        size_t len);
+    BACNET_STACK_EXPORT
+    bool memcopy_writer_advance(
+        MEMCOPY_WRITER * writer,
+        size_t len);
+    BACNET_STACK_EXPORT
+    bool memcopy_writer_append(
+        MEMCOPY_WRITER * writer,
+        const void *src,
+        size_t len);
+    BACNET_STACK_EXPORT
+    size_t memcopy_writer_mark(
+        MEMCOPY_WRITER const *writer);
+    BACNET_STACK_EXPORT
+    void memcopy_writer_rollback(
+        MEMCOPY_WRITER * writer,
+        size_t mark);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
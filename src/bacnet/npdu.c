@@ -609,6 +609,181 @@ int bacnet_npdu_decode(uint8_t *npdu,
     return len;
 }
 
+/**
+ * @brief Decode the NPCI of a received NPDU into a view that holds the
+ *  control octet, the network numbers and the offsets of the addresses
+ *  and of the APDU, without copying the addresses.  Routers and handlers
+ *  can decide what to do with a message from the view, and only copy the
+ *  addresses that they need with npdu_view_destination() and
+ *  npdu_view_source().
+ * @param pdu [in] Buffer holding the received NPDU
+ * @param pdu_len [in] Length of the received data
+ * @param view [out] The decoded view of the NPCI
+ * @return number of bytes in the NPCI, which is the offset of the APDU
+ *  or of the network message data, or -1 if the NPCI is malformed
+ */
+int bacnet_npdu_view_decode(
+    const uint8_t *pdu, uint16_t pdu_len, BACNET_NPDU_VIEW *view)
+{
+    uint16_t len = 2;
+    uint8_t control;
+
+    if (!pdu || !view || (pdu_len < 2)) {
+        return -1;
+    }
+    control = pdu[1];
+    view->control = control;
+    view->dnet = 0;
+    view->dlen = 0;
+    view->dadr_offset = 0;
+    view->snet = 0;
+    view->slen = 0;
+    view->sadr_offset = 0;
+    view->hop_count_offset = 0;
+    view->hop_count = 0;
+    view->vendor_id = 0;
+    view->network_message_type = NETWORK_MESSAGE_INVALID;
+    if (control & BIT(5)) {
+        /* DNET, DLEN, DADR */
+        if (pdu_len < (len + 3)) {
+            return -1;
+        }
+        view->dnet = ((uint16_t)pdu[len] << 8) | pdu[len + 1];
+        view->dlen = pdu[len + 2];
+        len += 3;
+        if (view->dlen) {
+            if ((view->dlen > MAX_MAC_LEN) || (pdu_len < (len + view->dlen))) {
+                return -1;
+            }
+            view->dadr_offset = (uint8_t)len;
+            len += view->dlen;
+        }
+    }
+    if (control & BIT(3)) {
+        /* SNET, SLEN, SADR */
+        if (pdu_len < (len + 3)) {
+            return -1;
+        }
+        view->snet = ((uint16_t)pdu[len] << 8) | pdu[len + 1];
+        view->slen = pdu[len + 2];
+        len += 3;
+        if (view->slen) {
+            if ((view->slen > MAX_MAC_LEN) || (pdu_len < (len + view->slen))) {
+                return -1;
+            }
+            view->sadr_offset = (uint8_t)len;
+            len += view->slen;
+        }
+    }
+    if (view->dnet) {
+        /* the hop count is present when the message has a DNET */
+        if (pdu_len <= len) {
+            return -1;
+        }
+        view->hop_count_offset = (uint8_t)len;
+        view->hop_count = pdu[len++];
+    }
+    if (control & BIT(7)) {
+        if (pdu_len <= len) {
+            return -1;
+        }
+        view->network_message_type = (BACNET_NETWORK_MESSAGE_TYPE)pdu[len++];
+        if (view->network_message_type >= 0x80) {
+            if (pdu_len < (len + 2)) {
+                return -1;
+            }
+            view->vendor_id = ((uint16_t)pdu[len] << 8) | pdu[len + 1];
+            len += 2;
+        }
+    }
+    view->apdu_offset = len;
+
+    return (int)len;
+}
+
+/**
+ * @brief Copy the routing destination of a received NPDU from its view.
+ *  When the NPDU has no DNET, the destination is cleared.
+ * @param pdu [in] Buffer holding the received NPDU
+ * @param view [in] The view from bacnet_npdu_view_decode()
+ * @param dest [out] The routing destination
+ */
+void npdu_view_destination(
+    const uint8_t *pdu, const BACNET_NPDU_VIEW *view, BACNET_ADDRESS *dest)
+{
+    uint8_t i;
+
+    if (!pdu || !view || !dest) {
+        return;
+    }
+    dest->mac_len = 0;
+    dest->net = view->dnet;
+    dest->len = view->dlen;
+    for (i = 0; i < MAX_MAC_LEN; i++) {
+        if (i < view->dlen) {
+            dest->adr[i] = pdu[view->dadr_offset + i];
+        } else {
+            dest->adr[i] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Copy the routing source of a received NPDU from its view.
+ *  When the NPDU has no SNET, the routing source is cleared, except for a
+ *  network number of BACNET_BROADCAST_NETWORK set by the datalink.  The
+ *  MAC address from the datalink is kept.
+ * @param pdu [in] Buffer holding the received NPDU
+ * @param view [in] The view from bacnet_npdu_view_decode()
+ * @param src [in,out] The source address from the datalink, returned with
+ *  the routing source
+ */
+void npdu_view_source(
+    const uint8_t *pdu, const BACNET_NPDU_VIEW *view, BACNET_ADDRESS *src)
+{
+    uint8_t i;
+
+    if (!pdu || !view || !src) {
+        return;
+    }
+    if (view->control & BIT(3)) {
+        src->net = view->snet;
+    } else if (src->net != BACNET_BROADCAST_NETWORK) {
+        src->net = 0;
+    }
+    src->len = view->slen;
+    for (i = 0; i < MAX_MAC_LEN; i++) {
+        if (i < view->slen) {
+            src->adr[i] = pdu[view->sadr_offset + i];
+        } else {
+            src->adr[i] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Fill the NPDU data of a received NPDU from its view, for the
+ *  functions that take a BACNET_NPDU_DATA, like the network layer handlers.
+ * @param pdu [in] Buffer holding the received NPDU
+ * @param view [in] The view from bacnet_npdu_view_decode()
+ * @param npdu_data [out] The NPDU data
+ */
+void npdu_view_npdu_data(const uint8_t *pdu,
+    const BACNET_NPDU_VIEW *view,
+    BACNET_NPDU_DATA *npdu_data)
+{
+    if (!pdu || !view || !npdu_data) {
+        return;
+    }
+    npdu_data->protocol_version = pdu[0];
+    npdu_data->data_expecting_reply = NPDU_VIEW_EXPECTING_REPLY(view);
+    npdu_data->network_layer_message = NPDU_VIEW_NETWORK_MESSAGE(view);
+    npdu_data->priority = NPDU_VIEW_PRIORITY(view);
+    npdu_data->network_message_type = view->network_message_type;
+    npdu_data->vendor_id = view->vendor_id;
+    npdu_data->hop_count = view->hop_count;
+}
+
 /**
  * @brief Helper for datalink detecting an application confirmed service
  * @param pdu [in]  Buffer containing the NPDU and APDU of the received packet.
@@ -619,14 +794,13 @@ bool npdu_confirmed_service(uint8_t *pdu, uint16_t pdu_len)
 {
     bool status = false;
     int apdu_offset = 0;
-    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_NPDU_VIEW view;
 
     if (pdu_len > 0) {
         if (pdu[0] == BACNET_PROTOCOL_VERSION) {
             /* only handle the version that we know how to handle */
-            apdu_offset =
-                bacnet_npdu_decode(&pdu[0], pdu_len, NULL, NULL, &npdu_data);
-            if ((!npdu_data.network_layer_message) && (apdu_offset > 0) &&
+            apdu_offset = bacnet_npdu_view_decode(&pdu[0], pdu_len, &view);
+            if ((!NPDU_VIEW_NETWORK_MESSAGE(&view)) && (apdu_offset > 0) &&
                 (apdu_offset < pdu_len)) {
                 if ((pdu[apdu_offset] & 0xF0) ==
                     PDU_TYPE_CONFIRMED_SERVICE_REQUEST) {
@@ -47,6 +47,30 @@ typedef struct bacnet_npdu_data_t {
     uint8_t hop_count;
 } BACNET_NPDU_DATA;
 
+/** A view of the NPCI of a received NPDU: the control octet, the network
+ * numbers and hop count, and the offsets of the addresses and of the APDU,
+ * decoded without copying the addresses.  See bacnet_npdu_view_decode(). */
+typedef struct bacnet_npdu_view_t {
+    uint8_t control;            /**< NPCI control octet */
+    uint8_t dlen;               /**< DLEN, 0 for a broadcast or no DNET */
+    uint8_t dadr_offset;        /**< offset of DADR when dlen is not 0 */
+    uint8_t slen;               /**< SLEN, 0 when there is no SNET */
+    uint8_t sadr_offset;        /**< offset of SADR when slen is not 0 */
+    uint8_t hop_count_offset;   /**< offset of the hop count, 0 if absent */
+    uint8_t hop_count;          /**< hop count, 0 if absent */
+    uint16_t dnet;              /**< DNET, 0 if absent */
+    uint16_t snet;              /**< SNET, 0 if absent */
+    uint16_t vendor_id;         /**< vendor of a proprietary network message */
+    BACNET_NETWORK_MESSAGE_TYPE network_message_type; /**< if network msg */
+    uint16_t apdu_offset;       /**< offset of the APDU or network data */
+} BACNET_NPDU_VIEW;
+
+/* NPCI control octet flags of an NPDU view */
+#define NPDU_VIEW_NETWORK_MESSAGE(view) (((view)->control & 0x80) != 0)
+#define NPDU_VIEW_EXPECTING_REPLY(view) (((view)->control & 0x04) != 0)
+#define NPDU_VIEW_PRIORITY(view) \
+    ((BACNET_MESSAGE_PRIORITY)((view)->control & 0x03))
+
 struct router_port_t;
 /** The info[] string has no agreed-upon purpose, hence it is useless.
  * Keeping it short here. This size could be 0-255. */
@@ -121,6 +145,27 @@ extern "C" {
         BACNET_ADDRESS * src,
         BACNET_NPDU_DATA * npdu_data);
 
+    BACNET_STACK_EXPORT
+    int bacnet_npdu_view_decode(
+        const uint8_t *pdu,
+        uint16_t pdu_len,
+        BACNET_NPDU_VIEW *view);
+    BACNET_STACK_EXPORT
+    void npdu_view_destination(
+        const uint8_t *pdu,
+        const BACNET_NPDU_VIEW *view,
+        BACNET_ADDRESS *dest);
+    BACNET_STACK_EXPORT
+    void npdu_view_source(
+        const uint8_t *pdu,
+        const BACNET_NPDU_VIEW *view,
+        BACNET_ADDRESS *src);
+    BACNET_STACK_EXPORT
+    void npdu_view_npdu_data(
+        const uint8_t *pdu,
+        const BACNET_NPDU_VIEW *view,
+        BACNET_NPDU_DATA *npdu_data);
+
     BACNET_STACK_EXPORT
     bool npdu_confirmed_service(
         uint8_t *pdu,
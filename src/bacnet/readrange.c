@@ -498,6 +498,49 @@ int rr_ack_encode_apdu(
     return apdu_len;
 }
 
+/**
+ * @brief Determine the length of one element of ReadRange itemData,
+ *  which is a primitive tagged value, or a constructed value from its
+ *  opening tag through its matching closing tag.
+ *
+ * @param apdu  Pointer to the first tag of the element.
+ * @param apdu_size  Bytes valid in the buffer.
+ *
+ * @return Bytes in the element, or BACNET_STATUS_ERROR if malformed.
+ */
+static int rr_ack_item_element_len(uint8_t *apdu, uint32_t apdu_size)
+{
+    BACNET_TAG tag = { 0 };
+    uint32_t apdu_len = 0;
+    unsigned depth = 0;
+    int len;
+
+    do {
+        len = bacnet_tag_decode(&apdu[apdu_len], apdu_size - apdu_len, &tag);
+        if (len <= 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += len;
+        if (tag.opening) {
+            depth++;
+        } else if (tag.closing) {
+            if (depth == 0) {
+                return BACNET_STATUS_ERROR;
+            }
+            depth--;
+        } else if (!tag.application ||
+            (tag.number != BACNET_APPLICATION_TAG_BOOLEAN)) {
+            /* an application tagged boolean value is in the tag */
+            apdu_len += tag.len_value_type;
+        }
+        if (apdu_len > apdu_size) {
+            return BACNET_STATUS_ERROR;
+        }
+    } while (depth > 0);
+
+    return (int)apdu_len;
+}
+
 /**
  * Decode the received ReadRange response
  *
@@ -604,10 +647,13 @@ int rr_ack_decode_service_request(uint8_t *apdu,
                     break;
                 } else {
                     /* Don't care about tag number, just skipping over
-                     * anyway */
-                    len += decode_tag_number_and_value(
-                        &apdu[len], NULL, &len_value_type);
-                    len += len_value_type; /* Skip over data value as well */
+                     * anyway, including any constructed data */
+                    tag_len = rr_ack_item_element_len(
+                        &apdu[len], (uint32_t)(apdu_len - len));
+                    if (tag_len <= 0) {
+                        return -1;
+                    }
+                    len += tag_len;
                     if (len >= apdu_len) { /* APDU is exhausted so we have
                                             * failed to find closing tag */
                         return (-1);
@@ -634,3 +680,95 @@ int rr_ack_decode_service_request(uint8_t *apdu,
 
     return len;
 }
+
+/**
+ * @brief Determine if an element of ReadRange itemData is the
+ *  context tag 0 timestamp that begins a log record
+ *
+ * @param apdu  Pointer to the first tag of the element.
+ * @param apdu_size  Bytes valid in the buffer.
+ *
+ * @return true if the element begins a log record
+ */
+static bool rr_ack_item_log_record(uint8_t *apdu, uint32_t apdu_size)
+{
+    BACNET_TAG tag = { 0 };
+
+    if (bacnet_tag_decode(apdu, apdu_size, &tag) <= 0) {
+        return false;
+    }
+
+    return (tag.number == 0) && (tag.context || tag.opening);
+}
+
+/**
+ * @brief Decode the received ReadRange response and call a function to
+ *  process each item of the itemData, without allocating any memory.
+ *
+ *  Items of a log buffer (BACnetLogRecord, BACnetEventLogRecord, and
+ *  BACnetLogMultipleRecord) begin with the context tag 0 timestamp and
+ *  span the elements up to the next timestamp.  Items of other lists
+ *  are each one application tagged or constructed element.
+ *
+ * @param apdu  Pointer to the APDU buffer.
+ * @param apdu_len  Bytes valid in the APDU buffer.
+ * @param device_id  The device ID of the device that replied.
+ * @param rrdata  Pointer to the data filled while decoding. The
+ *  application_data and application_data_len span all of the items.
+ * @param callback  The function to call for each item, or NULL.
+ *
+ * @return Bytes decoded, or BACNET_STATUS_ERROR if malformed.
+ *  The callback has been called for each item that was decoded
+ *  before the malformed part.
+ */
+int rr_ack_item_process(uint8_t *apdu,
+    int apdu_len,
+    uint32_t device_id,
+    BACNET_READ_RANGE_DATA *rrdata,
+    read_range_ack_item_process callback)
+{
+    uint8_t *item_data;
+    uint32_t item_data_size;
+    uint32_t offset = 0;
+    uint32_t item_start = 0;
+    uint32_t item_number = 0;
+    bool log_records;
+    int element_len;
+    int len;
+
+    if (!rrdata) {
+        return BACNET_STATUS_ERROR;
+    }
+    len = rr_ack_decode_service_request(apdu, apdu_len, rrdata);
+    if (len <= 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    if ((rrdata->ItemCount == 0) || (rrdata->application_data_len <= 0)) {
+        return len;
+    }
+    item_data = rrdata->application_data;
+    item_data_size = (uint32_t)rrdata->application_data_len;
+    log_records = rr_ack_item_log_record(item_data, item_data_size);
+    while (offset < item_data_size) {
+        element_len = rr_ack_item_element_len(
+            &item_data[offset], item_data_size - offset);
+        if (element_len <= 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        offset += (uint32_t)element_len;
+        if (log_records && (offset < item_data_size) &&
+            !rr_ack_item_log_record(
+                &item_data[offset], item_data_size - offset)) {
+            /* more elements of this record */
+            continue;
+        }
+        if (callback) {
+            callback(device_id, rrdata, item_number, &item_data[item_start],
+                (int)(offset - item_start));
+        }
+        item_number++;
+        item_start = offset;
+    }
+
+    return len;
+}
@@ -133,6 +133,21 @@ extern "C" {
         BACNET_READ_RANGE_DATA * pRequest,      /* Info on the request */
         RR_PROP_INFO * pInfo);  /* Where to write the response to */
 
+/** Function template for processing each item of a ReadRange-ACK.
+ * @param device_id [in] The device ID of the device that replied.
+ * @param rrdata [in] The decoded ReadRange-ACK.
+ * @param item_number [in] The item number in this reply, from zero.
+ * @param item_data [in] The encoded item, within the reply.
+ * @param item_data_len [in] The number of bytes of the encoded item.
+ */
+    typedef void (
+        *read_range_ack_item_process) (
+        uint32_t device_id,
+        BACNET_READ_RANGE_DATA * rrdata,
+        uint32_t item_number,
+        uint8_t * item_data,
+        int item_data_len);
+
     BACNET_STACK_EXPORT
     int rr_encode_apdu(
         uint8_t * apdu,
@@ -166,6 +181,13 @@ extern "C" {
         uint8_t * apdu,
         int apdu_len,   /* total length of the apdu */
         BACNET_READ_RANGE_DATA * rrdata);
+    BACNET_STACK_EXPORT
+    int rr_ack_item_process(
+        uint8_t * apdu,
+        int apdu_len,
+        uint32_t device_id,
+        BACNET_READ_RANGE_DATA * rrdata,
+        read_range_ack_item_process callback);
 
 #ifdef __cplusplus
 }
@@ -400,21 +400,26 @@ int rpm_ack_encode_apdu_init(uint8_t *apdu, uint8_t invoke_id)
 
 /** Encode the object type for an acknowledge of a RPM.
  *
- * @param apdu [in] Buffer of bytes to transmit.
+ * @param apdu [in] Buffer of bytes to transmit, or NULL for length
  * @param rpmdata [in] Pointer to the data used to fill in the APDU.
  *
  * @return Length of encoded bytes or 0 on failure.
  */
 int rpm_ack_encode_apdu_object_begin(uint8_t *apdu, BACNET_RPM_DATA *rpmdata)
 {
+    int len = 0;
     int apdu_len = 0; /* total length of the apdu, return value */
 
-    if (apdu) {
+    if (rpmdata) {
         /* Tag 0: objectIdentifier */
-        apdu_len = encode_context_object_id(
-            &apdu[0], 0, rpmdata->object_type, rpmdata->object_instance);
+        len = encode_context_object_id(
+            apdu, 0, rpmdata->object_type, rpmdata->object_instance);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
         /* Tag 1: listOfResults */
-        apdu_len += encode_opening_tag(&apdu[apdu_len], 1);
+        apdu_len += encode_opening_tag(apdu, 1);
     }
 
     return apdu_len;
@@ -422,7 +427,7 @@ int rpm_ack_encode_apdu_object_begin(uint8_t *apdu, BACNET_RPM_DATA *rpmdata)
 
 /** Encode the object property for an acknowledge of a RPM.
  *
- * @param apdu [in] Buffer of bytes to transmit.
+ * @param apdu [in] Buffer of bytes to transmit, or NULL for length
  * @param object_property [in] Object property ID.
  * @param array_index  Optional array index
  *
@@ -432,16 +437,18 @@ int rpm_ack_encode_apdu_object_property(uint8_t *apdu,
     BACNET_PROPERTY_ID object_property,
     BACNET_ARRAY_INDEX array_index)
 {
+    int len = 0;
     int apdu_len = 0; /* total length of the apdu, return value */
 
+    /* Tag 2: propertyIdentifier */
+    len = encode_context_enumerated(apdu, 2, object_property);
+    apdu_len += len;
     if (apdu) {
-        /* Tag 2: propertyIdentifier */
-        apdu_len = encode_context_enumerated(&apdu[0], 2, object_property);
-        /* Tag 3: optional propertyArrayIndex */
-        if (array_index != BACNET_ARRAY_ALL) {
-            apdu_len +=
-                encode_context_unsigned(&apdu[apdu_len], 3, array_index);
-        }
+        apdu += len;
+    }
+    /* Tag 3: optional propertyArrayIndex */
+    if (array_index != BACNET_ARRAY_ALL) {
+        apdu_len += encode_context_unsigned(apdu, 3, array_index);
     }
 
     return apdu_len;
@@ -481,7 +488,7 @@ int rpm_ack_encode_apdu_object_property_value(
 
 /** Encode the object property error for an acknowledge of a RPM.
  *
- * @param apdu [in] Buffer of bytes to transmit.
+ * @param apdu [in] Buffer of bytes to transmit, or NULL for length
  * @param error_class [in] Error Class
  * @param error_code [in] Error Code
  *
@@ -490,34 +497,39 @@ int rpm_ack_encode_apdu_object_property_value(
 int rpm_ack_encode_apdu_object_property_error(
     uint8_t *apdu, BACNET_ERROR_CLASS error_class, BACNET_ERROR_CODE error_code)
 {
+    int len = 0;
     int apdu_len = 0; /* total length of the apdu, return value */
 
+    /* Tag 5: propertyAccessError */
+    len = encode_opening_tag(apdu, 5);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_application_enumerated(apdu, error_class);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_application_enumerated(apdu, error_code);
+    apdu_len += len;
     if (apdu) {
-        /* Tag 5: propertyAccessError */
-        apdu_len += encode_opening_tag(&apdu[apdu_len], 5);
-        apdu_len += encode_application_enumerated(&apdu[apdu_len], error_class);
-        apdu_len += encode_application_enumerated(&apdu[apdu_len], error_code);
-        apdu_len += encode_closing_tag(&apdu[apdu_len], 5);
+        apdu += len;
     }
+    apdu_len += encode_closing_tag(apdu, 5);
 
     return apdu_len;
 }
 
 /** Encode the end tag for an acknowledge of a RPM.
  *
- * @param apdu [in] Buffer of bytes to transmit.
+ * @param apdu [in] Buffer of bytes to transmit, or NULL for length
  *
  * @return Length of encoded bytes or 0 on failure.
  */
 int rpm_ack_encode_apdu_object_end(uint8_t *apdu)
 {
-    int apdu_len = 0; /* total length of the apdu, return value */
-
-    if (apdu) {
-        apdu_len = encode_closing_tag(&apdu[0], 1);
-    }
-
-    return apdu_len;
+    return encode_closing_tag(apdu, 1);
 }
 
 #if BACNET_SVC_RPM_A
@@ -614,9 +626,16 @@ int rpm_ack_decode_object_property(uint8_t *apdu,
 }
 
 /**
- * @brief Decode the RPM Ack and call the ReadProperty-ACK function to 
+ * @brief Decode the RPM Ack and call the ReadProperty-ACK function to
  *  process each property value of the reply.
- * 
+ *
+ *  The reply is walked in place, without allocating any memory.
+ *  For each result, the callback gets the object, property, and array
+ *  index in rp_data, and either the encoded property value in
+ *  application_data and application_data_len with error_code set to
+ *  ERROR_CODE_SUCCESS, or the property-access-error in error_class and
+ *  error_code with application_data set to NULL.
+ *
  *  ReadAccessResult ::= SEQUENCE {
  *      object-identifier [0] BACnetObjectIdentifier,
  *      list-of-results [1] SEQUENCE OF SEQUENCE {
@@ -637,23 +656,26 @@ int rpm_ack_decode_object_property(uint8_t *apdu,
  * @param device_id [in] The device ID of the device that replied.
  * @param rp_data [in] The data structure to be filled.
  * @param callback [in] The function to call for each property value.
-*/
-void rpm_ack_object_property_process(
-    uint8_t *apdu,
+ * @return number of bytes decoded, or BACNET_STATUS_ERROR if the reply
+ *  is malformed. The callback has been called for each result that was
+ *  decoded before the malformed part.
+ */
+int rpm_ack_object_property_process(uint8_t *apdu,
     unsigned apdu_len,
     uint32_t device_id,
     BACNET_READ_PROPERTY_DATA *rp_data,
     read_property_ack_process callback)
 {
     int len = 0;
-    uint16_t application_data_len;
+    int decoded_len = 0;
+    int application_data_len;
     uint32_t error_value = 0; /* decoded error value */
 
     if (!apdu) {
-        return;
+        return BACNET_STATUS_ERROR;
     }
     if (!rp_data) {
-        return;
+        return BACNET_STATUS_ERROR;
     }
     while (apdu_len) {
         /*  object-identifier [0] BACnetObjectIdentifier */
@@ -662,37 +684,52 @@ void rpm_ack_object_property_process(
             apdu, apdu_len, &rp_data->object_type, &rp_data->object_instance);
         if (len <= 0) {
             /* malformed */
-            return;
+            return BACNET_STATUS_ERROR;
         }
+        decoded_len += len;
         apdu_len -= len;
         apdu += len;
-        while (apdu_len) {
+        for (;;) {
+            /* end of the list-of-results of this object? */
+            len = rpm_ack_decode_object_end(apdu, apdu_len);
+            if (len > 0) {
+                decoded_len += len;
+                apdu_len -= len;
+                apdu += len;
+                break;
+            }
             len = rpm_ack_decode_object_property(apdu, apdu_len,
                 &rp_data->object_property, &rp_data->array_index);
             if (len <= 0) {
                 /* malformed */
-                return;
+                return BACNET_STATUS_ERROR;
             }
+            decoded_len += len;
             apdu_len -= len;
             apdu += len;
             if (bacnet_is_opening_tag_number(apdu, apdu_len, 4, &len)) {
                 application_data_len = bacapp_data_len(
                     apdu, apdu_len, rp_data->object_property);
+                if (application_data_len < 0) {
+                    /* malformed */
+                    return BACNET_STATUS_ERROR;
+                }
                 /* propertyValue */
+                decoded_len += len;
                 apdu_len -= len;
                 apdu += len;
-                if (application_data_len) {
-                    rp_data->application_data_len = application_data_len;
-                    rp_data->application_data = apdu;
-                    apdu_len -= application_data_len;
-                    apdu += application_data_len;
-                }
+                rp_data->application_data_len = application_data_len;
+                rp_data->application_data = apdu;
+                decoded_len += application_data_len;
+                apdu_len -= application_data_len;
+                apdu += application_data_len;
                 if (bacnet_is_closing_tag_number(apdu, apdu_len, 4, &len)) {
+                    decoded_len += len;
                     apdu_len -= len;
                     apdu += len;
                 } else {
                     /* malformed */
-                    return;
+                    return BACNET_STATUS_ERROR;
                 }
                 rp_data->error_class = ERROR_CLASS_PROPERTY;
                 rp_data->error_code = ERROR_CODE_SUCCESS;
@@ -700,7 +737,8 @@ void rpm_ack_object_property_process(
                     callback(device_id, rp_data);
                 }
             } else if (bacnet_is_opening_tag_number(
-                            apdu, apdu_len, 5, &len)) {
+                           apdu, apdu_len, 5, &len)) {
+                decoded_len += len;
                 apdu_len -= len;
                 apdu += len;
                 /* property-access-error */
@@ -708,41 +746,44 @@ void rpm_ack_object_property_process(
                     apdu, apdu_len, &error_value);
                 if (len > 0) {
                     rp_data->error_class = (BACNET_ERROR_CLASS)error_value;
+                    decoded_len += len;
                     apdu_len -= len;
                     apdu += len;
                 } else {
                     /* malformed */
-                    return;
+                    return BACNET_STATUS_ERROR;
                 }
                 len = bacnet_enumerated_application_decode(
                     apdu, apdu_len, &error_value);
                 if (len > 0) {
                     rp_data->error_code = (BACNET_ERROR_CODE)error_value;
+                    decoded_len += len;
                     apdu_len -= len;
                     apdu += len;
                 } else {
                     /* malformed */
-                    return;
+                    return BACNET_STATUS_ERROR;
                 }
                 if (bacnet_is_closing_tag_number(apdu, apdu_len, 5, &len)) {
+                    decoded_len += len;
                     apdu_len -= len;
                     apdu += len;
                 } else {
                     /* malformed */
-                    return;
+                    return BACNET_STATUS_ERROR;
                 }
+                rp_data->application_data = NULL;
+                rp_data->application_data_len = 0;
                 if (callback) {
                     callback(device_id, rp_data);
                 }
+            } else {
+                /* malformed */
+                return BACNET_STATUS_ERROR;
             }
         }
-        len = rpm_decode_object_end(apdu, apdu_len);
-        if (len) {
-            apdu_len -= len;
-            apdu += len;
-        }
     }
 
-    return;
+    return decoded_len;
 }
 #endif
@@ -195,7 +195,8 @@ extern "C" {
         unsigned apdu_len,
         BACNET_PROPERTY_ID * object_property,
         BACNET_ARRAY_INDEX * array_index);
-    void rpm_ack_object_property_process(
+    BACNET_STACK_EXPORT
+    int rpm_ack_object_property_process(
         uint8_t *apdu,
         unsigned apdu_len,
         uint32_t device_id,
@@ -1169,6 +1169,131 @@ static void test_bacapp_context_data(void)
     }
 }
 
+/**
+ * @brief Test the datatype of the well-known complex properties
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacapp_tests, test_bacapp_known_property_tag)
+#else
+static void test_bacapp_known_property_tag(void)
+#endif
+{
+    const struct {
+        BACNET_PROPERTY_ID property;
+        BACNET_APPLICATION_TAG tag;
+    } known[] = {
+        { PROP_MEMBER_OF, BACNET_APPLICATION_TAG_DEVICE_OBJECT_REFERENCE },
+        { PROP_ZONE_MEMBERS, BACNET_APPLICATION_TAG_DEVICE_OBJECT_REFERENCE },
+        { PROP_DOOR_MEMBERS, BACNET_APPLICATION_TAG_DEVICE_OBJECT_REFERENCE },
+        { PROP_SUBORDINATE_LIST, BACNET_APPLICATION_TAG_DEVICE_OBJECT_REFERENCE },
+        { PROP_ACCESS_EVENT_CREDENTIAL, BACNET_APPLICATION_TAG_DEVICE_OBJECT_REFERENCE },
+        { PROP_ACCESS_DOORS, BACNET_APPLICATION_TAG_DEVICE_OBJECT_REFERENCE },
+        { PROP_ZONE_FROM, BACNET_APPLICATION_TAG_DEVICE_OBJECT_REFERENCE },
+        { PROP_ZONE_TO, BACNET_APPLICATION_TAG_DEVICE_OBJECT_REFERENCE },
+        { PROP_CREDENTIALS_IN_ZONE, BACNET_APPLICATION_TAG_DEVICE_OBJECT_REFERENCE },
+        { PROP_LAST_CREDENTIAL_ADDED, BACNET_APPLICATION_TAG_DEVICE_OBJECT_REFERENCE },
+        { PROP_LAST_CREDENTIAL_REMOVED, BACNET_APPLICATION_TAG_DEVICE_OBJECT_REFERENCE },
+        { PROP_ENTRY_POINTS, BACNET_APPLICATION_TAG_DEVICE_OBJECT_REFERENCE },
+        { PROP_EXIT_POINTS, BACNET_APPLICATION_TAG_DEVICE_OBJECT_REFERENCE },
+        { PROP_MEMBERS, BACNET_APPLICATION_TAG_DEVICE_OBJECT_REFERENCE },
+        { PROP_CREDENTIALS, BACNET_APPLICATION_TAG_DEVICE_OBJECT_REFERENCE },
+        { PROP_ACCOMPANIMENT, BACNET_APPLICATION_TAG_DEVICE_OBJECT_REFERENCE },
+        { PROP_BELONGS_TO, BACNET_APPLICATION_TAG_DEVICE_OBJECT_REFERENCE },
+        { PROP_LAST_ACCESS_POINT, BACNET_APPLICATION_TAG_DEVICE_OBJECT_REFERENCE },
+        { PROP_TIME_OF_ACTIVE_TIME_RESET, BACNET_APPLICATION_TAG_DATETIME },
+        { PROP_TIME_OF_STATE_COUNT_RESET, BACNET_APPLICATION_TAG_DATETIME },
+        { PROP_CHANGE_OF_STATE_TIME, BACNET_APPLICATION_TAG_DATETIME },
+        { PROP_MAXIMUM_VALUE_TIMESTAMP, BACNET_APPLICATION_TAG_DATETIME },
+        { PROP_MINIMUM_VALUE_TIMESTAMP, BACNET_APPLICATION_TAG_DATETIME },
+        { PROP_VALUE_CHANGE_TIME, BACNET_APPLICATION_TAG_DATETIME },
+        { PROP_START_TIME, BACNET_APPLICATION_TAG_DATETIME },
+        { PROP_STOP_TIME, BACNET_APPLICATION_TAG_DATETIME },
+        { PROP_MODIFICATION_DATE, BACNET_APPLICATION_TAG_DATETIME },
+        { PROP_UPDATE_TIME, BACNET_APPLICATION_TAG_DATETIME },
+        { PROP_COUNT_CHANGE_TIME, BACNET_APPLICATION_TAG_DATETIME },
+        { PROP_LAST_CREDENTIAL_ADDED_TIME, BACNET_APPLICATION_TAG_DATETIME },
+        { PROP_LAST_CREDENTIAL_REMOVED_TIME, BACNET_APPLICATION_TAG_DATETIME },
+        { PROP_ACTIVATION_TIME, BACNET_APPLICATION_TAG_DATETIME },
+        { PROP_EXPIRATION_TIME, BACNET_APPLICATION_TAG_DATETIME },
+        { PROP_LAST_USE_TIME, BACNET_APPLICATION_TAG_DATETIME },
+        { PROP_OBJECT_PROPERTY_REFERENCE, BACNET_APPLICATION_TAG_DEVICE_OBJECT_PROPERTY_REFERENCE },
+        { PROP_LOG_DEVICE_OBJECT_PROPERTY, BACNET_APPLICATION_TAG_DEVICE_OBJECT_PROPERTY_REFERENCE },
+        { PROP_LIST_OF_OBJECT_PROPERTY_REFERENCES, BACNET_APPLICATION_TAG_DEVICE_OBJECT_PROPERTY_REFERENCE },
+        { PROP_MANIPULATED_VARIABLE_REFERENCE, BACNET_APPLICATION_TAG_OBJECT_PROPERTY_REFERENCE },
+        { PROP_CONTROLLED_VARIABLE_REFERENCE, BACNET_APPLICATION_TAG_OBJECT_PROPERTY_REFERENCE },
+        { PROP_INPUT_REFERENCE, BACNET_APPLICATION_TAG_OBJECT_PROPERTY_REFERENCE },
+        { PROP_EVENT_TIME_STAMPS, BACNET_APPLICATION_TAG_TIMESTAMP },
+        { PROP_LAST_RESTORE_TIME, BACNET_APPLICATION_TAG_TIMESTAMP },
+        { PROP_TIME_OF_DEVICE_RESTART, BACNET_APPLICATION_TAG_TIMESTAMP },
+        { PROP_ACCESS_EVENT_TIME, BACNET_APPLICATION_TAG_TIMESTAMP },
+        { PROP_DEFAULT_COLOR, BACNET_APPLICATION_TAG_XY_COLOR },
+        { PROP_TRACKING_VALUE, BACNET_APPLICATION_TAG_XY_COLOR },
+        { PROP_PRESENT_VALUE, BACNET_APPLICATION_TAG_XY_COLOR },
+        { PROP_COLOR_COMMAND, BACNET_APPLICATION_TAG_COLOR_COMMAND },
+        { PROP_LIGHTING_COMMAND, BACNET_APPLICATION_TAG_LIGHTING_COMMAND },
+        { PROP_WEEKLY_SCHEDULE, BACNET_APPLICATION_TAG_WEEKLY_SCHEDULE },
+        { PROP_EXCEPTION_SCHEDULE, BACNET_APPLICATION_TAG_SPECIAL_EVENT },
+        { PROP_DATE_LIST, BACNET_APPLICATION_TAG_CALENDAR_ENTRY },
+        { PROP_EFFECTIVE_PERIOD, BACNET_APPLICATION_TAG_DATERANGE },
+        { PROP_RECIPIENT_LIST, BACNET_APPLICATION_TAG_DESTINATION }
+    };
+    const unsigned known_count = sizeof(known) / sizeof(known[0]);
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_DATE_TIME datetime = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint32_t property;
+    unsigned i;
+    int expected, tag, len, test_len;
+
+    for (property = 0; property <= (PROP_RESERVED_RANGE_MIN2 + 64);
+         property++) {
+        if (property == (PROP_RESERVED_RANGE_MAX + 1)) {
+            property = PROP_RESERVED_RANGE_MIN2;
+        }
+        expected = -1;
+        for (i = 0; i < known_count; i++) {
+            if (known[i].property == property) {
+                expected = known[i].tag;
+            }
+        }
+        tag = bacapp_known_property_tag(
+            OBJECT_COLOR, (BACNET_PROPERTY_ID)property);
+        zassert_equal(tag, expected, "property=%u", (unsigned)property);
+        if ((property == PROP_PRESENT_VALUE) ||
+            (property == PROP_TRACKING_VALUE)) {
+            expected = -1;
+        }
+        tag = bacapp_known_property_tag(
+            OBJECT_ANALOG_VALUE, (BACNET_PROPERTY_ID)property);
+        zassert_equal(tag, expected, "property=%u", (unsigned)property);
+    }
+    /* decode a complex value through the known property */
+    datetime_init_ascii(&datetime, "2024/4/1-12:34:56.78");
+    len = bacapp_encode_datetime(apdu, &datetime);
+    zassert_true(len > 0, NULL);
+    test_len = bacapp_decode_known_property(
+        apdu, len, &value, OBJECT_LOAD_CONTROL, PROP_START_TIME);
+    zassert_equal(test_len, len, NULL);
+    zassert_equal(value.tag, BACNET_APPLICATION_TAG_DATETIME, NULL);
+    zassert_equal(datetime_compare(&value.type.Date_Time, &datetime), 0, NULL);
+    /* a simple property */
+    len = encode_application_real(apdu, 3.14159f);
+    test_len = bacapp_decode_known_property(
+        apdu, len, &value, OBJECT_ANALOG_VALUE, PROP_PRESENT_VALUE);
+    zassert_equal(test_len, len, NULL);
+    zassert_equal(value.tag, BACNET_APPLICATION_TAG_REAL, NULL);
+    /* nothing to decode keeps the datatype of the property */
+    for (i = 0; i < known_count; i++) {
+        value.tag = BACNET_APPLICATION_TAG_NULL;
+        test_len = bacapp_decode_known_property(
+            apdu, 0, &value, OBJECT_COLOR, known[i].property);
+        if (test_len == 0) {
+            zassert_equal(value.tag, known[i].tag, "property=%u",
+                (unsigned)known[i].property);
+        }
+    }
+}
+
 /**
  * @brief Test
  */
@@ -1220,6 +1345,7 @@ void test_main(void)
         ztest_unit_test(testBACnetApplicationDataLength),
         ztest_unit_test(testBACnetApplicationData_Safe),
         ztest_unit_test(test_bacapp_context_data),
+        ztest_unit_test(test_bacapp_known_property_tag),
         ztest_unit_test(test_bacapp_sprintf_data));
 
     ztest_run_test_suite(bacapp_tests);
@@ -0,0 +1,353 @@
+/**
+ * @file
+ * @brief test the JSON and CSV writer and the JSON value parser
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacapp.h>
+#include <bacnet/bacjson.h>
+#include <bacnet/bactext.h>
+#include <bacnet/datetime.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Encode a value, compare the JSON text, parse it back and
+ *  compare the values
+ */
+static void testJsonValue(BACNET_OBJECT_TYPE object_type,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_APPLICATION_DATA_VALUE *value,
+    const char *expected)
+{
+    BACNET_APPLICATION_DATA_VALUE test_value = { 0 };
+    BACJSON_WRITER writer = { 0 };
+    char buffer[128];
+    bool status;
+    int len;
+
+    bacjson_writer_init(&writer, buffer, sizeof(buffer));
+    status =
+        bacjson_value_encode(&writer, object_type, object_property, value);
+    zassert_true(status, NULL);
+    zassert_equal(strcmp(buffer, expected), 0, "%s != %s", buffer, expected);
+    zassert_equal(bacjson_writer_length(&writer), strlen(expected), NULL);
+    len = bacjson_value_parse(buffer, writer.length, value->tag, object_type,
+        object_property, &test_value);
+    zassert_equal(len, (int)writer.length, "%s", buffer);
+    zassert_true(bacapp_same_value(value, &test_value), "%s", buffer);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacjson_tests, testJsonValues)
+#else
+static void testJsonValues(void)
+#endif
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    uint8_t octets[3] = { 0x01, 0xAB, 0xFF };
+
+    value.tag = BACNET_APPLICATION_TAG_NULL;
+    testJsonValue(OBJECT_DEVICE, PROP_PRESENT_VALUE, &value, "null");
+    value.tag = BACNET_APPLICATION_TAG_BOOLEAN;
+    value.type.Boolean = true;
+    testJsonValue(OBJECT_DEVICE, PROP_PRESENT_VALUE, &value, "true");
+    value.type.Boolean = false;
+    testJsonValue(OBJECT_DEVICE, PROP_PRESENT_VALUE, &value, "false");
+    value.tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+    value.type.Unsigned_Int = 0;
+    testJsonValue(OBJECT_DEVICE, PROP_PRESENT_VALUE, &value, "0");
+    value.type.Unsigned_Int = 4194303;
+    testJsonValue(OBJECT_DEVICE, PROP_PRESENT_VALUE, &value, "4194303");
+    value.tag = BACNET_APPLICATION_TAG_SIGNED_INT;
+    value.type.Signed_Int = -2147483647 - 1;
+    testJsonValue(OBJECT_DEVICE, PROP_PRESENT_VALUE, &value, "-2147483648");
+    value.type.Signed_Int = 42;
+    testJsonValue(OBJECT_DEVICE, PROP_PRESENT_VALUE, &value, "42");
+    value.tag = BACNET_APPLICATION_TAG_REAL;
+    value.type.Real = 72.5f;
+    testJsonValue(OBJECT_ANALOG_INPUT, PROP_PRESENT_VALUE, &value, "72.5");
+    value.type.Real = -0.125f;
+    testJsonValue(OBJECT_ANALOG_INPUT, PROP_PRESENT_VALUE, &value, "-0.125");
+    value.type.Real = 100.0f;
+    testJsonValue(OBJECT_ANALOG_INPUT, PROP_PRESENT_VALUE, &value, "100");
+    /* small values keep their significant digits */
+    value.type.Real = 1.5e-6f;
+    testJsonValue(
+        OBJECT_ANALOG_INPUT, PROP_PRESENT_VALUE, &value, "1.50000005e-06");
+    value.type.Real = 0.1f;
+    testJsonValue(
+        OBJECT_ANALOG_INPUT, PROP_PRESENT_VALUE, &value, "0.100000001");
+    value.tag = BACNET_APPLICATION_TAG_DOUBLE;
+    value.type.Double = 1234.5678;
+    testJsonValue(OBJECT_ANALOG_INPUT, PROP_PRESENT_VALUE, &value,
+        "1234.5678");
+    value.type.Double = 1e20;
+    testJsonValue(OBJECT_ANALOG_INPUT, PROP_PRESENT_VALUE, &value, "1e+20");
+    value.tag = BACNET_APPLICATION_TAG_OCTET_STRING;
+    octetstring_init(&value.type.Octet_String, octets, sizeof(octets));
+    testJsonValue(OBJECT_DEVICE, PROP_PRESENT_VALUE, &value, "\"01ABFF\"");
+    value.tag = BACNET_APPLICATION_TAG_CHARACTER_STRING;
+    characterstring_init_ansi(&value.type.Character_String, "a\"b\\c\n");
+    testJsonValue(OBJECT_DEVICE, PROP_OBJECT_NAME, &value,
+        "\"a\\\"b\\\\c\\n\"");
+    value.tag = BACNET_APPLICATION_TAG_BIT_STRING;
+    bitstring_init(&value.type.Bit_String);
+    bitstring_set_bit(&value.type.Bit_String, 0, true);
+    bitstring_set_bit(&value.type.Bit_String, 2, false);
+    testJsonValue(OBJECT_ANALOG_INPUT, PROP_STATUS_FLAGS, &value,
+        "[true,false,false]");
+    value.tag = BACNET_APPLICATION_TAG_ENUMERATED;
+    value.type.Enumerated = UNITS_DEGREES_FAHRENHEIT;
+    testJsonValue(OBJECT_ANALOG_INPUT, PROP_UNITS, &value,
+        "\"degrees-fahrenheit\"");
+    value.type.Enumerated = BINARY_ACTIVE;
+    testJsonValue(OBJECT_BINARY_VALUE, PROP_PRESENT_VALUE, &value,
+        "\"active\"");
+    testJsonValue(OBJECT_MULTI_STATE_VALUE, PROP_RELIABILITY, &value, "1");
+    value.tag = BACNET_APPLICATION_TAG_DATE;
+    datetime_set_date(&value.type.Date, 2024, 4, 1);
+    testJsonValue(OBJECT_DEVICE, PROP_LOCAL_DATE, &value, "\"2024-04-01\"");
+    value.tag = BACNET_APPLICATION_TAG_TIME;
+    datetime_set_time(&value.type.Time, 13, 45, 30, 0);
+    testJsonValue(OBJECT_DEVICE, PROP_LOCAL_TIME, &value,
+        "\"13:45:30.00\"");
+    value.type.Time.hundredths = 0xFF;
+    testJsonValue(OBJECT_DEVICE, PROP_LOCAL_TIME, &value, "\"13:45:30.*\"");
+    value.tag = BACNET_APPLICATION_TAG_OBJECT_ID;
+    value.type.Object_Id.type = OBJECT_ANALOG_INPUT;
+    value.type.Object_Id.instance = 1;
+    testJsonValue(OBJECT_DEVICE, PROP_OBJECT_IDENTIFIER, &value,
+        "\"analog-input:1\"");
+    value.type.Object_Id.type = 1000;
+    testJsonValue(OBJECT_DEVICE, PROP_OBJECT_IDENTIFIER, &value,
+        "\"1000:1\"");
+    value.tag = BACNET_APPLICATION_TAG_DATETIME;
+    datetime_set_values(&value.type.Date_Time, 2024, 4, 1, 13, 45, 30, 50);
+    testJsonValue(OBJECT_DEVICE, PROP_PRESENT_VALUE, &value,
+        "\"2024-04-01T13:45:30.50\"");
+
+    return;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacjson_tests, testJsonRecords)
+#else
+static void testJsonRecords(void)
+#endif
+{
+    BACNET_APPLICATION_DATA_VALUE value[2] = { 0 };
+    BACNET_OBJECT_PROPERTY_VALUE object_value = { 0 };
+    BACJSON_WRITER writer = { 0 };
+    const char *expected;
+    char buffer[128];
+    size_t size;
+    bool status;
+
+    value[0].tag = BACNET_APPLICATION_TAG_REAL;
+    value[0].type.Real = 72.5f;
+    object_value.object_type = OBJECT_ANALOG_INPUT;
+    object_value.object_instance = 1;
+    object_value.object_property = PROP_PRESENT_VALUE;
+    object_value.array_index = BACNET_ARRAY_ALL;
+    object_value.value = &value[0];
+    bacjson_writer_init(&writer, buffer, sizeof(buffer));
+    status = bacjson_property_value_encode(&writer, &object_value);
+    zassert_true(status, NULL);
+    expected = "{\"object-type\":\"analog-input\",\"object-instance\":1,"
+               "\"property\":\"present-value\",\"value\":72.5}";
+    zassert_equal(strcmp(buffer, expected), 0, "%s", buffer);
+    /* a record that does not fit leaves the buffer as it was */
+    for (size = 0; size <= strlen(expected); size++) {
+        bacjson_writer_init(&writer, buffer, size);
+        status = bacjson_property_value_encode(&writer, &object_value);
+        zassert_false(status, NULL);
+        zassert_equal(bacjson_writer_length(&writer), 0, NULL);
+    }
+    /* a list of values is an array */
+    value[0].tag = BACNET_APPLICATION_TAG_CHARACTER_STRING;
+    characterstring_init_ansi(&value[0].type.Character_String, "x,y");
+    value[0].next = &value[1];
+    value[1].tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+    value[1].type.Unsigned_Int = 7;
+    object_value.object_property = PROP_DESCRIPTION;
+    object_value.array_index = 2;
+    bacjson_writer_init(&writer, buffer, sizeof(buffer));
+    status = bacjson_property_value_encode(&writer, &object_value);
+    zassert_true(status, NULL);
+    expected = "{\"object-type\":\"analog-input\",\"object-instance\":1,"
+               "\"property\":\"description\",\"array-index\":2,"
+               "\"value\":[\"x,y\",7]}";
+    zassert_equal(strcmp(buffer, expected), 0, "%s", buffer);
+    /* CSV fields with separators or quotes are quoted */
+    bacjson_writer_reset(&writer);
+    status = bacjson_csv_property_value_encode(&writer, &object_value);
+    zassert_true(status, NULL);
+    expected = "analog-input,1,description,2,\"[\"\"x,y\"\",7]\"\n";
+    zassert_equal(strcmp(buffer, expected), 0, "%s", buffer);
+    value[0].next = NULL;
+    object_value.array_index = BACNET_ARRAY_ALL;
+    status = bacjson_csv_property_value_encode(&writer, &object_value);
+    zassert_true(status, NULL);
+    zassert_equal(
+        strcmp(&buffer[strlen(expected)],
+            "analog-input,1,description,,\"\"\"x,y\"\"\"\n"),
+        0, "%s", buffer);
+    /* a CSV line that does not fit leaves the buffer as it was */
+    for (size = 0; size < strlen(expected); size++) {
+        bacjson_writer_init(&writer, buffer, size);
+        object_value.array_index = 2;
+        value[0].next = &value[1];
+        status = bacjson_csv_property_value_encode(&writer, &object_value);
+        zassert_false(status, NULL);
+        zassert_equal(bacjson_writer_length(&writer), 0, NULL);
+    }
+
+    return;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacjson_tests, testJsonParse)
+#else
+static void testJsonParse(void)
+#endif
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    const char *text;
+    int len;
+
+    /* leading white space is skipped */
+    text = "  12.75, ";
+    len = bacjson_value_parse(text, strlen(text),
+        BACNET_APPLICATION_TAG_REAL, OBJECT_ANALOG_VALUE, PROP_PRESENT_VALUE,
+        &value);
+    zassert_equal(len, 7, NULL);
+    zassert_false(islessgreater(value.type.Real, 12.75f), NULL);
+    text = "-1.5e3";
+    len = bacjson_value_parse(text, strlen(text),
+        BACNET_APPLICATION_TAG_DOUBLE, OBJECT_ANALOG_VALUE,
+        PROP_PRESENT_VALUE, &value);
+    zassert_equal(len, 6, NULL);
+    zassert_false(islessgreater(value.type.Double, -1500.0), NULL);
+    text = "2.5e-300";
+    len = bacjson_value_parse(text, strlen(text),
+        BACNET_APPLICATION_TAG_DOUBLE, OBJECT_ANALOG_VALUE,
+        PROP_PRESENT_VALUE, &value);
+    zassert_equal(len, 8, NULL);
+    zassert_false(islessgreater(value.type.Double, 2.5e-300), NULL);
+    /* unicode escapes become UTF-8 */
+    text = "\"\\u00e9\\ud83d\\ude00\"";
+    len = bacjson_value_parse(text, strlen(text),
+        BACNET_APPLICATION_TAG_CHARACTER_STRING, OBJECT_DEVICE,
+        PROP_OBJECT_NAME, &value);
+    zassert_equal(len, (int)strlen(text), NULL);
+    zassert_equal(characterstring_encoding(&value.type.Character_String),
+        CHARACTER_UTF8, NULL);
+    zassert_equal(
+        characterstring_length(&value.type.Character_String), 6, NULL);
+    zassert_equal(memcmp(characterstring_value(&value.type.Character_String),
+                      "\xC3\xA9\xF0\x9F\x98\x80", 6),
+        0, NULL);
+    /* numbers of enumerations */
+    text = "12";
+    len = bacjson_value_parse(text, strlen(text),
+        BACNET_APPLICATION_TAG_ENUMERATED, OBJECT_ANALOG_INPUT, PROP_UNITS,
+        &value);
+    zassert_equal(len, 2, NULL);
+    zassert_equal(value.type.Enumerated, 12, NULL);
+    /* text that is not a value of the datatype */
+    text = "nul";
+    zassert_equal(bacjson_value_parse(text, strlen(text),
+                      BACNET_APPLICATION_TAG_NULL, OBJECT_DEVICE,
+                      PROP_PRESENT_VALUE, &value),
+        BACNET_STATUS_ERROR, NULL);
+    text = "-1";
+    zassert_equal(bacjson_value_parse(text, strlen(text),
+                      BACNET_APPLICATION_TAG_UNSIGNED_INT, OBJECT_DEVICE,
+                      PROP_PRESENT_VALUE, &value),
+        BACNET_STATUS_ERROR, NULL);
+    text = "2147483648";
+    zassert_equal(bacjson_value_parse(text, strlen(text),
+                      BACNET_APPLICATION_TAG_SIGNED_INT, OBJECT_DEVICE,
+                      PROP_PRESENT_VALUE, &value),
+        BACNET_STATUS_ERROR, NULL);
+    text = "\"no-such-unit\"";
+    zassert_equal(bacjson_value_parse(text, strlen(text),
+                      BACNET_APPLICATION_TAG_ENUMERATED, OBJECT_ANALOG_INPUT,
+                      PROP_UNITS, &value),
+        BACNET_STATUS_ERROR, NULL);
+    text = "\"analog-input:4194304\"";
+    zassert_equal(bacjson_value_parse(text, strlen(text),
+                      BACNET_APPLICATION_TAG_OBJECT_ID, OBJECT_DEVICE,
+                      PROP_OBJECT_IDENTIFIER, &value),
+        BACNET_STATUS_ERROR, NULL);
+    text = "\"0A1\"";
+    zassert_equal(bacjson_value_parse(text, strlen(text),
+                      BACNET_APPLICATION_TAG_OCTET_STRING, OBJECT_DEVICE,
+                      PROP_PRESENT_VALUE, &value),
+        BACNET_STATUS_ERROR, NULL);
+    text = "\"13:60\"";
+    zassert_equal(bacjson_value_parse(text, strlen(text),
+                      BACNET_APPLICATION_TAG_TIME, OBJECT_DEVICE,
+                      PROP_LOCAL_TIME, &value),
+        BACNET_STATUS_ERROR, NULL);
+    text = "\"unterminated";
+    zassert_equal(bacjson_value_parse(text, strlen(text),
+                      BACNET_APPLICATION_TAG_CHARACTER_STRING, OBJECT_DEVICE,
+                      PROP_OBJECT_NAME, &value),
+        BACNET_STATUS_ERROR, NULL);
+
+    return;
+}
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacjson_tests, testJsonIndexTables)
+#else
+static void testJsonIndexTables(void)
+#endif
+{
+    static const char *names[3][1024];
+    unsigned i;
+
+    /* the names are searched for until the tables are built */
+    for (i = 0; i < 1024; i++) {
+        names[0][i] = bactext_object_type_name(i);
+        names[1][i] = bactext_property_name(i);
+        names[2][i] = bactext_engineering_unit_name(i);
+    }
+    bactext_index_init();
+    bactext_index_init();
+    for (i = 0; i < 1024; i++) {
+        zassert_equal(names[0][i], bactext_object_type_name(i), "%u", i);
+        zassert_equal(names[1][i], bactext_property_name(i), "%u", i);
+        zassert_equal(
+            names[2][i], bactext_engineering_unit_name(i), "%u", i);
+    }
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(bacjson_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(bacjson_tests,
+     ztest_unit_test(testJsonIndexTables),
+     ztest_unit_test(testJsonValues),
+     ztest_unit_test(testJsonRecords),
+     ztest_unit_test(testJsonParse)
+     );
+
+    ztest_run_test_suite(bacjson_tests);
+}
+#endif
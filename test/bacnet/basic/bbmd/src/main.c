@@ -0,0 +1,432 @@
+/**
+ * @file
+ * @author Steve Karg
+ * @date April 2020
+ * @brief Test file for a basic BBMD for BVLC IPv4 handler
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdio.h> /* for standard i/o, like printing */
+#include <stdint.h> /* for standard integer types uint8_t etc. */
+#include <stdbool.h> /* for the standard bool type. */
+#include <string.h> /* for memcpy */
+#include <assert.h>
+#include <string.h>
+#include "bacnet/bacdcode.h"
+#include "bacnet/iam.h"
+#include "bacnet/npdu.h"
+#include "bacnet/datalink/bip.h"
+#include "bacnet/datalink/bvlc.h"
+#include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/bbmd/h_bbmd.h"
+
+struct device_info_t {
+    uint32_t Device_ID;
+    BACNET_IP_ADDRESS BIP_Addr;
+    BACNET_IP_ADDRESS BIP_Broadcast_Addr;
+    BACNET_ADDRESS BACnet_Address;
+};
+static struct device_info_t TD;
+static struct device_info_t IUT;
+
+#ifndef MAX_MPDU
+#define MAX_MPDU 1497
+#endif
+
+/* for the reply sent from the handler */
+static uint8_t Test_Sent_Message_Type;
+static uint8_t Test_Sent_Message_Length;
+static uint8_t Test_Sent_Message_Buffer[MAX_MPDU];
+static uint16_t Test_Sent_Message_Buffer_Length;
+static BACNET_IP_ADDRESS Test_Sent_Message_Dest;
+
+/* network stub functions */
+/**
+ * BACnet/IP Datalink Receive handler.
+ *
+ * @param src - returns the source address
+ * @param npdu - returns the NPDU buffer
+ * @param max_npdu -maximum size of the NPDU buffer
+ * @param timeout - number of milliseconds to wait for a packet
+ *
+ * @return Number of bytes received, or 0 if none or timeout.
+ */
+uint16_t bip_receive(
+    BACNET_ADDRESS *src, uint8_t *npdu, uint16_t max_npdu, unsigned timeout)
+{
+    return 0;
+}
+
+/**
+ * The send function for BACnet/IPv6 driver layer
+ *
+ * @param dest - Points to a BACNET_IP_ADDRESS structure containing the
+ *  destination address.
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ *
+ * @return Upon successful completion, returns the number of bytes sent.
+ *  Otherwise, -1 shall be returned and errno set to indicate the error.
+ */
+int bip_send_mpdu(BACNET_IP_ADDRESS *dest, uint8_t *mtu, uint16_t mtu_len)
+{
+    uint8_t message_type = 0;
+    uint16_t message_length = 0;
+    int header_len = 0;
+
+    header_len =
+        bvlc_decode_header(mtu, mtu_len, &message_type, &message_length);
+    Test_Sent_Message_Type = message_type;
+    Test_Sent_Message_Length = message_length;
+    bvlc_address_copy(&Test_Sent_Message_Dest, dest);
+    if ((header_len == 4) && (mtu_len >= 4)) {
+        memcpy(&Test_Sent_Message_Buffer[0], &mtu[4], mtu_len-4);
+        Test_Sent_Message_Buffer_Length = mtu_len - 4;
+    } else {
+        Test_Sent_Message_Buffer_Length = 0;
+    }
+
+    return 0;
+}
+
+/** Return the Object Instance number for our (single) Device Object.
+ * This is a key function, widely invoked by the handler code, since
+ * it provides "our" (ie, local) address.
+ *
+ * @return The Instance number used in the BACNET_OBJECT_ID for the Device.
+ */
+uint32_t Device_Object_Instance_Number(void)
+{
+    return IUT.Device_ID;
+}
+
+/**
+ * Get the BACnet/IP address
+ *
+ * @return BACnet/IP address
+ */
+bool bip_get_addr(BACNET_IP_ADDRESS *addr)
+{
+    return bvlc_address_copy(addr, &IUT.BIP_Addr);
+}
+
+/**
+ * Get the BACnet/IP address
+ *
+ * @return BACnet/IP address
+ */
+bool bip_get_broadcast_addr(BACNET_IP_ADDRESS *addr)
+{
+    return bvlc_address_copy(addr, &IUT.BIP_Broadcast_Addr);
+}
+
+static void test_setup(void)
+{
+    bvlc_init();
+    bvlc_address_set(&TD.BIP_Broadcast_Addr, 255, 255, 255, 255);
+    bvlc_address_set(&TD.BIP_Addr, 192, 168, 1, 100);
+    TD.Device_ID = 12345;
+
+    bvlc_address_set(&IUT.BIP_Broadcast_Addr, 255, 255, 255, 255);
+    bvlc_address_set(&IUT.BIP_Addr, 192, 168, 1, 10);
+    IUT.Device_ID = 54321;
+}
+
+static void test_cleanup(void)
+{
+
+}
+
+/**
+ * @brief Test 15.2.1.1 Initiate Original-Broadcast-NPDU
+ */
+static void test_Initiate_Original_Broadcast_NPDU(void)
+{
+    uint8_t pdu[MAX_MPDU] = {0};
+    int npdu_len = 0;
+    int apdu_len = 0;
+    int pdu_len = 0;
+    BACNET_ADDRESS dest = {0};
+    BACNET_NPDU_DATA npdu_data = {0};
+    uint8_t test_pdu[MAX_MPDU] = {0};
+    uint16_t test_pdu_len = 0;
+    int function_len = 0;
+
+    test_setup();
+    /* MAKE(the IUT send a broadcast) */
+    dest.net = BACNET_BROADCAST_NETWORK;
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    npdu_len = npdu_encode_pdu(&pdu[0], &dest, &IUT.BACnet_Address, &npdu_data);
+    apdu_len = iam_encode_apdu(&pdu[npdu_len], IUT.Device_ID, MAX_APDU,
+        SEGMENTATION_NONE, BACNET_VENDOR_ID);
+    pdu_len = npdu_len + apdu_len;
+    bvlc_send_pdu(&dest, &npdu_data, pdu, pdu_len);
+    /* DA=Link Local Multicast Address */
+    assert(!bvlc_address_different(
+        &TD.BIP_Broadcast_Addr, &Test_Sent_Message_Dest));
+    /* SA = IUT - done in port layer */
+    /* Original-Broadcast-NPDU */
+    assert(Test_Sent_Message_Type == BVLC_ORIGINAL_BROADCAST_NPDU);
+    if (Test_Sent_Message_Type == BVLC_ORIGINAL_BROADCAST_NPDU) {
+        function_len = bvlc_decode_original_broadcast(
+            Test_Sent_Message_Buffer, Test_Sent_Message_Buffer_Length,
+            test_pdu, sizeof(test_pdu), &test_pdu_len);
+        printf("len=%u pdu[%u] test_pdu[%u]\n",
+            (unsigned)function_len,
+            (unsigned)Test_Sent_Message_Buffer_Length,
+            (unsigned)sizeof(test_pdu));
+        assert(function_len > 0);
+        /* (any valid BACnet-Unconfirmed-Request-PDU,
+            with any valid broadcast network options */
+        assert(test_pdu_len == pdu_len);
+    }
+    test_cleanup();
+}
+
+/**
+ * @brief Encode an I-Am broadcast NPDU from the TD
+ * @param npdu - buffer for the NPDU
+ * @param device_id - device instance to put into the I-Am broadcast
+ * @return number of bytes in the NPDU
+ */
+static uint16_t test_encode_broadcast(uint8_t *npdu, uint32_t device_id)
+{
+    int npdu_len = 0;
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+
+    dest.net = BACNET_BROADCAST_NETWORK;
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    npdu_len = npdu_encode_pdu(&npdu[0], &dest, &TD.BACnet_Address,
+        &npdu_data);
+    npdu_len += iam_encode_apdu(&npdu[npdu_len], device_id, MAX_APDU,
+        SEGMENTATION_NONE, BACNET_VENDOR_ID);
+
+    return (uint16_t)npdu_len;
+}
+
+/**
+ * @brief Send an Original-Broadcast-NPDU from a B/IP node to the IUT
+ * @param addr - B/IP address of the node
+ * @param device_id - device instance to put into the I-Am broadcast
+ */
+static void test_send_original_broadcast_from(
+    BACNET_IP_ADDRESS *addr, uint32_t device_id)
+{
+    uint8_t npdu[MAX_MPDU] = { 0 };
+    uint8_t mtu[MAX_MPDU] = { 0 };
+    uint16_t npdu_len = 0;
+    int mtu_len = 0;
+    BACNET_ADDRESS src = { 0 };
+
+    npdu_len = test_encode_broadcast(npdu, device_id);
+    mtu_len = bvlc_encode_original_broadcast(
+        &mtu[0], sizeof(mtu), &npdu[0], npdu_len);
+    (void)bvlc_bbmd_enabled_handler(addr, &src, mtu, mtu_len);
+}
+
+/**
+ * @brief Send an Original-Broadcast-NPDU from the TD to the IUT
+ * @param device_id - device instance to put into the I-Am broadcast
+ */
+static void test_send_original_broadcast(uint32_t device_id)
+{
+    test_send_original_broadcast_from(&TD.BIP_Addr, device_id);
+}
+
+/**
+ * @brief Send a Forwarded-NPDU from a peer BBMD to the IUT
+ * @param addr - B/IP address of the peer BBMD
+ * @param origin - B/IP address of the node that originated the broadcast
+ * @param device_id - device instance to put into the I-Am broadcast
+ */
+static void test_send_forwarded_npdu(BACNET_IP_ADDRESS *addr,
+    BACNET_IP_ADDRESS *origin,
+    uint32_t device_id)
+{
+    uint8_t npdu[MAX_MPDU] = { 0 };
+    uint8_t mtu[MAX_MPDU] = { 0 };
+    uint16_t npdu_len = 0;
+    int mtu_len = 0;
+    BACNET_ADDRESS src = { 0 };
+
+    npdu_len = test_encode_broadcast(npdu, device_id);
+    mtu_len = bvlc_encode_forwarded_npdu(
+        &mtu[0], sizeof(mtu), origin, &npdu[0], npdu_len);
+    (void)bvlc_bbmd_enabled_handler(addr, &src, mtu, mtu_len);
+}
+
+/**
+ * @brief Test the rate limit and duplicate suppression of forwarding
+ */
+static void test_BBMD_Forward_Limits(void)
+{
+    BVLC_BBMD_COUNTERS counters = { 0 };
+    BACNET_IP_ADDRESS addr = { 0 };
+    uint32_t i = 0;
+
+    test_setup();
+    /* no limits by default */
+    for (i = 0; i < 10; i++) {
+        test_send_original_broadcast(TD.Device_ID);
+    }
+    bvlc_bbmd_counters(&counters);
+    assert(counters.forwarded == 10);
+    assert(counters.rate_limited == 0);
+    assert(counters.duplicates == 0);
+    assert(bvlc_bbmd_source_counters(&TD.BIP_Addr, &counters));
+    assert(counters.forwarded == 10);
+    bvlc_address_set(&addr, 192, 168, 1, 200);
+    assert(!bvlc_bbmd_source_counters(&addr, &counters));
+    /* the same broadcast is only forwarded once within the window */
+    bvlc_init();
+    bvlc_bbmd_duplicate_window_set(2);
+    test_send_original_broadcast(TD.Device_ID);
+    test_send_original_broadcast(TD.Device_ID);
+    test_send_original_broadcast(TD.Device_ID + 1);
+    bvlc_bbmd_counters(&counters);
+    assert(counters.forwarded == 2);
+    assert(counters.duplicates == 1);
+    bvlc_maintenance_timer(1);
+    test_send_original_broadcast(TD.Device_ID);
+    bvlc_bbmd_counters(&counters);
+    assert(counters.duplicates == 2);
+    bvlc_maintenance_timer(1);
+    test_send_original_broadcast(TD.Device_ID);
+    bvlc_bbmd_counters(&counters);
+    assert(counters.forwarded == 3);
+    assert(counters.duplicates == 2);
+    bvlc_bbmd_duplicate_window_set(0);
+    /* a burst, and then the rate, of broadcasts from a node */
+    bvlc_init();
+    bvlc_bbmd_rate_limit_set(2, 5);
+    for (i = 0; i < 10; i++) {
+        test_send_original_broadcast(TD.Device_ID + i);
+    }
+    bvlc_bbmd_counters(&counters);
+    assert(counters.forwarded == 5);
+    assert(counters.rate_limited == 5);
+    bvlc_maintenance_timer(1);
+    for (i = 0; i < 10; i++) {
+        test_send_original_broadcast(TD.Device_ID + i);
+    }
+    assert(bvlc_bbmd_source_counters(&TD.BIP_Addr, &counters));
+    assert(counters.forwarded == 7);
+    assert(counters.rate_limited == 13);
+    /* the burst is restored over time */
+    bvlc_maintenance_timer(60);
+    for (i = 0; i < 10; i++) {
+        test_send_original_broadcast(TD.Device_ID + i);
+    }
+    bvlc_bbmd_counters(&counters);
+    assert(counters.forwarded == 12);
+    bvlc_bbmd_rate_limit_set(0, 0);
+    test_cleanup();
+}
+
+/**
+ * @brief Test which B/IP node a forwarded broadcast is counted against
+ */
+static void test_BBMD_Forward_Sources(void)
+{
+    BVLC_BBMD_COUNTERS counters = { 0 };
+    BACNET_IP_ADDRESS addr = { 0 };
+    BACNET_IP_ADDRESS peer = { 0 };
+    BACNET_IP_ADDRESS origin = { 0 };
+    uint32_t i = 0;
+
+    test_setup();
+    bvlc_bbmd_rate_limit_set(1, 1);
+    /* nodes behind the same NAT address have their own limit */
+    bvlc_address_port_from_ascii(&addr, "192.168.1.200", "0xBAC0");
+    test_send_original_broadcast_from(&addr, TD.Device_ID);
+    test_send_original_broadcast_from(&addr, TD.Device_ID + 1);
+    addr.port = 0xBAC1;
+    test_send_original_broadcast_from(&addr, TD.Device_ID + 2);
+    assert(bvlc_bbmd_source_counters(&addr, &counters));
+    assert(counters.forwarded == 1);
+    assert(counters.rate_limited == 0);
+    addr.port = 0xBAC0;
+    assert(bvlc_bbmd_source_counters(&addr, &counters));
+    assert(counters.forwarded == 1);
+    assert(counters.rate_limited == 1);
+    /* a Forwarded-NPDU is limited by the node that originated it,
+       not by the peer BBMD that forwarded it */
+    bvlc_address_port_from_ascii(&peer, "192.168.2.1", "0xBAC0");
+    bvlc_address_port_from_ascii(&origin, "192.168.2.100", "0xBAC0");
+    test_send_forwarded_npdu(&peer, &origin, TD.Device_ID);
+    test_send_forwarded_npdu(&peer, &origin, TD.Device_ID + 1);
+    assert(!bvlc_bbmd_source_counters(&peer, &counters));
+    assert(bvlc_bbmd_source_counters(&origin, &counters));
+    assert(counters.forwarded == 1);
+    assert(counters.rate_limited == 1);
+    origin.port = 0xBAC1;
+    test_send_forwarded_npdu(&peer, &origin, TD.Device_ID + 2);
+    assert(bvlc_bbmd_source_counters(&origin, &counters));
+    assert(counters.forwarded == 1);
+    /* the nodes that do not fit in the source list share one limit */
+    for (i = 0; i < BBMD_SOURCE_ENTRIES_MAX; i++) {
+        bvlc_address_set(&addr, 10, 0, 0, (uint8_t)i);
+        test_send_original_broadcast_from(&addr, TD.Device_ID);
+    }
+    assert(!bvlc_bbmd_source_counters(&addr, &counters));
+    bvlc_bbmd_counters(&counters);
+    assert(counters.forwarded == 9);
+    assert(counters.rate_limited == 5);
+    bvlc_maintenance_timer(1);
+    test_send_original_broadcast_from(&addr, TD.Device_ID);
+    bvlc_bbmd_counters(&counters);
+    assert(counters.forwarded == 10);
+    bvlc_bbmd_rate_limit_set(0, 0);
+    test_cleanup();
+}
+
+static void test_BBMD_Result(void)
+{
+    int result = 0;
+    uint16_t result_code[] = { BVLC_RESULT_SUCCESSFUL_COMPLETION,
+        BVLC_RESULT_WRITE_BROADCAST_DISTRIBUTION_TABLE_NAK,
+        BVLC_RESULT_READ_BROADCAST_DISTRIBUTION_TABLE_NAK,
+        BVLC_RESULT_REGISTER_FOREIGN_DEVICE_NAK,
+        BVLC_RESULT_READ_FOREIGN_DEVICE_TABLE_NAK,
+        BVLC_RESULT_DELETE_FOREIGN_DEVICE_TABLE_ENTRY_NAK,
+        BVLC_RESULT_DISTRIBUTE_BROADCAST_TO_NETWORK_NAK };
+    size_t result_code_max = sizeof(result_code) / sizeof(result_code[0]);
+    uint16_t test_result_code = 0;
+    uint8_t test_function_code = 0;
+    BACNET_IP_ADDRESS addr;
+    BACNET_ADDRESS src;
+    unsigned int i = 0;
+    uint8_t mtu[MAX_MPDU] = { 0 };
+    uint16_t mtu_len = 0;
+
+    bvlc_address_port_from_ascii(&addr, "192.168.0.1", "0xBAC0");
+    for (i = 0; i < result_code_max; i++) {
+        mtu_len = bvlc_encode_result(&mtu[0], sizeof(mtu), result_code[i]);
+        result = bvlc_bbmd_disabled_handler(&addr, &src, &mtu[0], mtu_len);
+        /* validate that the result is handled (0) */
+        assert(result == 0);
+        test_result_code = bvlc_get_last_result();
+        assert(test_result_code == result_code[i]);
+        test_function_code = bvlc_get_function_code();
+        assert(test_function_code == BVLC_RESULT);
+        result = bvlc_bbmd_enabled_handler(&addr, &src, &mtu[0], mtu_len);
+        /* validate that the result is handled (0) */
+        assert(result == 0);
+        test_result_code = bvlc_get_last_result();
+        assert(test_result_code == result_code[i]);
+        test_function_code = bvlc_get_function_code();
+        assert(test_function_code == BVLC_RESULT);
+    }
+}
+
+int main(void)
+{
+    test_BBMD_Result();
+    test_BBMD_Forward_Limits();
+    test_BBMD_Forward_Sources();
+    test_Initiate_Original_Broadcast_NPDU();
+
+    return 0;
+}
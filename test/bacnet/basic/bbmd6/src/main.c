@@ -41,6 +41,10 @@ static uint8_t Test_Sent_Message_Length;
 static uint8_t Test_Sent_Message_Buffer[MAX_MPDU];
 static uint16_t Test_Sent_Message_Buffer_Length;
 static BACNET_IP6_ADDRESS Test_Sent_Message_Dest;
+/* for the messages sent to a list of destinations */
+static unsigned Test_Sent_List_Count;
+static BACNET_IP6_ADDRESS Test_Sent_List_Exclude;
+static bool Test_Sent_List_Excluded;
 
 /* network stub functions */
 /**
@@ -91,6 +95,36 @@ int bip6_send_mpdu(BACNET_IP6_ADDRESS *dest, uint8_t *mtu, uint16_t mtu_len)
     return 0;
 }
 
+/**
+ * The send function for BACnet/IPv6 driver layer to send the same
+ * message to several destinations
+ *
+ * @param dest - array of BACNET_IP6_ADDRESS destination addresses
+ * @param dest_count - number of destination addresses
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ *
+ * @return number of destinations that the message was sent to
+ */
+int bip6_send_mpdu_list(BACNET_IP6_ADDRESS *dest,
+    unsigned dest_count,
+    uint8_t *mtu,
+    uint16_t mtu_len)
+{
+    unsigned i;
+
+    Test_Sent_List_Count = dest_count;
+    Test_Sent_List_Excluded = true;
+    for (i = 0; i < dest_count; i++) {
+        if (!bvlc6_address_different(&dest[i], &Test_Sent_List_Exclude)) {
+            Test_Sent_List_Excluded = false;
+        }
+        bip6_send_mpdu(&dest[i], mtu, mtu_len);
+    }
+
+    return (int)dest_count;
+}
+
 /** Return the Object Instance number for our (single) Device Object.
  * This is a key function, widely invoked by the handler code, since
  * it provides "our" (ie, local) address.
@@ -268,6 +302,209 @@ static void test_Execute_Virtual_Address_Resolution(void)
     test_cleanup();
 }
 
+/**
+ * @brief Set a VMAC address like an IPv6 address and port
+ */
+static void test_VMAC_Address_Set(struct vmac_data *vmac, uint32_t n)
+{
+    memset(vmac, 0, sizeof(struct vmac_data));
+    vmac->mac[0] = 0x20;
+    vmac->mac[1] = 0x01;
+    encode_unsigned32(&vmac->mac[12], n);
+    vmac->mac[16] = 0xBA;
+    vmac->mac[17] = 0xC0;
+    vmac->mac_len = VMAC_MAC_MAX;
+}
+
+/**
+ * @brief Test the VMAC table lookups in both directions, and aging
+ */
+static void test_VMAC_Table(void)
+{
+    struct vmac_data vmac = { 0 };
+    struct vmac_data *pVMAC = NULL;
+    uint32_t device_id = 0;
+    uint32_t i = 0;
+    const uint32_t count = 5000;
+
+    VMAC_Init();
+    for (i = 0; i < count; i++) {
+        test_VMAC_Address_Set(&vmac, i);
+        assert(VMAC_Add(i + 100, &vmac));
+    }
+    assert(VMAC_Count() == count);
+    assert(!VMAC_Add(100, &vmac));
+    for (i = 0; i < count; i++) {
+        test_VMAC_Address_Set(&vmac, i);
+        assert(VMAC_Find_By_Data(&vmac, &device_id));
+        assert(device_id == (i + 100));
+        pVMAC = VMAC_Find_By_Key(i + 100);
+        assert(pVMAC != NULL);
+        assert(VMAC_Match(pVMAC, &vmac));
+    }
+    test_VMAC_Address_Set(&vmac, count);
+    assert(!VMAC_Find_By_Data(&vmac, &device_id));
+    /* addresses whose hash may be the same are still told apart */
+    memset(&vmac, 0, sizeof(vmac));
+    vmac.mac_len = 2;
+    vmac.mac[0] = 1;
+    assert(VMAC_Add(1, &vmac));
+    vmac.mac[1] = 1;
+    assert(VMAC_Add(2, &vmac));
+    assert(VMAC_Find_By_Data(&vmac, &device_id));
+    assert(device_id == 2);
+    assert(VMAC_Delete(2));
+    assert(!VMAC_Find_By_Data(&vmac, &device_id));
+    vmac.mac[1] = 0;
+    assert(VMAC_Find_By_Data(&vmac, &device_id));
+    assert(device_id == 1);
+    assert(VMAC_Delete(1));
+    assert(!VMAC_Find_By_Data(&vmac, &device_id));
+    /* entries not heard from within their lifetime are removed */
+    VMAC_Lifetime_Set(60);
+    assert(VMAC_Lifetime_Get() == 60);
+    VMAC_Timer(30);
+    test_VMAC_Address_Set(&vmac, 7);
+    assert(VMAC_Find_By_Data(&vmac, &device_id));
+    VMAC_Timer(30);
+    assert(VMAC_Count() == 1);
+    assert(VMAC_Find_By_Key(107) != NULL);
+    assert(!VMAC_Find_By_Key(108));
+    test_VMAC_Address_Set(&vmac, 8);
+    assert(!VMAC_Find_By_Data(&vmac, &device_id));
+    VMAC_Timer(60);
+    assert(VMAC_Count() == 0);
+    VMAC_Lifetime_Set(0);
+    VMAC_Cleanup();
+}
+
+#if BBMD6_ENABLED
+/**
+ * @brief Register a foreign device with the IUT, and get the result
+ */
+static uint16_t test_Register_Foreign_Device(
+    BACNET_IP6_ADDRESS *addr, uint32_t device_id, uint16_t ttl_seconds)
+{
+    uint8_t mtu[MAX_MPDU] = { 0 };
+    uint16_t mtu_len = 0;
+    uint16_t result_code = 0;
+    uint32_t vmac_src = 0;
+    BACNET_ADDRESS src = { 0 };
+    int result = 0;
+
+    mtu_len = bvlc6_encode_register_foreign_device(
+        &mtu[0], sizeof(mtu), device_id, ttl_seconds);
+    result = bvlc6_bbmd_enabled_handler(addr, &src, &mtu[0], mtu_len);
+    assert(result == 0);
+    assert(Test_Sent_Message_Type == BVLC6_RESULT);
+    assert(!bvlc6_address_different(&Test_Sent_Message_Dest, addr));
+    bvlc6_decode_result(Test_Sent_Message_Buffer,
+        Test_Sent_Message_Buffer_Length, &vmac_src, &result_code);
+
+    return result_code;
+}
+
+/**
+ * @brief Test the Broadcast Distribution and Foreign Device Tables
+ */
+static void test_BBMD_Tables(void)
+{
+    uint8_t mtu[MAX_MPDU] = { 0 };
+    uint8_t npdu[8] = { 0x01, 0x20, 0xFF, 0xFF, 0x00, 0xFF, 0x10, 0x08 };
+    uint16_t mtu_len = 0;
+    BACNET_IP6_ADDRESS addr = { 0 };
+    BACNET_IP6_ADDRESS peer = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    unsigned peers = 0;
+    unsigned i = 0;
+    int result = 0;
+
+    test_setup();
+    /* peer BBMDs - the IUT itself is never sent to */
+    for (i = 0; i < 10; i++) {
+        bvlc6_address_set(&peer, 0x2001, 0x0DBB, 0xAC10, 0xFE02, 0, 0, 0, i);
+        peer.port = 0xBAC0;
+        assert(bvlc6_bdt_entry_add(&peer));
+    }
+    assert(bvlc6_bdt_entry_add(&peer));
+    assert(bvlc6_bdt_entry_add(&IUT.BIP6_Addr));
+    peers = 10;
+    assert(bvlc6_bdt_count() == (peers + 1));
+    /* foreign devices, up to the size of the table */
+    for (i = 0; i < MAX_FD6_ENTRIES + 10; i++) {
+        bvlc6_address_set(&addr, 0x2001, 0x0DBB, 0xAC10, 0xFE03, 0, 0,
+            (uint16_t)(i >> 16), (uint16_t)i);
+        addr.port = 0xBAC0;
+        if (i < MAX_FD6_ENTRIES) {
+            assert(test_Register_Foreign_Device(&addr, 1000 + i, 60 + i) ==
+                BVLC6_RESULT_SUCCESSFUL_COMPLETION);
+        } else {
+            assert(test_Register_Foreign_Device(&addr, 1000 + i, 60) ==
+                BVLC6_RESULT_REGISTER_FOREIGN_DEVICE_NAK);
+        }
+    }
+    assert(bvlc6_fdt_count() == MAX_FD6_ENTRIES);
+    bvlc6_address_set(&addr, 0x2001, 0x0DBB, 0xAC10, 0xFE03, 0, 0, 0, 0);
+    addr.port = 0xBAC0;
+    assert(bvlc6_fdt_seconds_remaining(&addr) == 90);
+    /* an Original-Broadcast-NPDU is forwarded to every peer and device */
+    mtu_len = bvlc6_encode_original_broadcast(
+        &mtu[0], sizeof(mtu), TD.Device_ID, npdu, sizeof(npdu));
+    result = bvlc6_bbmd_enabled_handler(&TD.BIP6_Addr, &src, mtu, mtu_len);
+    assert(result > 0);
+    assert(Test_Sent_List_Count == (peers + MAX_FD6_ENTRIES));
+    assert(Test_Sent_Message_Type == BVLC6_FORWARDED_NPDU);
+    /* a Distribute-Broadcast-To-Network goes to all but its originator */
+    bvlc6_address_copy(&Test_Sent_List_Exclude, &addr);
+    mtu_len = bvlc6_encode_distribute_broadcast_to_network(
+        &mtu[0], sizeof(mtu), 1000, npdu, sizeof(npdu));
+    result = bvlc6_bbmd_enabled_handler(&addr, &src, mtu, mtu_len);
+    assert(result > 0);
+    assert(Test_Sent_List_Count == (peers + MAX_FD6_ENTRIES - 1));
+    assert(Test_Sent_List_Excluded);
+    /* a Forwarded-NPDU from a peer goes to the foreign devices only */
+    Test_Sent_List_Count = 0;
+    mtu_len = bvlc6_encode_forwarded_npdu(
+        &mtu[0], sizeof(mtu), TD.Device_ID, &TD.BIP6_Addr, npdu, sizeof(npdu));
+    result = bvlc6_bbmd_enabled_handler(&peer, &src, mtu, mtu_len);
+    assert(result > 0);
+    assert(Test_Sent_List_Count == MAX_FD6_ENTRIES);
+    /* and is dropped when it is not from a peer */
+    Test_Sent_List_Count = 0;
+    result = bvlc6_bbmd_enabled_handler(&TD.BIP6_Addr, &src, mtu, mtu_len);
+    assert(result == 0);
+    assert(Test_Sent_List_Count == 0);
+    /* foreign devices are purged after their time-to-live and grace */
+    bvlc6_maintenance_timer(89);
+    assert(bvlc6_fdt_count() == MAX_FD6_ENTRIES);
+    bvlc6_maintenance_timer(1);
+    assert(bvlc6_fdt_count() == (MAX_FD6_ENTRIES - 1));
+    assert(bvlc6_fdt_seconds_remaining(&addr) == 0);
+    bvlc6_maintenance_timer(10);
+    assert(bvlc6_fdt_count() == (MAX_FD6_ENTRIES - 11));
+    /* a registration is renewed */
+    bvlc6_address_set(&addr, 0x2001, 0x0DBB, 0xAC10, 0xFE03, 0, 0, 0, 20);
+    addr.port = 0xBAC0;
+    assert(test_Register_Foreign_Device(&addr, 1020, 60) ==
+        BVLC6_RESULT_SUCCESSFUL_COMPLETION);
+    assert(bvlc6_fdt_count() == (MAX_FD6_ENTRIES - 11));
+    assert(bvlc6_fdt_seconds_remaining(&addr) == 90);
+    /* and deleted */
+    mtu_len = bvlc6_encode_delete_foreign_device(
+        &mtu[0], sizeof(mtu), TD.Device_ID, &addr);
+    result = bvlc6_bbmd_enabled_handler(&TD.BIP6_Addr, &src, mtu, mtu_len);
+    assert(result == 0);
+    assert(bvlc6_fdt_count() == (MAX_FD6_ENTRIES - 12));
+    assert(bvlc6_fdt_seconds_remaining(&addr) == 0);
+    result = bvlc6_bbmd_enabled_handler(&TD.BIP6_Addr, &src, mtu, mtu_len);
+    assert(Test_Sent_Message_Type == BVLC6_RESULT);
+    assert(bvlc6_bdt_entry_delete(&peer));
+    assert(!bvlc6_bdt_entry_delete(&peer));
+    assert(bvlc6_bdt_count() == peers);
+    test_cleanup();
+}
+#endif
+
 static void test_BBMD_Result(void)
 {
     int result = 0;
@@ -305,6 +542,10 @@ static void test_BBMD_Result(void)
 
 int main(void)
 {
+    test_VMAC_Table();
+#if BBMD6_ENABLED
+    test_BBMD_Tables();
+#endif
     test_BBMD_Result();
     test_Execute_Virtual_Address_Resolution();
     test_Initiate_Original_Broadcast_NPDU();
@@ -10,6 +10,8 @@
 
 #include <zephyr/ztest.h>
 #include <bacnet/basic/object/device.h>
+#include <bacnet/basic/object/ai.h>
+#include <bacnet/basic/object/property_cache.h>
 #include <bacnet/bactext.h>
 
 /**
@@ -117,6 +119,82 @@ static void test_Device_Data_Sharing(void)
     }
 }
 
+/**
+ * @brief Read the object-name property through the device object
+ */
+static bool test_Device_Object_Name_Read(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    const char *name)
+{
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    int len;
+
+    rpdata.object_type = object_type;
+    rpdata.object_instance = object_instance;
+    rpdata.object_property = PROP_OBJECT_NAME;
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    rpdata.application_data = apdu;
+    rpdata.application_data_len = sizeof(apdu);
+    len = Device_Read_Property(&rpdata);
+    if (len <= 0) {
+        return false;
+    }
+    len = bacapp_decode_application_data(apdu, len, &value);
+    if ((len <= 0) || (value.tag != BACNET_APPLICATION_TAG_CHARACTER_STRING)) {
+        return false;
+    }
+
+    return characterstring_ansi_same(&value.type.Character_String, name);
+}
+
+/**
+ * @brief Test the property cache through the device object
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, test_Device_Property_Cache)
+#else
+static void test_Device_Property_Cache(void)
+#endif
+{
+    const uint32_t instance = 1;
+    bool status = false;
+
+    Device_Init(NULL);
+    Analog_Input_Create(instance);
+    status = Analog_Input_Name_Set(instance, "AI-1");
+    zassert_true(status, NULL);
+    /* not cached until enabled */
+    status =
+        test_Device_Object_Name_Read(OBJECT_ANALOG_INPUT, instance, "AI-1");
+    zassert_true(status, NULL);
+    zassert_equal(Property_Cache_Count(), 0, NULL);
+    Property_Cache_Enable(OBJECT_ANALOG_INPUT, true);
+    status =
+        test_Device_Object_Name_Read(OBJECT_ANALOG_INPUT, instance, "AI-1");
+    zassert_true(status, NULL);
+    zassert_equal(Property_Cache_Count(), 1, NULL);
+    status =
+        test_Device_Object_Name_Read(OBJECT_ANALOG_INPUT, instance, "AI-1");
+    zassert_true(status, NULL);
+    /* the setter invalidates the cached value */
+    status = Analog_Input_Name_Set(instance, "AI-2");
+    zassert_true(status, NULL);
+    status =
+        test_Device_Object_Name_Read(OBJECT_ANALOG_INPUT, instance, "AI-2");
+    zassert_true(status, NULL);
+    /* deleting the object drops its cached values */
+    status = Analog_Input_Delete(instance);
+    zassert_true(status, NULL);
+    zassert_equal(Property_Cache_Count(), 0, NULL);
+    status =
+        test_Device_Object_Name_Read(OBJECT_ANALOG_INPUT, instance, "AI-2");
+    zassert_false(status, NULL);
+    Property_Cache_Enable(OBJECT_ANALOG_INPUT, false);
+    Property_Cache_Cleanup();
+}
+
 /**
  * @brief Test basic API
  */
@@ -220,7 +298,8 @@ ZTEST_SUITE(device_tests, NULL, NULL, NULL, NULL, NULL);
 void test_main(void)
 {
     ztest_test_suite(device_tests, ztest_unit_test(testDevice),
-        ztest_unit_test(test_Device_Data_Sharing));
+        ztest_unit_test(test_Device_Data_Sharing),
+        ztest_unit_test(test_Device_Property_Cache));
 
     ztest_run_test_suite(device_tests);
 }
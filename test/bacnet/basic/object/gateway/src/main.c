@@ -0,0 +1,159 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+/* @file
+ * @brief test BACnet gateway routed Device APIs
+ */
+
+#include <zephyr/ztest.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/basic/object/device.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+#define TEST_DNET 4000
+#define TEST_GATEWAY_INSTANCE 1000
+#define TEST_ROUTED_DEVICES 2000
+
+/**
+ * @brief Count the Devices found for a destination address
+ */
+static unsigned test_Routed_Device_Count(BACNET_ADDRESS *dest)
+{
+    int DNET_list[2] = { TEST_DNET, -1 };
+    int cursor = 0;
+    unsigned count = 0;
+
+    while (Routed_Device_GetNext(dest, DNET_list, &cursor)) {
+        count++;
+        if (cursor < 0) {
+            break;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Test the table of routed Devices with many Devices
+ */
+static void test_Routed_Device_Table(void)
+{
+    int DNET_list[2] = { TEST_DNET, -1 };
+    BACNET_ADDRESS dest = { 0 };
+    DEVICE_OBJECT_DATA *pDev = NULL;
+    uint32_t instance = 0;
+    uint16_t idx = 0;
+    int cursor = 0;
+    bool status = false;
+    int i = 0;
+
+    Device_Init(NULL);
+    Routing_Device_Init(TEST_GATEWAY_INSTANCE);
+    for (i = 1; i <= TEST_ROUTED_DEVICES; i++) {
+        idx = Add_Routed_Device(TEST_GATEWAY_INSTANCE + i, NULL, NULL);
+        zassert_equal(idx, i, NULL);
+        pDev = Get_Routed_Device_Object(i);
+        zassert_not_null(pDev, NULL);
+        pDev->bacDevAddr.net = TEST_DNET;
+        encode_unsigned24(&pDev->bacDevAddr.adr[0], TEST_GATEWAY_INSTANCE + i);
+        pDev->bacDevAddr.len = 3;
+    }
+    zassert_is_null(Get_Routed_Device_Object(TEST_ROUTED_DEVICES + 1), NULL);
+    /* each routed Device is found by its virtual MAC address */
+    dest.net = TEST_DNET;
+    dest.len = 3;
+    for (i = 1; i <= TEST_ROUTED_DEVICES; i += 97) {
+        instance = TEST_GATEWAY_INSTANCE + i;
+        encode_unsigned24(&dest.adr[0], instance);
+        cursor = 0;
+        status = Routed_Device_GetNext(&dest, DNET_list, &cursor);
+        zassert_true(status, NULL);
+        zassert_equal(cursor, -1, NULL);
+        zassert_equal(Routed_Device_Object_Instance_Number(), instance, NULL);
+    }
+    encode_unsigned24(&dest.adr[0], 1);
+    cursor = 0;
+    zassert_false(Routed_Device_GetNext(&dest, DNET_list, &cursor), NULL);
+    zassert_equal(cursor, -1, NULL);
+    /* a changed address is found, and the old one is not */
+    pDev = Get_Routed_Device_Object(7);
+    encode_unsigned24(&pDev->bacDevAddr.adr[0], 0xABCDEF);
+    encode_unsigned24(&dest.adr[0], TEST_GATEWAY_INSTANCE + 7);
+    zassert_equal(test_Routed_Device_Count(&dest), 0, NULL);
+    encode_unsigned24(&dest.adr[0], 0xABCDEF);
+    zassert_equal(test_Routed_Device_Count(&dest), 1, NULL);
+    zassert_equal(Routed_Device_Object_Instance_Number(),
+        TEST_GATEWAY_INSTANCE + 7, NULL);
+    /* broadcasts reach every Device */
+    dest.len = 0;
+    zassert_equal(test_Routed_Device_Count(&dest), TEST_ROUTED_DEVICES, NULL);
+    dest.net = BACNET_BROADCAST_NETWORK;
+    zassert_equal(
+        test_Routed_Device_Count(&dest), TEST_ROUTED_DEVICES + 1, NULL);
+    /* no routing information is for the gateway */
+    dest.net = 0;
+    zassert_equal(test_Routed_Device_Count(&dest), 1, NULL);
+    zassert_equal(
+        Routed_Device_Object_Instance_Number(), TEST_GATEWAY_INSTANCE, NULL);
+    /* each Device is found by its instance number */
+    instance = TEST_GATEWAY_INSTANCE + 1234;
+    zassert_true(Routed_Device_Valid_Object_Instance_Number(instance), NULL);
+    zassert_equal(Routed_Device_Object_Instance_Number(), instance, NULL);
+    zassert_false(Routed_Device_Valid_Object_Instance_Number(1), NULL);
+    /* and by its new instance number once it is changed */
+    pDev = Get_Routed_Device_Object(5);
+    zassert_not_null(pDev, NULL);
+    status = Routed_Device_Set_Object_Instance_Number(BACNET_MAX_INSTANCE);
+    zassert_true(status, NULL);
+    zassert_true(
+        Routed_Device_Valid_Object_Instance_Number(BACNET_MAX_INSTANCE), NULL);
+    zassert_equal(Get_Routed_Device_Object(-1), pDev, NULL);
+    zassert_false(Routed_Device_Valid_Object_Instance_Number(
+                      TEST_GATEWAY_INSTANCE + 5),
+        NULL);
+    /* Devices are visited in instance order within a range */
+    instance = TEST_GATEWAY_INSTANCE + 3;
+    zassert_true(
+        Routed_Device_Instance_Next(&instance, TEST_GATEWAY_INSTANCE + 6),
+        NULL);
+    zassert_equal(instance, TEST_GATEWAY_INSTANCE + 3, NULL);
+    zassert_equal(Routed_Device_Object_Instance_Number(), instance, NULL);
+    instance++;
+    zassert_true(
+        Routed_Device_Instance_Next(&instance, TEST_GATEWAY_INSTANCE + 6),
+        NULL);
+    zassert_equal(instance, TEST_GATEWAY_INSTANCE + 4, NULL);
+    instance++;
+    zassert_true(
+        Routed_Device_Instance_Next(&instance, TEST_GATEWAY_INSTANCE + 6),
+        NULL);
+    zassert_equal(instance, TEST_GATEWAY_INSTANCE + 6, NULL);
+    instance++;
+    zassert_false(
+        Routed_Device_Instance_Next(&instance, TEST_GATEWAY_INSTANCE + 6),
+        NULL);
+    instance = TEST_GATEWAY_INSTANCE + TEST_ROUTED_DEVICES + 1;
+    zassert_true(
+        Routed_Device_Instance_Next(&instance, BACNET_MAX_INSTANCE), NULL);
+    zassert_equal(instance, BACNET_MAX_INSTANCE, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(gateway_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        gateway_tests, ztest_unit_test(test_Routed_Device_Table));
+
+    ztest_run_test_suite(gateway_tests);
+}
+#endif
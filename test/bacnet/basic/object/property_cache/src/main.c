@@ -0,0 +1,185 @@
+/**
+ * @file
+ * @brief Unit test for the cache of encoded property values
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/basic/object/property_cache.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test storing, reading and invalidating cached values
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(property_cache_tests, testPropertyCache)
+#else
+static void testPropertyCache(void)
+#endif
+{
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    /* encoded CharacterString "AI-1" */
+    uint8_t value[] = { 0x75, 0x05, 0x00, 'A', 'I', '-', '1' };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    int value_len = 0;
+    int len = 0;
+    bool status = false;
+
+    zassert_true(Property_Cache_Property(PROP_OBJECT_NAME), NULL);
+    zassert_true(Property_Cache_Property(PROP_PROPERTY_LIST), NULL);
+    zassert_false(Property_Cache_Property(PROP_PRESENT_VALUE), NULL);
+    value_len = sizeof(value);
+    rpdata.object_type = OBJECT_ANALOG_INPUT;
+    rpdata.object_instance = 1;
+    rpdata.object_property = PROP_OBJECT_NAME;
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    rpdata.application_data = value;
+    rpdata.application_data_len = sizeof(value);
+    /* disabled by default */
+    zassert_false(Property_Cache_Enabled(OBJECT_ANALOG_INPUT), NULL);
+    status = Property_Cache_Store(&rpdata, value_len);
+    zassert_false(status, NULL);
+    Property_Cache_Enable(OBJECT_ANALOG_INPUT, true);
+    zassert_true(Property_Cache_Enabled(OBJECT_ANALOG_INPUT), NULL);
+    zassert_false(Property_Cache_Enabled(OBJECT_ANALOG_VALUE), NULL);
+    status = Property_Cache_Store(&rpdata, value_len);
+    zassert_true(status, NULL);
+    zassert_equal(Property_Cache_Count(), 1, NULL);
+    /* hit */
+    rpdata.application_data = apdu;
+    len = Property_Cache_Read(&rpdata);
+    zassert_equal(len, value_len, NULL);
+    zassert_mem_equal(apdu, value, value_len, NULL);
+    /* too small of a buffer is a miss */
+    rpdata.application_data_len = value_len - 1;
+    len = Property_Cache_Read(&rpdata);
+    zassert_equal(len, 0, NULL);
+    rpdata.application_data_len = sizeof(apdu);
+    /* array index is a miss */
+    rpdata.array_index = 1;
+    len = Property_Cache_Read(&rpdata);
+    zassert_equal(len, 0, NULL);
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    /* other instance is a miss */
+    rpdata.object_instance = 2;
+    len = Property_Cache_Read(&rpdata);
+    zassert_equal(len, 0, NULL);
+    rpdata.object_instance = 1;
+    /* uncached property is not stored */
+    rpdata.object_property = PROP_PRESENT_VALUE;
+    status = Property_Cache_Store(&rpdata, value_len);
+    zassert_false(status, NULL);
+    rpdata.object_property = PROP_OBJECT_NAME;
+    /* invalidate a single property */
+    Property_Cache_Invalidate(OBJECT_ANALOG_INPUT, 1, PROP_DESCRIPTION);
+    len = Property_Cache_Read(&rpdata);
+    zassert_equal(len, value_len, NULL);
+    Property_Cache_Invalidate(OBJECT_ANALOG_INPUT, 1, PROP_OBJECT_NAME);
+    len = Property_Cache_Read(&rpdata);
+    zassert_equal(len, 0, NULL);
+    /* invalidate the whole object */
+    rpdata.application_data = value;
+    status = Property_Cache_Store(&rpdata, value_len);
+    zassert_true(status, NULL);
+    Property_Cache_Invalidate(OBJECT_ANALOG_INPUT, 1, PROP_ALL);
+    zassert_equal(Property_Cache_Count(), 0, NULL);
+    /* invalidate the object type */
+    rpdata.object_instance = 1;
+    status = Property_Cache_Store(&rpdata, value_len);
+    zassert_true(status, NULL);
+    rpdata.object_instance = 2;
+    status = Property_Cache_Store(&rpdata, value_len);
+    zassert_true(status, NULL);
+    zassert_equal(Property_Cache_Count(), 2, NULL);
+    Property_Cache_Invalidate_Object_Type(OBJECT_ANALOG_INPUT);
+    zassert_equal(Property_Cache_Count(), 0, NULL);
+    /* disable drops the values */
+    status = Property_Cache_Store(&rpdata, value_len);
+    zassert_true(status, NULL);
+    Property_Cache_Enable(OBJECT_ANALOG_INPUT, false);
+    zassert_equal(Property_Cache_Count(), 0, NULL);
+    rpdata.application_data = apdu;
+    len = Property_Cache_Read(&rpdata);
+    zassert_equal(len, 0, NULL);
+    Property_Cache_Cleanup();
+}
+
+static int Lock_Depth;
+static int Lock_Depth_Max;
+static int Lock_Count;
+
+static void test_lock(void)
+{
+    Lock_Depth++;
+    Lock_Count++;
+    if (Lock_Depth > Lock_Depth_Max) {
+        Lock_Depth_Max = Lock_Depth;
+    }
+}
+
+static void test_unlock(void)
+{
+    Lock_Depth--;
+}
+
+/**
+ * @brief Test that the lock functions are balanced and not nested
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(property_cache_tests, testPropertyCacheLock)
+#else
+static void testPropertyCacheLock(void)
+#endif
+{
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    uint8_t value[] = { 0x75, 0x05, 0x00, 'A', 'I', '-', '1' };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    int len = 0;
+
+    Property_Cache_Lock_Set(test_lock, test_unlock);
+    Property_Cache_Enable(OBJECT_ANALOG_INPUT, true);
+    rpdata.object_type = OBJECT_ANALOG_INPUT;
+    rpdata.object_instance = 1;
+    rpdata.object_property = PROP_OBJECT_NAME;
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    rpdata.application_data = value;
+    rpdata.application_data_len = sizeof(value);
+    zassert_true(Property_Cache_Store(&rpdata, sizeof(value)), NULL);
+    zassert_equal(Lock_Depth, 0, NULL);
+    rpdata.application_data = apdu;
+    rpdata.application_data_len = sizeof(apdu);
+    len = Property_Cache_Read(&rpdata);
+    zassert_equal(len, sizeof(value), NULL);
+    zassert_equal(Lock_Depth, 0, NULL);
+    Property_Cache_Invalidate(OBJECT_ANALOG_INPUT, 1, PROP_ALL);
+    zassert_equal(Property_Cache_Count(), 0, NULL);
+    /* disable drops the values of the type with the lock held once */
+    Property_Cache_Enable(OBJECT_ANALOG_INPUT, false);
+    zassert_equal(Lock_Depth, 0, NULL);
+    Property_Cache_Cleanup();
+    zassert_equal(Lock_Depth, 0, NULL);
+    zassert_true(Lock_Count >= 7, NULL);
+    zassert_equal(Lock_Depth_Max, 1, NULL);
+    Property_Cache_Lock_Set(NULL, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(property_cache_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        property_cache_tests, ztest_unit_test(testPropertyCache),
+        ztest_unit_test(testPropertyCacheLock));
+
+    ztest_run_test_suite(property_cache_tests);
+}
+#endif
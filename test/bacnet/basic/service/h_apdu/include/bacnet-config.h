@@ -0,0 +1,19 @@
+/**
+ * @file
+ * @brief compile-time service dispatch configuration for the APDU
+ *  handler unit test
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_CONFIG_H_TEST
+#define BACNET_CONFIG_H_TEST
+
+#define BACNET_CONFIRMED_SERVICE_HANDLERS(X)                  \
+    X(SERVICE_CONFIRMED_READ_PROPERTY, handler_read_property) \
+    X(SERVICE_CONFIRMED_DEVICE_COMMUNICATION_CONTROL,         \
+        handler_device_communication_control)
+#define BACNET_UNCONFIRMED_SERVICE_HANDLERS(X) \
+    X(SERVICE_UNCONFIRMED_WHO_IS, handler_who_is)
+#define BACNET_UNRECOGNIZED_SERVICE_HANDLER handler_unrecognized_service
+
+#endif
@@ -0,0 +1,160 @@
+/**
+ * @file
+ * @brief test the APDU handler with the compile-time service dispatch
+ *  of include/bacnet-config.h, shared with the h_apdu_unrecognized build
+ *  that sets the unrecognized service handler at runtime
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/ztest.h>
+#include "bacnet/bacdef.h"
+#include "bacnet/dcc.h"
+#include "bacnet/basic/services.h"
+#include "bacnet/basic/tsm/tsm.h"
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* number of calls to each handler stub */
+static unsigned Read_Property_Count;
+static unsigned DCC_Count;
+static unsigned Unrecognized_Count;
+static unsigned Who_Is_Count;
+static unsigned Write_Property_Count;
+
+/* test stub functions */
+void tsm_free_invoke_id(uint8_t invokeID)
+{
+    (void)invokeID;
+}
+
+/* test stub functions, listed in bacnet-config.h */
+void handler_read_property(uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    (void)service_request;
+    (void)service_len;
+    (void)src;
+    (void)service_data;
+    Read_Property_Count++;
+}
+
+void handler_device_communication_control(uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    (void)service_request;
+    (void)service_len;
+    (void)src;
+    (void)service_data;
+    DCC_Count++;
+}
+
+void handler_unrecognized_service(uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    (void)service_request;
+    (void)service_len;
+    (void)src;
+    (void)service_data;
+    Unrecognized_Count++;
+}
+
+void handler_who_is(
+    uint8_t *service_request, uint16_t service_len, BACNET_ADDRESS *src)
+{
+    (void)service_request;
+    (void)service_len;
+    (void)src;
+    Who_Is_Count++;
+}
+
+/* not listed in bacnet-config.h */
+static void test_handler_write_property(uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    (void)service_request;
+    (void)service_len;
+    (void)src;
+    (void)service_data;
+    Write_Property_Count++;
+}
+
+static void testServiceDispatch(void)
+{
+    BACNET_ADDRESS src = { 0 };
+    /* confirmed ReadProperty, WriteProperty and DCC requests */
+    uint8_t read_property[] = { 0x00, 0x05, 0x01, 0x0C, 0x0C, 0x02, 0x00,
+        0x00, 0x01, 0x19, 0x4D };
+    uint8_t write_property[] = { 0x00, 0x05, 0x02, 0x0F, 0x0C, 0x00, 0x80,
+        0x00, 0x01, 0x19, 0x55, 0x3E, 0x44, 0x42, 0x90, 0x00, 0x00, 0x3F };
+    uint8_t dcc[] = { 0x00, 0x05, 0x03, 0x11, 0x19, 0x00 };
+    /* unconfirmed Who-Is and I-Am requests */
+    uint8_t who_is[] = { 0x10, 0x08 };
+    uint8_t i_am[] = { 0x10, 0x00, 0xC4, 0x02, 0x00, 0x00, 0x01, 0x22, 0x01,
+        0xE0, 0x91, 0x00, 0x21, 0x0F };
+
+#if !defined(BACNET_UNRECOGNIZED_SERVICE_HANDLER)
+    /* the unrecognized service handler is still set at runtime */
+    apdu_set_unrecognized_service_handler_handler(
+        handler_unrecognized_service);
+#endif
+    /* the handlers are fixed at compile time */
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_WRITE_PROPERTY, test_handler_write_property);
+    apdu_set_confirmed_handler(SERVICE_CONFIRMED_READ_PROPERTY, NULL);
+    apdu_handler(&src, read_property, sizeof(read_property));
+    zassert_equal(Read_Property_Count, 1, NULL);
+    apdu_handler(&src, write_property, sizeof(write_property));
+    zassert_equal(Write_Property_Count, 0, NULL);
+    zassert_equal(Unrecognized_Count, 1, NULL);
+    apdu_handler(&src, who_is, sizeof(who_is));
+    zassert_equal(Who_Is_Count, 1, NULL);
+    apdu_handler(&src, i_am, sizeof(i_am));
+    zassert_equal(Who_Is_Count, 1, NULL);
+    /* only DCC is handled while communication is disabled */
+    zassert_true(dcc_set_status_duration(COMMUNICATION_DISABLE, 0), NULL);
+    apdu_handler(&src, read_property, sizeof(read_property));
+    zassert_equal(Read_Property_Count, 1, NULL);
+    apdu_handler(&src, who_is, sizeof(who_is));
+    zassert_equal(Who_Is_Count, 1, NULL);
+    apdu_handler(&src, dcc, sizeof(dcc));
+    zassert_equal(DCC_Count, 1, NULL);
+    zassert_true(dcc_set_status_duration(COMMUNICATION_ENABLE, 0), NULL);
+}
+
+static void testServiceSupported(void)
+{
+    zassert_true(apdu_service_supported(SERVICE_SUPPORTED_READ_PROPERTY),
+        NULL);
+    zassert_true(apdu_service_supported(
+                     SERVICE_SUPPORTED_DEVICE_COMMUNICATION_CONTROL),
+        NULL);
+    zassert_true(apdu_service_supported(SERVICE_SUPPORTED_WHO_IS), NULL);
+    zassert_false(apdu_service_supported(SERVICE_SUPPORTED_WRITE_PROPERTY),
+        NULL);
+    zassert_false(apdu_service_supported(SERVICE_SUPPORTED_I_AM), NULL);
+}
+
+/**
+ * @}
+ */
+
+void test_main(void)
+{
+    ztest_test_suite(h_apdu_tests, ztest_unit_test(testServiceDispatch),
+        ztest_unit_test(testServiceSupported));
+
+    ztest_run_test_suite(h_apdu_tests);
+}
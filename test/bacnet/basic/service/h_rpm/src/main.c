@@ -0,0 +1,268 @@
+/**
+ * @file
+ * @brief test the single pass encoding of the ReadPropertyMultiple response
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/rpm.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/object/netport.h"
+#include "bacnet/basic/services.h"
+#include "bacnet/datalink/datalink.h"
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* number of calls to Device_Read_Property() */
+static unsigned Read_Property_Count;
+
+/* test stub functions */
+uint8_t Handler_Transmit_Buffer[MAX_PDU];
+
+int datalink_send_pdu(BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)dest;
+    (void)npdu_data;
+    (void)pdu;
+
+    return (int)pdu_len;
+}
+
+void datalink_get_my_address(BACNET_ADDRESS *my_address)
+{
+    (void)my_address;
+}
+
+int bacapp_data_len(
+    uint8_t *apdu, unsigned apdu_len_max, BACNET_PROPERTY_ID property)
+{
+    (void)apdu;
+    (void)apdu_len_max;
+    (void)property;
+
+    return 0;
+}
+
+uint32_t Device_Object_Instance_Number(void)
+{
+    return 1234;
+}
+
+uint32_t Network_Port_Index_To_Instance(unsigned find_index)
+{
+    return find_index;
+}
+
+bool Device_Valid_Object_Id(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    return (object_type == OBJECT_ANALOG_INPUT) && (object_instance == 1);
+}
+
+void Device_Objects_Property_List(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    struct special_property_list_t *pPropertyList)
+{
+    (void)object_type;
+    (void)object_instance;
+    memset(pPropertyList, 0, sizeof(*pPropertyList));
+}
+
+/**
+ * @brief Read a property of Analog Input 1: the Present_Value is read,
+ *  and the Description fails after the object wrote part of its value.
+ */
+int Device_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    int len = BACNET_STATUS_ERROR;
+
+    Read_Property_Count++;
+    if (!Device_Valid_Object_Id(
+            rpdata->object_type, rpdata->object_instance)) {
+        return BACNET_STATUS_ERROR;
+    }
+    switch (rpdata->object_property) {
+        case PROP_PRESENT_VALUE:
+            if (rpdata->application_data_len < 5) {
+                rpdata->error_code =
+                    ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+                return BACNET_STATUS_ABORT;
+            }
+            len = encode_application_real(rpdata->application_data, 1.5f);
+            break;
+        case PROP_DESCRIPTION:
+            /* leave some octets behind */
+            memset(rpdata->application_data, 0xFF,
+                rpdata->application_data_len < 4
+                    ? rpdata->application_data_len
+                    : 4);
+            rpdata->error_class = ERROR_CLASS_PROPERTY;
+            rpdata->error_code = ERROR_CODE_READ_ACCESS_DENIED;
+            break;
+        default:
+            rpdata->error_class = ERROR_CLASS_PROPERTY;
+            rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
+            break;
+    }
+
+    return len;
+}
+
+/**
+ * @brief Encode the request for Analog Input 1 Present_Value and
+ *  Description, and Analog Input 2 Present_Value
+ * @param apdu - buffer for the service request
+ * @return number of octets in the service request
+ */
+static int test_rpm_request_encode(uint8_t *apdu)
+{
+    int len = 0;
+
+    len += rpm_encode_apdu_object_begin(&apdu[len], OBJECT_ANALOG_INPUT, 1);
+    len += rpm_encode_apdu_object_property(
+        &apdu[len], PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+    len += rpm_encode_apdu_object_property(
+        &apdu[len], PROP_DESCRIPTION, BACNET_ARRAY_ALL);
+    len += rpm_encode_apdu_object_end(&apdu[len]);
+    len += rpm_encode_apdu_object_begin(&apdu[len], OBJECT_ANALOG_INPUT, 2);
+    len += rpm_encode_apdu_object_property(
+        &apdu[len], PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+    len += rpm_encode_apdu_object_end(&apdu[len]);
+
+    return len;
+}
+
+/**
+ * @brief Encode the expected response to the request
+ * @param apdu - buffer for the response
+ * @param invoke_id - invoke ID of the request
+ * @return number of octets in the response
+ */
+static int test_rpm_response_encode(uint8_t *apdu, uint8_t invoke_id)
+{
+    BACNET_RPM_DATA rpmdata = { 0 };
+    uint8_t value[5] = { 0 };
+    int value_len;
+    int len = 0;
+
+    value_len = encode_application_real(value, 1.5f);
+    len += rpm_ack_encode_apdu_init(&apdu[len], invoke_id);
+    rpmdata.object_type = OBJECT_ANALOG_INPUT;
+    rpmdata.object_instance = 1;
+    len += rpm_ack_encode_apdu_object_begin(&apdu[len], &rpmdata);
+    len += rpm_ack_encode_apdu_object_property(
+        &apdu[len], PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+    len += rpm_ack_encode_apdu_object_property_value(
+        &apdu[len], value, value_len);
+    len += rpm_ack_encode_apdu_object_property(
+        &apdu[len], PROP_DESCRIPTION, BACNET_ARRAY_ALL);
+    len += rpm_ack_encode_apdu_object_property_error(
+        &apdu[len], ERROR_CLASS_PROPERTY, ERROR_CODE_READ_ACCESS_DENIED);
+    len += rpm_ack_encode_apdu_object_end(&apdu[len]);
+    rpmdata.object_instance = 2;
+    len += rpm_ack_encode_apdu_object_begin(&apdu[len], &rpmdata);
+    len += rpm_ack_encode_apdu_object_property(
+        &apdu[len], PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+    len += rpm_ack_encode_apdu_object_property_error(
+        &apdu[len], ERROR_CLASS_OBJECT, ERROR_CODE_UNKNOWN_OBJECT);
+    len += rpm_ack_encode_apdu_object_end(&apdu[len]);
+
+    return len;
+}
+
+static void testRPMEncode(void)
+{
+    uint8_t request[MAX_APDU] = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t test_apdu[MAX_APDU] = { 0 };
+    BACNET_CONFIRMED_SERVICE_DATA service_data = { 0 };
+    int request_len;
+    int apdu_len;
+    int test_len;
+
+    service_data.invoke_id = 7;
+    service_data.max_resp = MAX_APDU;
+    request_len = test_rpm_request_encode(request);
+    test_len = test_rpm_response_encode(test_apdu, service_data.invoke_id);
+    /* each property is read once, directly into the response, and an
+       error rolls back anything the object left behind */
+    Read_Property_Count = 0;
+    apdu_len = handler_read_property_multiple_encode(
+        request, request_len, &service_data, apdu, sizeof(apdu));
+    zassert_equal(apdu_len, test_len, "len=%d", apdu_len);
+    zassert_mem_equal(apdu, test_apdu, test_len, NULL);
+    zassert_equal(Read_Property_Count, 3, NULL);
+    /* exactly enough room */
+    apdu_len = handler_read_property_multiple_encode(
+        request, request_len, &service_data, apdu, test_len);
+    zassert_equal(apdu_len, test_len, "len=%d", apdu_len);
+    zassert_mem_equal(apdu, test_apdu, test_len, NULL);
+}
+
+static void testRPMEncodeBufferFull(void)
+{
+    uint8_t request[MAX_APDU] = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t test_apdu[MAX_APDU] = { 0 };
+    BACNET_CONFIRMED_SERVICE_DATA service_data = { 0 };
+    int request_len;
+    int apdu_len;
+    int test_len;
+    size_t apdu_size;
+
+    service_data.invoke_id = 7;
+    service_data.max_resp = MAX_APDU;
+    request_len = test_rpm_request_encode(request);
+    test_len = test_rpm_response_encode(test_apdu, service_data.invoke_id);
+    /* any response that runs out of room is an abort */
+    for (apdu_size = 3; apdu_size < (size_t)test_len; apdu_size++) {
+        memset(apdu, 0, sizeof(apdu));
+        apdu_len = handler_read_property_multiple_encode(
+            request, request_len, &service_data, apdu, apdu_size);
+        zassert_equal(apdu_len, 3, "size=%u", (unsigned)apdu_size);
+        zassert_equal(apdu[0], PDU_TYPE_ABORT | 1, NULL);
+        zassert_equal(apdu[1], service_data.invoke_id, NULL);
+        zassert_equal(apdu[2], ABORT_REASON_SEGMENTATION_NOT_SUPPORTED,
+            "size=%u", (unsigned)apdu_size);
+    }
+    /* too big for the client */
+    service_data.max_resp = test_len - 1;
+    apdu_len = handler_read_property_multiple_encode(
+        request, request_len, &service_data, apdu, sizeof(apdu));
+    zassert_equal(apdu_len, 3, NULL);
+    zassert_equal(apdu[0], PDU_TYPE_ABORT | 1, NULL);
+    zassert_equal(apdu[2], ABORT_REASON_SEGMENTATION_NOT_SUPPORTED, NULL);
+    /* segmented requests are not supported */
+    service_data.max_resp = MAX_APDU;
+    service_data.segmented_message = true;
+    apdu_len = handler_read_property_multiple_encode(
+        request, request_len, &service_data, apdu, sizeof(apdu));
+    zassert_equal(apdu_len, 3, NULL);
+    zassert_equal(apdu[2], ABORT_REASON_SEGMENTATION_NOT_SUPPORTED, NULL);
+}
+
+/**
+ * @}
+ */
+
+void test_main(void)
+{
+    ztest_test_suite(h_rpm_tests, ztest_unit_test(testRPMEncode),
+        ztest_unit_test(testRPMEncodeBufferFull));
+
+    ztest_run_test_suite(h_rpm_tests);
+}
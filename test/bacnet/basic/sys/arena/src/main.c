@@ -0,0 +1,92 @@
+/**
+ * @file
+ * @brief test the arena bump allocator
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/arena.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Unit Test for the arena allocator
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(arena_tests, testArena)
+#else
+static void testArena(void)
+#endif
+{
+    ARENA_BUFFER arena = { 0 };
+    uint8_t data[64];
+    uint8_t *memory;
+    uint8_t *memory2;
+    size_t used;
+    unsigned i;
+
+    /* no memory */
+    Arena_Init(&arena, NULL, sizeof(data));
+    zassert_is_null(Arena_Alloc(&arena, 1), NULL);
+    zassert_equal(Arena_Available(&arena), 0, NULL);
+    zassert_is_null(Arena_Alloc(NULL, 1), NULL);
+    zassert_equal(Arena_Used(NULL), 0, NULL);
+    /* allocations are zeroed and aligned */
+    memset(data, 0xAA, sizeof(data));
+    Arena_Init(&arena, data, sizeof(data));
+    zassert_equal(Arena_Available(&arena), sizeof(data), NULL);
+    zassert_is_null(Arena_Alloc(&arena, 0), NULL);
+    memory = Arena_Alloc(&arena, 3);
+    zassert_not_null(memory, NULL);
+    for (i = 0; i < 3; i++) {
+        zassert_equal(memory[i], 0, NULL);
+    }
+    memory2 = Arena_Alloc(&arena, 5);
+    zassert_not_null(memory2, NULL);
+    zassert_equal(((uintptr_t)memory) % ARENA_ALIGNMENT, 0, NULL);
+    zassert_equal(((uintptr_t)memory2) % ARENA_ALIGNMENT, 0, NULL);
+    zassert_true(memory2 >= &memory[3], NULL);
+    used = Arena_Used(&arena);
+    zassert_true(used >= 8, NULL);
+    zassert_equal(Arena_Available(&arena), sizeof(data) - used, NULL);
+    /* the arena bounds the memory */
+    zassert_is_null(Arena_Alloc(&arena, sizeof(data)), NULL);
+    zassert_equal(Arena_Used(&arena), used, NULL);
+    while (Arena_Alloc(&arena, ARENA_ALIGNMENT)) {
+        zassert_true(Arena_Used(&arena) <= sizeof(data), NULL);
+    }
+    zassert_true(Arena_Available(&arena) < (2 * ARENA_ALIGNMENT), NULL);
+    used = Arena_Used(&arena);
+    zassert_equal(Arena_Peak(&arena), used, NULL);
+    /* reset releases everything, and keeps the peak */
+    Arena_Reset(&arena);
+    zassert_equal(Arena_Used(&arena), 0, NULL);
+    zassert_equal(Arena_Available(&arena), sizeof(data), NULL);
+    memory2 = Arena_Alloc(&arena, 4);
+    zassert_not_null(memory2, NULL);
+    zassert_equal(Arena_Peak(&arena), used, NULL);
+
+    return;
+}
+/**
+ * @}
+ */
+
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(arena_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(arena_tests,
+     ztest_unit_test(testArena)
+     );
+
+    ztest_run_test_suite(arena_tests);
+}
+#endif
@@ -9,6 +9,7 @@
  */
 
 #include <limits.h>
+#include <string.h>
 #include <zephyr/ztest.h>
 #include <bacnet/basic/sys/fifo.h>
 
@@ -127,6 +128,25 @@ static void testFIFOBuffer(void)
         zassert_equal(test_add_data[0], add_data[index], NULL);
     }
     zassert_true(FIFO_Empty(&test_buffer), NULL);
+    /* test Peek_Data */
+    status = FIFO_Add(&test_buffer, add_data, sizeof(add_data));
+    zassert_true(status, NULL);
+    memset(test_add_data, 0, sizeof(test_add_data));
+    count = FIFO_Peek_Data(&test_buffer, &test_add_data[0], 2);
+    zassert_equal(count, 2, NULL);
+    zassert_equal(FIFO_Count(&test_buffer), sizeof(add_data), NULL);
+    zassert_equal(test_add_data[0], add_data[0], NULL);
+    zassert_equal(test_add_data[1], add_data[1], NULL);
+    count = FIFO_Pull(&test_buffer, NULL, 2);
+    zassert_equal(count, 2, NULL);
+    count = FIFO_Peek_Data(
+        &test_buffer, &test_add_data[0], sizeof(test_add_data));
+    zassert_equal(count, sizeof(add_data) - 2, NULL);
+    for (index = 0; index < count; index++) {
+        zassert_equal(test_add_data[index], add_data[index + 2], NULL);
+    }
+    FIFO_Flush(&test_buffer);
+    zassert_true(FIFO_Empty(&test_buffer), NULL);
     /* test flush */
     status = FIFO_Add(&test_buffer, test_add_data, sizeof(test_add_data));
     zassert_true(status, NULL);
@@ -11,6 +11,7 @@
 #include <zephyr/ztest.h>
 #include <stdlib.h>
 #include <bacnet/datalink/cobs.h>
+#include <bacnet/datalink/mstpdef.h>
 #include <bacnet/basic/sys/bytes.h>
 
 /**
@@ -51,6 +52,78 @@ static void test_COBS_Encode_Decode(void)
     zassert_true(test_buffer_length == sizeof(buffer),
         "COBS encode/decode length fail");
 }
+
+/**
+ * @brief Test the CRC32K of a span of octets against the CRC32K
+ *  of each octet, for spans shorter and longer than eight octets
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(cobs_tests, test_COBS_CRC32K_Span)
+#else
+static void test_COBS_CRC32K_Span(void)
+#endif
+{
+    uint8_t data[64];
+    uint32_t crc, span_crc;
+    unsigned i, length, offset;
+
+    for (i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)((i * 73) + 41);
+    }
+    for (offset = 0; offset < 8; offset++) {
+        for (length = 0; length <= (sizeof(data) - offset); length++) {
+            crc = CRC32K_INITIAL_VALUE;
+            for (i = 0; i < length; i++) {
+                crc = cobs_crc32k(data[offset + i], crc);
+            }
+            span_crc = cobs_crc32k_span(
+                &data[offset], length, CRC32K_INITIAL_VALUE);
+            zassert_equal(crc, span_crc, NULL);
+        }
+    }
+    span_crc = cobs_crc32k_span(NULL, sizeof(data), CRC32K_INITIAL_VALUE);
+    zassert_equal(span_crc, CRC32K_INITIAL_VALUE, NULL);
+}
+
+/**
+ * @brief "Test" to create/log generated CRC32K slice-by-8 tables
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(cobs_tests, testCRC32KCreateTable)
+#else
+static void testCRC32KCreateTable(void)
+#endif
+{
+    static uint32_t table[8][256];
+    int i, n;
+
+    for (i = 0; i < 256; i++) {
+        table[0][i] = cobs_crc32k(i, 0);
+    }
+    for (n = 1; n < 8; n++) {
+        for (i = 0; i < 256; i++) {
+            table[n][i] = (table[n - 1][i] >> 8) ^
+                table[0][table[n - 1][i] & 0xff];
+        }
+    }
+    printf("static const uint32_t CRC32K_Slice[8][256] = {\n");
+    for (n = 0; n < 8; n++) {
+        printf("    {\n");
+        printf("        ");
+        for (i = 0; i < 256; i++) {
+            printf("0x%08x", (unsigned)table[n][i]);
+            if (i == 255) {
+                printf("\n");
+            } else if (!((i + 1) % 6)) {
+                printf(",\n        ");
+            } else {
+                printf(", ");
+            }
+        }
+        printf("    }%s\n", (n == 7) ? "" : ",");
+    }
+    printf("};\n");
+}
 /**
  * @}
  */
@@ -62,7 +135,9 @@ ZTEST_SUITE(cobs_tests, NULL, NULL, NULL, NULL, NULL);
 void test_main(void)
 {
     ztest_test_suite(cobs_tests,
-     ztest_unit_test(test_COBS_Encode_Decode)
+     ztest_unit_test(test_COBS_Encode_Decode),
+     ztest_unit_test(test_COBS_CRC32K_Span),
+     ztest_unit_test(testCRC32KCreateTable)
      );
 
     ztest_run_test_suite(cobs_tests);
@@ -76,6 +76,40 @@ static void testCRC16(void)
     zassert_equal(crc, 0xF0B8, NULL);
 }
 
+/**
+ * @brief Test the CRC16 of a span of data octets against the CRC16
+ *  of each octet, for spans shorter and longer than eight octets
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(crc_tests, testCRC16Span)
+#else
+static void testCRC16Span(void)
+#endif
+{
+    const uint8_t annex[3] = { 0x01, 0x22, 0x30 };
+    uint8_t data[64];
+    uint16_t crc, span_crc;
+    unsigned i, length, offset;
+
+    crc = CRC_Calc_Data_Span(annex, sizeof(annex), 0xffff);
+    zassert_equal(crc, 0x42EF, NULL);
+    crc = CRC_Calc_Data_Span(NULL, sizeof(annex), 0xffff);
+    zassert_equal(crc, 0xffff, NULL);
+    for (i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)((i * 73) + 41);
+    }
+    for (offset = 0; offset < 8; offset++) {
+        for (length = 0; length <= (sizeof(data) - offset); length++) {
+            crc = 0xffff;
+            for (i = 0; i < length; i++) {
+                crc = CRC_Calc_Data(data[offset + i], crc);
+            }
+            span_crc = CRC_Calc_Data_Span(&data[offset], length, 0xffff);
+            zassert_equal(crc, span_crc, NULL);
+        }
+    }
+}
+
 /**
  * @brief "Test" to create/log generated CRC8 table
  */
@@ -131,6 +165,46 @@ static void testCRC16CreateTable(void)
     }
     printf("};\n");
 }
+
+/**
+ * @brief "Test" to create/log generated CRC16 slice-by-8 tables
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(crc_tests, testCRC16CreateSliceTable)
+#else
+static void testCRC16CreateSliceTable(void)
+#endif
+{
+    uint16_t table[8][256];
+    int i, n;
+
+    for (i = 0; i < 256; i++) {
+        table[0][i] = CRC_Calc_Data(i, 0);
+    }
+    for (n = 1; n < 8; n++) {
+        for (i = 0; i < 256; i++) {
+            table[n][i] = (table[n - 1][i] >> 8) ^
+                table[0][table[n - 1][i] & 0xff];
+        }
+    }
+    printf("static const uint16_t DataCRC_Slice[8][256] = {\n");
+    for (n = 0; n < 8; n++) {
+        printf("    {\n");
+        printf("        ");
+        for (i = 0; i < 256; i++) {
+            printf("0x%04x", table[n][i]);
+            if (i == 255) {
+                printf("\n");
+            } else if (!((i + 1) % 9)) {
+                printf(",\n        ");
+            } else {
+                printf(", ");
+            }
+        }
+        printf("    }%s\n", (n == 7) ? "" : ",");
+    }
+    printf("};\n");
+}
 /**
  * @}
  */
@@ -144,8 +218,10 @@ void test_main(void)
     ztest_test_suite(crc_tests,
      ztest_unit_test(testCRC8),
      ztest_unit_test(testCRC16),
+     ztest_unit_test(testCRC16Span),
      ztest_unit_test(testCRC8CreateTable),
-     ztest_unit_test(testCRC16CreateTable)
+     ztest_unit_test(testCRC16CreateTable),
+     ztest_unit_test(testCRC16CreateSliceTable)
      );
 
     ztest_run_test_suite(crc_tests);
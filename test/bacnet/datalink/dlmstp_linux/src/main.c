@@ -0,0 +1,392 @@
+/**
+ * @file
+ * @brief test the reply matching and the queues of the Linux MS/TP datalink
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/npdu.h"
+#include "bacnet/datalink/mstp.h"
+#include "bacnet/datalink/mstpdef.h"
+#include "bacnet/basic/sys/ringbuf.h"
+/* port specific */
+#include "dlmstp_linux.h"
+#include "rs485.h"
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+static SHARED_MSTP_DATA Shared_Data;
+static struct mstp_port_struct_t MSTP_Port;
+/* milliseconds of silence on the line, as seen by the port */
+static uint32_t Silence_Milliseconds;
+/* frames sent, and the type and destination of the last one */
+static unsigned Sent_Frame_Count;
+static uint8_t Sent_Frame_Type;
+static uint8_t Sent_Frame_Destination;
+
+/* confirmed ReadProperty request, invoke ID 0x2A */
+static uint8_t Request_APDU[] = { 0x00, 0x05, 0x2A, 0x0C, 0x0C, 0x02, 0x00,
+    0x00, 0x08, 0x19, 0x55 };
+
+/* test stub functions */
+void RS485_Send_Frame(
+    struct mstp_port_struct_t *mstp_port, uint8_t *buffer, uint16_t nbytes)
+{
+    (void)mstp_port;
+    if (nbytes > 3) {
+        Sent_Frame_Count++;
+        Sent_Frame_Type = buffer[2];
+        Sent_Frame_Destination = buffer[3];
+    }
+}
+
+static uint32_t test_silence_timer(void *pArg)
+{
+    (void)pArg;
+
+    return Silence_Milliseconds;
+}
+
+static void test_silence_timer_reset(void *pArg)
+{
+    (void)pArg;
+    Silence_Milliseconds = 0;
+}
+
+void RS485_Receive_Frame_Data(
+    struct mstp_port_struct_t *mstp_port, unsigned timeout_ms)
+{
+    (void)mstp_port;
+    (void)timeout_ms;
+}
+
+/**
+ * @brief Encode an NPDU for the local network around an APDU
+ * @param pdu - buffer for the NPDU
+ * @param data_expecting_reply - true for a confirmed request
+ * @param apdu - the APDU
+ * @param apdu_len - number of octets in the APDU
+ * @return number of octets in the NPDU
+ */
+static uint16_t test_pdu_encode(uint8_t *pdu,
+    bool data_expecting_reply,
+    const uint8_t *apdu,
+    uint16_t apdu_len)
+{
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int len;
+
+    npdu_encode_npdu_data(
+        &npdu_data, data_expecting_reply, MESSAGE_PRIORITY_NORMAL);
+    len = npdu_encode_pdu(pdu, &dest, &src, &npdu_data);
+    memcpy(&pdu[len], apdu, apdu_len);
+
+    return (uint16_t)(len + apdu_len);
+}
+
+/**
+ * @brief Compare a reply APDU with the confirmed request from node 5
+ * @param apdu - the reply APDU
+ * @param apdu_len - number of octets in the reply APDU
+ * @param dest_address - MS/TP address the reply is sent to
+ * @return true if the reply answers the request
+ */
+static bool test_reply_match(
+    const uint8_t *apdu, uint16_t apdu_len, uint8_t dest_address)
+{
+    uint8_t request[MAX_PDU] = { 0 };
+    uint8_t reply[MAX_PDU] = { 0 };
+    uint16_t request_len;
+    uint16_t reply_len;
+
+    request_len =
+        test_pdu_encode(request, true, Request_APDU, sizeof(Request_APDU));
+    reply_len = test_pdu_encode(reply, false, apdu, apdu_len);
+
+    return dlmstp_compare_data_expecting_reply(
+        request, request_len, 5, reply, reply_len, dest_address);
+}
+
+static void testReplyKeyMatch(void)
+{
+    uint8_t complex_ack[] = { 0x30, 0x2A, 0x0C, 0x0C, 0x02, 0x00, 0x00,
+        0x08, 0x19, 0x55, 0x3E, 0x91, 0x00, 0x3F };
+    uint8_t segmented_ack[] = { 0x38, 0x2A, 0x00, 0x04, 0x0C, 0x0C };
+    uint8_t simple_ack[] = { 0x20, 0x2A, 0x0F };
+    uint8_t error[] = { 0x50, 0x2A, 0x0C, 0x91, 0x02, 0x91, 0x20 };
+    uint8_t reject[] = { 0x60, 0x2A, 0x01 };
+    uint8_t abort[] = { 0x70, 0x2A, 0x04 };
+    uint8_t short_ack[] = { 0x30, 0x2A };
+    uint8_t unconfirmed[] = { 0x10, 0x08 };
+    uint8_t request[MAX_PDU] = { 0 };
+    uint8_t reply[MAX_PDU] = { 0 };
+    uint16_t request_len;
+    uint16_t reply_len;
+
+    zassert_true(test_reply_match(complex_ack, sizeof(complex_ack), 5), NULL);
+    zassert_true(
+        test_reply_match(segmented_ack, sizeof(segmented_ack), 5), NULL);
+    zassert_true(test_reply_match(error, sizeof(error), 5), NULL);
+    /* reject and abort don't have the service choice */
+    zassert_true(test_reply_match(reject, sizeof(reject), 5), NULL);
+    zassert_true(test_reply_match(abort, sizeof(abort), 5), NULL);
+    /* another node, invoke ID, or service */
+    zassert_false(
+        test_reply_match(complex_ack, sizeof(complex_ack), 6), NULL);
+    complex_ack[1] = 0x2B;
+    zassert_false(
+        test_reply_match(complex_ack, sizeof(complex_ack), 5), NULL);
+    zassert_false(test_reply_match(simple_ack, sizeof(simple_ack), 5), NULL);
+    /* not a reply, or too short to be one */
+    zassert_false(test_reply_match(short_ack, sizeof(short_ack), 5), NULL);
+    zassert_false(
+        test_reply_match(unconfirmed, sizeof(unconfirmed), 5), NULL);
+    /* not a confirmed request */
+    request_len =
+        test_pdu_encode(request, false, unconfirmed, sizeof(unconfirmed));
+    reply_len = test_pdu_encode(reply, false, reject, sizeof(reject));
+    zassert_false(dlmstp_compare_data_expecting_reply(
+                      request, request_len, 5, reply, reply_len, 5),
+        NULL);
+}
+
+/**
+ * @brief Initialize the port and its queues, as dlmstp_init() does,
+ *  without opening a serial port
+ */
+static void test_port_init(void)
+{
+    unsigned i;
+
+    memset(&Shared_Data, 0, sizeof(Shared_Data));
+    memset(&MSTP_Port, 0, sizeof(MSTP_Port));
+    MSTP_Port.UserData = &Shared_Data;
+    Ringbuf_Init(&Shared_Data.PDU_Queue, (uint8_t *)&Shared_Data.PDU_Buffer,
+        sizeof(struct mstp_pdu_packet), MSTP_PDU_PACKET_COUNT);
+    for (i = 0; i < MSTP_PDU_PRIORITY_QUEUES; i++) {
+        Ringbuf_Init(&Shared_Data.PDU_Priority_Queue[i],
+            (uint8_t *)&Shared_Data.PDU_Priority_Buffer[i],
+            sizeof(struct mstp_pdu_packet), MSTP_PDU_PRIORITY_PACKET_COUNT);
+    }
+    Ringbuf_Init(&Shared_Data.Reply_Queue,
+        (uint8_t *)&Shared_Data.Reply_Buffer, sizeof(struct mstp_pdu_packet),
+        MSTP_REPLY_PACKET_COUNT);
+    Ringbuf_Init(&Shared_Data.Receive_Queue,
+        (uint8_t *)&Shared_Data.Receive_Buffer, sizeof(DLMSTP_PACKET),
+        MSTP_RECEIVE_PACKET_COUNT);
+    (void)sem_init(&Shared_Data.Receive_Packet_Flag, 0, 0);
+    MSTP_Port.InputBuffer = &Shared_Data.RxBuffer[0];
+    MSTP_Port.InputBufferSize = sizeof(Shared_Data.RxBuffer);
+    MSTP_Port.OutputBuffer = &Shared_Data.TxBuffer[0];
+    MSTP_Port.OutputBufferSize = sizeof(Shared_Data.TxBuffer);
+    MSTP_Port.This_Station = 1;
+    MSTP_Port.SilenceTimer = test_silence_timer;
+    MSTP_Port.SilenceTimerReset = test_silence_timer_reset;
+    MSTP_Port.Treply_delay = DEFAULT_Treply_delay;
+    Silence_Milliseconds = 0;
+    Sent_Frame_Count = 0;
+}
+
+/**
+ * @brief Receive a Data Expecting Reply frame from node 5
+ * @param invoke_id - invoke ID of the confirmed request
+ */
+static void test_port_receive_request(uint8_t invoke_id)
+{
+    Request_APDU[2] = invoke_id;
+    MSTP_Port.FrameType = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
+    MSTP_Port.SourceAddress = 5;
+    MSTP_Port.DataLength = test_pdu_encode(
+        MSTP_Port.InputBuffer, true, Request_APDU, sizeof(Request_APDU));
+    (void)MSTP_Put_Receive(&MSTP_Port);
+}
+
+static void testReplyQueueFull(void)
+{
+    uint8_t complex_ack[] = { 0x30, 0x00, 0x0C, 0x0C, 0x02, 0x00, 0x00,
+        0x08, 0x19, 0x55, 0x3E, 0x91, 0x00, 0x3F };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    uint16_t pdu_len;
+    BACNET_ADDRESS dest = { 0 };
+    uint8_t invoke_id;
+    uint8_t count = MSTP_REPLY_PACKET_COUNT + 2;
+    int len;
+
+    test_port_init();
+    dest.mac[0] = 5;
+    dest.mac_len = 1;
+    /* replies beyond the reply queue go into the normal PDU queue */
+    for (invoke_id = 1; invoke_id <= count; invoke_id++) {
+        complex_ack[1] = invoke_id;
+        pdu_len =
+            test_pdu_encode(pdu, false, complex_ack, sizeof(complex_ack));
+        len = dlmstp_send_pdu(&MSTP_Port, &dest, pdu, pdu_len);
+        zassert_equal(len, pdu_len, NULL);
+    }
+    zassert_equal(dlmstp_transmit_queue_drops(&MSTP_Port), 0, NULL);
+    zassert_equal(
+        Ringbuf_Count(&Shared_Data.Reply_Queue), MSTP_REPLY_PACKET_COUNT,
+        NULL);
+    zassert_equal(Ringbuf_Count(&Shared_Data.PDU_Queue), 2, NULL);
+    /* a queued reply answers its request at once, and its frame is
+       built around the PDU in the queue */
+    test_port_receive_request(1);
+    len = MSTP_Get_Reply(&MSTP_Port, 0);
+    zassert_equal(len, pdu_len + DLMSTP_HEADER_MAX, NULL);
+    zassert_equal(
+        MSTP_Port.OutputBuffer, Shared_Data.Reply_Buffer[0].frame, NULL);
+    zassert_equal(MSTP_Port.OutputBuffer[2],
+        FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, NULL);
+    zassert_equal(MSTP_Port.OutputBuffer[3], 5, NULL);
+    /* the packet is lent until the frame is sent */
+    zassert_equal(Ringbuf_Count(&Shared_Data.Reply_Queue),
+        MSTP_REPLY_PACKET_COUNT, NULL);
+    /* a reply that did not fit is postponed, and sent with the token */
+    test_port_receive_request(count);
+    zassert_equal(MSTP_Get_Reply(&MSTP_Port, 0), 0, NULL);
+    zassert_equal(Ringbuf_Count(&Shared_Data.Reply_Queue),
+        MSTP_REPLY_PACKET_COUNT - 1, NULL);
+    zassert_equal(MSTP_Port.OutputBuffer, Shared_Data.TxBuffer, NULL);
+    for (invoke_id = 2; invoke_id <= count; invoke_id++) {
+        zassert_true(MSTP_Get_Send(&MSTP_Port, 0) > 0, NULL);
+    }
+    zassert_equal(MSTP_Get_Send(&MSTP_Port, 0), 0, NULL);
+    zassert_equal(Ringbuf_Count(&Shared_Data.PDU_Queue), 0, NULL);
+    sem_destroy(&Shared_Data.Receive_Packet_Flag);
+}
+
+static void testTransmitQueueHighWater(void)
+{
+    uint8_t unconfirmed[] = { 0x10, 0x08 };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    uint16_t pdu_len;
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    int len;
+
+    test_port_init();
+    dest.mac[0] = 5;
+    dest.mac_len = 1;
+    /* one normal and two urgent PDUs wait at once */
+    pdu_len = test_pdu_encode(pdu, false, unconfirmed, sizeof(unconfirmed));
+    zassert_equal(dlmstp_send_pdu(&MSTP_Port, &dest, pdu, pdu_len), pdu_len,
+        NULL);
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_URGENT);
+    len = npdu_encode_pdu(pdu, &dest, &src, &npdu_data);
+    memcpy(&pdu[len], unconfirmed, sizeof(unconfirmed));
+    pdu_len = (uint16_t)(len + sizeof(unconfirmed));
+    zassert_equal(dlmstp_send_pdu(&MSTP_Port, &dest, pdu, pdu_len), pdu_len,
+        NULL);
+    zassert_equal(dlmstp_send_pdu(&MSTP_Port, &dest, pdu, pdu_len), pdu_len,
+        NULL);
+    zassert_equal(dlmstp_transmit_queue_high_water(&MSTP_Port), 3, NULL);
+    /* the mark is of all the queues together, not the sum of the most
+       that waited in each of them */
+    zassert_true(MSTP_Get_Send(&MSTP_Port, 0) > 0, NULL);
+    zassert_true(MSTP_Get_Send(&MSTP_Port, 0) > 0, NULL);
+    zassert_true(MSTP_Get_Send(&MSTP_Port, 0) > 0, NULL);
+    zassert_equal(MSTP_Get_Send(&MSTP_Port, 0), 0, NULL);
+    pdu_len = test_pdu_encode(pdu, false, unconfirmed, sizeof(unconfirmed));
+    zassert_equal(dlmstp_send_pdu(&MSTP_Port, &dest, pdu, pdu_len), pdu_len,
+        NULL);
+    zassert_equal(dlmstp_send_pdu(&MSTP_Port, &dest, pdu, pdu_len), pdu_len,
+        NULL);
+    zassert_equal(dlmstp_transmit_queue_high_water(&MSTP_Port), 3, NULL);
+    dlmstp_transmit_queue_statistics_reset(&MSTP_Port);
+    zassert_equal(dlmstp_transmit_queue_high_water(&MSTP_Port), 0, NULL);
+    zassert_equal(dlmstp_send_pdu(&MSTP_Port, &dest, pdu, pdu_len), pdu_len,
+        NULL);
+    zassert_equal(dlmstp_transmit_queue_high_water(&MSTP_Port), 3, NULL);
+    sem_destroy(&Shared_Data.Receive_Packet_Flag);
+}
+
+/**
+ * @brief Receive a Data Expecting Reply frame from node 5 at a slave node,
+ *  and let the slave node state machine pass it to the application
+ * @param invoke_id - invoke ID of the confirmed request
+ */
+static void test_slave_receive_request(uint8_t invoke_id)
+{
+    Request_APDU[2] = invoke_id;
+    MSTP_Port.FrameType = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
+    MSTP_Port.SourceAddress = 5;
+    MSTP_Port.DestinationAddress = MSTP_Port.This_Station;
+    MSTP_Port.DataLength = test_pdu_encode(
+        MSTP_Port.InputBuffer, true, Request_APDU, sizeof(Request_APDU));
+    MSTP_Port.ReceivedValidFrame = true;
+    Silence_Milliseconds = 0;
+    MSTP_Slave_Node_FSM(&MSTP_Port);
+}
+
+static void testSlaveReply(void)
+{
+    uint8_t complex_ack[] = { 0x30, 0x00, 0x0C, 0x0C, 0x02, 0x00, 0x00,
+        0x08, 0x19, 0x55, 0x3E, 0x91, 0x00, 0x3F };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    uint16_t pdu_len;
+    BACNET_ADDRESS dest = { 0 };
+
+    test_port_init();
+    MSTP_Port.This_Station = 200;
+    dest.mac[0] = 5;
+    dest.mac_len = 1;
+    /* an idle slave node waits for a frame */
+    zassert_equal(dlmstp_port_timeout(&MSTP_Port), Tno_token, NULL);
+    /* and polls for the reply to a request */
+    test_slave_receive_request(1);
+    zassert_equal(Ringbuf_Count(&Shared_Data.Receive_Queue), 1, NULL);
+    Silence_Milliseconds = 10;
+    zassert_equal(dlmstp_port_timeout(&MSTP_Port), 0, NULL);
+    MSTP_Slave_Node_FSM(&MSTP_Port);
+    zassert_equal(Sent_Frame_Count, 0, NULL);
+    /* which is sent as soon as the application has it */
+    complex_ack[1] = 1;
+    pdu_len = test_pdu_encode(pdu, false, complex_ack, sizeof(complex_ack));
+    zassert_equal(dlmstp_send_pdu(&MSTP_Port, &dest, pdu, pdu_len), pdu_len,
+        NULL);
+    Silence_Milliseconds = 20;
+    zassert_equal(dlmstp_port_timeout(&MSTP_Port), 0, NULL);
+    MSTP_Slave_Node_FSM(&MSTP_Port);
+    zassert_equal(Sent_Frame_Count, 1, NULL);
+    zassert_equal(
+        Sent_Frame_Type, FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, NULL);
+    zassert_equal(Sent_Frame_Destination, 5, NULL);
+    zassert_equal(
+        dlmstp_port_timeout(&MSTP_Port), Tno_token - Silence_Milliseconds,
+        NULL);
+    /* no reply is possible after Treply_delay */
+    test_slave_receive_request(2);
+    zassert_equal(dlmstp_port_timeout(&MSTP_Port), 0, NULL);
+    Silence_Milliseconds = MSTP_Port.Treply_delay + 1;
+    zassert_equal(
+        dlmstp_port_timeout(&MSTP_Port), Tno_token - Silence_Milliseconds,
+        NULL);
+    sem_destroy(&Shared_Data.Receive_Packet_Flag);
+}
+
+/**
+ * @}
+ */
+
+void test_main(void)
+{
+    ztest_test_suite(dlmstp_linux_tests,
+        ztest_unit_test(testReplyKeyMatch),
+        ztest_unit_test(testReplyQueueFull),
+        ztest_unit_test(testTransmitQueueHighWater),
+        ztest_unit_test(testSlaveReply));
+
+    ztest_run_test_suite(dlmstp_linux_tests);
+}
@@ -102,9 +102,20 @@ uint16_t MSTP_Put_Receive(struct mstp_port_struct_t *mstp_port)
  * @param timeout milliseconds to wait for a packet to send
  * @return amount of PDU data
  */
+/* when true, MSTP_Get_Send() always has a frame to send */
+static bool Test_Send_Pending;
 uint16_t MSTP_Get_Send(struct mstp_port_struct_t *mstp_port, unsigned timeout)
 { /* milliseconds to wait for a packet */
-    return 0;
+    uint8_t data[4] = { 0x01, 0x00, 0x10, 0x08 };
+
+    (void)timeout;
+    if (!Test_Send_Pending) {
+        return 0;
+    }
+
+    return MSTP_Create_Frame(mstp_port->OutputBuffer,
+        mstp_port->OutputBufferSize, FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY,
+        MSTP_BROADCAST_ADDRESS, mstp_port->This_Station, data, sizeof(data));
 }
 
 /**
@@ -141,6 +152,19 @@ static void Timer_Silence_Reset(void *pArg)
     SilenceTime = 0;
 }
 
+/* a free running timer in milliseconds */
+static uint32_t Test_Milliseconds;
+/**
+ * @brief MS/TP state machine calls this to measure the token rotation
+ * @param pArg pointer to the port specific context data
+ * @return amount of time in milliseconds
+ */
+static uint32_t Timer_Milliseconds(void *pArg)
+{
+    (void)pArg;
+    return Test_Milliseconds;
+}
+
 /**
  * @brief MS/TP state machine calls this to send a frame
  * @param mstp_port port specific context data
@@ -557,6 +581,166 @@ static void testReceiveNodeFSM(void)
         FRAME_TYPE_BACNET_EXTENDED_DATA_NOT_EXPECTING_REPLY, NULL);
 }
 
+static void testReceiveFrameData(void)
+{
+    struct mstp_port_struct_t mstp_port = { 0 }; /* port data */
+    uint8_t my_mac = 0x05; /* local MAC address */
+    uint8_t buffer[MAX_MPDU] = { 0 };
+    uint8_t data[MAX_PDU] = { 0 };
+    uint16_t len, data_len, token_len, offset, used;
+    size_t i;
+
+    mstp_port.InputBuffer = &RxBuffer[0];
+    mstp_port.InputBufferSize = sizeof(RxBuffer);
+    mstp_port.OutputBuffer = &TxBuffer[0];
+    mstp_port.OutputBufferSize = sizeof(TxBuffer);
+    mstp_port.SilenceTimer = Timer_Silence;
+    mstp_port.SilenceTimerReset = Timer_Silence_Reset;
+    mstp_port.This_Station = my_mac;
+    mstp_port.Nmax_info_frames = 1;
+    mstp_port.Nmax_master = 127;
+    MSTP_Init(&mstp_port);
+    SilenceTime = 0;
+    for (i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)i;
+    }
+    /* a data frame, a token and a data frame for another node in a block */
+    data_len = MSTP_Create_Frame(buffer, sizeof(buffer),
+        FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, my_mac, 1, data, 200);
+    zassert_true(data_len > 0, NULL);
+    token_len = MSTP_Create_Frame(&buffer[data_len], sizeof(buffer) - data_len,
+        FRAME_TYPE_TOKEN, my_mac, 1, NULL, 0);
+    zassert_true(token_len > 0, NULL);
+    len = data_len + token_len;
+    len += MSTP_Create_Frame(&buffer[len], sizeof(buffer) - len,
+        FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, 7, 1, data, 100);
+    /* feeding stops at the end of each frame */
+    used = MSTP_Receive_Frame_Data(&mstp_port, buffer, len);
+    zassert_equal(used, data_len, NULL);
+    zassert_true(mstp_port.ReceivedValidFrame, NULL);
+    zassert_equal(mstp_port.DataLength, 200, NULL);
+    zassert_equal(memcmp(mstp_port.InputBuffer, data, 200), 0, NULL);
+    zassert_equal(MSTP_Receive_Frame_Data(&mstp_port, &buffer[used], 1), 0,
+        NULL);
+    mstp_port.ReceivedValidFrame = false;
+    offset = used;
+    used = MSTP_Receive_Frame_Data(&mstp_port, &buffer[offset], len - offset);
+    zassert_equal(used, token_len, NULL);
+    zassert_true(mstp_port.ReceivedValidFrame, NULL);
+    zassert_equal(mstp_port.FrameType, FRAME_TYPE_TOKEN, NULL);
+    mstp_port.ReceivedValidFrame = false;
+    offset += used;
+    /* a frame for another node is skipped, one octet at a time */
+    for (i = offset; i < len; i++) {
+        used = MSTP_Receive_Frame_Data(&mstp_port, &buffer[i], 1);
+        zassert_equal(used, 1, NULL);
+    }
+    zassert_true(mstp_port.ReceivedValidFrame, NULL);
+    zassert_equal(mstp_port.DestinationAddress, 7, NULL);
+    mstp_port.ReceivedValidFrame = false;
+    /* a bad data CRC is found over the span */
+    buffer[10] ^= 0xFF;
+    used = MSTP_Receive_Frame_Data(&mstp_port, buffer, data_len);
+    zassert_equal(used, data_len, NULL);
+    zassert_false(mstp_port.ReceivedValidFrame, NULL);
+    zassert_true(mstp_port.ReceivedInvalidFrame, NULL);
+    mstp_port.ReceivedInvalidFrame = false;
+    buffer[10] ^= 0xFF;
+    /* silence in the data aborts the frame */
+    used = MSTP_Receive_Frame_Data(&mstp_port, buffer, 20);
+    zassert_equal(used, 20, NULL);
+    zassert_equal(mstp_port.receive_state, MSTP_RECEIVE_STATE_DATA, NULL);
+    SilenceTime = mstp_port.Tframe_abort + 1;
+    used = MSTP_Receive_Frame_Data(&mstp_port, &buffer[20], data_len - 20);
+    zassert_equal(used, 0, NULL);
+    zassert_true(mstp_port.ReceivedInvalidFrame, NULL);
+    zassert_equal(mstp_port.receive_state, MSTP_RECEIVE_STATE_IDLE, NULL);
+    mstp_port.ReceivedInvalidFrame = false;
+    SilenceTime = 0;
+    /* an extended frame is decoded to the start of the buffer */
+    len = MSTP_Create_Frame(buffer, sizeof(buffer),
+        FRAME_TYPE_BACNET_EXTENDED_DATA_NOT_EXPECTING_REPLY, my_mac, 1, data,
+        600);
+    zassert_true(len > 0, NULL);
+    used = MSTP_Receive_Frame_Data(&mstp_port, buffer, len);
+    zassert_equal(used, len, NULL);
+    zassert_true(mstp_port.ReceivedValidFrame, NULL);
+    zassert_equal(mstp_port.DataLength, 600, NULL);
+    zassert_equal(memcmp(mstp_port.InputBuffer, data, 600), 0, NULL);
+    /* a frame built around data already in place is the same frame */
+    len = MSTP_Create_Frame(buffer, sizeof(buffer),
+        FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY, 7, my_mac, data, 300);
+    zassert_true(len > 0, NULL);
+    memcpy(&RxBuffer[MSTP_FRAME_HEADER_LEN], data, 300);
+    used = MSTP_Create_Frame(RxBuffer, sizeof(RxBuffer),
+        FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY, 7, my_mac,
+        &RxBuffer[MSTP_FRAME_HEADER_LEN], 300);
+    zassert_equal(used, len, NULL);
+    zassert_equal(memcmp(RxBuffer, buffer, len), 0, NULL);
+}
+
+static void testReceiveExtendedFrameMax(void)
+{
+    struct mstp_port_struct_t mstp_port = { 0 }; /* port data */
+    uint8_t my_mac = 0x05; /* local MAC address */
+    uint8_t input[DLMSTP_MPDU_MAX] = { 0 };
+    uint8_t buffer[MSTP_FRAME_HEADER_LEN + DLMSTP_MPDU_MAX] = { 0 };
+    uint8_t data[MAX_PDU] = { 0 };
+    uint16_t len, used, data_len;
+    size_t i;
+
+    mstp_port.InputBuffer = &input[0];
+    mstp_port.InputBufferSize = sizeof(input);
+    mstp_port.OutputBuffer = &TxBuffer[0];
+    mstp_port.OutputBufferSize = sizeof(TxBuffer);
+    mstp_port.SilenceTimer = Timer_Silence;
+    mstp_port.SilenceTimerReset = Timer_Silence_Reset;
+    mstp_port.This_Station = my_mac;
+    mstp_port.Nmax_info_frames = 1;
+    mstp_port.Nmax_master = 127;
+    MSTP_Init(&mstp_port);
+    SilenceTime = 0;
+    for (i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i + 1);
+    }
+    /* the largest data whose encoded frame fits the input buffer */
+    data_len = MAX_PDU;
+    while ((COBS_ENCODED_SIZE(data_len) + COBS_ENCODED_CRC_SIZE) >
+        sizeof(input)) {
+        data_len--;
+    }
+    zassert_true(data_len > (MAX_PDU / 2), NULL);
+    len = MSTP_Create_Frame(buffer, sizeof(buffer),
+        FRAME_TYPE_BACNET_EXTENDED_DATA_NOT_EXPECTING_REPLY, my_mac, 1, data,
+        data_len);
+    zassert_equal(len - MSTP_FRAME_HEADER_LEN,
+        COBS_ENCODED_SIZE(data_len) + COBS_ENCODED_CRC_SIZE, NULL);
+    /* decoded in place, with no room after the encoded data */
+    used = MSTP_Receive_Frame_Data(&mstp_port, buffer, len);
+    zassert_equal(used, len, NULL);
+    zassert_true(mstp_port.ReceivedValidFrame, NULL);
+    zassert_false(mstp_port.ReceivedInvalidFrame, NULL);
+    zassert_equal(mstp_port.DataLength, data_len, NULL);
+    zassert_equal(memcmp(input, data, data_len), 0, NULL);
+    mstp_port.ReceivedValidFrame = false;
+    /* one octet at a time */
+    memset(input, 0, sizeof(input));
+    for (i = 0; i < len; i++) {
+        used = MSTP_Receive_Frame_Data(&mstp_port, &buffer[i], 1);
+        zassert_equal(used, 1, NULL);
+    }
+    zassert_true(mstp_port.ReceivedValidFrame, NULL);
+    zassert_equal(mstp_port.DataLength, data_len, NULL);
+    zassert_equal(memcmp(input, data, data_len), 0, NULL);
+    mstp_port.ReceivedValidFrame = false;
+    /* a bad encoded CRC is found after decoding the data */
+    buffer[len - 1] ^= 0x01;
+    used = MSTP_Receive_Frame_Data(&mstp_port, buffer, len);
+    zassert_equal(used, len, NULL);
+    zassert_false(mstp_port.ReceivedValidFrame, NULL);
+    zassert_true(mstp_port.ReceivedInvalidFrame, NULL);
+}
+
 static void testMasterNodeFSM(void)
 {
     struct mstp_port_struct_t MSTP_Port; /* port data */
@@ -584,6 +768,175 @@ static void testMasterNodeFSM(void)
     /* FIXME: write a unit test for the Master Node State Machine */
 }
 
+/**
+ * @brief Pass the token around masters 1 to 20, and to this node at 5
+ * @param mstp_port port specific context data
+ */
+static void testMasterNodeAdaptiveRotation(struct mstp_port_struct_t *mstp_port)
+{
+    uint8_t src;
+
+    for (src = 1; src <= 20; src++) {
+        mstp_port->master_state = MSTP_MASTER_STATE_IDLE;
+        mstp_port->Next_Station = 6;
+        mstp_port->ReceivedValidFrame = true;
+        mstp_port->FrameType = FRAME_TYPE_TOKEN;
+        mstp_port->SourceAddress = src;
+        mstp_port->DestinationAddress = (src % 20) + 1;
+        if (src == 5) {
+            /* this node uses the token in turn */
+            continue;
+        }
+        MSTP_Master_Node_FSM(mstp_port);
+        if (src == 4) {
+            zassert_equal(
+                mstp_port->master_state, MSTP_MASTER_STATE_USE_TOKEN, NULL);
+            MSTP_Master_Node_FSM(mstp_port);
+        }
+    }
+    mstp_port->master_state = MSTP_MASTER_STATE_IDLE;
+    Test_Milliseconds += 10;
+}
+
+static void testMasterNodeAdaptive(void)
+{
+    struct mstp_port_struct_t MSTP_Port = { 0 }; /* port data */
+    MSTP_TOKEN_ROTATION rotation = { 0 };
+    unsigned i;
+
+    MSTP_Port.InputBuffer = &RxBuffer[0];
+    MSTP_Port.InputBufferSize = sizeof(RxBuffer);
+    MSTP_Port.OutputBuffer = &TxBuffer[0];
+    MSTP_Port.OutputBufferSize = sizeof(TxBuffer);
+    MSTP_Port.Nmax_info_frames = 1;
+    MSTP_Port.Nmax_master = 127;
+    MSTP_Port.SilenceTimer = Timer_Silence;
+    MSTP_Port.SilenceTimerReset = Timer_Silence_Reset;
+    MSTP_Port.MillisecondTimer = Timer_Milliseconds;
+    MSTP_Port.This_Station = 5;
+    MSTP_Init(&MSTP_Port);
+    MSTP_Adaptive_Enable(&MSTP_Port, true);
+    zassert_true(MSTP_Adaptive_Enabled(&MSTP_Port), NULL);
+    SilenceTime = 0;
+    Test_Milliseconds = 0;
+    Test_Send_Pending = false;
+    /* Max_Master is lowered to the highest master seen, and a margin */
+    for (i = 0; i < MSTP_ADAPTIVE_WINDOW_TOKENS; i++) {
+        zassert_equal(MSTP_Port.Nmax_master, 127, NULL);
+        testMasterNodeAdaptiveRotation(&MSTP_Port);
+    }
+    zassert_equal(
+        MSTP_Port.Nmax_master, 20 + MSTP_ADAPTIVE_MASTER_MARGIN, NULL);
+    zassert_equal(MSTP_Port.Nmax_info_frames, 1, NULL);
+    MSTP_Token_Rotation(&MSTP_Port, &rotation);
+    zassert_equal(rotation.count, MSTP_ADAPTIVE_WINDOW_TOKENS - 1, NULL);
+    zassert_equal(rotation.last_ms, 10, NULL);
+    zassert_equal(rotation.max_ms, 10, NULL);
+    zassert_equal(
+        rotation.total_ms, 10 * (MSTP_ADAPTIVE_WINDOW_TOKENS - 1), NULL);
+    zassert_equal(MSTP_Port.Statistics.token_rotation[4],
+        MSTP_ADAPTIVE_WINDOW_TOKENS - 1, NULL);
+    MSTP_Token_Rotation_Reset(&MSTP_Port);
+    MSTP_Token_Rotation(&MSTP_Port, &rotation);
+    zassert_equal(rotation.count, 0, NULL);
+    /* the full range is polled now and then for new masters */
+    for (i = 1; i < MSTP_ADAPTIVE_SWEEP_WINDOWS; i++) {
+        while (MSTP_Port.Adaptive.window_tokens <
+            (MSTP_ADAPTIVE_WINDOW_TOKENS - 1)) {
+            testMasterNodeAdaptiveRotation(&MSTP_Port);
+        }
+        zassert_equal(
+            MSTP_Port.Nmax_master, 20 + MSTP_ADAPTIVE_MASTER_MARGIN, NULL);
+        testMasterNodeAdaptiveRotation(&MSTP_Port);
+    }
+    zassert_equal(MSTP_Port.Nmax_master, 127, NULL);
+    for (i = 0; i < MSTP_ADAPTIVE_WINDOW_TOKENS; i++) {
+        testMasterNodeAdaptiveRotation(&MSTP_Port);
+    }
+    zassert_equal(
+        MSTP_Port.Nmax_master, 20 + MSTP_ADAPTIVE_MASTER_MARGIN, NULL);
+    /* Max_Info_Frames is doubled while the token is used up */
+    Test_Send_Pending = true;
+    for (i = 0; i < MSTP_ADAPTIVE_BUSY_TOKENS; i++) {
+        zassert_equal(MSTP_Port.Nmax_info_frames, 1, NULL);
+        testMasterNodeAdaptiveRotation(&MSTP_Port);
+    }
+    zassert_equal(MSTP_Port.Nmax_info_frames, 2, NULL);
+    /* and decreased again when the transmit queue empties */
+    Test_Send_Pending = false;
+    for (i = 0; i < MSTP_ADAPTIVE_IDLE_TOKENS; i++) {
+        zassert_equal(MSTP_Port.Nmax_info_frames, 2, NULL);
+        testMasterNodeAdaptiveRotation(&MSTP_Port);
+    }
+    zassert_equal(MSTP_Port.Nmax_info_frames, 1, NULL);
+    /* the configured values are restored */
+    MSTP_Adaptive_Max_Master_Set(&MSTP_Port, 100);
+    zassert_equal(
+        MSTP_Port.Nmax_master, 20 + MSTP_ADAPTIVE_MASTER_MARGIN, NULL);
+    MSTP_Adaptive_Enable(&MSTP_Port, false);
+    zassert_false(MSTP_Adaptive_Enabled(&MSTP_Port), NULL);
+    zassert_equal(MSTP_Port.Nmax_master, 100, NULL);
+    zassert_equal(MSTP_Port.Nmax_info_frames, 1, NULL);
+}
+
+static void testStatistics(void)
+{
+    struct mstp_port_struct_t MSTP_Port = { 0 }; /* port data */
+    MSTP_STATISTICS statistics = { 0 };
+    uint8_t frame[MAX_MPDU] = { 0 };
+    uint8_t data[8] = { 0x01, 0x00, 0x10, 0x08, 0x00, 0x00, 0x00, 0x00 };
+    uint16_t len;
+
+    zassert_equal(MSTP_Statistics_Histogram_Bin(0), 0, NULL);
+    zassert_equal(MSTP_Statistics_Histogram_Bin(1), 1, NULL);
+    zassert_equal(MSTP_Statistics_Histogram_Bin(3), 2, NULL);
+    zassert_equal(MSTP_Statistics_Histogram_Bin(4), 3, NULL);
+    zassert_equal(MSTP_Statistics_Histogram_Bin(0xFFFFFFFF),
+        MSTP_STATISTICS_HISTOGRAM_BINS - 1, NULL);
+    MSTP_Port.InputBuffer = &RxBuffer[0];
+    MSTP_Port.InputBufferSize = sizeof(RxBuffer);
+    MSTP_Port.OutputBuffer = &TxBuffer[0];
+    MSTP_Port.OutputBufferSize = sizeof(TxBuffer);
+    MSTP_Port.Nmax_info_frames = 1;
+    MSTP_Port.Nmax_master = 127;
+    MSTP_Port.SilenceTimer = Timer_Silence;
+    MSTP_Port.SilenceTimerReset = Timer_Silence_Reset;
+    MSTP_Port.This_Station = 5;
+    MSTP_Init(&MSTP_Port);
+    SilenceTime = 0;
+    /* a valid token, then one with a bad header CRC */
+    len = MSTP_Create_Frame(
+        frame, sizeof(frame), FRAME_TYPE_TOKEN, 5, 4, NULL, 0);
+    MSTP_Receive_Frame_Data(&MSTP_Port, frame, len);
+    zassert_true(MSTP_Port.ReceivedValidFrame, NULL);
+    MSTP_Port.ReceivedValidFrame = false;
+    frame[7] ^= 0xFF;
+    MSTP_Receive_Frame_Data(&MSTP_Port, frame, len);
+    zassert_true(MSTP_Port.ReceivedInvalidFrame, NULL);
+    MSTP_Port.ReceivedInvalidFrame = false;
+    /* a data frame with a bad data CRC */
+    len = MSTP_Create_Frame(frame, sizeof(frame),
+        FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, 5, 4, data, sizeof(data));
+    frame[len - 1] ^= 0xFF;
+    MSTP_Receive_Frame_Data(&MSTP_Port, frame, len);
+    zassert_true(MSTP_Port.ReceivedInvalidFrame, NULL);
+    MSTP_Port.ReceivedInvalidFrame = false;
+    /* frames sent are counted by type */
+    MSTP_Create_And_Send_Frame(
+        &MSTP_Port, FRAME_TYPE_POLL_FOR_MASTER, 6, 5, NULL, 0);
+    MSTP_Statistics(&MSTP_Port, &statistics);
+    zassert_equal(statistics.rx_frames[FRAME_TYPE_TOKEN], 1, NULL);
+    zassert_equal(statistics.rx_invalid_frames, 2, NULL);
+    zassert_equal(statistics.header_crc_errors, 1, NULL);
+    zassert_equal(statistics.data_crc_errors, 1, NULL);
+    zassert_equal(statistics.tx_frames[FRAME_TYPE_POLL_FOR_MASTER], 1, NULL);
+    zassert_equal(statistics.tx_frames[FRAME_TYPE_TOKEN], 0, NULL);
+    MSTP_Statistics_Reset(&MSTP_Port);
+    MSTP_Statistics(&MSTP_Port, &statistics);
+    zassert_equal(statistics.rx_frames[FRAME_TYPE_TOKEN], 0, NULL);
+    zassert_equal(statistics.rx_invalid_frames, 0, NULL);
+}
+
 static void testSlaveNodeFSM(void)
 {
     struct mstp_port_struct_t MSTP_Port = { 0 }; /* port data */
@@ -1108,7 +1461,12 @@ static void testZeroConfigNodeFSM(void)
 void test_main(void)
 {
     ztest_test_suite(crc_tests, ztest_unit_test(testReceiveNodeFSM),
-        ztest_unit_test(testMasterNodeFSM), ztest_unit_test(testSlaveNodeFSM),
+        ztest_unit_test(testReceiveFrameData),
+        ztest_unit_test(testReceiveExtendedFrameMax),
+        ztest_unit_test(testMasterNodeFSM),
+        ztest_unit_test(testMasterNodeAdaptive),
+        ztest_unit_test(testStatistics),
+        ztest_unit_test(testSlaveNodeFSM),
         ztest_unit_test(testZeroConfigNodeFSM));
 
     ztest_run_test_suite(crc_tests);
@@ -59,6 +59,31 @@ static void testIndexText(void)
     zassert_equal(
         index, indtext_by_istring_default(data_list, "ANNA", index), NULL);
 }
+
+/**
+ * @brief Test the lookup table against the list search
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(indtext_tests, testIndexTextTable)
+#else
+static void testIndexTextTable(void)
+#endif
+{
+    INDTEXT_INDEX index_table;
+    const char *table[4];
+    unsigned i;
+
+    /* indexes 4 and 5 are beyond the table, and found in the list */
+    indtext_index_init(&index_table, data_list, table, 4);
+    for (i = 0; i < 10; i++) {
+        zassert_equal(indtext_index_by_index(&index_table, i),
+            indtext_by_index(data_list, i), "index=%u", i);
+    }
+    indtext_index_init(&index_table, data_list, NULL, 4);
+    zassert_equal(indtext_index_by_index(&index_table, 2),
+        indtext_by_index(data_list, 2), NULL);
+    zassert_is_null(indtext_index_by_index(NULL, 2), NULL);
+}
 /**
  * @}
  */
@@ -70,7 +95,8 @@ ZTEST_SUITE(indtext_tests, NULL, NULL, NULL, NULL, NULL);
 void test_main(void)
 {
     ztest_test_suite(indtext_tests,
-     ztest_unit_test(testIndexText)
+     ztest_unit_test(testIndexText),
+     ztest_unit_test(testIndexTextTable)
      );
 
     ztest_run_test_suite(indtext_tests);
@@ -40,6 +40,59 @@ static void test_memcopy(void)
         &buffer[0], &big_buffer[0], 1, sizeof(big_buffer), sizeof(buffer));
     zassert_equal(len, 0, NULL);
 }
+
+/**
+ * @brief Test the bounded writer
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(memcopy_tests, test_memcopy_writer)
+#else
+static void test_memcopy_writer(void)
+#endif
+{
+    uint8_t buffer[8] = { 0 };
+    uint8_t data[4] = { 1, 2, 3, 4 };
+    MEMCOPY_WRITER writer = { 0 };
+    uint8_t *apdu = NULL;
+    size_t mark = 0;
+    bool status = false;
+
+    memcopy_writer_init(&writer, buffer, sizeof(buffer));
+    zassert_equal(memcopy_writer_length(&writer), 0, NULL);
+    zassert_equal(memcopy_writer_remaining(&writer), sizeof(buffer), NULL);
+    zassert_false(memcopy_writer_overflow(&writer), NULL);
+    status = memcopy_writer_append(&writer, data, sizeof(data));
+    zassert_true(status, NULL);
+    zassert_equal(memcopy_writer_length(&writer), sizeof(data), NULL);
+    zassert_equal(memcmp(buffer, data, sizeof(data)), 0, NULL);
+    /* encode in place */
+    mark = memcopy_writer_mark(&writer);
+    apdu = memcopy_writer_reserve(&writer, 2);
+    zassert_equal(apdu, &buffer[4], NULL);
+    apdu[0] = 5;
+    apdu[1] = 6;
+    status = memcopy_writer_advance(&writer, 2);
+    zassert_true(status, NULL);
+    zassert_equal(memcopy_writer_remaining(&writer), 2, NULL);
+    /* overflow is latched */
+    status = memcopy_writer_append(&writer, data, sizeof(data));
+    zassert_false(status, NULL);
+    zassert_true(memcopy_writer_overflow(&writer), NULL);
+    zassert_equal(memcopy_writer_length(&writer), 6, NULL);
+    apdu = memcopy_writer_reserve(&writer, 1);
+    zassert_is_null(apdu, NULL);
+    /* rollback clears the overflow */
+    memcopy_writer_rollback(&writer, mark);
+    zassert_false(memcopy_writer_overflow(&writer), NULL);
+    zassert_equal(memcopy_writer_length(&writer), mark, NULL);
+    status = memcopy_writer_append(&writer, data, sizeof(data));
+    zassert_true(status, NULL);
+    zassert_equal(memcopy_writer_remaining(&writer), 0, NULL);
+    /* invalid writer */
+    zassert_is_null(memcopy_writer_reserve(NULL, 0), NULL);
+    zassert_true(memcopy_writer_overflow(NULL), NULL);
+    zassert_equal(memcopy_writer_remaining(NULL), 0, NULL);
+}
 /**
  * @}
  */
@@ -51,7 +104,8 @@ ZTEST_SUITE(memcopy_tests, NULL, NULL, NULL, NULL, NULL);
 void test_main(void)
 {
     ztest_test_suite(memcopy_tests,
-     ztest_unit_test(test_memcopy)
+     ztest_unit_test(test_memcopy),
+     ztest_unit_test(test_memcopy_writer)
      );
 
     ztest_run_test_suite(memcopy_tests);
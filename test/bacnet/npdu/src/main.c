@@ -9,6 +9,7 @@
  */
 
 #include <zephyr/ztest.h>
+#include <bacnet/bacaddr.h>
 #include <bacnet/npdu.h>
 
 /**
@@ -197,6 +198,106 @@ static void testNPDU1(void)
     zassert_equal(npdu_dest.mac_len, src.mac_len, NULL);
     zassert_equal(npdu_src.mac_len, dest.mac_len, NULL);
 }
+
+/**
+ * @brief Test the NPDU view against the full NPDU decoder
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(npdu_tests, testNPDUView)
+#else
+static void testNPDUView(void)
+#endif
+{
+    uint8_t pdu[MAX_NPDU] = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    BACNET_ADDRESS npdu_dest = { 0 };
+    BACNET_ADDRESS npdu_src = { 0 };
+    BACNET_ADDRESS view_dest = { 0 };
+    BACNET_ADDRESS view_src = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_NPDU_DATA view_data = { 0 };
+    BACNET_NPDU_VIEW view = { 0 };
+    int len = 0;
+    int npdu_len = 0;
+    int view_len = 0;
+    int i = 0;
+
+    /* routed, with DNET, DADR, SNET, SADR and hop count */
+    dest.net = 1;
+    dest.len = 6;
+    for (i = 0; i < dest.len; i++) {
+        dest.adr[i] = i * 10;
+    }
+    src.net = 2;
+    src.len = 1;
+    src.adr[0] = 0x40;
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_URGENT);
+    len = bacnet_npdu_encode_pdu(&pdu[0], sizeof(pdu), &dest, &src, &npdu_data);
+    zassert_true(len > 0, NULL);
+    npdu_len = bacnet_npdu_decode(
+        pdu, (uint16_t)len, &npdu_dest, &npdu_src, &npdu_data);
+    view_len = bacnet_npdu_view_decode(pdu, (uint16_t)len, &view);
+    zassert_equal(view_len, npdu_len, NULL);
+    zassert_equal(view.apdu_offset, npdu_len, NULL);
+    zassert_equal(view.dnet, dest.net, NULL);
+    zassert_equal(view.dlen, dest.len, NULL);
+    zassert_equal(view.snet, src.net, NULL);
+    zassert_equal(view.slen, src.len, NULL);
+    zassert_equal(view.hop_count, HOP_COUNT_DEFAULT, NULL);
+    zassert_equal(pdu[view.hop_count_offset], HOP_COUNT_DEFAULT, NULL);
+    zassert_true(NPDU_VIEW_EXPECTING_REPLY(&view), NULL);
+    zassert_false(NPDU_VIEW_NETWORK_MESSAGE(&view), NULL);
+    zassert_equal(NPDU_VIEW_PRIORITY(&view), MESSAGE_PRIORITY_URGENT, NULL);
+    npdu_view_destination(pdu, &view, &view_dest);
+    zassert_true(bacnet_address_same(&view_dest, &npdu_dest), NULL);
+    npdu_view_source(pdu, &view, &view_src);
+    zassert_equal(view_src.net, npdu_src.net, NULL);
+    zassert_equal(view_src.len, npdu_src.len, NULL);
+    zassert_mem_equal(view_src.adr, npdu_src.adr, npdu_src.len, NULL);
+    npdu_view_npdu_data(pdu, &view, &view_data);
+    zassert_equal(view_data.hop_count, npdu_data.hop_count, NULL);
+    zassert_equal(view_data.priority, npdu_data.priority, NULL);
+    zassert_equal(
+        view_data.data_expecting_reply, npdu_data.data_expecting_reply, NULL);
+    /* every truncation of the NPCI is malformed */
+    for (i = 2; i < npdu_len; i++) {
+        view_len = bacnet_npdu_view_decode(pdu, (uint16_t)i, &view);
+        zassert_equal(view_len, -1, "len=%d", i);
+    }
+    /* local, with no routing information */
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    len = bacnet_npdu_encode_pdu(&pdu[0], sizeof(pdu), NULL, NULL, &npdu_data);
+    view_len = bacnet_npdu_view_decode(pdu, (uint16_t)len, &view);
+    zassert_equal(view_len, 2, NULL);
+    zassert_equal(view.dnet, 0, NULL);
+    zassert_equal(view.snet, 0, NULL);
+    zassert_equal(view.hop_count_offset, 0, NULL);
+    /* the network number set by the datalink for a broadcast is kept */
+    view_src.net = BACNET_BROADCAST_NETWORK;
+    npdu_view_source(pdu, &view, &view_src);
+    zassert_equal(view_src.net, BACNET_BROADCAST_NETWORK, NULL);
+    zassert_equal(view_src.len, 0, NULL);
+    /* network layer message with a vendor proprietary type */
+    npdu_encode_npdu_network(&npdu_data, 0x80, false, MESSAGE_PRIORITY_NORMAL);
+    npdu_data.vendor_id = 260;
+    dest.net = BACNET_BROADCAST_NETWORK;
+    dest.len = 0;
+    len = bacnet_npdu_encode_pdu(&pdu[0], sizeof(pdu), &dest, NULL, &npdu_data);
+    npdu_len = bacnet_npdu_decode(
+        pdu, (uint16_t)len, &npdu_dest, &npdu_src, &npdu_data);
+    view_len = bacnet_npdu_view_decode(pdu, (uint16_t)len, &view);
+    zassert_equal(view_len, npdu_len, NULL);
+    zassert_true(NPDU_VIEW_NETWORK_MESSAGE(&view), NULL);
+    zassert_equal(view.network_message_type, 0x80, NULL);
+    zassert_equal(view.vendor_id, 260, NULL);
+    zassert_equal(view.dnet, BACNET_BROADCAST_NETWORK, NULL);
+    /* too long of an address */
+    pdu[4] = MAX_MAC_LEN + 1;
+    view_len = bacnet_npdu_view_decode(pdu, sizeof(pdu), &view);
+    zassert_equal(view_len, -1, NULL);
+    zassert_equal(bacnet_npdu_view_decode(NULL, 2, &view), -1, NULL);
+}
 /**
  * @}
  */
@@ -210,7 +311,8 @@ void test_main(void)
     ztest_test_suite(npdu_tests,
      ztest_unit_test(testNPDU1),
      ztest_unit_test(testNPDU2),
-     ztest_unit_test(test_NPDU_Network)
+     ztest_unit_test(test_NPDU_Network),
+     ztest_unit_test(testNPDUView)
      );
 
     ztest_run_test_suite(npdu_tests);
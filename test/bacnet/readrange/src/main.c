@@ -0,0 +1,163 @@
+/**
+ * @file
+ * @brief Unit test for the ReadRange service encode and decode
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/readrange.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* items from the ReadRange-ACK process callback */
+static uint8_t *Item_Data[8];
+static int Item_Data_Len[8];
+static unsigned Item_Count;
+
+static void rr_ack_item_callback(uint32_t device_id,
+    BACNET_READ_RANGE_DATA *rrdata,
+    uint32_t item_number,
+    uint8_t *item_data,
+    int item_data_len)
+{
+    zassert_equal(device_id, 260001, NULL);
+    zassert_equal(rrdata->object_type, OBJECT_TRENDLOG, NULL);
+    zassert_equal(item_number, Item_Count, NULL);
+    if (Item_Count < 8) {
+        Item_Data[Item_Count] = item_data;
+        Item_Data_Len[Item_Count] = item_data_len;
+    }
+    Item_Count++;
+}
+
+/**
+ * @brief Encode a BACnetLogRecord with a real value and status flags
+ */
+static int log_record_encode(uint8_t *apdu, uint8_t minute, float real)
+{
+    BACNET_DATE date;
+    BACNET_TIME time;
+    BACNET_BIT_STRING status_flags;
+    int len = 0;
+
+    datetime_set_date(&date, 2026, 10, 17);
+    datetime_set_time(&time, 13, minute, 0, 0);
+    bitstring_init(&status_flags);
+    bitstring_set_bit(&status_flags, STATUS_FLAG_IN_ALARM, false);
+    bitstring_set_bit(&status_flags, STATUS_FLAG_FAULT, true);
+    bitstring_set_bit(&status_flags, STATUS_FLAG_OVERRIDDEN, false);
+    bitstring_set_bit(&status_flags, STATUS_FLAG_OUT_OF_SERVICE, false);
+    len += encode_opening_tag(&apdu[len], 0);
+    len += encode_application_date(&apdu[len], &date);
+    len += encode_application_time(&apdu[len], &time);
+    len += encode_closing_tag(&apdu[len], 0);
+    len += encode_opening_tag(&apdu[len], 1);
+    len += encode_context_real(&apdu[len], 2, real);
+    len += encode_closing_tag(&apdu[len], 1);
+    len += encode_context_bitstring(&apdu[len], 2, &status_flags);
+
+    return len;
+}
+
+/**
+ * @brief Test walking the items of a ReadRange-ACK in place
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(readrange_tests, testReadRangeAckItemProcess)
+#else
+static void testReadRangeAckItemProcess(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t item_data[MAX_APDU] = { 0 };
+    int record_len[3] = { 0 };
+    BACNET_READ_RANGE_DATA rrdata = { 0 };
+    BACNET_READ_RANGE_DATA test_rrdata = { 0 };
+    int item_data_len = 0;
+    int apdu_len = 0;
+    int len = 0;
+    unsigned i;
+
+    for (i = 0; i < 3; i++) {
+        record_len[i] = log_record_encode(
+            &item_data[item_data_len], (uint8_t)i, 20.0f + (float)i);
+        item_data_len += record_len[i];
+    }
+    rrdata.object_type = OBJECT_TRENDLOG;
+    rrdata.object_instance = 1;
+    rrdata.object_property = PROP_LOG_BUFFER;
+    rrdata.array_index = BACNET_ARRAY_ALL;
+    rrdata.application_data = item_data;
+    rrdata.application_data_len = item_data_len;
+    bitstring_init(&rrdata.ResultFlags);
+    bitstring_set_bit(&rrdata.ResultFlags, RESULT_FLAG_FIRST_ITEM, true);
+    bitstring_set_bit(&rrdata.ResultFlags, RESULT_FLAG_LAST_ITEM, true);
+    bitstring_set_bit(&rrdata.ResultFlags, RESULT_FLAG_MORE_ITEMS, false);
+    rrdata.RequestType = RR_BY_SEQUENCE;
+    rrdata.ItemCount = 3;
+    rrdata.FirstSequence = 7;
+    apdu_len = rr_ack_encode_apdu(apdu, 1, &rrdata);
+    zassert_true(apdu_len > 3, NULL);
+    /* skip the complex-ack header: type, invoke-id, service */
+    Item_Count = 0;
+    len = rr_ack_item_process(&apdu[3], apdu_len - 3, 260001, &test_rrdata,
+        rr_ack_item_callback);
+    zassert_equal(len, apdu_len - 3, NULL);
+    zassert_equal(test_rrdata.ItemCount, 3, NULL);
+    zassert_equal(test_rrdata.FirstSequence, 7, NULL);
+    zassert_equal(test_rrdata.application_data_len, item_data_len, NULL);
+    zassert_equal(Item_Count, 3, NULL);
+    item_data_len = 0;
+    for (i = 0; i < 3; i++) {
+        zassert_equal(Item_Data_Len[i], record_len[i], NULL);
+        zassert_mem_equal(
+            Item_Data[i], &item_data[item_data_len], record_len[i], NULL);
+        item_data_len += record_len[i];
+    }
+    /* a list of application tagged values: one item per value */
+    item_data_len = encode_application_real(&item_data[0], 1.0f);
+    item_data_len += encode_application_boolean(&item_data[item_data_len], 1);
+    item_data_len += encode_application_unsigned(&item_data[item_data_len], 9);
+    rrdata.application_data_len = item_data_len;
+    rrdata.RequestType = RR_BY_POSITION;
+    apdu_len = rr_ack_encode_apdu(apdu, 1, &rrdata);
+    Item_Count = 0;
+    len = rr_ack_item_process(&apdu[3], apdu_len - 3, 260001, &test_rrdata,
+        rr_ack_item_callback);
+    zassert_equal(len, apdu_len - 3, NULL);
+    zassert_equal(Item_Count, 3, NULL);
+    zassert_equal(Item_Data_Len[0], 5, NULL);
+    zassert_equal(Item_Data_Len[1], 1, NULL);
+    zassert_equal(Item_Data_Len[2], 2, NULL);
+    /* malformed item data: unbalanced constructed element */
+    item_data[0] = 0x0E;
+    item_data[1] = 0x21;
+    item_data[2] = 0x09;
+    rrdata.application_data_len = 3;
+    apdu_len = rr_ack_encode_apdu(apdu, 1, &rrdata);
+    len = rr_ack_item_process(&apdu[3], apdu_len - 3, 260001, &test_rrdata,
+        rr_ack_item_callback);
+    zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+    len = rr_ack_item_process(&apdu[3], apdu_len - 3, 260001, NULL, NULL);
+    zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(readrange_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        readrange_tests, ztest_unit_test(testReadRangeAckItemProcess));
+
+    ztest_run_test_suite(readrange_tests);
+}
+#endif
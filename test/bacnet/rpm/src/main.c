@@ -12,6 +12,8 @@
 #include <bacnet/bacerror.h>  /* For bacerror_decode_error_class_and_code() */
 #include <bacnet/bacdcode.h>
 #include <bacnet/rpm.h>
+#include <bacnet/basic/service/h_rpm_a.h>
+#include <bacnet/basic/sys/arena.h>
 
 /**
  * @addtogroup bacnet_tests
@@ -123,6 +125,8 @@ static void testReadPropertyMultiple(void)
     apdu_len += rpm_encode_apdu_object_property(
         &apdu[apdu_len], PROP_ALL, BACNET_ARRAY_ALL);
     apdu_len += rpm_encode_apdu_object_end(&apdu[apdu_len]);
+    /* the request encoders don't do length only encoding */
+    zassert_equal(rpm_encode_apdu_object_end(NULL), 0, NULL);
 
     zassert_not_equal(apdu_len, 0, NULL);
 
@@ -280,6 +284,15 @@ static void testReadPropertyMultipleAck(void)
     /* object end */
     apdu_len += rpm_ack_encode_apdu_object_end(&apdu[apdu_len]);
     zassert_not_equal(apdu_len, 0, NULL);
+    /* length only encoding */
+    test_len = rpm_ack_encode_apdu_init(NULL, invoke_id);
+    test_len += rpm_ack_encode_apdu_object_begin(NULL, &rpmdata);
+    test_len += rpm_ack_encode_apdu_object_property(
+        NULL, PROP_DEADBAND, BACNET_ARRAY_ALL);
+    test_len += rpm_ack_encode_apdu_object_property_error(
+        NULL, ERROR_CLASS_PROPERTY, ERROR_CODE_UNKNOWN_PROPERTY);
+    test_len += rpm_ack_encode_apdu_object_end(NULL);
+    zassert_equal(test_len, 6 + 2 + 6 + 1, "len=%d", test_len);
 
     /****** decode the packet ******/
     test_len = rpm_ack_decode_apdu(&apdu[0], apdu_len, &test_invoke_id,
@@ -402,11 +415,173 @@ static void testReadPropertyMultipleAck(void)
     zassert_equal(test_len, 0, NULL);
     zassert_equal(len, service_request_len, NULL);
 }
+
+/* results from the RPM-ACK process callback */
+static BACNET_READ_PROPERTY_DATA Process_Results[4];
+static unsigned Process_Count;
+
+static void rpm_ack_process_callback(
+    uint32_t device_id, BACNET_READ_PROPERTY_DATA *rp_data)
+{
+    zassert_equal(device_id, 260001, NULL);
+    if (Process_Count < 4) {
+        Process_Results[Process_Count] = *rp_data;
+    }
+    Process_Count++;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(rpm_tests, testReadPropertyMultipleAckProcess)
+#else
+static void testReadPropertyMultipleAckProcess(void)
+#endif
+{
+    uint8_t apdu[480] = { 0 };
+    uint8_t application_data_buffer[MAX_APDU] = { 0 };
+    int application_data_buffer_len = 0;
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_APPLICATION_DATA_VALUE test_value = { 0 };
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    BACNET_RPM_DATA rpmdata = { 0 };
+    int apdu_len = 0;
+    int len = 0;
+
+    value.tag = BACNET_APPLICATION_TAG_REAL;
+    value.type.Real = 42.0f;
+    application_data_buffer_len =
+        bacapp_encode_application_data(&application_data_buffer[0], &value);
+    /* two objects, the second with an error */
+    rpmdata.object_type = OBJECT_ANALOG_INPUT;
+    rpmdata.object_instance = 1;
+    apdu_len = rpm_ack_encode_apdu_object_begin(&apdu[apdu_len], &rpmdata);
+    apdu_len += rpm_ack_encode_apdu_object_property(
+        &apdu[apdu_len], PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+    apdu_len += rpm_ack_encode_apdu_object_property_value(&apdu[apdu_len],
+        &application_data_buffer[0], application_data_buffer_len);
+    apdu_len += rpm_ack_encode_apdu_object_end(&apdu[apdu_len]);
+    rpmdata.object_type = OBJECT_ANALOG_VALUE;
+    rpmdata.object_instance = 2;
+    apdu_len += rpm_ack_encode_apdu_object_begin(&apdu[apdu_len], &rpmdata);
+    apdu_len += rpm_ack_encode_apdu_object_property(
+        &apdu[apdu_len], PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+    apdu_len += rpm_ack_encode_apdu_object_property_value(&apdu[apdu_len],
+        &application_data_buffer[0], application_data_buffer_len);
+    apdu_len += rpm_ack_encode_apdu_object_property(
+        &apdu[apdu_len], PROP_PRIORITY_ARRAY, 3);
+    apdu_len += rpm_ack_encode_apdu_object_property_error(
+        &apdu[apdu_len], ERROR_CLASS_PROPERTY, ERROR_CODE_UNKNOWN_PROPERTY);
+    apdu_len += rpm_ack_encode_apdu_object_end(&apdu[apdu_len]);
+    Process_Count = 0;
+    len = rpm_ack_object_property_process(&apdu[0], apdu_len, 260001,
+        &rp_data, rpm_ack_process_callback);
+    zassert_equal(len, apdu_len, NULL);
+    zassert_equal(Process_Count, 3, NULL);
+    zassert_equal(Process_Results[0].object_type, OBJECT_ANALOG_INPUT, NULL);
+    zassert_equal(Process_Results[0].object_instance, 1, NULL);
+    zassert_equal(
+        Process_Results[0].object_property, PROP_PRESENT_VALUE, NULL);
+    zassert_equal(Process_Results[0].error_code, ERROR_CODE_SUCCESS, NULL);
+    zassert_equal(Process_Results[0].application_data_len,
+        application_data_buffer_len, NULL);
+    len = bacapp_decode_application_data(Process_Results[0].application_data,
+        Process_Results[0].application_data_len, &test_value);
+    zassert_equal(len, application_data_buffer_len, NULL);
+    zassert_true(bacapp_same_value(&value, &test_value), NULL);
+    zassert_equal(Process_Results[1].object_type, OBJECT_ANALOG_VALUE, NULL);
+    zassert_equal(Process_Results[1].object_instance, 2, NULL);
+    zassert_equal(Process_Results[2].object_property, PROP_PRIORITY_ARRAY,
+        NULL);
+    zassert_equal(Process_Results[2].array_index, 3, NULL);
+    zassert_equal(Process_Results[2].error_class, ERROR_CLASS_PROPERTY, NULL);
+    zassert_equal(
+        Process_Results[2].error_code, ERROR_CODE_UNKNOWN_PROPERTY, NULL);
+    zassert_is_null(Process_Results[2].application_data, NULL);
+    /* malformed: truncated reply */
+    Process_Count = 0;
+    len = rpm_ack_object_property_process(&apdu[0], apdu_len - 1, 260001,
+        &rp_data, rpm_ack_process_callback);
+    zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+    zassert_equal(Process_Count, 3, NULL);
+    len = rpm_ack_object_property_process(
+        NULL, apdu_len, 260001, &rp_data, rpm_ack_process_callback);
+    zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+}
 /**
  * @}
  */
 
 
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(rpm_tests, testReadPropertyMultipleAckArena)
+#else
+static void testReadPropertyMultipleAckArena(void)
+#endif
+{
+    uint8_t apdu[480] = { 0 };
+    uint8_t application_data_buffer[MAX_APDU] = { 0 };
+    static uint64_t arena_data[4096];
+    int application_data_buffer_len = 0;
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_READ_ACCESS_DATA read_access_data = { 0 };
+    BACNET_RPM_DATA rpmdata = { 0 };
+    ARENA_BUFFER arena = { 0 };
+    size_t arena_size = 0;
+    size_t size = 0;
+    int apdu_len = 0;
+    int len = 0;
+
+    value.tag = BACNET_APPLICATION_TAG_REAL;
+    value.type.Real = 42.0f;
+    application_data_buffer_len =
+        bacapp_encode_application_data(&application_data_buffer[0], &value);
+    /* two objects, with two properties each */
+    rpmdata.object_type = OBJECT_ANALOG_INPUT;
+    rpmdata.object_instance = 1;
+    apdu_len = rpm_ack_encode_apdu_object_begin(&apdu[apdu_len], &rpmdata);
+    apdu_len += rpm_ack_encode_apdu_object_property(
+        &apdu[apdu_len], PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+    apdu_len += rpm_ack_encode_apdu_object_property_value(&apdu[apdu_len],
+        &application_data_buffer[0], application_data_buffer_len);
+    apdu_len += rpm_ack_encode_apdu_object_property(
+        &apdu[apdu_len], PROP_DEADBAND, BACNET_ARRAY_ALL);
+    apdu_len += rpm_ack_encode_apdu_object_property_error(
+        &apdu[apdu_len], ERROR_CLASS_PROPERTY, ERROR_CODE_UNKNOWN_PROPERTY);
+    apdu_len += rpm_ack_encode_apdu_object_end(&apdu[apdu_len]);
+    rpmdata.object_type = OBJECT_ANALOG_VALUE;
+    rpmdata.object_instance = 2;
+    apdu_len += rpm_ack_encode_apdu_object_begin(&apdu[apdu_len], &rpmdata);
+    apdu_len += rpm_ack_encode_apdu_object_property(
+        &apdu[apdu_len], PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+    apdu_len += rpm_ack_encode_apdu_object_property_value(&apdu[apdu_len],
+        &application_data_buffer[0], application_data_buffer_len);
+    apdu_len += rpm_ack_encode_apdu_object_property(
+        &apdu[apdu_len], PROP_COV_INCREMENT, BACNET_ARRAY_ALL);
+    apdu_len += rpm_ack_encode_apdu_object_property_value(&apdu[apdu_len],
+        &application_data_buffer[0], application_data_buffer_len);
+    apdu_len += rpm_ack_encode_apdu_object_end(&apdu[apdu_len]);
+    /* enough memory for the whole list */
+    Arena_Init(&arena, arena_data, sizeof(arena_data));
+    len = rpm_ack_decode_service_request_arena(
+        apdu, apdu_len, &read_access_data, &arena);
+    zassert_equal(len, apdu_len, "len=%d apdu_len=%d", len, apdu_len);
+    zassert_equal(read_access_data.object_type, OBJECT_ANALOG_INPUT, NULL);
+    zassert_not_null(read_access_data.next, NULL);
+    zassert_equal(read_access_data.next->object_instance, 2, NULL);
+    zassert_not_null(read_access_data.next->listOfProperties, NULL);
+    zassert_not_null(read_access_data.next->listOfProperties->next, NULL);
+    arena_size = Arena_Used(&arena);
+    zassert_true(arena_size > 0, NULL);
+    /* running out of memory for any node is an error, never a short list */
+    for (size = 0; size < arena_size; size++) {
+        memset(&read_access_data, 0, sizeof(read_access_data));
+        Arena_Init(&arena, arena_data, size);
+        len = rpm_ack_decode_service_request_arena(
+            apdu, apdu_len, &read_access_data, &arena);
+        zassert_equal(len, BACNET_STATUS_ERROR, "size=%u len=%d",
+            (unsigned)size, len);
+    }
+}
+
 #if defined(CONFIG_ZTEST_NEW_API)
 ZTEST_SUITE(rpm_tests, NULL, NULL, NULL, NULL, NULL);
 #else
@@ -414,7 +589,9 @@ void test_main(void)
 {
     ztest_test_suite(rpm_tests,
      ztest_unit_test(testReadPropertyMultiple),
-     ztest_unit_test(testReadPropertyMultipleAck)
+     ztest_unit_test(testReadPropertyMultipleAck),
+     ztest_unit_test(testReadPropertyMultipleAckProcess),
+     ztest_unit_test(testReadPropertyMultipleAckArena)
      );
 
     ztest_run_test_suite(rpm_tests);